@@ -0,0 +1,194 @@
+#include "fixtures.h"
+
+#include "globals.h"
+
+namespace fixtures {
+
+namespace {
+const time_t HELSINKI_OFFSET_S = 2 * 3600;
+
+String formatTime(time_t t, const char* format) {
+	struct tm tm;
+	gmtime_r(&t, &tm);
+	char buf[40];
+	strftime(buf, sizeof(buf), format, &tm);
+	return buf;
+}
+
+String localTimestamp(time_t t) {
+	return formatTime(t + HELSINKI_OFFSET_S, "%Y-%m-%dT%H:%M:%S+02:00");
+}
+
+String utcTimestamp(time_t t) { return formatTime(t, "%Y-%m-%dT%H:%M:%S.0000000"); }
+
+// Odd rooms are free for the first 20 minutes
+time_t bookingStart(int room, int booking) {
+	return NOW - 600 + (room % 2) * 1800 + booking * 3600;
+}
+
+std::shared_ptr<cal::Event> event(const String& id, const String& summary, time_t start,
+                                  time_t end) {
+	return std::shared_ptr<cal::Event>(new cal::Event{
+	    .id = id,
+	    .creator = "organizer@example.com",
+	    .summary = summary,
+	    .unixStartTime = start,
+	    .unixEndTime = end,
+	});
+}
+}  // namespace
+
+void begin() {
+	safeUTC.setTime(NOW);
+	safeMyTZ.setLocation("Europe/Helsinki");
+	auto err = l10n.setLanguage("EN");
+	if (err)
+		log_e("Messages not loaded: %s", err->message.c_str());
+}
+
+String googleEventList(int count) {
+	String json = "{\"summary\":\"Meeting Room 1\",\"items\":[";
+	for (int i = 0; i < count; i++) {
+		const time_t start = NOW - 3600 + i * 1800;
+		const char* response = i % 3 == 2 ? "declined" : "accepted";
+		if (i > 0)
+			json += ",";
+		json += "{\"id\":\"event" + String(i) + "\",";
+		json += "\"creator\":{\"email\":\"organizer" + String(i)
+		        + "@example.com\",\"displayName\":\"Organizer " + String(i) + "\"},";
+		json += "\"summary\":\"Weekly sync " + String(i) + "\",";
+		json += "\"start\":{\"dateTime\":\"" + localTimestamp(start) + "\"},";
+		json += "\"end\":{\"dateTime\":\"" + localTimestamp(start + 1500) + "\"},";
+		json += "\"attendees\":[{\"email\":\"room@resource.calendar.google.com\","
+		        "\"resource\":true,\"responseStatus\":\""
+		        + String(response) + "\"}]}";
+	}
+	json += "]}";
+	return json;
+}
+
+String caldavReport(int count) {
+	String xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+	             "<D:multistatus xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">";
+	for (int i = 0; i < count; i++) {
+		const bool weekly = i % 4 == 3;
+		const time_t start = NOW - 3600 + i * 1800 - (weekly ? 4 * 7 * 24 * 3600 : 0);
+		xml += "<D:response><D:href>/rooms/room1/event" + String(i) + ".ics</D:href>";
+		xml += "<D:propstat><D:prop><C:calendar-data>BEGIN:VCALENDAR\r\nVERSION:2.0\r\n";
+		xml += "PRODID:-//Example//Calendar//EN\r\nBEGIN:VEVENT\r\n";
+		xml += "UID:event" + String(i) + "@example.com\r\n";
+		xml += "DTSTAMP:20240301T080000Z\r\n";
+		xml += "DTSTART;TZID=Europe/Helsinki:"
+		       + formatTime(start + HELSINKI_OFFSET_S, "%Y%m%dT%H%M%S") + "\r\n";
+		xml += "DTEND;TZID=Europe/Helsinki:"
+		       + formatTime(start + 1500 + HELSINKI_OFFSET_S, "%Y%m%dT%H%M%S") + "\r\n";
+		if (weekly) {
+			String weekday = formatTime(start + HELSINKI_OFFSET_S, "%a").substring(0, 2);
+			weekday.toUpperCase();
+			xml += "RRULE:FREQ=WEEKLY;BYDAY=" + weekday + "\r\n";
+		}
+		xml += "SUMMARY:Weekly sync " + String(i) + "\r\n";
+		xml += "ORGANIZER;CN=Organizer " + String(i) + ":mailto:organizer" + String(i)
+		       + "@example.com\r\n";
+		xml += "END:VEVENT\r\nEND:VCALENDAR\r\n</C:calendar-data></D:prop>";
+		xml += "<D:status>HTTP/1.1 200 OK</D:status></D:propstat></D:response>";
+	}
+	xml += "</D:multistatus>";
+	return xml;
+}
+
+String microsoftCalendarView() {
+	String json = "{\"value\":[";
+	for (int i = 0; i < 2; i++) {
+		const time_t start = NOW - 600 + i * 3600;
+		if (i > 0)
+			json += ",";
+		json += "{\"id\":\"AAMkAG" + String(i) + "\",";
+		json += "\"subject\":\"Weekly sync " + String(i) + "\",";
+		json += "\"organizer\":{\"emailAddress\":{\"name\":\"Organizer\","
+		        "\"address\":\"organizer@example.com\"}},";
+		json += "\"start\":{\"dateTime\":\"" + utcTimestamp(start) + "\",\"timeZone\":\"UTC\"},";
+		json += "\"end\":{\"dateTime\":\"" + utcTimestamp(start + 1800)
+		        + "\",\"timeZone\":\"UTC\"}}";
+	}
+	json += "]}";
+	return json;
+}
+
+String microsoftRoomName() {
+	return "{\"owner\":{\"name\":\"Meeting Room 1\",\"address\":\"room1@example.com\"}}";
+}
+
+std::vector<cal::Room> rooms(int count) {
+	std::vector<cal::Room> rooms;
+	for (int i = 0; i < count; i++)
+		rooms.push_back(cal::Room{"Room " + String(i), "room" + String(i) + "@example.com"});
+	return rooms;
+}
+
+String googleFreeBusy(int count, int bookings) {
+	String json = "{\"kind\":\"calendar#freeBusy\",\"timeMin\":\"" + localTimestamp(NOW)
+	              + "\",\"timeMax\":\"" + localTimestamp(NOW + 12 * 3600) + "\",\"calendars\":{";
+	for (int i = 0; i < count; i++) {
+		if (i > 0)
+			json += ",";
+		json += "\"room" + String(i) + "@example.com\":{\"busy\":[";
+		for (int b = 0; b < bookings; b++) {
+			const time_t start = bookingStart(i, b);
+			if (b > 0)
+				json += ",";
+			json += "{\"start\":\"" + localTimestamp(start) + "\",\"end\":\""
+			        + localTimestamp(start + 1800) + "\"}";
+		}
+		json += "]}";
+	}
+	json += "}}";
+	return json;
+}
+
+String microsoftSchedule(int count, int bookings) {
+	String json = "{\"value\":[";
+	for (int i = 0; i < count; i++) {
+		if (i > 0)
+			json += ",";
+		json += "{\"scheduleId\":\"room" + String(i) + "@example.com\",";
+		json += "\"availabilityView\":\"0220220220220220\",\"scheduleItems\":[";
+		for (int b = 0; b < bookings; b++) {
+			const time_t start = bookingStart(i, b);
+			if (b > 0)
+				json += ",";
+			json += "{\"isPrivate\":false,\"status\":\"busy\",\"subject\":\"Weekly sync "
+			        + String(b) + "\",\"location\":\"Room " + String(i) + "\",";
+			json += "\"start\":{\"dateTime\":\"" + utcTimestamp(start)
+			        + "\",\"timeZone\":\"UTC\"},";
+			json += "\"end\":{\"dateTime\":\"" + utcTimestamp(start + 1800)
+			        + "\",\"timeZone\":\"UTC\"}}";
+		}
+		json += "],\"workingHours\":{\"daysOfWeek\":[\"monday\",\"tuesday\",\"wednesday\","
+		        "\"thursday\",\"friday\"],\"startTime\":\"08:00:00.0000000\","
+		        "\"endTime\":\"17:00:00.0000000\",\"timeZone\":{\"name\":\"UTC\"}}}";
+	}
+	json += "]}";
+	return json;
+}
+
+cal::Token token() {
+	return cal::Token{
+	    .accessToken = "access",
+	    .refreshToken = "refresh",
+	    .clientId = "client",
+	    .clientSecret = "secret",
+	    .scope = "calendar",
+	    .unixExpiry = NOW + 3600,
+	};
+}
+
+std::shared_ptr<cal::CalendarStatus> status(const String& suffix) {
+	return std::shared_ptr<cal::CalendarStatus>(new cal::CalendarStatus{
+	    .name = "Meeting Room 1",
+	    .currentEvent = event("current", "Weekly sync" + suffix, NOW - 600, NOW + 1200),
+	    .nextEvent = event("next", "Planning" + suffix, NOW + 3000, NOW + 4800),
+	});
+}
+
+}  // namespace fixtures
@@ -0,0 +1,67 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+#include <Arduino.h>
+
+#include <memory>
+#include <vector>
+
+#include "calendar/api.h"
+
+/**
+ * Canned inputs shared by the benchmarks. Everything is built relative to NOW,
+ * so the results don't depend on the host clock.
+ */
+namespace fixtures {
+
+// 2024-03-12 10:10:00 UTC, a Tuesday
+const time_t NOW = 1710238200;
+
+/**
+ * Set the clocks to NOW, the timezone to Europe/Helsinki and load the English messages.
+ * Messages are only available if data/localization.bin has been compiled.
+ */
+void begin();
+
+/**
+ * Google Calendar event list of `count` half hour events starting an hour before NOW,
+ * with local time offsets. Every third event is declined by the room.
+ */
+String googleEventList(int count = 16);
+
+/**
+ * CalDAV calendar-query response with `count` half hour events starting an hour before NOW,
+ * in Europe/Helsinki time. Every fourth event is weekly and started four weeks earlier.
+ */
+String caldavReport(int count = 16);
+
+/**
+ * Microsoft Graph calendar view of two events, times in UTC without a zone like Graph sends them.
+ */
+String microsoftCalendarView();
+String microsoftRoomName();
+
+/**
+ * Dashboard rooms room0@example.com, room1@example.com, ... named "Room 0", "Room 1", ...
+ */
+std::vector<cal::Room> rooms(int count);
+
+/**
+ * Google free/busy and Graph getSchedule responses for rooms(count). Every room has
+ * `bookings` half hour bookings an hour apart, the first one starting at NOW - 10 min in
+ * every other room. Each schedule also carries the fields that the filters drop.
+ */
+String googleFreeBusy(int count, int bookings = 6);
+String microsoftSchedule(int count, int bookings = 6);
+
+cal::Token token();
+
+/**
+ * Status with a current event from NOW - 10 min to NOW + 20 min and a next event
+ * starting at NOW + 50 min. Summaries get `suffix` so that statuses can differ.
+ */
+std::shared_ptr<cal::CalendarStatus> status(const String& suffix = "");
+
+}  // namespace fixtures
+
+#endif
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include "fixtures.h"
+#include "gui/screens/mainScreen.h"
+
+namespace {
+
+gui::MainScreen& mainScreen() {
+	fixtures::begin();
+	static gui::MainScreen screen;
+	return screen;
+}
+
+void BM_MainScreenSetStatus(benchmark::State& state) {
+	gui::MainScreen& screen = mainScreen();
+	const std::array<std::shared_ptr<cal::CalendarStatus>, 2> statuses{
+	    fixtures::status(" A"),
+	    fixtures::status(" B"),
+	};
+
+	size_t i = 0;
+	for (auto _ : state) screen.setStatus(statuses[i++ % statuses.size()]);
+}
+BENCHMARK(BM_MainScreenSetStatus);
+
+/**
+ * Full redraw into the screen buffer, including the button layout and the PNG decodes
+ * of the icons from data/images.
+ */
+void BM_MainScreenDraw(benchmark::State& state) {
+	gui::MainScreen& screen = mainScreen();
+	auto freeRoom = fixtures::status();
+	freeRoom->currentEvent = nullptr;
+	const std::array<std::shared_ptr<cal::CalendarStatus>, 2> statuses{
+	    fixtures::status(),
+	    freeRoom,
+	};
+
+	size_t i = 0;
+	for (auto _ : state) {
+		screen.setStatus(statuses[i++ % statuses.size()]);
+		screen.draw(UPDATE_MODE_GC16);
+	}
+}
+BENCHMARK(BM_MainScreenDraw)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Redraw when only the summaries changed, the common case of a status poll.
+ */
+void BM_MainScreenReducedDraw(benchmark::State& state) {
+	gui::MainScreen& screen = mainScreen();
+	const std::array<std::shared_ptr<cal::CalendarStatus>, 2> statuses{
+	    fixtures::status(" A"),
+	    fixtures::status(" B"),
+	};
+	screen.setStatus(statuses[0]);
+	screen.draw(UPDATE_MODE_GC16);
+
+	size_t i = 1;
+	for (auto _ : state) {
+		screen.setStatus(statuses[i++ % statuses.size()]);
+		screen.reducedDraw(UPDATE_MODE_GL16);
+	}
+}
+BENCHMARK(BM_MainScreenReducedDraw)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
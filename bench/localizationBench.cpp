@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "fixtures.h"
+#include "globals.h"
+#include "localization.h"
+
+namespace {
+
+// Languages of data/localization.json, alternated since loading the current language is a no-op
+const char* const LANGUAGES[] = {"FI", "EN"};
+
+void BM_LocalizationLoad(benchmark::State& state) {
+	fixtures::begin();
+	Localization localization;
+
+	size_t i = 0;
+	for (auto _ : state) {
+		auto err = localization.setLanguage(LANGUAGES[i++ % 2]);
+		if (err) {
+			state.SkipWithError(err->message.c_str());
+			break;
+		}
+	}
+}
+BENCHMARK(BM_LocalizationLoad);
+
+void BM_LocalizationLookup(benchmark::State& state) {
+	fixtures::begin();
+
+	size_t i = 0;
+	for (auto _ : state) {
+		const auto message = (L10nMessage)(i++ % (size_t)L10nMessage::SIZE);
+		benchmark::DoNotOptimize(l10n.msg(message));
+	}
+}
+BENCHMARK(BM_LocalizationLookup);
+
+}  // namespace
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include "calendar/model.h"
+#include "fixtures.h"
+#include "gui/guiTask.h"
+
+namespace {
+
+/**
+ * Model wired to an APITask and GUITask without tasks, see native/src/stubs.cpp.
+ * Statuses are delivered the way the API task does, through callbackCalendarStatus.
+ */
+struct ModelHarness {
+	ModelHarness() : apiTask(nullptr), model(apiTask) { model.registerGUITask(&guiTask); }
+
+	cal::APITask apiTask;
+	cal::Model model;
+	gui::GUITask guiTask;
+};
+
+ModelHarness& harness() {
+	static ModelHarness h;
+	return h;
+}
+
+void BM_ModelStatusUnchanged(benchmark::State& state) {
+	fixtures::begin();
+	ModelHarness& h = harness();
+	const auto result = cal::Result<cal::CalendarStatus>::makeOk(fixtures::status());
+	h.apiTask.callbackCalendarStatus(result);
+
+	for (auto _ : state) h.apiTask.callbackCalendarStatus(result);
+}
+BENCHMARK(BM_ModelStatusUnchanged);
+
+void BM_ModelStatusChanged(benchmark::State& state) {
+	fixtures::begin();
+	ModelHarness& h = harness();
+	const std::array<cal::Result<cal::CalendarStatus>, 2> results{
+	    cal::Result<cal::CalendarStatus>::makeOk(fixtures::status(" A")),
+	    cal::Result<cal::CalendarStatus>::makeOk(fixtures::status(" B")),
+	};
+
+	size_t i = 0;
+	for (auto _ : state) h.apiTask.callbackCalendarStatus(results[i++ % results.size()]);
+}
+BENCHMARK(BM_ModelStatusChanged);
+
+void BM_ModelCalculateReserveParams(benchmark::State& state) {
+	fixtures::begin();
+	ModelHarness& h = harness();
+	// No current event, the next one limits the reservation
+	auto status = fixtures::status();
+	status->currentEvent = nullptr;
+	h.apiTask.callbackCalendarStatus(cal::Result<cal::CalendarStatus>::makeOk(status));
+
+	for (auto _ : state) benchmark::DoNotOptimize(h.model.calculateReserveParams(30 * 60));
+}
+BENCHMARK(BM_ModelCalculateReserveParams);
+
+}  // namespace
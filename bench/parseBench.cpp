@@ -0,0 +1,194 @@
+#include <HTTPClient.h>
+#include <benchmark/benchmark.h>
+
+#include "calendar/caldavApi.h"
+#include "calendar/gatewayProtocol.h"
+#include "calendar/googleApi.h"
+#include "calendar/microsoftApi.h"
+#include "fixtures.h"
+#include "timeUtils.h"
+
+namespace {
+
+// The forms listed in timeUtils.h, and a Microsoft Graph time without an offset
+const char* const RFC_TIMESTAMPS[] = {
+    "2024-03-12T10:10:00Z",
+    "2024-03-12T12:10:00+02:00",
+    "2024-03-12T08:10:00-02:00",
+    "2024-03-12T10:10:00.000Z",
+    "2024-03-12T12:10:00.000+02:00",
+    "2024-03-12T08:10:00.123-02:00",
+    "2024-03-12T10:10:00.0000000",
+};
+const int RFC_TIMESTAMP_COUNT = sizeof(RFC_TIMESTAMPS) / sizeof(RFC_TIMESTAMPS[0]);
+
+void BM_ParseRfcTimestamp(benchmark::State& state) {
+	const char* input = RFC_TIMESTAMPS[state.range(0)];
+	const size_t length = strlen(input);
+	state.SetLabel(input);
+	for (auto _ : state) benchmark::DoNotOptimize(timeutils::parseRfcTimestamp(input, length));
+}
+BENCHMARK(BM_ParseRfcTimestamp)->DenseRange(0, RFC_TIMESTAMP_COUNT - 1);
+
+void BM_ParseRfcTimestampStrict(benchmark::State& state) {
+	const char* input = RFC_TIMESTAMPS[state.range(0)];
+	const size_t length = strlen(input);
+	state.SetLabel(input);
+	time_t result;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(timeutils::parseRfcTimestampStrict(input, length, result));
+}
+BENCHMARK(BM_ParseRfcTimestampStrict)->DenseRange(0, RFC_TIMESTAMP_COUNT - 2);
+
+// As the providers used to call it, on a String copied out of the document
+void BM_ParseRfcTimestampString(benchmark::State& state) {
+	const char* input = RFC_TIMESTAMPS[state.range(0)];
+	state.SetLabel(input);
+	for (auto _ : state) benchmark::DoNotOptimize(timeutils::parseRfcTimestamp(String(input)));
+}
+BENCHMARK(BM_ParseRfcTimestampString)->DenseRange(0, RFC_TIMESTAMP_COUNT - 1);
+
+void BM_GoogleFetchCalendarStatus(benchmark::State& state) {
+	fixtures::begin();
+	const String body = fixtures::googleEventList(state.range(0));
+	HTTPClient::clearResponses();
+	HTTPClient::setResponse("https://www.googleapis.com/calendar/v3/", HTTP_CODE_OK, body);
+	cal::GoogleAPI api(fixtures::token(), "room@resource.calendar.google.com");
+
+	for (auto _ : state) {
+		auto result = api.fetchCalendarStatus();
+		if (result.isErr()) {
+			state.SkipWithError(result.err()->message.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetBytesProcessed(state.iterations() * body.length());
+}
+BENCHMARK(BM_GoogleFetchCalendarStatus)->Arg(4)->Arg(16);
+
+void BM_MicrosoftFetchCalendarStatus(benchmark::State& state) {
+	fixtures::begin();
+	const String body = fixtures::microsoftCalendarView();
+	HTTPClient::clearResponses();
+	HTTPClient::setResponse("https://graph.microsoft.com/v1.0/users/room1@example.com/calendar?",
+	                        HTTP_CODE_OK, fixtures::microsoftRoomName());
+	HTTPClient::setResponse(
+	    "https://graph.microsoft.com/v1.0/users/room1@example.com/calendarView?", HTTP_CODE_OK,
+	    body);
+	cal::MicrosoftAPI api(fixtures::token(), "room1@example.com");
+
+	for (auto _ : state) {
+		auto result = api.fetchCalendarStatus();
+		if (result.isErr()) {
+			state.SkipWithError(result.err()->message.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetBytesProcessed(state.iterations() * body.length());
+}
+BENCHMARK(BM_MicrosoftFetchCalendarStatus);
+
+// Batched fetch of the dashboard mode, parsed from the response stream through a filter
+void BM_GoogleFetchRoomStatuses(benchmark::State& state) {
+	fixtures::begin();
+	const String body = fixtures::googleFreeBusy(state.range(0));
+	const auto rooms = fixtures::rooms(state.range(0));
+	HTTPClient::clearResponses();
+	HTTPClient::setResponse("https://www.googleapis.com/calendar/v3/freeBusy", HTTP_CODE_OK, body);
+	cal::GoogleAPI api(fixtures::token(), "");
+
+	for (auto _ : state) {
+		auto result = api.fetchRoomStatuses(rooms);
+		if (result.isErr()) {
+			state.SkipWithError(result.err()->message.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetBytesProcessed(state.iterations() * body.length());
+}
+BENCHMARK(BM_GoogleFetchRoomStatuses)->Arg(6)->Arg(12);
+
+void BM_MicrosoftFetchRoomStatuses(benchmark::State& state) {
+	fixtures::begin();
+	const String body = fixtures::microsoftSchedule(state.range(0));
+	const auto rooms = fixtures::rooms(state.range(0));
+	HTTPClient::clearResponses();
+	HTTPClient::setResponse("https://graph.microsoft.com/v1.0/me/calendar/getSchedule",
+	                        HTTP_CODE_OK, body);
+	cal::MicrosoftAPI api(fixtures::token(), "room1@example.com");
+
+	for (auto _ : state) {
+		auto result = api.fetchRoomStatuses(rooms);
+		if (result.isErr()) {
+			state.SkipWithError(result.err()->message.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetBytesProcessed(state.iterations() * body.length());
+}
+BENCHMARK(BM_MicrosoftFetchRoomStatuses)->Arg(6)->Arg(12);
+
+void BM_CalDAVFetchCalendarStatus(benchmark::State& state) {
+	fixtures::begin();
+	const String body = fixtures::caldavReport(state.range(0));
+	HTTPClient::clearResponses();
+	HTTPClient::setResponse("https://dav.example.com/rooms/room1/", 207, body);
+	cal::CalDAVAPI api("https://dav.example.com/rooms/room1/", "user", "password");
+
+	for (auto _ : state) {
+		auto result = api.fetchCalendarStatus();
+		if (result.isErr()) {
+			state.SkipWithError(result.err()->message.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetBytesProcessed(state.iterations() * body.length());
+}
+BENCHMARK(BM_CalDAVFetchCalendarStatus)->Arg(4)->Arg(16)->Arg(256);
+
+// The same status as the fetches above, from the LAN gateway instead of the provider json
+void BM_GatewayDecodeStatus(benchmark::State& state) {
+	fixtures::begin();
+	cal::gateway::Response response{};
+	response.type = cal::gateway::Type::STATUS_OK;
+	response.status = *fixtures::status();
+	response.hash = cal::gateway::hashStatus(response.status);
+	uint8_t frame[cal::gateway::FRAME_MAX_SIZE];
+	const size_t size = cal::gateway::encodeResponse(response, frame, sizeof(frame));
+
+	for (auto _ : state) {
+		cal::gateway::Response decoded{};
+		if (!cal::gateway::decodeResponse(frame, size, decoded)) {
+			state.SkipWithError("Decoding failed");
+			break;
+		}
+		benchmark::DoNotOptimize(decoded);
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_GatewayDecodeStatus);
+
+void BM_MergeConfig(benchmark::State& state) {
+	StaticJsonDocument<2048> base;
+	deserializeJson(base, R"({"name":"Room 1","wifi":{"ssid":"office","password":"secret"},)"
+	                      R"("gapi":{"calendarId":"room","token":{"client_id":"c"}},)"
+	                      R"("language":"EN","timezone":"Europe/Helsinki",)"
+	                      R"("awake":{"mon":[7,18]}})");
+	StaticJsonDocument<512> patch;
+	deserializeJson(patch, R"({"wifi":{"password":"changed"},"awake":{"fri":[8,16]}})");
+
+	StaticJsonDocument<2048> dst;
+	for (auto _ : state) {
+		dst.set(base);
+		utils::merge(dst.as<JsonVariant>(), patch.as<JsonVariantConst>());
+		benchmark::DoNotOptimize(dst);
+	}
+}
+BENCHMARK(BM_MergeConfig);
+
+}  // namespace
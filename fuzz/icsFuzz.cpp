@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "calendar/ics.h"
+
+/**
+ * Fuzz target of the streaming iCalendar parser, calendar text comes from any CalDAV server.
+ *
+ * - The input is fed as one calendar object, so AddressSanitizer catches overflows of the fixed
+ *   line, text and rule buffers and UBSan catches overflows in the recurrence arithmetic.
+ * - Every instance the parser reports must overlap the window, must not end before it starts,
+ *   and its strings must fit the buffers they were copied to.
+ */
+namespace {
+
+// Monday 2024-03-04 00:00 UTC and a week after it
+const time_t WINDOW_START = 1709510400;
+const time_t WINDOW_END = WINDOW_START + 7 * 24 * 60 * 60;
+
+void fail(const char* what, const cal::ics::Occurrence& occurrence) {
+	fprintf(stderr, "%s: uid \"%s\" %lld-%lld\n", what, occurrence.uid,
+	        (long long)occurrence.start, (long long)occurrence.end);
+	abort();
+}
+
+void check(const cal::ics::Occurrence& occurrence) {
+	if (occurrence.end < occurrence.start)
+		fail("Instance ends before it starts", occurrence);
+	if (occurrence.start >= WINDOW_END
+	    || (occurrence.end <= WINDOW_START && occurrence.start < WINDOW_START))
+		fail("Instance outside the window", occurrence);
+	if (strlen(occurrence.uid) >= cal::ics::UID_MAX_SIZE
+	    || strlen(occurrence.summary) >= cal::ics::TEXT_MAX_SIZE
+	    || strlen(occurrence.creator) >= cal::ics::TEXT_MAX_SIZE)
+		fail("Text longer than its buffer", occurrence);
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	cal::ics::TimeResolver resolver;
+	cal::ics::Parser parser(resolver);
+	parser.begin(WINDOW_START, WINDOW_END, check);
+	parser.feed((const char*)data, size);
+	parser.endObject();
+	return 0;
+}
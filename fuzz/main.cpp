@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Stand-alone driver of the fuzz targets for compilers without libFuzzer, e.g. the GCC of the
+ * native environment. Runs every file of the corpus, then random mutations of them.
+ *
+ * Usage: program [--runs=N] [--seed=N] CORPUS_DIR_OR_FILE...
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+// Bytes the parsers look for, of timestamps and iCalendar lines
+const char* const INTERESTING_BYTES = "0123456789-:.+TtZz ;=,\r\n";
+
+char interestingByte(std::mt19937& rng) {
+	return INTERESTING_BYTES[rng() % strlen(INTERESTING_BYTES)];
+}
+
+void loadCorpus(const std::filesystem::path& path, std::vector<std::string>& corpus) {
+	if (std::filesystem::is_directory(path)) {
+		for (const auto& entry : std::filesystem::directory_iterator(path))
+			loadCorpus(entry.path(), corpus);
+		return;
+	}
+	std::ifstream file(path, std::ios::binary);
+	corpus.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void mutate(std::string& input, std::mt19937& rng) {
+	const int mutations = 1 + rng() % 4;
+	for (int i = 0; i < mutations; i++) {
+		const size_t pos = input.empty() ? 0 : rng() % input.size();
+		switch (rng() % 5) {
+			case 0:  // Random byte
+				if (!input.empty())
+					input[pos] = (char)rng();
+				break;
+			case 1:
+				if (!input.empty())
+					input[pos] = interestingByte(rng);
+				break;
+			case 2:  // Truncate
+				input.resize(pos);
+				break;
+			case 3:  // Insert
+				input.insert(input.begin() + pos, interestingByte(rng));
+				break;
+			case 4:  // Erase
+				if (!input.empty())
+					input.erase(pos, 1);
+				break;
+		}
+	}
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	long runs = 1000000;
+	unsigned seed = 1;
+	std::vector<std::string> corpus;
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--runs=", 7) == 0)
+			runs = atol(argv[i] + 7);
+		else if (strncmp(argv[i], "--seed=", 7) == 0)
+			seed = atoi(argv[i] + 7);
+		else
+			loadCorpus(argv[i], corpus);
+	}
+	if (corpus.empty())
+		corpus.emplace_back();
+
+	for (const std::string& input : corpus)
+		LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+
+	std::mt19937 rng(seed);
+	for (long run = 0; run < runs; run++) {
+		std::string input = corpus[rng() % corpus.size()];
+		mutate(input, rng);
+		LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+	}
+	printf("%zu corpus inputs and %ld mutations passed\n", corpus.size(), runs);
+	return 0;
+}
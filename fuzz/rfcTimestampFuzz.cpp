@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include "timeUtils.h"
+
+/**
+ * Fuzz target of the RFC 3339 parsers.
+ *
+ * - Neither parser reads past length, the input is copied to a buffer of exactly that size
+ *   without a terminating zero, so AddressSanitizer catches overreads.
+ * - Everything parseRfcTimestampStrict accepts is checked against sscanf and timegm, and the
+ *   fast parser must agree with it.
+ */
+namespace {
+
+// Independent reading of a timestamp the strict parser accepted
+time_t reference(const char* text) {
+	struct tm tm {};
+	int consumed = 0;
+	sscanf(text, "%4d-%2d-%2d%*c%2d:%2d:%2d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour,
+	       &tm.tm_min, &tm.tm_sec, &consumed);
+	tm.tm_year -= 1900;
+	tm.tm_mon -= 1;
+	time_t t = timegm(&tm);
+
+	const char* offset = text + consumed;
+	if (*offset == '.')
+		offset += strspn(offset + 1, "0123456789") + 1;
+	if (*offset == '+' || *offset == '-') {
+		int hours = 0, minutes = 0;
+		sscanf(offset + 1, "%2d:%2d", &hours, &minutes);
+		const time_t seconds = hours * 3600 + minutes * 60;
+		t -= *offset == '-' ? -seconds : seconds;
+	}
+	return t;
+}
+
+void fail(const char* what, const char* text, long long expected, long long actual) {
+	fprintf(stderr, "%s: \"%s\" expected %lld, got %lld\n", what, text, expected, actual);
+	abort();
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	std::unique_ptr<char[]> input(new char[size]);
+	memcpy(input.get(), data, size);
+
+	const time_t fast = timeutils::parseRfcTimestamp(input.get(), size);
+	time_t strict = 0;
+	if (!timeutils::parseRfcTimestampStrict(input.get(), size, strict))
+		return 0;
+
+	// Accepted input has no zero bytes, a terminated copy is safe for sscanf
+	const std::string text(input.get(), size);
+	const time_t expected = reference(text.c_str());
+	if (strict != expected)
+		fail("Strict parser", text.c_str(), expected, strict);
+	if (fast != strict)
+		fail("Fast parser", text.c_str(), strict, fast);
+	return 0;
+}
@@ -0,0 +1,165 @@
+#include "calendarCache.h"
+
+#include "globals.h"
+
+namespace gateway {
+
+namespace {
+// Entries nobody asked for in this long are not refreshed, e.g. devices asleep for the night
+const time_t ACTIVE_S = 10 * 60;
+// Background refresh starts this long before an entry gets too old
+const time_t REFRESH_AHEAD_S = 5;
+// The gateway sends the requests of many devices, but still with a single credential
+const uint16_t RATE_LIMIT_BURST = 30;
+const time_t RATE_LIMIT_REFILL_S = 1;
+
+}  // namespace
+
+CalendarCache::CalendarCache(APIFactory factory, time_t maxAge)
+    : _factory{factory}, _maxAge{maxAge}, _limiter{RATE_LIMIT_BURST, RATE_LIMIT_REFILL_S} {}
+
+CalendarCache::CalendarEntry& CalendarCache::_calendar(const String& calendarId) {
+	CalendarEntry& entry = _calendars[calendarId];
+	if (!entry.api)
+		entry.api = _factory(calendarId);
+	return entry;
+}
+
+std::shared_ptr<cal::Error> CalendarCache::_authorize(cal::API& api) {
+	const time_t now = safeUTC.now();
+	const time_t until = _limiter.acquire(now);
+	if (until)
+		return cal::RateLimiter::heldBackError(until, now);
+	if (api.refreshAuth(now + cal::TOKEN_EXPIRY_MARGIN_S))
+		return nullptr;
+	return std::make_shared<cal::Error>(cal::Error::Type::HTTP, "Provider token refresh failed");
+}
+
+template <typename T>
+cal::Result<T> CalendarCache::_send(cal::API& api,
+                                    const std::function<cal::Result<T>()>& request) {
+	auto err = _authorize(api);
+	if (err)
+		return cal::Result<T>::makeErr(err);
+	auto result = request();
+	_limiter.record(result.isErr() ? result.err().get() : nullptr, safeUTC.now());
+	return result;
+}
+
+std::shared_ptr<cal::Error> CalendarCache::_fetch(CalendarEntry& entry) {
+	cal::API& api = *entry.api;
+	auto result = _send<cal::CalendarStatus>(api, [&api]() { return api.fetchCalendarStatus(); });
+	if (result.isErr())
+		return result.err();
+	entry.status = result.ok();
+	entry.fetched = safeUTC.now();
+	return nullptr;
+}
+
+std::shared_ptr<cal::Error> CalendarCache::_fetch(RoomsEntry& entry) {
+	if (!_roomsApi)
+		_roomsApi = _factory("");
+	auto result = _send<std::vector<cal::RoomStatus>>(
+	    *_roomsApi, [&]() { return _roomsApi->fetchRoomStatuses(entry.rooms); });
+	if (result.isErr())
+		return result.err();
+	entry.statuses = result.ok();
+	entry.fetched = safeUTC.now();
+	return nullptr;
+}
+
+bool CalendarCache::_isRefreshDue(const CacheTimes& times, time_t now) const {
+	const time_t refreshAge = _maxAge - min(REFRESH_AHEAD_S, _maxAge / 2);
+	return now - times.requested < ACTIVE_S && now - times.fetched >= refreshAge
+	       && now - times.attempted >= refreshAge;
+}
+
+cal::Result<cal::CalendarStatus> CalendarCache::status(const String& calendarId) {
+	CalendarEntry& entry = _calendar(calendarId);
+	const time_t now = safeUTC.now();
+	entry.requested = now;
+	if (entry.status && now - entry.fetched < _maxAge)
+		return cal::Result<cal::CalendarStatus>::makeOk(entry.status);
+	auto err = _fetch(entry);
+	if (err)
+		return cal::Result<cal::CalendarStatus>::makeErr(err);
+	return cal::Result<cal::CalendarStatus>::makeOk(entry.status);
+}
+
+cal::Result<cal::Event> CalendarCache::endEvent(const String& calendarId,
+                                                const String& eventId) {
+	CalendarEntry& entry = _calendar(calendarId);
+	entry.status = nullptr;
+	cal::API& api = *entry.api;
+	return _send<cal::Event>(api, [&]() { return api.endEvent(eventId); });
+}
+
+cal::Result<cal::Event> CalendarCache::insertEvent(const String& calendarId, time_t startTime,
+                                                   time_t endTime) {
+	CalendarEntry& entry = _calendar(calendarId);
+	entry.status = nullptr;
+	cal::API& api = *entry.api;
+	return _send<cal::Event>(api, [&]() { return api.insertEvent(startTime, endTime); });
+}
+
+cal::Result<cal::Event> CalendarCache::rescheduleEvent(const String& calendarId,
+                                                       std::shared_ptr<cal::Event> event,
+                                                       time_t newStartTime, time_t newEndTime) {
+	CalendarEntry& entry = _calendar(calendarId);
+	entry.status = nullptr;
+	cal::API& api = *entry.api;
+	return _send<cal::Event>(
+	    api, [&]() { return api.rescheduleEvent(event, newStartTime, newEndTime); });
+}
+
+cal::Result<std::vector<cal::RoomStatus>> CalendarCache::roomStatuses(
+    const std::vector<String>& roomIds) {
+	String key;
+	for (const String& id : roomIds) key += id + "\n";
+	RoomsEntry& entry = _rooms[key];
+	if (entry.rooms.empty()) {
+		// Names are added by the device, the status only needs the id
+		for (const String& id : roomIds) entry.rooms.push_back(cal::Room{"", id});
+	}
+
+	const time_t now = safeUTC.now();
+	entry.requested = now;
+	if (entry.statuses && now - entry.fetched < _maxAge)
+		return cal::Result<std::vector<cal::RoomStatus>>::makeOk(entry.statuses);
+	auto err = _fetch(entry);
+	if (err)
+		return cal::Result<std::vector<cal::RoomStatus>>::makeErr(err);
+	return cal::Result<std::vector<cal::RoomStatus>>::makeOk(entry.statuses);
+}
+
+void CalendarCache::refresh() {
+	const time_t now = safeUTC.now();
+
+	// Only the oldest entry, so devices don't wait behind a batch of provider requests
+	CacheTimes* oldest = nullptr;
+	std::function<std::shared_ptr<cal::Error>()> fetchOldest;
+	for (auto& c : _calendars) {
+		CalendarEntry& entry = c.second;
+		if (_isRefreshDue(entry, now) && (!oldest || entry.fetched < oldest->fetched)) {
+			oldest = &entry;
+			fetchOldest = [this, &entry]() { return _fetch(entry); };
+		}
+	}
+	for (auto& r : _rooms) {
+		RoomsEntry& entry = r.second;
+		if (_isRefreshDue(entry, now) && (!oldest || entry.fetched < oldest->fetched)) {
+			oldest = &entry;
+			fetchOldest = [this, &entry]() { return _fetch(entry); };
+		}
+	}
+	if (!oldest)
+		return;
+
+	// A failure is retried after refreshAge, and reported by the next device request
+	oldest->attempted = now;
+	auto err = fetchOldest();
+	if (err)
+		log_w("Background refresh failed: %s", err->message.c_str());
+}
+
+}  // namespace gateway
@@ -0,0 +1,88 @@
+#ifndef GATEWAY_CALENDAR_CACHE_H
+#define GATEWAY_CALENDAR_CACHE_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "calendar/api.h"
+#include "calendar/rateLimiter.h"
+
+namespace gateway {
+
+/**
+ * Provider calendars of the gateway, one provider API per calendar.
+ *
+ * Statuses are cached for maxAge, so devices showing the same calendar or the same rooms
+ * share the provider requests. Calendars that devices keep asking for are refetched in the
+ * background before they get old, so a device is usually answered without waiting for the
+ * provider. Changes made through the gateway drop the cached status of their calendar.
+ *
+ * All calendars share the provider credential of the gateway, so one rate limiter holds back
+ * every provider request while the provider is throttling, and devices are told to retry later.
+ *
+ * Not thread safe, like the provider APIs.
+ */
+class CalendarCache {
+  public:
+	using APIFactory = std::function<std::unique_ptr<cal::API>(const String& calendarId)>;
+
+	CalendarCache(APIFactory factory, time_t maxAge);
+
+	cal::Result<cal::CalendarStatus> status(const String& calendarId);
+	cal::Result<cal::Event> endEvent(const String& calendarId, const String& eventId);
+	cal::Result<cal::Event> insertEvent(const String& calendarId, time_t startTime,
+	                                    time_t endTime);
+	cal::Result<cal::Event> rescheduleEvent(const String& calendarId,
+	                                        std::shared_ptr<cal::Event> event,
+	                                        time_t newStartTime, time_t newEndTime);
+	cal::Result<std::vector<cal::RoomStatus>> roomStatuses(const std::vector<String>& roomIds);
+
+	/**
+	 * Refetch the entries requested within the last few polls that are getting old.
+	 * Call regularly between requests.
+	 */
+	void refresh();
+
+  private:
+	struct CacheTimes {
+		time_t fetched = 0;
+		// Last background refresh, also when it failed
+		time_t attempted = 0;
+		time_t requested = 0;
+	};
+
+	struct CalendarEntry : CacheTimes {
+		std::unique_ptr<cal::API> api;
+		std::shared_ptr<cal::CalendarStatus> status;
+	};
+
+	struct RoomsEntry : CacheTimes {
+		std::vector<cal::Room> rooms;
+		std::shared_ptr<std::vector<cal::RoomStatus>> statuses;
+	};
+
+	CalendarEntry& _calendar(const String& calendarId);
+	// Refreshes the provider token of api, returns an error if that failed or was held back
+	std::shared_ptr<cal::Error> _authorize(cal::API& api);
+	// Sends request with api when the rate limiter lets it through, and records the result
+	template <typename T>
+	cal::Result<T> _send(cal::API& api, const std::function<cal::Result<T>()>& request);
+	std::shared_ptr<cal::Error> _fetch(CalendarEntry& entry);
+	std::shared_ptr<cal::Error> _fetch(RoomsEntry& entry);
+	bool _isRefreshDue(const CacheTimes& times, time_t now) const;
+
+	APIFactory _factory;
+	time_t _maxAge;
+	std::map<String, CalendarEntry> _calendars;
+	// Keyed by the joined room ids, a dashboard asks for the same rooms every time
+	std::map<String, RoomsEntry> _rooms;
+	// Room statuses come from one request for all rooms, not from a room's own calendar
+	std::unique_ptr<cal::API> _roomsApi;
+	cal::RateLimiter _limiter;
+};
+
+}  // namespace gateway
+
+#endif
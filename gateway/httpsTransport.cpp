@@ -0,0 +1,179 @@
+#include "httpsTransport.h"
+
+#include <netdb.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+namespace gateway {
+
+namespace {
+const int SOCKET_TIMEOUT_S = 15;
+
+struct Url {
+	String host;
+	String port;
+	String path;
+};
+
+bool parseUrl(const String& url, Url& parsed) {
+	const String scheme = "https://";
+	if (!url.startsWith(scheme))
+		return false;
+	int pathStart = url.indexOf('/', scheme.length());
+	if (pathStart < 0)
+		pathStart = url.length();
+	const String authority = url.substring(scheme.length(), pathStart);
+	const int colon = authority.indexOf(':');
+	parsed.host = colon < 0 ? authority : authority.substring(0, colon);
+	parsed.port = colon < 0 ? String("443") : authority.substring(colon + 1);
+	parsed.path = pathStart < (int)url.length() ? url.substring(pathStart) : String("/");
+	return !parsed.host.isEmpty();
+}
+
+int connectTcp(const Url& url) {
+	addrinfo hints{};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* addresses = nullptr;
+	if (getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &addresses) != 0)
+		return -1;
+
+	int fd = -1;
+	for (addrinfo* a = addresses; a && fd < 0; a = a->ai_next) {
+		fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+		if (fd < 0)
+			continue;
+		timeval timeout{SOCKET_TIMEOUT_S, 0};
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+		if (connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+	freeaddrinfo(addresses);
+	return fd;
+}
+
+SSL_CTX* sslContext() {
+	static SSL_CTX* context = []() {
+		SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+		SSL_CTX_set_default_verify_paths(ctx);
+		SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+		return ctx;
+	}();
+	return context;
+}
+
+/**
+ * Body of a chunked response, false if the chunks are malformed.
+ */
+bool decodeChunked(const std::string& chunked, std::string& body) {
+	size_t position = 0;
+	for (;;) {
+		const size_t lineEnd = chunked.find("\r\n", position);
+		if (lineEnd == std::string::npos)
+			return false;
+		const size_t size = strtoul(chunked.c_str() + position, nullptr, 16);
+		position = lineEnd + 2;
+		if (size == 0)
+			return true;
+		if (position + size > chunked.size())
+			return false;
+		body.append(chunked, position, size);
+		position += size + 2;
+	}
+}
+
+/**
+ * Status code, headers and body of a raw response, a negative HTTPC_ERROR if it is not HTTP.
+ */
+int parseResponse(const std::string& response, HTTPResponse& parsed) {
+	const size_t headerEnd = response.find("\r\n\r\n");
+	if (response.compare(0, 5, "HTTP/") != 0 || headerEnd == std::string::npos)
+		return HTTPC_ERROR_NO_HTTP_SERVER;
+	const size_t codeStart = response.find(' ');
+	const int code = atoi(response.c_str() + codeStart + 1);
+
+	bool chunked = false;
+	size_t lineStart = response.find("\r\n") + 2;
+	while (lineStart < headerEnd) {
+		const size_t lineEnd = response.find("\r\n", lineStart);
+		const String line(response.c_str() + lineStart, lineEnd - lineStart);
+		const int colon = line.indexOf(':');
+		if (colon > 0) {
+			String value = line.substring(colon + 1);
+			value.trim();
+			parsed.headers.push_back({line.substring(0, colon), value});
+			chunked = chunked
+			          || (line.substring(0, colon).equalsIgnoreCase("Transfer-Encoding")
+			              && value.equalsIgnoreCase("chunked"));
+		}
+		lineStart = lineEnd + 2;
+	}
+
+	const std::string content = response.substr(headerEnd + 4);
+	if (chunked) {
+		std::string decoded;
+		if (!decodeChunked(content, decoded))
+			return HTTPC_ERROR_ENCODING;
+		parsed.body = String(decoded.c_str(), decoded.size());
+	} else {
+		parsed.body = String(content.c_str(), content.size());
+	}
+	return code > 0 ? code : HTTPC_ERROR_NO_HTTP_SERVER;
+}
+}  // namespace
+
+int httpsRequest(const HTTPRequest& request, HTTPResponse& response) {
+	response = HTTPResponse{};
+	Url url;
+	if (!parseUrl(request.url, url)) {
+		log_e("Not an https url: %s", request.url.c_str());
+		return HTTPC_ERROR_CONNECTION_REFUSED;
+	}
+
+	const int fd = connectTcp(url);
+	if (fd < 0) {
+		log_w("Connecting to %s:%s failed", url.host.c_str(), url.port.c_str());
+		return HTTPC_ERROR_CONNECTION_REFUSED;
+	}
+	std::unique_ptr<SSL, decltype(&SSL_free)> ssl(SSL_new(sslContext()), SSL_free);
+	SSL_set_fd(ssl.get(), fd);
+	SSL_set_tlsext_host_name(ssl.get(), url.host.c_str());
+	SSL_set1_host(ssl.get(), url.host.c_str());
+	if (SSL_connect(ssl.get()) != 1) {
+		log_w("TLS handshake with %s failed: %s", url.host.c_str(),
+		      ERR_error_string(ERR_get_error(), nullptr));
+		close(fd);
+		return HTTPC_ERROR_CONNECTION_REFUSED;
+	}
+
+	// Connection: close, so the response ends when the server closes the connection
+	String head = String(request.method) + " " + url.path + " HTTP/1.1\r\nHost: " + url.host
+	              + "\r\nConnection: close\r\nContent-Length: " + String(request.payload.length())
+	              + "\r\n";
+	for (const auto& header : request.headers) head += header.first + ": " + header.second + "\r\n";
+	head += "\r\n";
+	const String message = head + request.payload;
+
+	int result = HTTPC_ERROR_SEND_HEADER_FAILED;
+	if (SSL_write(ssl.get(), message.c_str(), message.length()) == (int)message.length()) {
+		std::string raw;
+		char buffer[4096];
+		int read;
+		while ((read = SSL_read(ssl.get(), buffer, sizeof(buffer))) > 0) raw.append(buffer, read);
+		result = parseResponse(raw, response);
+	}
+
+	SSL_shutdown(ssl.get());
+	close(fd);
+	return result;
+}
+
+}  // namespace gateway
@@ -0,0 +1,17 @@
+#ifndef GATEWAY_HTTPS_TRANSPORT_H
+#define GATEWAY_HTTPS_TRANSPORT_H
+
+#include <HTTPClient.h>
+
+namespace gateway {
+
+/**
+ * HTTPS transport of the host HTTPClient with OpenSSL, so the provider APIs of the firmware
+ * run unchanged in the gateway. One connection per request, certificates are verified
+ * against the system store. Returns the status code or a negative HTTPC_ERROR.
+ */
+int httpsRequest(const HTTPRequest& request, HTTPResponse& response);
+
+}  // namespace gateway
+
+#endif
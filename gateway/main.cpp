@@ -0,0 +1,152 @@
+/**
+ * LAN calendar gateway of the devices, see gateway/README.md.
+ *
+ * Talks to the calendar provider with the provider APIs of the firmware, and answers the
+ * devices with the binary protocol of src/calendar/gatewayProtocol.h.
+ *
+ * Usage: program [--config FILE]
+ */
+
+#include <ArduinoJson.h>
+
+#include <memory>
+
+#include "calendar/googleApi.h"
+#include "calendar/microsoftApi.h"
+#include "calendarCache.h"
+#include "globals.h"
+#include "httpsTransport.h"
+#include "mockApi.h"
+#include "server.h"
+
+namespace {
+
+const size_t CONFIG_MAX_SIZE = 8192;
+const time_t DEFAULT_MAX_AGE_S = 60;
+
+String readFile(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return String();
+	String content;
+	char buffer[1024];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) content.concat(buffer, read);
+	fclose(file);
+	return content;
+}
+
+bool writeFile(const char* path, const String& content) {
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+	const bool written = fwrite(content.c_str(), 1, content.length(), file) == content.length();
+	return fclose(file) == 0 && written;
+}
+
+/**
+ * Provider APIs of the configured provider, nullptr after logging the error if the config is
+ * invalid. Rotated refresh tokens are written back to the config file.
+ */
+gateway::CalendarCache::APIFactory makeFactory(const String& provider, JsonDocument& config,
+                                               const String& configPath) {
+	if (provider == "mock") {
+		auto calendars = std::make_shared<gateway::MockCalendars>();
+		return [calendars](const String& calendarId) {
+			return std::unique_ptr<cal::API>(new gateway::MockAPI(calendars, calendarId));
+		};
+	}
+	if (provider != "google" && provider != "microsoft") {
+		log_e("Unknown calendar provider: %s", provider.c_str());
+		return nullptr;
+	}
+
+	const String key = provider == "google" ? "gcalsettings" : "mscalsettings";
+	auto tokenRes = cal::jsonToToken(config[key]["token"]);
+	if (tokenRes.isErr()) {
+		log_e("%s", tokenRes.err()->message.c_str());
+		return nullptr;
+	}
+	// Shared by the APIs of all calendars, so a rotated refresh token is used by the next one
+	std::shared_ptr<cal::Token> token = tokenRes.ok();
+
+	auto saveToken = [configPath, key, token](const cal::Token& newToken) {
+		*token = newToken;
+		// From the file, strings replaced in a document keep taking its memory
+		DynamicJsonDocument config(CONFIG_MAX_SIZE);
+		String content = readFile(configPath.c_str());
+		if (deserializeJson(config, content) == DeserializationError::Ok) {
+			config[key]["token"]["refresh_token"] = newToken.refreshToken;
+			content.clear();
+			serializeJsonPretty(config, content);
+			if (writeFile(configPath.c_str(), content)) {
+				log_i("Updated token saved");
+				return;
+			}
+		}
+		log_e("Saving the updated token to %s failed", configPath.c_str());
+	};
+
+	return [provider, token, saveToken](const String& calendarId) {
+		cal::Token calendarToken = *token;
+		cal::loadAccessToken(calendarToken);
+		cal::API* api = nullptr;
+		if (provider == "google")
+			api = new cal::GoogleAPI{calendarToken, calendarId};
+		else
+			api = new cal::MicrosoftAPI{calendarToken, calendarId};
+		api->registerSaveTokenFunc(saveToken);
+		return std::unique_ptr<cal::API>(api);
+	};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	String configPath = "gateway.json";
+	for (int i = 1; i < argc; i++) {
+		const String arg = argv[i];
+		if (arg == "--config" && i + 1 < argc) {
+			configPath = argv[++i];
+		} else {
+			fprintf(stderr, "Usage: %s [--config FILE]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	DynamicJsonDocument config(CONFIG_MAX_SIZE);
+	const String content = readFile(configPath.c_str());
+	if (content.isEmpty()) {
+		log_e("Config file %s is missing or empty", configPath.c_str());
+		return 1;
+	}
+	DeserializationError err = deserializeJson(config, content);
+	if (err) {
+		log_e("Config file %s is not valid json: %s", configPath.c_str(), err.c_str());
+		return 1;
+	}
+
+	safeUTC.setTime(time(nullptr));
+	const String timezone = config["timezone"] | "Europe/Helsinki";
+	if (!safeMyTZ.setLocation(timezone)) {
+		log_e("Unknown timezone: %s", timezone.c_str());
+		return 1;
+	}
+	// Summaries of the events booked from the devices
+	auto l10nErr = l10n.setLanguage(config["language"] | "EN");
+	if (l10nErr)
+		log_w("Messages not loaded: %s", l10nErr->message.c_str());
+
+	const String provider = config["calendar_provider"] | "mock";
+	gateway::CalendarCache::APIFactory factory = makeFactory(provider, config, configPath);
+	if (!factory)
+		return 1;
+	if (provider != "mock")
+		HTTPClient::setTransport(gateway::httpsRequest);
+
+	gateway::CalendarCache cache(factory, config["max_age_s"] | DEFAULT_MAX_AGE_S);
+	gateway::Server server(cache, config["key"] | "");
+	if (!server.begin(config["port"] | cal::gateway::DEFAULT_PORT))
+		return 1;
+	server.run();
+}
@@ -0,0 +1,145 @@
+#include "mockApi.h"
+
+#include <algorithm>
+
+#include "globals.h"
+
+namespace gateway {
+
+namespace {
+const time_t SLOT_S = 30 * 60;
+
+struct Booking {
+	const char* summary;
+	time_t startOffset;  // From the slot of the first use
+	time_t duration;
+};
+
+const Booking BOOKINGS[] = {
+    {"Weekly sync", -SLOT_S, 45 * 60},
+    {"Design review", 2 * SLOT_S, 30 * 60},
+    {"Planning", 6 * SLOT_S, 60 * 60},
+};
+
+// Spreads the bookings of different calendars, so a dashboard shows a mix of states
+time_t calendarOffset(const String& calendarId) {
+	uint32_t sum = 0;
+	for (const char* c = calendarId.c_str(); *c; c++) sum += (uint8_t)*c;
+	return (sum % 3) * SLOT_S;
+}
+
+cal::Event* findEvent(std::vector<cal::Event>& events, const String& eventId) {
+	auto it = std::find_if(events.begin(), events.end(),
+	                       [&](const cal::Event& e) { return e.id == eventId; });
+	return it == events.end() ? nullptr : &*it;
+}
+}  // namespace
+
+std::vector<cal::Event>& MockCalendars::events(const String& calendarId) {
+	auto it = _events.find(calendarId);
+	if (it != _events.end())
+		return it->second;
+
+	std::vector<cal::Event>& events = _events[calendarId];
+	const time_t now = safeUTC.now();
+	const time_t slot = now - now % SLOT_S + calendarOffset(calendarId);
+	for (const Booking& b : BOOKINGS) {
+		events.push_back(cal::Event{
+		    .id = nextEventId(),
+		    .creator = "organizer@example.com",
+		    .summary = b.summary,
+		    .unixStartTime = slot + b.startOffset,
+		    .unixEndTime = slot + b.startOffset + b.duration,
+		});
+	}
+	return events;
+}
+
+cal::Result<cal::CalendarStatus> MockAPI::fetchCalendarStatus() {
+	std::vector<cal::Event> events = _calendars->events(_calendarId);
+	std::sort(events.begin(), events.end(), [](const cal::Event& a, const cal::Event& b) {
+		return a.unixStartTime < b.unixStartTime;
+	});
+
+	const int at = _calendarId.indexOf('@');
+	auto status = new cal::CalendarStatus{
+	    .name = at < 0 ? _calendarId : _calendarId.substring(0, at),
+	    .currentEvent = nullptr,
+	    .nextEvent = nullptr,
+	};
+	const time_t now = safeUTC.now();
+	for (const cal::Event& event : events) {
+		if (event.unixStartTime <= now && now <= event.unixEndTime && !status->currentEvent)
+			status->currentEvent = std::make_shared<cal::Event>(event);
+		else if (event.unixStartTime > now && !status->nextEvent)
+			status->nextEvent = std::make_shared<cal::Event>(event);
+	}
+	return cal::Result<cal::CalendarStatus>::makeOk(status);
+}
+
+cal::Result<cal::Event> MockAPI::endEvent(const String& eventId) {
+	cal::Event* event = findEvent(_calendars->events(_calendarId), eventId);
+	if (!event) {
+		return cal::Result<cal::Event>::makeErr(
+		    new cal::Error(cal::Error::Type::HTTP, "HTTP: 404, Not Found"));
+	}
+	event->unixEndTime = safeUTC.now();
+	return cal::Result<cal::Event>::makeOk(new cal::Event(*event));
+}
+
+cal::Result<cal::Event> MockAPI::insertEvent(time_t startTime, time_t endTime) {
+	if (!isFree(startTime, endTime)) {
+		return cal::Result<cal::Event>::makeErr(new cal::Error(
+		    cal::Error::Type::LOGICAL, "Couldn't insert, it would overlap with another event"));
+	}
+	auto event = new cal::Event{
+	    .id = _calendars->nextEventId(),
+	    .creator = "gateway@example.com",
+	    .summary = l10n.msg(L10nMessage::NEW_EVENT_SUMMARY),
+	    .unixStartTime = startTime,
+	    .unixEndTime = endTime,
+	};
+	_calendars->events(_calendarId).push_back(*event);
+	return cal::Result<cal::Event>::makeOk(event);
+}
+
+cal::Result<cal::Event> MockAPI::rescheduleEvent(std::shared_ptr<cal::Event> event,
+                                                 time_t newStartTime, time_t newEndTime) {
+	if (!isFree(newStartTime, newEndTime, event->id)) {
+		return cal::Result<cal::Event>::makeErr(
+		    new cal::Error(cal::Error::Type::LOGICAL,
+		                   "Couldn't reschedule, it would overlap with another event"));
+	}
+	cal::Event* stored = findEvent(_calendars->events(_calendarId), event->id);
+	if (!stored) {
+		return cal::Result<cal::Event>::makeErr(
+		    new cal::Error(cal::Error::Type::HTTP, "HTTP: 404, Not Found"));
+	}
+	stored->unixStartTime = newStartTime;
+	stored->unixEndTime = newEndTime;
+	return cal::Result<cal::Event>::makeOk(new cal::Event(*stored));
+}
+
+cal::Result<std::vector<cal::RoomStatus>> MockAPI::fetchRoomStatuses(
+    const std::vector<cal::Room>& rooms) {
+	auto statuses = new std::vector<cal::RoomStatus>();
+	const time_t now = safeUTC.now();
+	for (const cal::Room& room : rooms) {
+		std::vector<cal::BusyPeriod> busy;
+		for (const cal::Event& event : _calendars->events(room.id))
+			busy.push_back(cal::BusyPeriod{event.unixStartTime, event.unixEndTime});
+		statuses->push_back(cal::roomStatusFromBusy(room.name, busy, now));
+	}
+	return cal::Result<std::vector<cal::RoomStatus>>::makeOk(statuses);
+}
+
+bool MockAPI::isFree(time_t startTime, time_t endTime, const String& ignoreId) {
+	for (const cal::Event& event : _calendars->events(_calendarId)) {
+		if (event.id != ignoreId && event.unixStartTime < endTime
+		    && startTime < event.unixEndTime)
+			return false;
+	}
+	return true;
+}
+
+}  // namespace gateway
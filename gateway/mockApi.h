@@ -0,0 +1,57 @@
+#ifndef GATEWAY_MOCK_API_H
+#define GATEWAY_MOCK_API_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "calendar/api.h"
+
+namespace gateway {
+
+/**
+ * Made-up calendars for trying the gateway and the devices without a provider account.
+ * A calendar gets a few bookings around the time it is first used, changes are kept in memory
+ * until the gateway exits.
+ */
+class MockCalendars {
+  public:
+	std::vector<cal::Event>& events(const String& calendarId);
+	String nextEventId() { return "mock" + String(_nextId++); }
+
+  private:
+	std::map<String, std::vector<cal::Event>> _events;
+	int _nextId = 0;
+};
+
+/**
+ * Provider API of one mock calendar, the calendars are shared by all instances.
+ */
+class MockAPI : public cal::API {
+  public:
+	MockAPI(std::shared_ptr<MockCalendars> calendars, const String& calendarId)
+	    : _calendars{calendars}, _calendarId{calendarId} {}
+
+	bool refreshAuth(time_t validUntil) override final { return true; }
+	time_t getTokenExpiry() override final { return 0; }
+	void registerSaveTokenFunc(
+	    std::function<void(const cal::Token&)> saveTokenFunc) override final {}
+
+	cal::Result<cal::CalendarStatus> fetchCalendarStatus() override final;
+	cal::Result<cal::Event> endEvent(const String& eventId) override final;
+	cal::Result<cal::Event> insertEvent(time_t startTime, time_t endTime) override final;
+	cal::Result<cal::Event> rescheduleEvent(std::shared_ptr<cal::Event> event,
+	                                        time_t newStartTime, time_t newEndTime) override final;
+	cal::Result<std::vector<cal::RoomStatus>> fetchRoomStatuses(
+	    const std::vector<cal::Room>& rooms) override final;
+
+  private:
+	bool isFree(time_t startTime, time_t endTime, const String& ignoreId = "");
+
+	std::shared_ptr<MockCalendars> _calendars;
+	String _calendarId;
+};
+
+}  // namespace gateway
+
+#endif
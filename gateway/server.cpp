@@ -0,0 +1,210 @@
+#include "server.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "globals.h"
+
+namespace gateway {
+
+namespace proto = cal::gateway;
+
+namespace {
+const int LISTEN_BACKLOG = 32;
+// The cache is refreshed at least this often when no device connects
+const int POLL_TIMEOUT_MS = 1000;
+// A device sends its request right after connecting
+const int RECEIVE_TIMEOUT_S = 2;
+
+const char* typeName(proto::Type type) {
+	switch (type) {
+		case proto::Type::STATUS:
+			return "status";
+		case proto::Type::END_EVENT:
+			return "end_event";
+		case proto::Type::INSERT_EVENT:
+			return "insert_event";
+		case proto::Type::RESCHEDULE_EVENT:
+			return "reschedule_event";
+		case proto::Type::ROOM_STATUSES:
+			return "room_statuses";
+		case proto::Type::STATUS_OK:
+			return "status_ok";
+		case proto::Type::NOT_MODIFIED:
+			return "not_modified";
+		case proto::Type::EVENT_OK:
+			return "event_ok";
+		case proto::Type::ROOM_STATUSES_OK:
+			return "room_statuses_ok";
+		case proto::Type::ERROR:
+			return "error";
+		default:
+			return "unknown";
+	}
+}
+
+bool receiveAll(int fd, uint8_t* buffer, size_t size) {
+	size_t received = 0;
+	while (received < size) {
+		const ssize_t n = recv(fd, buffer + received, size - received, 0);
+		if (n <= 0)
+			return false;
+		received += n;
+	}
+	return true;
+}
+
+proto::Response errorResponse(cal::Error::Type type, const String& message) {
+	proto::Response response{};
+	response.type = proto::Type::ERROR;
+	response.errorType = type;
+	response.message = message;
+	return response;
+}
+
+// Passes the Retry-After of the provider on, so devices back off with the gateway
+proto::Response errorResponse(const cal::Error& err) {
+	proto::Response response = errorResponse(err.type, err.message);
+	response.retryAfter = err.retryAfter;
+	return response;
+}
+
+proto::Response eventResponse(const cal::Result<cal::Event>& result) {
+	if (result.isErr())
+		return errorResponse(*result.err());
+	proto::Response response{};
+	response.type = proto::Type::EVENT_OK;
+	response.event = *result.ok();
+	return response;
+}
+}  // namespace
+
+Server::~Server() {
+	if (_listenFd >= 0)
+		close(_listenFd);
+}
+
+bool Server::begin(uint16_t port) {
+	_listenFd = socket(AF_INET6, SOCK_STREAM, 0);
+	if (_listenFd < 0) {
+		log_e("Creating the socket failed: %s", strerror(errno));
+		return false;
+	}
+	// Accept IPv4 too, and rebind right after a restart
+	const int off = 0;
+	const int on = 1;
+	setsockopt(_listenFd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+	setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+	sockaddr_in6 address{};
+	address.sin6_family = AF_INET6;
+	address.sin6_addr = in6addr_any;
+	address.sin6_port = htons(port);
+	if (bind(_listenFd, (sockaddr*)&address, sizeof(address)) != 0
+	    || listen(_listenFd, LISTEN_BACKLOG) != 0) {
+		log_e("Listening on port %u failed: %s", port, strerror(errno));
+		return false;
+	}
+	log_i("Listening on port %u", port);
+	return true;
+}
+
+void Server::run() {
+	for (;;) {
+		// The firmware clocks are set from the host clock, it is kept in time by the OS
+		safeUTC.setTime(time(nullptr));
+
+		pollfd listening{_listenFd, POLLIN, 0};
+		if (poll(&listening, 1, POLL_TIMEOUT_MS) > 0) {
+			const int client = accept(_listenFd, nullptr, nullptr);
+			if (client >= 0) {
+				_serve(client);
+				close(client);
+			}
+			continue;
+		}
+		// Only when no device is waiting
+		_cache.refresh();
+	}
+}
+
+void Server::_serve(int client) {
+	timeval timeout{RECEIVE_TIMEOUT_S, 0};
+	setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	uint8_t frame[proto::FRAME_MAX_SIZE];
+	if (!receiveAll(client, frame, proto::HEADER_SIZE)) {
+		log_w("No request received");
+		return;
+	}
+	const int payloadSize = proto::payloadSize(frame);
+	proto::Request request{};
+	if (payloadSize < 0 || !receiveAll(client, frame + proto::HEADER_SIZE, payloadSize)
+	    || !proto::decodeRequest(frame, proto::HEADER_SIZE + payloadSize, request)) {
+		log_w("Malformed request");
+		return;
+	}
+
+	const unsigned long start = millis();
+	const proto::Response response = _handle(request);
+	const size_t size = proto::encodeResponse(response, frame, sizeof(frame));
+	if (size == 0) {
+		log_e("Response to %s doesn't fit a frame", typeName(request.type));
+		return;
+	}
+	send(client, frame, size, MSG_NOSIGNAL);
+	log_i("%s %s: %s, %zu bytes in %lu ms", typeName(request.type), request.calendarId.c_str(),
+	      typeName(response.type), size, millis() - start);
+}
+
+proto::Response Server::_handle(const proto::Request& request) {
+	if (!_key.isEmpty() && request.key != _key)
+		return errorResponse(cal::Error::Type::HTTP, "Wrong gateway key");
+
+	switch (request.type) {
+		case proto::Type::STATUS: {
+			auto result = _cache.status(request.calendarId);
+			if (result.isErr())
+				return errorResponse(*result.err());
+			proto::Response response{};
+			response.hash = proto::hashStatus(*result.ok());
+			if (response.hash == request.knownHash) {
+				response.type = proto::Type::NOT_MODIFIED;
+			} else {
+				response.type = proto::Type::STATUS_OK;
+				response.status = *result.ok();
+			}
+			return response;
+		}
+		case proto::Type::END_EVENT:
+			return eventResponse(_cache.endEvent(request.calendarId, request.eventId));
+		case proto::Type::INSERT_EVENT:
+			return eventResponse(
+			    _cache.insertEvent(request.calendarId, request.startTime, request.endTime));
+		case proto::Type::RESCHEDULE_EVENT:
+			return eventResponse(_cache.rescheduleEvent(request.calendarId,
+			                                            std::make_shared<cal::Event>(request.event),
+			                                            request.startTime, request.endTime));
+		case proto::Type::ROOM_STATUSES: {
+			auto result = _cache.roomStatuses(request.roomIds);
+			if (result.isErr())
+				return errorResponse(*result.err());
+			proto::Response response{};
+			response.hash = proto::hashRoomStatuses(*result.ok());
+			if (response.hash == request.knownHash) {
+				response.type = proto::Type::NOT_MODIFIED;
+			} else {
+				response.type = proto::Type::ROOM_STATUSES_OK;
+				response.roomStatuses = *result.ok();
+			}
+			return response;
+		}
+		default:
+			return errorResponse(cal::Error::Type::LOGICAL, "Unknown gateway request");
+	}
+}
+
+}  // namespace gateway
@@ -0,0 +1,42 @@
+#ifndef GATEWAY_SERVER_H
+#define GATEWAY_SERVER_H
+
+#include "calendar/gatewayProtocol.h"
+#include "calendarCache.h"
+
+namespace gateway {
+
+/**
+ * TCP server of the device protocol, see src/calendar/gatewayProtocol.h.
+ *
+ * Connections are served one at a time on the calling thread, the provider APIs are not
+ * thread safe. Requests are short and mostly answered from the cache, waiting devices queue
+ * in the listen backlog.
+ */
+class Server {
+  public:
+	/**
+	 * Requests must carry key, an empty key accepts all requests.
+	 */
+	Server(CalendarCache& cache, const String& key) : _cache(cache), _key(key) {}
+	~Server();
+
+	bool begin(uint16_t port);
+
+	/**
+	 * Serve devices and refresh the cache between them, never returns.
+	 */
+	void run();
+
+  private:
+	void _serve(int client);
+	cal::gateway::Response _handle(const cal::gateway::Request& request);
+
+	CalendarCache& _cache;
+	String _key;
+	int _listenFd = -1;
+};
+
+}  // namespace gateway
+
+#endif
@@ -968,6 +968,14 @@ bool Timezone::setLocation(const String location /* = "GeoIP" */) {
 	return false;
 }
 
+// Set a known POSIX rule without a lookup, but keep the Olson name for getOlson()
+bool Timezone::setPosix(const String posix, const String olson) {
+	if (!setPosix(posix))
+		return false;
+	_olson = olson;
+	return true;
+}
+
 String Timezone::getOlson() { return _olson; }
 
 String Timezone::getOlsen() { return _olson; }
@@ -251,6 +251,7 @@ class Timezone {
 #ifdef EZTIME_NETWORK_ENABLE
   public:
 	bool setLocation(const String location = "GeoIP");
+	bool setPosix(const String posix, const String olson);
 	String getOlson();
 	String getOlsen();
 #ifdef EZTIME_CACHE_EEPROM
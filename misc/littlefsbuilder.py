@@ -1,2 +1,11 @@
 Import("env")
-env.Replace( MKSPIFFSTOOL=env.get("PROJECT_DIR") + '/mklittlefs' )
\ No newline at end of file
+from SCons.Script import COMMAND_LINE_TARGETS
+
+env.Replace( MKSPIFFSTOOL=env.get("PROJECT_DIR") + '/mklittlefs' )
+
+# Localized strings are read from a precompiled binary table, keep it in sync with the json source
+if any(target in COMMAND_LINE_TARGETS for target in ("buildfs", "uploadfs", "uploadfsota")):
+    env.Execute("$PYTHONEXE " + env.get("PROJECT_DIR") + "/scripts/compile_localization.py"
+                + " --json " + env.get("PROJECT_DIR") + "/data/localization.json"
+                + " --header " + env.get("PROJECT_DIR") + "/src/localization.h"
+                + " --out " + env.get("PROJECT_DIR") + "/data/localization.bin")
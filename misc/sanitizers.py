@@ -0,0 +1,4 @@
+Import("env")
+
+# Sanitizers need their runtime at link time too, build_flags only reach the compiler
+env.Append(LINKFLAGS=["-fsanitize=address,undefined"])
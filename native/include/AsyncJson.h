@@ -0,0 +1,7 @@
+#ifndef ASYNC_JSON_H_
+#define ASYNC_JSON_H_
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+
+#endif
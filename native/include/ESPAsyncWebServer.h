@@ -0,0 +1,26 @@
+#ifndef _ESPAsyncWebServer_H_
+#define _ESPAsyncWebServer_H_
+
+#include <Arduino.h>
+
+/**
+ * Host declarations of the async web server types referenced by the GUI headers.
+ * The server itself is not part of the native build.
+ */
+
+class AsyncWebServerRequest;
+
+class AsyncWebHandler {
+  public:
+	virtual ~AsyncWebHandler() = default;
+	virtual bool canHandle(AsyncWebServerRequest* request) { return false; }
+	virtual void handleRequest(AsyncWebServerRequest* request) {}
+	virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+class AsyncWebServer {
+  public:
+	explicit AsyncWebServer(uint16_t port) {}
+};
+
+#endif
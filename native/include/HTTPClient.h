@@ -0,0 +1,198 @@
+#ifndef HTTPCLIENT_H_
+#define HTTPCLIENT_H_
+
+#include <Arduino.h>
+#include <Stream.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+typedef enum {
+	HTTP_CODE_CONTINUE = 100,
+	HTTP_CODE_SWITCHING_PROTOCOLS = 101,
+	HTTP_CODE_PROCESSING = 102,
+	HTTP_CODE_OK = 200,
+	HTTP_CODE_CREATED = 201,
+	HTTP_CODE_ACCEPTED = 202,
+	HTTP_CODE_NON_AUTHORITATIVE_INFORMATION = 203,
+	HTTP_CODE_NO_CONTENT = 204,
+	HTTP_CODE_RESET_CONTENT = 205,
+	HTTP_CODE_PARTIAL_CONTENT = 206,
+	HTTP_CODE_MULTI_STATUS = 207,
+	HTTP_CODE_ALREADY_REPORTED = 208,
+	HTTP_CODE_IM_USED = 226,
+	HTTP_CODE_MULTIPLE_CHOICES = 300,
+	HTTP_CODE_MOVED_PERMANENTLY = 301,
+	HTTP_CODE_FOUND = 302,
+	HTTP_CODE_SEE_OTHER = 303,
+	HTTP_CODE_NOT_MODIFIED = 304,
+	HTTP_CODE_USE_PROXY = 305,
+	HTTP_CODE_TEMPORARY_REDIRECT = 307,
+	HTTP_CODE_PERMANENT_REDIRECT = 308,
+	HTTP_CODE_BAD_REQUEST = 400,
+	HTTP_CODE_UNAUTHORIZED = 401,
+	HTTP_CODE_PAYMENT_REQUIRED = 402,
+	HTTP_CODE_FORBIDDEN = 403,
+	HTTP_CODE_NOT_FOUND = 404,
+	HTTP_CODE_METHOD_NOT_ALLOWED = 405,
+	HTTP_CODE_NOT_ACCEPTABLE = 406,
+	HTTP_CODE_PROXY_AUTHENTICATION_REQUIRED = 407,
+	HTTP_CODE_REQUEST_TIMEOUT = 408,
+	HTTP_CODE_CONFLICT = 409,
+	HTTP_CODE_GONE = 410,
+	HTTP_CODE_LENGTH_REQUIRED = 411,
+	HTTP_CODE_PRECONDITION_FAILED = 412,
+	HTTP_CODE_PAYLOAD_TOO_LARGE = 413,
+	HTTP_CODE_URI_TOO_LONG = 414,
+	HTTP_CODE_UNSUPPORTED_MEDIA_TYPE = 415,
+	HTTP_CODE_RANGE_NOT_SATISFIABLE = 416,
+	HTTP_CODE_EXPECTATION_FAILED = 417,
+	HTTP_CODE_MISDIRECTED_REQUEST = 421,
+	HTTP_CODE_UNPROCESSABLE_ENTITY = 422,
+	HTTP_CODE_LOCKED = 423,
+	HTTP_CODE_FAILED_DEPENDENCY = 424,
+	HTTP_CODE_UPGRADE_REQUIRED = 426,
+	HTTP_CODE_PRECONDITION_REQUIRED = 428,
+	HTTP_CODE_TOO_MANY_REQUESTS = 429,
+	HTTP_CODE_REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
+	HTTP_CODE_INTERNAL_SERVER_ERROR = 500,
+	HTTP_CODE_NOT_IMPLEMENTED = 501,
+	HTTP_CODE_BAD_GATEWAY = 502,
+	HTTP_CODE_SERVICE_UNAVAILABLE = 503,
+	HTTP_CODE_GATEWAY_TIMEOUT = 504,
+	HTTP_CODE_HTTP_VERSION_NOT_SUPPORTED = 505,
+	HTTP_CODE_VARIANT_ALSO_NEGOTIATES = 506,
+	HTTP_CODE_INSUFFICIENT_STORAGE = 507,
+	HTTP_CODE_LOOP_DETECTED = 508,
+	HTTP_CODE_NOT_EXTENDED = 510,
+	HTTP_CODE_NETWORK_AUTHENTICATION_REQUIRED = 511
+} t_http_codes;
+
+/**
+ * Response body of the host HTTPClient, the firmware reads it like the WiFiClient of a
+ * connection. Writes are dropped.
+ */
+class HTTPBodyStream : public Stream {
+  public:
+	void reset(const String& body) {
+		_body = body;
+		_position = 0;
+	}
+
+	int available() override { return _body.length() - _position; }
+	int read() override { return _position < _body.length() ? (uint8_t)_body[_position++] : -1; }
+	int peek() override { return _position < _body.length() ? (uint8_t)_body[_position] : -1; }
+	using Stream::readBytes;
+	size_t readBytes(char* buffer, size_t length) override;
+	size_t write(uint8_t c) override { return 0; }
+
+  private:
+	String _body;
+	size_t _position = 0;
+};
+
+using HTTPHeaders = std::vector<std::pair<String, String>>;
+
+/**
+ * A request of the host HTTPClient, handed to the transport.
+ */
+struct HTTPRequest {
+	const char* method;
+	const String& url;
+	const HTTPHeaders& headers;
+	const String& payload;
+	// Certificate the server must present, nullptr without pinning
+	const char* caCert;
+};
+
+struct HTTPResponse {
+	String body;
+	HTTPHeaders headers;
+};
+
+/**
+ * Sends a request and returns the status code or a negative HTTPC_ERROR, response gets the
+ * response body and headers.
+ */
+using HTTPTransport = std::function<int(const HTTPRequest& request, HTTPResponse& response)>;
+
+/**
+ * Host version of HTTPClient. Without a transport there is no network, requests are answered
+ * from canned responses registered with setResponse(), so the calendar APIs can be driven
+ * from benchmarks.
+ */
+class HTTPClient {
+  public:
+	bool begin(String url);
+	// The transport sees the certificate, it isn't verified
+	bool begin(String url, const char* CAcert);
+	void end();
+
+	void setReuse(bool reuse) {}
+	void useHTTP10(bool usehttp10) {}
+	void setTimeout(uint16_t timeout) {}
+	void setConnectTimeout(int32_t connectTimeout) {}
+	void addHeader(const String& name, const String& value, bool first = false,
+	               bool replace = true);
+	// Basic auth, sent as an Authorization header
+	void setAuthorization(const char* user, const char* password);
+
+	int GET();
+	int POST(String payload);
+	int PATCH(String payload);
+	int PUT(String payload);
+	int sendRequest(const char* type, String payload);
+
+	// Only the headers in headerKeys are kept from the responses, like on the device
+	void collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+	String header(const char* name);
+	bool hasHeader(const char* name) { return header(name).length() > 0; }
+
+	String getString() { return _body; }
+	int getSize() { return _body.length(); }
+	// Reads the body from the start, independent of getString()
+	Stream& getStream();
+	Stream* getStreamPtr() { return &getStream(); }
+	// The whole body is read before the request returns, so open until it has been streamed
+	bool connected() { return _stream.available() > 0; }
+
+	static String errorToString(int error);
+
+	/**
+	 * Answer requests whose url starts with urlPrefix. The longest matching prefix wins and
+	 * unmatched requests fail with HTTPC_ERROR_CONNECTION_REFUSED.
+	 */
+	static void setResponse(const String& urlPrefix, int code, const String& body,
+	                        const HTTPHeaders& headers = {});
+	static void clearResponses();
+
+	/**
+	 * Send all requests with transport instead of answering them from the canned responses,
+	 * nullptr restores the canned responses.
+	 */
+	static void setTransport(HTTPTransport transport);
+
+  private:
+	String _url;
+	const char* _caCert = nullptr;
+	HTTPHeaders _headers;
+	String _body;
+	std::vector<String> _headerKeys;
+	HTTPHeaders _responseHeaders;
+	HTTPBodyStream _stream;
+};
+
+#endif
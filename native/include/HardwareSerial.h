@@ -0,0 +1,26 @@
+#ifndef HARDWARE_SERIAL_H
+#define HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+/**
+ * Serial writes to stdout and never has input.
+ */
+class HardwareSerial : public Stream {
+  public:
+	void begin(unsigned long baud) {}
+	void end() {}
+
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t* buffer, size_t size) override;
+	using Print::write;
+
+	int available() override { return 0; }
+	int read() override { return -1; }
+	int peek() override { return -1; }
+	void flush() override;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef IPADDRESS_H
+#define IPADDRESS_H
+
+#include <stdint.h>
+
+#include "WString.h"
+
+/**
+ * Host version of the Arduino IPv4 address.
+ */
+class IPAddress {
+  public:
+	IPAddress() : IPAddress(0, 0, 0, 0) {}
+	IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{a, b, c, d} {}
+
+	uint8_t operator[](int index) const { return _octets[index]; }
+	bool operator==(const IPAddress& rhs) const {
+		return memcmp(_octets, rhs._octets, sizeof(_octets)) == 0;
+	}
+	bool operator!=(const IPAddress& rhs) const { return !(*this == rhs); }
+
+	String toString() const {
+		return String(_octets[0]) + "." + _octets[1] + "." + _octets[2] + "." + _octets[3];
+	}
+
+  private:
+	uint8_t _octets[4];
+};
+
+#endif
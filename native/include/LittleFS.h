@@ -0,0 +1,30 @@
+#ifndef _LITTLEFS_H_
+#define _LITTLEFS_H_
+
+#include "FS.h"
+
+namespace fs {
+
+/**
+ * The flash file system is the data/ directory of the project, like the image uploaded with
+ * "pio run -t uploadfs". Set NATIVE_FS_ROOT to use another directory.
+ */
+class LittleFSFS : public FS {
+  public:
+	LittleFSFS();
+
+	bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+	           uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs") {
+		return true;
+	}
+	void end() {}
+	bool format() { return false; }
+	size_t totalBytes() { return 0; }
+	size_t usedBytes() { return 0; }
+};
+
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef _M5EPD_H_
+#define _M5EPD_H_
+
+#include <Arduino.h>
+
+#include <vector>
+
+/**
+ * Host version of the M5Paper board support library.
+ * The EPD panel is a 4bpp framebuffer in memory, canvases draw into their own framebuffers
+ * with the pixel format of the real library: two pixels per byte, even x in the high nibble,
+ * 0 is white and 15 is black. Text is not rasterized, only the text backgrounds are drawn.
+ */
+
+#define M5EPD_PANEL_W 960
+#define M5EPD_PANEL_H 540
+
+typedef enum {
+	UPDATE_MODE_INIT = 0,
+	UPDATE_MODE_DU = 1,
+	UPDATE_MODE_GC16 = 2,
+	UPDATE_MODE_GL16 = 3,
+	UPDATE_MODE_GLR16 = 4,
+	UPDATE_MODE_GLD16 = 5,
+	UPDATE_MODE_DU4 = 6,
+	UPDATE_MODE_A2 = 7,
+	UPDATE_MODE_NONE = 8
+} m5epd_update_mode_t;
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint16_t id;
+	uint16_t size;
+} tp_finger_t;
+
+typedef struct RTC_Time {
+	int8_t hour;
+	int8_t min;
+	int8_t sec;
+	RTC_Time() : hour(), min(), sec() {}
+	RTC_Time(int8_t h, int8_t m, int8_t s) : hour(h), min(m), sec(s) {}
+} rtc_time_t;
+
+typedef struct RTC_Date {
+	int8_t week;
+	int8_t mon;
+	int8_t day;
+	int16_t year;
+	RTC_Date() : week(), mon(), day(), year() {}
+	RTC_Date(int8_t w, int8_t m, int8_t d, int16_t y) : week(w), mon(m), day(d), year(y) {}
+} rtc_date_t;
+
+class M5EPD_Driver {
+  public:
+	/**
+	 * Host only: an area update and how many bytes of the area changed on the panel.
+	 */
+	struct Update {
+		uint16_t x;
+		uint16_t y;
+		uint16_t w;
+		uint16_t h;
+		m5epd_update_mode_t mode;
+		uint32_t bytesChanged;
+	};
+
+	M5EPD_Driver();
+
+	void Clear(bool init = false);
+	void Sleep() {}
+	void Active() {}
+	void SetRotation(uint16_t rotation = 0) {}
+	void SetColorReverse(bool isReverse) { _reverse = isReverse; }
+
+	/**
+	 * Write a packed 4bpp area to the panel, inverted when SetColorReverse(true) is set.
+	 */
+	void WritePartGram4bpp(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* gram);
+	void WriteFullGram4bpp(const uint8_t* gram);
+	void UpdateArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, m5epd_update_mode_t mode);
+	void UpdateFull(m5epd_update_mode_t mode) {
+		UpdateArea(0, 0, M5EPD_PANEL_W, M5EPD_PANEL_H, mode);
+	}
+
+	/**
+	 * Host only: the framebuffer written by WritePartGram4bpp, what the panel shows after
+	 * the area updates, and the updates since clearUpdates().
+	 */
+	const std::vector<uint8_t>& gram() const { return _gram; }
+	const std::vector<uint8_t>& displayed() const { return _displayed; }
+	const std::vector<Update>& updates() const { return _updates; }
+	void clearUpdates() { _updates.clear(); }
+	uint32_t updateCount() const { return _updateCount; }
+
+  private:
+	std::vector<uint8_t> _gram;
+	std::vector<uint8_t> _displayed;
+	std::vector<Update> _updates;
+	bool _reverse = false;
+	uint32_t _updateCount = 0;
+};
+
+class M5EPD_Canvas : public Print {
+  public:
+	M5EPD_Canvas(M5EPD_Driver* driver) : _driver(driver) {}
+
+	/**
+	 * Does nothing if a canvas of the same size exists already.
+	 */
+	void* createCanvas(int16_t w, int16_t h);
+	void deleteCanvas();
+	void* frameBuffer(int8_t f = 0) { return _buffer.data(); }
+	int16_t width() const { return _width; }
+	int16_t height() const { return _height; }
+
+	void fillCanvas(uint32_t color);
+	void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+	void drawPixel(int32_t x, int32_t y, uint32_t color);
+	uint16_t readPixel(int32_t x, int32_t y) const;
+	void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t* data);
+	void ReversePartColor(int32_t x, int32_t y, int32_t w, int32_t h);
+	void pushToCanvas(int32_t x, int32_t y, M5EPD_Canvas* canvas);
+	void pushCanvas(int32_t x, int32_t y, m5epd_update_mode_t mode);
+
+	void setTextFont(uint8_t font) {}
+	void setTextSize(uint16_t size) {}
+	void setTextDatum(uint8_t datum) {}
+	void setTextColor(uint16_t color) {}
+	void setTextArea(int16_t x, int16_t y, int16_t w, int16_t h) {}
+	int16_t drawString(const String& string, int32_t x, int32_t y) { return 0; }
+
+	size_t write(uint8_t c) override { return 1; }
+	using Print::write;
+
+  private:
+	M5EPD_Driver* _driver;
+	std::vector<uint8_t> _buffer;
+	int16_t _width = 0;
+	int16_t _height = 0;
+};
+
+class M5EPD {
+  public:
+	void begin(bool touchEnable = true, bool SDEnable = true, bool SerialEnable = true,
+	           bool BatteryADCEnable = true, bool I2CEnable = false) {}
+	void update() {}
+	void shutdown() {}
+	int shutdown(int seconds) { return 0; }
+
+	/**
+	 * Host only: set the voltage returned by getBatteryVoltage().
+	 */
+	void setBatteryVoltage(uint32_t mv) { _batteryVoltage = mv; }
+	uint32_t getBatteryVoltage() { return _batteryVoltage; }
+
+	M5EPD_Driver EPD;
+
+  private:
+	uint32_t _batteryVoltage = 4000;
+};
+
+extern M5EPD M5;
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef _PREFERENCES_H_
+#define _PREFERENCES_H_
+
+#include "WString.h"
+
+/**
+ * Host version of the NVS backed Preferences, kept in memory for the lifetime of the program.
+ * Namespaces are shared between instances like on the device.
+ */
+class Preferences {
+  public:
+	bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+	void end();
+
+	bool clear();
+	bool remove(const char* key);
+	bool isKey(const char* key);
+
+	size_t putBool(const char* key, bool value) { return putBytes(key, &value, sizeof(value)); }
+	size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+	size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+	size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+	size_t putLong64(const char* key, int64_t value) {
+		return putBytes(key, &value, sizeof(value));
+	}
+	size_t putULong64(const char* key, uint64_t value) {
+		return putBytes(key, &value, sizeof(value));
+	}
+	size_t putString(const char* key, const char* value);
+	size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+	size_t putBytes(const char* key, const void* value, size_t len);
+
+	bool getBool(const char* key, bool defaultValue = false) { return get(key, defaultValue); }
+	uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+	int32_t getInt(const char* key, int32_t defaultValue = 0) { return get(key, defaultValue); }
+	uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+	int64_t getLong64(const char* key, int64_t defaultValue = 0) { return get(key, defaultValue); }
+	uint64_t getULong64(const char* key, uint64_t defaultValue = 0) {
+		return get(key, defaultValue);
+	}
+	String getString(const char* key, const String defaultValue = String());
+	size_t getBytesLength(const char* key);
+	size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+  private:
+	template <typename T>
+	T get(const char* key, T defaultValue) {
+		T value;
+		return getBytesLength(key) == sizeof(T) && getBytes(key, &value, sizeof(T)) ? value
+		                                                                           : defaultValue;
+	}
+
+	String _name;
+	bool _readOnly = false;
+};
+
+#endif
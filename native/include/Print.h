@@ -0,0 +1,55 @@
+#ifndef PRINT_H
+#define PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/**
+ * Host version of the Arduino Print, subclasses only need to implement write(uint8_t).
+ */
+class Print {
+  public:
+	virtual ~Print() = default;
+
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size);
+	size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+	size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+	size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+	size_t print(const String& s) { return write(s.c_str(), s.length()); }
+	size_t print(const char str[]) { return write(str); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char n, int base = DEC) { return print(String(n, base)); }
+	size_t print(int n, int base = DEC) { return print(String(n, base)); }
+	size_t print(unsigned int n, int base = DEC) { return print(String(n, base)); }
+	size_t print(long n, int base = DEC) { return print(String(n, base)); }
+	size_t print(unsigned long n, int base = DEC) { return print(String(n, base)); }
+	size_t print(long long n, int base = DEC) { return print(String(n, base)); }
+	size_t print(unsigned long long n, int base = DEC) { return print(String(n, base)); }
+	size_t print(double n, int digits = 2) { return print(String(n, digits)); }
+
+	template <typename T>
+	size_t println(const T& value) {
+		size_t n = print(value);
+		return n + println();
+	}
+	template <typename T>
+	size_t println(const T& value, int format) {
+		size_t n = print(value, format);
+		return n + println();
+	}
+	size_t println() { return write("\r\n"); }
+
+	virtual void flush() {}
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "Print.h"
+
+/**
+ * Host version of the Arduino Stream, reads never wait for data.
+ */
+class Stream : public Print {
+  public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+
+	void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+	virtual size_t readBytes(char* buffer, size_t length);
+	size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+	String readString();
+	String readStringUntil(char terminator);
+
+  protected:
+	unsigned long _timeout = 1000;
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+class StringSumHelper;
+
+/**
+ * Host version of the Arduino String, backed by std::string.
+ * Only implements what the firmware and its libraries use, with the Arduino semantics
+ * (e.g. substring clamps its indices and indexOf returns -1 when not found).
+ */
+class String {
+  public:
+	String(const char* cstr = "");
+	String(const char* cstr, unsigned int length);
+	String(const String& str) = default;
+	String(String&& str) = default;
+	explicit String(char c);
+	explicit String(unsigned char value, unsigned char base = 10);
+	explicit String(int value, unsigned char base = 10);
+	explicit String(unsigned int value, unsigned char base = 10);
+	explicit String(long value, unsigned char base = 10);
+	explicit String(unsigned long value, unsigned char base = 10);
+	explicit String(long long value, unsigned char base = 10);
+	explicit String(unsigned long long value, unsigned char base = 10);
+	explicit String(float value, unsigned int decimalPlaces = 2);
+	explicit String(double value, unsigned int decimalPlaces = 2);
+	~String() = default;
+
+	String& operator=(const String& rhs) = default;
+	String& operator=(String&& rhs) = default;
+	String& operator=(const char* cstr);
+
+	unsigned int length() const { return _str.length(); }
+	bool isEmpty() const { return _str.empty(); }
+	void clear() { _str.clear(); }
+	const char* c_str() const { return _str.c_str(); }
+	bool reserve(unsigned int size);
+
+	bool concat(const String& str);
+	bool concat(const char* cstr);
+	bool concat(const char* cstr, unsigned int length);
+	bool concat(char c);
+	bool concat(unsigned char value);
+	bool concat(int value);
+	bool concat(unsigned int value);
+	bool concat(long value);
+	bool concat(unsigned long value);
+	bool concat(long long value);
+	bool concat(unsigned long long value);
+	bool concat(float value);
+	bool concat(double value);
+
+	template <typename T>
+	String& operator+=(const T& rhs) {
+		concat(rhs);
+		return *this;
+	}
+
+	int compareTo(const String& other) const { return _str.compare(other._str); }
+	bool equals(const String& other) const { return _str == other._str; }
+	bool equals(const char* cstr) const { return _str == (cstr ? cstr : ""); }
+	bool equalsIgnoreCase(const String& other) const;
+	bool operator==(const String& rhs) const { return equals(rhs); }
+	bool operator==(const char* cstr) const { return equals(cstr); }
+	bool operator!=(const String& rhs) const { return !equals(rhs); }
+	bool operator!=(const char* cstr) const { return !equals(cstr); }
+	bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+	bool operator>(const String& rhs) const { return compareTo(rhs) > 0; }
+	bool operator<=(const String& rhs) const { return compareTo(rhs) <= 0; }
+	bool operator>=(const String& rhs) const { return compareTo(rhs) >= 0; }
+
+	bool startsWith(const String& prefix) const { return startsWith(prefix, 0); }
+	bool startsWith(const String& prefix, unsigned int offset) const;
+	bool endsWith(const String& suffix) const;
+
+	char charAt(unsigned int index) const { return index < length() ? _str[index] : 0; }
+	void setCharAt(unsigned int index, char c);
+	char operator[](unsigned int index) const { return charAt(index); }
+	char& operator[](unsigned int index);
+	void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+	void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+		getBytes((unsigned char*)buf, bufsize, index);
+	}
+
+	int indexOf(char c, unsigned int fromIndex = 0) const;
+	int indexOf(const String& str, unsigned int fromIndex = 0) const;
+	int lastIndexOf(char c) const;
+	int lastIndexOf(const String& str) const;
+
+	String substring(unsigned int beginIndex) const { return substring(beginIndex, length()); }
+	String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+	void replace(char find, char replace);
+	void replace(const String& find, const String& replace);
+	void remove(unsigned int index);
+	void remove(unsigned int index, unsigned int count);
+	void toLowerCase();
+	void toUpperCase();
+	void trim();
+
+	long toInt() const { return atol(c_str()); }
+	float toFloat() const { return (float)toDouble(); }
+	double toDouble() const { return atof(c_str()); }
+
+  private:
+	std::string _str;
+};
+
+/**
+ * Result type of concatenation, ArduinoJson adapts it like a String.
+ */
+class StringSumHelper : public String {
+  public:
+	StringSumHelper(const String& s) : String(s) {}
+	StringSumHelper(const char* p) : String(p) {}
+};
+
+StringSumHelper operator+(const String& lhs, const String& rhs);
+StringSumHelper operator+(const String& lhs, const char* rhs);
+StringSumHelper operator+(const char* lhs, const String& rhs);
+StringSumHelper operator+(const String& lhs, char rhs);
+StringSumHelper operator+(const String& lhs, unsigned char rhs);
+StringSumHelper operator+(const String& lhs, int rhs);
+StringSumHelper operator+(const String& lhs, unsigned int rhs);
+StringSumHelper operator+(const String& lhs, long rhs);
+StringSumHelper operator+(const String& lhs, unsigned long rhs);
+StringSumHelper operator+(const String& lhs, long long rhs);
+StringSumHelper operator+(const String& lhs, unsigned long long rhs);
+StringSumHelper operator+(const String& lhs, float rhs);
+StringSumHelper operator+(const String& lhs, double rhs);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef WiFi_h
+#define WiFi_h
+
+#include <Arduino.h>
+
+#include "IPAddress.h"
+#include "WiFiUdp.h"
+
+typedef enum {
+	WL_NO_SHIELD = 255,
+	WL_IDLE_STATUS = 0,
+	WL_NO_SSID_AVAIL = 1,
+	WL_SCAN_COMPLETED = 2,
+	WL_CONNECTED = 3,
+	WL_CONNECT_FAILED = 4,
+	WL_CONNECTION_LOST = 5,
+	WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+	WIFI_REASON_UNSPECIFIED = 1,
+	WIFI_REASON_AUTH_EXPIRE = 2,
+	WIFI_REASON_AUTH_LEAVE = 3,
+	WIFI_REASON_ASSOC_EXPIRE = 4,
+	WIFI_REASON_ASSOC_TOOMANY = 5,
+	WIFI_REASON_NOT_AUTHED = 6,
+	WIFI_REASON_NOT_ASSOCED = 7,
+	WIFI_REASON_ASSOC_LEAVE = 8,
+	WIFI_REASON_ASSOC_NOT_AUTHED = 9,
+	WIFI_REASON_BEACON_TIMEOUT = 200,
+	WIFI_REASON_NO_AP_FOUND = 201,
+	WIFI_REASON_AUTH_FAIL = 202,
+	WIFI_REASON_ASSOC_FAIL = 203,
+	WIFI_REASON_HANDSHAKE_TIMEOUT = 204,
+	WIFI_REASON_CONNECTION_FAIL = 205,
+} wifi_err_reason_t;
+
+/**
+ * Host version of the WiFi singleton. The host has no radio, so it is never connected.
+ */
+class WiFiClass {
+  public:
+	wl_status_t status() { return WL_DISCONNECTED; }
+	bool isConnected() { return status() == WL_CONNECTED; }
+	int8_t RSSI() { return 0; }
+	IPAddress localIP() { return IPAddress(); }
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef WIFIUDP_H
+#define WIFIUDP_H
+
+#include <Arduino.h>
+
+/**
+ * Host version of WiFiUDP that never receives anything.
+ */
+class WiFiUDP {
+  public:
+	uint8_t begin(uint16_t port) { return 0; }
+	void stop() {}
+	void flush() {}
+	int beginPacket(const char* host, uint16_t port) { return 0; }
+	int endPacket() { return 0; }
+	size_t write(const uint8_t* buffer, size_t size) { return 0; }
+	int parsePacket() { return 0; }
+	int available() { return 0; }
+	int read() { return -1; }
+	int read(uint8_t* buffer, size_t len) { return 0; }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef ESP32_HAL_LOG_H
+#define ESP32_HAL_LOG_H
+
+#include <stdio.h>
+
+// Same levels as the ESP32 core, set with -DCORE_DEBUG_LEVEL
+#define ARDUHAL_LOG_LEVEL_NONE 0
+#define ARDUHAL_LOG_LEVEL_ERROR 1
+#define ARDUHAL_LOG_LEVEL_WARN 2
+#define ARDUHAL_LOG_LEVEL_INFO 3
+#define ARDUHAL_LOG_LEVEL_DEBUG 4
+#define ARDUHAL_LOG_LEVEL_VERBOSE 5
+
+#ifndef CORE_DEBUG_LEVEL
+#define CORE_DEBUG_LEVEL ARDUHAL_LOG_LEVEL_ERROR
+#endif
+
+// Logs go to stderr, so they don't mix with benchmark results on stdout
+#define ARDUHAL_LOG(letter, format, ...) \
+	fprintf(stderr, "[" letter "][%s:%d] %s(): " format "\n", __FILE__, __LINE__, __func__, \
+	        ##__VA_ARGS__)
+
+#define ARDUHAL_LOG_NOOP(...) \
+	do {                      \
+	} while (0)
+
+#if CORE_DEBUG_LEVEL >= ARDUHAL_LOG_LEVEL_ERROR
+#define log_e(format, ...) ARDUHAL_LOG("E", format, ##__VA_ARGS__)
+#else
+#define log_e(...) ARDUHAL_LOG_NOOP()
+#endif
+
+#if CORE_DEBUG_LEVEL >= ARDUHAL_LOG_LEVEL_WARN
+#define log_w(format, ...) ARDUHAL_LOG("W", format, ##__VA_ARGS__)
+#else
+#define log_w(...) ARDUHAL_LOG_NOOP()
+#endif
+
+#if CORE_DEBUG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+#define log_i(format, ...) ARDUHAL_LOG("I", format, ##__VA_ARGS__)
+#else
+#define log_i(...) ARDUHAL_LOG_NOOP()
+#endif
+
+#if CORE_DEBUG_LEVEL >= ARDUHAL_LOG_LEVEL_DEBUG
+#define log_d(format, ...) ARDUHAL_LOG("D", format, ##__VA_ARGS__)
+#else
+#define log_d(...) ARDUHAL_LOG_NOOP()
+#endif
+
+#if CORE_DEBUG_LEVEL >= ARDUHAL_LOG_LEVEL_VERBOSE
+#define log_v(format, ...) ARDUHAL_LOG("V", format, ##__VA_ARGS__)
+#else
+#define log_v(...) ARDUHAL_LOG_NOOP()
+#endif
+
+#endif
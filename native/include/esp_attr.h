@@ -0,0 +1,11 @@
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+// Memory placement attributes, RTC memory is ordinary memory on the host
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define EXT_RAM_ATTR
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef ESP_EVENT_H
+#define ESP_EVENT_H
+
+#include <stdint.h>
+
+// Only the types, the event loop isn't used by the host build
+typedef const char* esp_event_base_t;
+typedef void* esp_event_handler_t;
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#include "esp32-hal-log.h"
+
+#define ESP_LOGE(tag, format, ...) log_e("%s: " format, tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) log_w("%s: " format, tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) log_i("%s: " format, tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) log_d("%s: " format, tag, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) log_v("%s: " format, tag, ##__VA_ARGS__)
+
+#endif
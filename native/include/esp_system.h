@@ -0,0 +1,30 @@
+#ifndef ESP_SYSTEM_H
+#define ESP_SYSTEM_H
+
+#include <cstdint>
+#include <random>
+
+typedef enum {
+	ESP_RST_UNKNOWN,
+	ESP_RST_POWERON,
+	ESP_RST_EXT,
+	ESP_RST_SW,
+	ESP_RST_PANIC,
+	ESP_RST_INT_WDT,
+	ESP_RST_TASK_WDT,
+	ESP_RST_WDT,
+	ESP_RST_DEEPSLEEP,
+	ESP_RST_BROWNOUT,
+	ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+// Every run of a host program is a cold boot
+inline esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+// Not a hardware RNG, but random enough for jitter
+inline uint32_t esp_random() {
+	thread_local std::random_device device;
+	return device();
+}
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+
+// Only the types and the clock, timers aren't used by the host build
+struct esp_timer;
+typedef esp_timer* esp_timer_handle_t;
+
+unsigned long micros();
+inline int64_t esp_timer_get_time() { return micros(); }
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef EVENT_GROUPS_H
+#define EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+// Only the types, SleepManager isn't built for the host
+struct EventGroupDef_t;
+typedef EventGroupDef_t* EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+
+#endif
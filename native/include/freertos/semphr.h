@@ -0,0 +1,27 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "queue.h"
+
+// Like FreeRTOS, semaphores are queues of zero sized items
+typedef QueueHandle_t SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return xQueueCreate(1, 0); }
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+	SemaphoreHandle_t mutex = xQueueCreate(1, 0);
+	xQueueSend(mutex, nullptr, 0);
+	return mutex;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+	return xQueueReceive(semaphore, nullptr, ticksToWait);
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+	return xQueueSend(semaphore, nullptr, 0);
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore) { vQueueDelete(semaphore); }
+
+#endif
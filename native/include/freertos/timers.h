@@ -0,0 +1,10 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include "FreeRTOS.h"
+
+// Only the types, SleepManager isn't built for the host
+struct tmrTimerControl;
+typedef tmrTimerControl* TimerHandle_t;
+
+#endif
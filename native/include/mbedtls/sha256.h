@@ -0,0 +1,44 @@
+#ifndef MBEDTLS_SHA256_H
+#define MBEDTLS_SHA256_H
+
+#include <openssl/evp.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// The mbedTLS 2 SHA-256 functions the firmware uses, on OpenSSL. Link with -lcrypto.
+struct mbedtls_sha256_context {
+	EVP_MD_CTX* md = nullptr;
+};
+
+inline void mbedtls_sha256_init(mbedtls_sha256_context* ctx) { ctx->md = EVP_MD_CTX_new(); }
+inline void mbedtls_sha256_free(mbedtls_sha256_context* ctx) { EVP_MD_CTX_free(ctx->md); }
+
+inline int mbedtls_sha256_starts_ret(mbedtls_sha256_context* ctx, int is224) {
+	return EVP_DigestInit_ex(ctx->md, is224 ? EVP_sha224() : EVP_sha256(), nullptr) == 1 ? 0
+	                                                                                      : -1;
+}
+
+inline int mbedtls_sha256_update_ret(mbedtls_sha256_context* ctx, const unsigned char* input,
+                                     size_t ilen) {
+	return EVP_DigestUpdate(ctx->md, input, ilen) == 1 ? 0 : -1;
+}
+
+inline int mbedtls_sha256_finish_ret(mbedtls_sha256_context* ctx, unsigned char output[32]) {
+	return EVP_DigestFinal_ex(ctx->md, output, nullptr) == 1 ? 0 : -1;
+}
+
+inline int mbedtls_sha256_ret(const unsigned char* input, size_t ilen, unsigned char output[32],
+                              int is224) {
+	mbedtls_sha256_context ctx;
+	mbedtls_sha256_init(&ctx);
+	int ret = mbedtls_sha256_starts_ret(&ctx, is224);
+	if (ret == 0)
+		ret = mbedtls_sha256_update_ret(&ctx, input, ilen);
+	if (ret == 0)
+		ret = mbedtls_sha256_finish_ret(&ctx, output);
+	mbedtls_sha256_free(&ctx);
+	return ret;
+}
+
+#endif
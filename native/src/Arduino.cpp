@@ -0,0 +1,88 @@
+#include <Arduino.h>
+
+#include <stdarg.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace {
+const auto startTime = std::chrono::steady_clock::now();
+
+template <typename Duration>
+unsigned long sinceStart() {
+	return std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - startTime)
+	    .count();
+}
+}  // namespace
+
+HardwareSerial Serial;
+
+unsigned long millis() { return sinceStart<std::chrono::milliseconds>(); }
+
+unsigned long micros() { return sinceStart<std::chrono::microseconds>(); }
+
+void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void yield() { std::this_thread::yield(); }
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+	size_t n = 0;
+	while (size--) {
+		if (!write(*buffer++))
+			break;
+		n++;
+	}
+	return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+	char small[128];
+	va_list args;
+	va_start(args, format);
+	int len = vsnprintf(small, sizeof(small), format, args);
+	va_end(args);
+	if (len < 0)
+		return 0;
+	if ((size_t)len < sizeof(small))
+		return write((const uint8_t*)small, len);
+
+	std::string large(len + 1, '\0');
+	va_start(args, format);
+	vsnprintf(&large[0], large.size(), format, args);
+	va_end(args);
+	return write((const uint8_t*)large.data(), len);
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+	size_t n = 0;
+	while (n < length) {
+		int c = read();
+		if (c < 0)
+			break;
+		buffer[n++] = (char)c;
+	}
+	return n;
+}
+
+String Stream::readString() {
+	String out;
+	int c;
+	while ((c = read()) >= 0) out += (char)c;
+	return out;
+}
+
+String Stream::readStringUntil(char terminator) {
+	String out;
+	int c;
+	while ((c = read()) >= 0 && c != terminator) out += (char)c;
+	return out;
+}
+
+size_t HardwareSerial::write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+	return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() { fflush(stdout); }
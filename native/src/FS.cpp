@@ -0,0 +1,196 @@
+#include <LittleFS.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs {
+
+class FileImpl {
+  public:
+	FileImpl(FS& fs, const String& path) : _fs(fs), _path(path) {
+		size_t slash = _path.lastIndexOf('/');
+		_name = _path.substring(slash + 1);
+	}
+	~FileImpl() { close(); }
+
+	void close() {
+		if (_file)
+			fclose(_file);
+		_file = nullptr;
+		_isDirectory = false;
+	}
+
+	FS& _fs;
+	String _path;
+	String _name;
+	FILE* _file = nullptr;
+	bool _isDirectory = false;
+	// Sorted entries of a directory and the next one to open
+	std::vector<String> _entries;
+	size_t _nextEntry = 0;
+};
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buf, size_t size) {
+	if (!_impl || !_impl->_file)
+		return 0;
+	return fwrite(buf, 1, size, _impl->_file);
+}
+
+int File::available() {
+	if (!_impl || !_impl->_file)
+		return 0;
+	return size() - position();
+}
+
+int File::read() {
+	uint8_t c;
+	return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+	if (!_impl || !_impl->_file)
+		return -1;
+	int c = fgetc(_impl->_file);
+	if (c != EOF)
+		ungetc(c, _impl->_file);
+	return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+	if (_impl && _impl->_file)
+		fflush(_impl->_file);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+	if (!_impl || !_impl->_file)
+		return 0;
+	return fread(buf, 1, size, _impl->_file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+	if (!_impl || !_impl->_file)
+		return false;
+	const int whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+	return fseek(_impl->_file, pos, whence) == 0;
+}
+
+size_t File::position() const {
+	if (!_impl || !_impl->_file)
+		return 0;
+	return ftell(_impl->_file);
+}
+
+size_t File::size() const {
+	if (!_impl || !_impl->_file)
+		return 0;
+	std::error_code ec;
+	auto size = std::filesystem::file_size(_impl->_fs.hostPath(_impl->_path.c_str()).c_str(), ec);
+	return ec ? 0 : size;
+}
+
+void File::close() {
+	if (_impl)
+		_impl->close();
+}
+
+File::operator bool() const { return _impl && (_impl->_file || _impl->_isDirectory); }
+
+const char* File::path() const { return _impl ? _impl->_path.c_str() : nullptr; }
+
+const char* File::name() const { return _impl ? _impl->_name.c_str() : nullptr; }
+
+bool File::isDirectory() const { return _impl && _impl->_isDirectory; }
+
+File File::openNextFile(const char* mode) {
+	if (!isDirectory() || _impl->_nextEntry >= _impl->_entries.size())
+		return File();
+	String path = _impl->_path;
+	if (!path.endsWith("/"))
+		path += "/";
+	path += _impl->_entries[_impl->_nextEntry++];
+	return _impl->_fs.open(path, mode);
+}
+
+void File::rewindDirectory() {
+	if (_impl)
+		_impl->_nextEntry = 0;
+}
+
+String FS::hostPath(const char* path) const {
+	String host = _root;
+	if (path[0] != '/')
+		host += "/";
+	host += path;
+	return host;
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+	const std::filesystem::path host = hostPath(path).c_str();
+	auto impl = std::make_shared<FileImpl>(*this, path);
+	std::error_code ec;
+
+	if (std::filesystem::is_directory(host, ec)) {
+		impl->_isDirectory = true;
+		for (const auto& entry : std::filesystem::directory_iterator(host, ec))
+			impl->_entries.push_back(entry.path().filename().c_str());
+		std::sort(impl->_entries.begin(), impl->_entries.end());
+		return File(impl);
+	}
+
+	const bool writing = mode[0] != 'r';
+	if (writing && create)
+		std::filesystem::create_directories(host.parent_path(), ec);
+
+	// Binary mode, the firmware reads and writes exact bytes
+	String hostMode = String(mode) + "b";
+	impl->_file = fopen(host.c_str(), hostMode.c_str());
+	if (!impl->_file)
+		return File();
+	return File(impl);
+}
+
+bool FS::exists(const char* path) {
+	std::error_code ec;
+	return std::filesystem::exists(hostPath(path).c_str(), ec);
+}
+
+bool FS::remove(const char* path) {
+	std::error_code ec;
+	return std::filesystem::is_regular_file(hostPath(path).c_str(), ec)
+	       && std::filesystem::remove(hostPath(path).c_str(), ec);
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+	std::error_code ec;
+	std::filesystem::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str(), ec);
+	return !ec;
+}
+
+bool FS::mkdir(const char* path) {
+	std::error_code ec;
+	return std::filesystem::create_directory(hostPath(path).c_str(), ec);
+}
+
+bool FS::rmdir(const char* path) {
+	std::error_code ec;
+	return std::filesystem::is_directory(hostPath(path).c_str(), ec)
+	       && std::filesystem::remove(hostPath(path).c_str(), ec);
+}
+
+namespace {
+const char* littleFSRoot() {
+	const char* root = getenv("NATIVE_FS_ROOT");
+	return root ? root : "data";
+}
+}  // namespace
+
+LittleFSFS::LittleFSFS() : FS(littleFSRoot()) {}
+
+}  // namespace fs
+
+fs::LittleFSFS LittleFS;
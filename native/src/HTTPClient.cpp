@@ -0,0 +1,191 @@
+#include <HTTPClient.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace {
+struct Response {
+	int code;
+	String body;
+	HTTPHeaders headers;
+};
+
+std::mutex responsesMutex;  // Protects responses and transport
+std::map<String, Response> responses;
+HTTPTransport transport;
+}  // namespace
+
+size_t HTTPBodyStream::readBytes(char* buffer, size_t length) {
+	const size_t count = std::min(length, (size_t)available());
+	memcpy(buffer, _body.c_str() + _position, count);
+	_position += count;
+	return count;
+}
+
+bool HTTPClient::begin(String url) {
+	_url = url;
+	_caCert = nullptr;
+	_headers.clear();
+	_body = "";
+	return true;
+}
+
+bool HTTPClient::begin(String url, const char* CAcert) {
+	begin(url);
+	_caCert = CAcert;
+	return true;
+}
+
+void HTTPClient::end() {
+	_url = "";
+	_caCert = nullptr;
+	_headers.clear();
+	_body = "";
+}
+
+void HTTPClient::addHeader(const String& name, const String& value, bool first, bool replace) {
+	for (auto& header : _headers) {
+		if (header.first.equalsIgnoreCase(name)) {
+			if (replace)
+				header.second = value;
+			return;
+		}
+	}
+	if (first)
+		_headers.insert(_headers.begin(), {name, value});
+	else
+		_headers.push_back({name, value});
+}
+
+void HTTPClient::setAuthorization(const char* user, const char* password) {
+	static const char ALPHABET[]
+	    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	const String credentials = String(user) + ":" + password;
+	String encoded;
+	for (size_t i = 0; i < credentials.length(); i += 3) {
+		uint32_t group = (uint8_t)credentials[i] << 16;
+		if (i + 1 < credentials.length())
+			group |= (uint8_t)credentials[i + 1] << 8;
+		if (i + 2 < credentials.length())
+			group |= (uint8_t)credentials[i + 2];
+		encoded += ALPHABET[group >> 18 & 0x3F];
+		encoded += ALPHABET[group >> 12 & 0x3F];
+		encoded += i + 1 < credentials.length() ? ALPHABET[group >> 6 & 0x3F] : '=';
+		encoded += i + 2 < credentials.length() ? ALPHABET[group & 0x3F] : '=';
+	}
+	addHeader("Authorization", "Basic " + encoded);
+}
+
+void HTTPClient::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+	_headerKeys.assign(headerKeys, headerKeys + headerKeysCount);
+	_responseHeaders.clear();
+}
+
+String HTTPClient::header(const char* name) {
+	for (const auto& header : _responseHeaders) {
+		if (header.first.equalsIgnoreCase(name))
+			return header.second;
+	}
+	return "";
+}
+
+Stream& HTTPClient::getStream() {
+	_stream.reset(_body);
+	return _stream;
+}
+
+int HTTPClient::GET() { return sendRequest("GET", ""); }
+int HTTPClient::POST(String payload) { return sendRequest("POST", payload); }
+int HTTPClient::PATCH(String payload) { return sendRequest("PATCH", payload); }
+int HTTPClient::PUT(String payload) { return sendRequest("PUT", payload); }
+
+int HTTPClient::sendRequest(const char* type, String payload) {
+	HTTPTransport send;
+	{
+		std::lock_guard<std::mutex> lock(responsesMutex);
+		send = transport;
+	}
+	HTTPResponse response;
+	int code = HTTPC_ERROR_CONNECTION_REFUSED;
+	if (send) {
+		code = send(HTTPRequest{type, _url, _headers, payload, _caCert}, response);
+	} else {
+		std::lock_guard<std::mutex> lock(responsesMutex);
+		const Response* match = nullptr;
+		size_t matchLength = 0;
+		for (const auto& r : responses) {
+			if (_url.startsWith(r.first) && r.first.length() >= matchLength) {
+				match = &r.second;
+				matchLength = r.first.length();
+			}
+		}
+		if (!match)
+			return HTTPC_ERROR_CONNECTION_REFUSED;
+		response.body = match->body;
+		response.headers = match->headers;
+		code = match->code;
+	}
+
+	// Like on the device, a collected header keeps its value until a response replaces it
+	_body = response.body;
+	for (const auto& header : response.headers) {
+		for (const String& key : _headerKeys) {
+			if (!header.first.equalsIgnoreCase(key))
+				continue;
+			auto kept = std::find_if(
+			    _responseHeaders.begin(), _responseHeaders.end(),
+			    [&](const std::pair<String, String>& h) { return h.first.equalsIgnoreCase(key); });
+			if (kept == _responseHeaders.end())
+				_responseHeaders.push_back({key, header.second});
+			else
+				kept->second = header.second;
+		}
+	}
+	return code;
+}
+
+String HTTPClient::errorToString(int error) {
+	switch (error) {
+		case HTTPC_ERROR_CONNECTION_REFUSED:
+			return "connection refused";
+		case HTTPC_ERROR_SEND_HEADER_FAILED:
+			return "send header failed";
+		case HTTPC_ERROR_SEND_PAYLOAD_FAILED:
+			return "send payload failed";
+		case HTTPC_ERROR_NOT_CONNECTED:
+			return "not connected";
+		case HTTPC_ERROR_CONNECTION_LOST:
+			return "connection lost";
+		case HTTPC_ERROR_NO_STREAM:
+			return "no stream";
+		case HTTPC_ERROR_NO_HTTP_SERVER:
+			return "no HTTP server";
+		case HTTPC_ERROR_TOO_LESS_RAM:
+			return "too less ram";
+		case HTTPC_ERROR_ENCODING:
+			return "Transfer-Encoding not supported";
+		case HTTPC_ERROR_STREAM_WRITE:
+			return "Stream write error";
+		case HTTPC_ERROR_READ_TIMEOUT:
+			return "read Timeout";
+		default:
+			return String();
+	}
+}
+
+void HTTPClient::setResponse(const String& urlPrefix, int code, const String& body,
+                             const HTTPHeaders& headers) {
+	std::lock_guard<std::mutex> lock(responsesMutex);
+	responses[urlPrefix] = Response{code, body, headers};
+}
+
+void HTTPClient::clearResponses() {
+	std::lock_guard<std::mutex> lock(responsesMutex);
+	responses.clear();
+}
+
+void HTTPClient::setTransport(HTTPTransport newTransport) {
+	std::lock_guard<std::mutex> lock(responsesMutex);
+	transport = newTransport;
+}
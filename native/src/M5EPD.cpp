@@ -0,0 +1,117 @@
+#include <M5EPD.h>
+
+namespace {
+uint8_t getNibble(const uint8_t* packed, size_t stride, int32_t x, int32_t y) {
+	uint8_t byte = packed[y * stride + x / 2];
+	return x % 2 == 0 ? byte >> 4 : byte & 0x0F;
+}
+
+void setNibble(uint8_t* packed, size_t stride, int32_t x, int32_t y, uint8_t value) {
+	uint8_t& byte = packed[y * stride + x / 2];
+	byte = x % 2 == 0 ? (byte & 0x0F) | (value << 4) : (byte & 0xF0) | (value & 0x0F);
+}
+}  // namespace
+
+M5EPD_Driver::M5EPD_Driver()
+    : _gram(M5EPD_PANEL_W * M5EPD_PANEL_H / 2, 0), _displayed(_gram) {}
+
+void M5EPD_Driver::Clear(bool init) {
+	std::fill(_gram.begin(), _gram.end(), 0);
+	std::fill(_displayed.begin(), _displayed.end(), 0);
+}
+
+void M5EPD_Driver::WritePartGram4bpp(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                                     const uint8_t* gram) {
+	const size_t stride = (w + 1) / 2;
+	for (int32_t row = 0; row < h; row++) {
+		for (int32_t col = 0; col < w; col++) {
+			if (x + col >= M5EPD_PANEL_W || y + row >= M5EPD_PANEL_H)
+				continue;
+			uint8_t value = getNibble(gram, stride, col, row);
+			if (_reverse)
+				value = 15 - value;
+			setNibble(_gram.data(), M5EPD_PANEL_W / 2, x + col, y + row, value);
+		}
+	}
+}
+
+void M5EPD_Driver::WriteFullGram4bpp(const uint8_t* gram) {
+	WritePartGram4bpp(0, 0, M5EPD_PANEL_W, M5EPD_PANEL_H, gram);
+}
+
+void M5EPD_Driver::UpdateArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                              m5epd_update_mode_t mode) {
+	_updateCount++;
+	const size_t stride = M5EPD_PANEL_W / 2;
+	const size_t begin = x / 2;
+	const size_t end = std::min<size_t>((x + w + 1) / 2, stride);
+	uint32_t bytesChanged = 0;
+	for (size_t row = y; row < std::min<size_t>(y + h, M5EPD_PANEL_H); row++) {
+		for (size_t i = row * stride + begin; i < row * stride + end; i++) {
+			bytesChanged += _displayed[i] != _gram[i];
+			_displayed[i] = _gram[i];
+		}
+	}
+	_updates.push_back(Update{x, y, w, h, mode, bytesChanged});
+}
+
+void* M5EPD_Canvas::createCanvas(int16_t w, int16_t h) {
+	if (w == _width && h == _height && !_buffer.empty())
+		return _buffer.data();
+	_width = w;
+	_height = h;
+	_buffer.assign((w + 1) / 2 * h, 0);
+	return _buffer.data();
+}
+
+void M5EPD_Canvas::deleteCanvas() {
+	_buffer.clear();
+	_width = 0;
+	_height = 0;
+}
+
+void M5EPD_Canvas::fillCanvas(uint32_t color) {
+	const uint8_t nibble = color & 0x0F;
+	std::fill(_buffer.begin(), _buffer.end(), nibble << 4 | nibble);
+}
+
+void M5EPD_Canvas::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+	for (int32_t row = y; row < y + h; row++)
+		for (int32_t col = x; col < x + w; col++) drawPixel(col, row, color);
+}
+
+void M5EPD_Canvas::drawPixel(int32_t x, int32_t y, uint32_t color) {
+	if (x < 0 || y < 0 || x >= _width || y >= _height)
+		return;
+	setNibble(_buffer.data(), (_width + 1) / 2, x, y, color & 0x0F);
+}
+
+uint16_t M5EPD_Canvas::readPixel(int32_t x, int32_t y) const {
+	if (x < 0 || y < 0 || x >= _width || y >= _height)
+		return 0;
+	return getNibble(_buffer.data(), (_width + 1) / 2, x, y);
+}
+
+void M5EPD_Canvas::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t* data) {
+	const size_t stride = (w + 1) / 2;
+	for (int32_t row = 0; row < h; row++)
+		for (int32_t col = 0; col < w; col++)
+			drawPixel(x + col, y + row, getNibble(data, stride, col, row));
+}
+
+void M5EPD_Canvas::ReversePartColor(int32_t x, int32_t y, int32_t w, int32_t h) {
+	for (int32_t row = y; row < y + h; row++)
+		for (int32_t col = x; col < x + w; col++) drawPixel(col, row, 15 - readPixel(col, row));
+}
+
+void M5EPD_Canvas::pushToCanvas(int32_t x, int32_t y, M5EPD_Canvas* canvas) {
+	canvas->pushImage(x, y, _width, _height, _buffer.data());
+}
+
+void M5EPD_Canvas::pushCanvas(int32_t x, int32_t y, m5epd_update_mode_t mode) {
+	_driver->WritePartGram4bpp(x, y, _width, _height, _buffer.data());
+	if (mode != UPDATE_MODE_NONE)
+		_driver->UpdateArea(x, y, _width, _height, mode);
+}
+
+M5EPD M5;
@@ -0,0 +1,81 @@
+#include <Preferences.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+using Namespace = std::map<std::string, std::vector<uint8_t>>;
+
+std::mutex storeMutex;  // Protects store
+std::map<std::string, Namespace> store;
+}  // namespace
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+	_name = name;
+	_readOnly = readOnly;
+	return true;
+}
+
+void Preferences::end() {}
+
+bool Preferences::clear() {
+	if (_readOnly)
+		return false;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	store[_name.c_str()].clear();
+	return true;
+}
+
+bool Preferences::remove(const char* key) {
+	if (_readOnly)
+		return false;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	return store[_name.c_str()].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	return store[_name.c_str()].count(key) > 0;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+	// Stored with the terminator like NVS strings
+	return putBytes(key, value, strlen(value) + 1);
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+	if (_readOnly)
+		return 0;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const uint8_t* bytes = static_cast<const uint8_t*>(value);
+	store[_name.c_str()][key] = std::vector<uint8_t>(bytes, bytes + len);
+	return len;
+}
+
+String Preferences::getString(const char* key, const String defaultValue) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const Namespace& ns = store[_name.c_str()];
+	auto it = ns.find(key);
+	if (it == ns.end() || it->second.empty())
+		return defaultValue;
+	return String((const char*)it->second.data());
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const Namespace& ns = store[_name.c_str()];
+	auto it = ns.find(key);
+	return it == ns.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const Namespace& ns = store[_name.c_str()];
+	auto it = ns.find(key);
+	if (it == ns.end() || it->second.size() > maxLen)
+		return 0;
+	memcpy(buf, it->second.data(), it->second.size());
+	return it->second.size();
+}
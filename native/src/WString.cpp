@@ -0,0 +1,240 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include <algorithm>
+
+namespace {
+template <typename T>
+std::string unsignedToString(T value, unsigned char base) {
+	if (base < 2 || base > 36)
+		base = 10;
+	std::string out;
+	do {
+		unsigned digit = value % base;
+		out.push_back(digit < 10 ? '0' + digit : 'a' + digit - 10);
+		value /= base;
+	} while (value);
+	std::reverse(out.begin(), out.end());
+	return out;
+}
+
+template <typename T>
+std::string signedToString(T value, unsigned char base) {
+	// Arduino only prints a sign in base 10, other bases show the two's complement
+	if (base == 10 && value < 0)
+		return "-" + unsignedToString(0 - (unsigned long long)value, base);
+	return unsignedToString((unsigned long long)value & (~0ULL >> (64 - 8 * sizeof(T))), base);
+}
+
+std::string doubleToString(double value, unsigned int decimalPlaces) {
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+	return buf;
+}
+}  // namespace
+
+String::String(const char* cstr) : _str(cstr ? cstr : "") {}
+String::String(const char* cstr, unsigned int length) : _str(cstr ? cstr : "", cstr ? length : 0) {}
+String::String(char c) : _str(1, c) {}
+String::String(unsigned char value, unsigned char base) : _str(unsignedToString(value, base)) {}
+String::String(int value, unsigned char base) : _str(signedToString(value, base)) {}
+String::String(unsigned int value, unsigned char base) : _str(unsignedToString(value, base)) {}
+String::String(long value, unsigned char base) : _str(signedToString(value, base)) {}
+String::String(unsigned long value, unsigned char base) : _str(unsignedToString(value, base)) {}
+String::String(long long value, unsigned char base) : _str(signedToString(value, base)) {}
+String::String(unsigned long long value, unsigned char base)
+    : _str(unsignedToString(value, base)) {}
+String::String(float value, unsigned int decimalPlaces)
+    : _str(doubleToString(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces)
+    : _str(doubleToString(value, decimalPlaces)) {}
+
+String& String::operator=(const char* cstr) {
+	_str = cstr ? cstr : "";
+	return *this;
+}
+
+bool String::reserve(unsigned int size) {
+	_str.reserve(size);
+	return true;
+}
+
+bool String::concat(const String& str) {
+	_str += str._str;
+	return true;
+}
+
+bool String::concat(const char* cstr) {
+	if (!cstr)
+		return false;
+	_str += cstr;
+	return true;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+	if (!cstr)
+		return false;
+	_str.append(cstr, length);
+	return true;
+}
+
+bool String::concat(char c) {
+	_str.push_back(c);
+	return true;
+}
+
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(long long value) { return concat(String(value)); }
+bool String::concat(unsigned long long value) { return concat(String(value)); }
+bool String::concat(float value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+bool String::equalsIgnoreCase(const String& other) const {
+	if (length() != other.length())
+		return false;
+	for (size_t i = 0; i < _str.length(); i++) {
+		if (tolower((unsigned char)_str[i]) != tolower((unsigned char)other._str[i]))
+			return false;
+	}
+	return true;
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+	if (offset > length() || prefix.length() > length() - offset)
+		return false;
+	return _str.compare(offset, prefix.length(), prefix._str) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+	if (suffix.length() > length())
+		return false;
+	return _str.compare(length() - suffix.length(), suffix.length(), suffix._str) == 0;
+}
+
+void String::setCharAt(unsigned int index, char c) {
+	if (index < length())
+		_str[index] = c;
+}
+
+char& String::operator[](unsigned int index) {
+	static char dummy;
+	if (index >= length()) {
+		dummy = 0;
+		return dummy;
+	}
+	return _str[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+	if (!bufsize || !buf)
+		return;
+	if (index >= length()) {
+		buf[0] = 0;
+		return;
+	}
+	unsigned int n = std::min(bufsize - 1, length() - index);
+	memcpy(buf, _str.data() + index, n);
+	buf[n] = 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+	if (fromIndex >= length())
+		return -1;
+	size_t pos = _str.find(c, fromIndex);
+	return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+	if (fromIndex >= length())
+		return -1;
+	size_t pos = _str.find(str._str, fromIndex);
+	return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+	size_t pos = _str.rfind(c);
+	return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str) const {
+	size_t pos = _str.rfind(str._str);
+	return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+	if (beginIndex > endIndex)
+		std::swap(beginIndex, endIndex);
+	if (beginIndex >= length())
+		return String();
+	endIndex = std::min(endIndex, length());
+	return String(_str.data() + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace) {
+	std::replace(_str.begin(), _str.end(), find, replace);
+}
+
+void String::replace(const String& find, const String& replace) {
+	if (find.isEmpty())
+		return;
+	size_t pos = 0;
+	while ((pos = _str.find(find._str, pos)) != std::string::npos) {
+		_str.replace(pos, find.length(), replace._str);
+		pos += replace.length();
+	}
+}
+
+void String::remove(unsigned int index) { remove(index, (unsigned int)-1); }
+
+void String::remove(unsigned int index, unsigned int count) {
+	if (index >= length())
+		return;
+	_str.erase(index, std::min(count, length() - index));
+}
+
+void String::toLowerCase() {
+	for (char& c : _str) c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+	for (char& c : _str) c = toupper((unsigned char)c);
+}
+
+void String::trim() {
+	size_t begin = 0;
+	while (begin < _str.length() && isspace((unsigned char)_str[begin])) begin++;
+	size_t end = _str.length();
+	while (end > begin && isspace((unsigned char)_str[end - 1])) end--;
+	_str = _str.substr(begin, end - begin);
+}
+
+template <typename T>
+static StringSumHelper concatenated(const String& lhs, const T& rhs) {
+	StringSumHelper sum(lhs);
+	sum.concat(rhs);
+	return sum;
+}
+
+StringSumHelper operator+(const String& lhs, const String& rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, const char* rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const char* lhs, const String& rhs) {
+	return concatenated(String(lhs), rhs);
+}
+StringSumHelper operator+(const String& lhs, char rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, unsigned char rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, int rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, unsigned int rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, long rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, unsigned long rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, long long rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, unsigned long long rhs) {
+	return concatenated(lhs, rhs);
+}
+StringSumHelper operator+(const String& lhs, float rhs) { return concatenated(lhs, rhs); }
+StringSumHelper operator+(const String& lhs, double rhs) { return concatenated(lhs, rhs); }
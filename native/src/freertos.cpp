@@ -0,0 +1,157 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <pthread.h>
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct QueueDefinition {
+	std::mutex mutex;  // Protects items
+	std::condition_variable changed;
+	std::deque<std::vector<uint8_t>> items;
+	size_t length;
+	size_t itemSize;
+};
+
+struct tskTaskControlBlock {
+	std::string name;
+};
+
+namespace {
+const auto startTime = std::chrono::steady_clock::now();
+
+thread_local TaskHandle_t currentTask = nullptr;
+
+/**
+ * Wait on the queue until ready() or the ticks run out, lock must be held.
+ */
+template <typename Predicate>
+bool waitFor(QueueHandle_t queue, std::unique_lock<std::mutex>& lock, TickType_t ticks,
+             Predicate ready) {
+	if (ticks == portMAX_DELAY) {
+		queue->changed.wait(lock, ready);
+		return true;
+	}
+	return queue->changed.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+
+BaseType_t send(QueueHandle_t queue, const void* item, TickType_t ticksToWait, bool front) {
+	std::unique_lock<std::mutex> lock(queue->mutex);
+	if (!waitFor(queue, lock, ticksToWait,
+	             [queue]() { return queue->items.size() < queue->length; }))
+		return pdFALSE;
+
+	std::vector<uint8_t> copy(queue->itemSize);
+	if (queue->itemSize)
+		memcpy(copy.data(), item, queue->itemSize);
+	if (front)
+		queue->items.push_front(std::move(copy));
+	else
+		queue->items.push_back(std::move(copy));
+	queue->changed.notify_all();
+	return pdTRUE;
+}
+
+BaseType_t receive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait, bool remove) {
+	std::unique_lock<std::mutex> lock(queue->mutex);
+	if (!waitFor(queue, lock, ticksToWait, [queue]() { return !queue->items.empty(); }))
+		return pdFALSE;
+
+	if (queue->itemSize)
+		memcpy(buffer, queue->items.front().data(), queue->itemSize);
+	if (remove) {
+		queue->items.pop_front();
+		queue->changed.notify_all();
+	}
+	return pdTRUE;
+}
+}  // namespace
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+	QueueHandle_t queue = new QueueDefinition();
+	queue->length = length;
+	queue->itemSize = itemSize;
+	return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+	return send(queue, item, ticksToWait, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+	return send(queue, item, ticksToWait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+	return send(queue, item, ticksToWait, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+	return receive(queue, buffer, ticksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+	return receive(queue, buffer, ticksToWait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+	std::lock_guard<std::mutex> lock(queue->mutex);
+	return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+	std::lock_guard<std::mutex> lock(queue->mutex);
+	return queue->length - queue->items.size();
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* createdTask) {
+	// Task handles live as long as the program, like tasks of the firmware
+	TaskHandle_t task = new tskTaskControlBlock{name ? name : ""};
+	if (createdTask)
+		*createdTask = task;
+	std::thread([code, parameters, task]() {
+		currentTask = task;
+		code(parameters);
+	}).detach();
+	return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* createdTask, BaseType_t coreId) {
+	return xTaskCreate(code, name, stackDepth, parameters, priority, createdTask);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+	if (task == nullptr || task == currentTask)
+		pthread_exit(nullptr);
+	// Another thread can't be stopped from the outside, tasks of the firmware never do this
+}
+
+void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
+
+TickType_t xTaskGetTickCount() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()
+	                                                             - startTime)
+	    .count();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask; }
+
+const char* pcTaskGetName(TaskHandle_t task) {
+	if (!task)
+		task = currentTask;
+	return task ? task->name.c_str() : "main";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return 0; }
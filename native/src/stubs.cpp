@@ -0,0 +1,45 @@
+/**
+ * Link stubs for the classes that own radios and FreeRTOS tasks.
+ * The native build runs their callers' logic, not the tasks themselves, so constructors only
+ * set up what the logic touches and requests to the tasks are dropped.
+ */
+
+#include "calendar/apiTask.h"
+#include "gui/guiTask.h"
+#include "metrics.h"
+#include "myUpdate.h"
+#include "sleepManager.h"
+#include "wifiManager.h"
+
+SleepManager::SleepManager() {}
+void SleepManager::registerCallback(Callback type, const std::function<void()>& cb) {}
+
+WiFiManager::WiFiManager() {}
+bool WiFiManager::waitWiFi(int maxRetries) { return true; }
+
+void Metrics::registerJsonArena(const cal::JsonArena* arena) {}
+void Metrics::unregisterJsonArena(const cal::JsonArena* arena) {}
+
+utils::Result<String> getLatestVersion() {
+	return utils::Result<String>::makeErr(new utils::Error("No update server on the host"));
+}
+
+namespace cal {
+// Requests are dropped, so there's nothing to limit
+APITask::APITask(std::unique_ptr<API>&& api) : rateLimiter{UINT16_MAX, 1}, _api{std::move(api)} {}
+void APITask::fetchCalendarStatus() {}
+void APITask::endEvent(const String& eventId) {}
+void APITask::insertEvent(time_t startTime, time_t endTime) {}
+void APITask::rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
+                              time_t newEndTime) {}
+void APITask::fetchRoomStatuses(const std::vector<Room>& rooms) {}
+}  // namespace cal
+
+namespace gui {
+GUITask::GUITask(bool resume) : _gui(this, resume) {}
+void GUITask::success(Request type, std::shared_ptr<cal::CalendarStatus> status) {}
+void GUITask::error(Request type, std::shared_ptr<cal::Error> error) {}
+void GUITask::showRoomStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses) {}
+
+GUI::GUI(GUITask* guiTask, bool resume) : _guiTask(guiTask) {}
+}  // namespace gui
@@ -0,0 +1,292 @@
+/**
+ * Host renderer of the device screens, see native/README.md.
+ *
+ * Draws every scene with the real screen code into the in-memory EPD panel, reports the draw
+ * time of each element and the bytes changed by each area update, writes the panel as a PNG
+ * and compares it to the golden image of the scene. A missing golden image is a failure.
+ *
+ * Usage: program [--update | --no-compare] [--out DIR] [--golden DIR]
+ *   --update      overwrite the golden images instead of comparing to them
+ *   --no-compare  only report and write the panels, e.g. in CI where there are no golden images
+ */
+
+#include <M5EPD.h>
+#include <PNGdec.h>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "fixtures.h"
+#include "globals.h"
+#include "gui/drawProfile.h"
+#include "gui/screens/confirmFreeScreen.h"
+#include "gui/screens/mainScreen.h"
+#include "gui/screens/roomGridScreen.h"
+#include "gui/screens/settingsScreen.h"
+#include "gui/screens/shutdownScreen.h"
+#include "pngWriter.h"
+
+namespace {
+
+const uint32_t BATTERY_FULL_MV = 4100;
+const uint32_t BATTERY_HALF_MV = 3800;
+const uint32_t BATTERY_LOW_MV = 3300;
+
+struct Scene {
+	const char* name;
+	// Brings the panel to the state before the measured draw, may be empty
+	std::function<void()> setup;
+	std::function<void()> draw;
+};
+
+std::shared_ptr<cal::CalendarStatus> freeStatus() {
+	auto status = fixtures::status();
+	status->currentEvent = nullptr;
+	return status;
+}
+
+std::shared_ptr<std::vector<cal::RoomStatus>> roomStatuses(int count) {
+	auto statuses = std::make_shared<std::vector<cal::RoomStatus>>();
+	for (const cal::Room& room : fixtures::rooms(count)) {
+		const int i = statuses->size();
+		const auto state = i % 5 == 4 ? cal::RoomStatus::State::UNKNOWN
+		                   : i % 2    ? cal::RoomStatus::State::FREE
+		                              : cal::RoomStatus::State::BUSY;
+		const time_t until = i % 3 == 1 ? 0 : fixtures::NOW + 1200 + i * 900;
+		statuses->push_back(cal::RoomStatus{room.name, state, until});
+	}
+	return statuses;
+}
+
+std::vector<Scene> makeScenes() {
+	auto mainScreen = std::make_shared<gui::MainScreen>();
+	auto roomGrid = std::make_shared<gui::RoomGridScreen>();
+	auto confirmFree = std::make_shared<gui::ConfirmFreeScreen>();
+	auto settings = std::make_shared<gui::SettingsScreen>();
+	auto shutdown = std::make_shared<gui::ShutdownScreen>();
+
+	return {
+	    {"main_free", nullptr,
+	     [=]() {
+		     mainScreen->setStatus(freeStatus());
+		     mainScreen->draw(UPDATE_MODE_GC16);
+	     }},
+	    {"main_taken", nullptr,
+	     [=]() {
+		     mainScreen->setStatus(fixtures::status());
+		     mainScreen->draw(UPDATE_MODE_GC16);
+	     }},
+	    {"main_error", nullptr,
+	     [=]() {
+		     mainScreen->setStatus(fixtures::status());
+		     mainScreen->setError("Connection refused");
+		     mainScreen->draw(UPDATE_MODE_GC16);
+	     }},
+	    {"main_low_battery",
+	     [=]() {
+		     mainScreen->setError("");
+		     M5.setBatteryVoltage(BATTERY_LOW_MV);
+	     },
+	     [=]() {
+		     mainScreen->setStatus(freeStatus());
+		     mainScreen->draw(UPDATE_MODE_GC16);
+	     }},
+	    // Status poll where only the battery level changed
+	    {"main_reduced",
+	     [=]() {
+		     M5.setBatteryVoltage(BATTERY_FULL_MV);
+		     mainScreen->setStatus(fixtures::status());
+		     mainScreen->draw(UPDATE_MODE_GC16);
+		     M5.setBatteryVoltage(BATTERY_HALF_MV);
+	     },
+	     [=]() { mainScreen->reducedDraw(UPDATE_MODE_GL16); }},
+	    {"confirm_free", nullptr,
+	     [=]() {
+		     confirmFree->setEvent(fixtures::status()->currentEvent);
+		     confirmFree->draw(UPDATE_MODE_GC16);
+	     }},
+	    {"settings", nullptr, [=]() { settings->draw(UPDATE_MODE_GC16); }},
+	    {"rooms", nullptr,
+	     [=]() {
+		     roomGrid->setStatuses(roomStatuses(cal::ROOMS_MAX));
+		     roomGrid->draw(UPDATE_MODE_GC16);
+	     }},
+	    {"rooms_few", nullptr,
+	     [=]() {
+		     roomGrid->setStatuses(roomStatuses(5));
+		     roomGrid->draw(UPDATE_MODE_GC16);
+	     }},
+	    // Status poll where no room changed
+	    {"rooms_reduced",
+	     [=]() {
+		     roomGrid->setStatuses(roomStatuses(cal::ROOMS_MAX));
+		     roomGrid->draw(UPDATE_MODE_GC16);
+	     },
+	     [=]() {
+		     roomGrid->setStatuses(nullptr);
+		     roomGrid->reducedDraw(UPDATE_MODE_GL16);
+	     }},
+	    {"shutdown", nullptr,
+	     [=]() {
+		     shutdown->setText("Shutting down\nUntil tomorrow", false);
+		     shutdown->draw(UPDATE_MODE_GC16);
+	     }},
+	    {"shutdown_error", nullptr,
+	     [=]() {
+		     shutdown->setText("Configuration error", true);
+		     shutdown->draw(UPDATE_MODE_GC16);
+	     }},
+	};
+}
+
+/**
+ * The panel as 8-bit grayscale, 4bpp value 0 is white and 15 is black.
+ */
+std::vector<uint8_t> panelToGray() {
+	const std::vector<uint8_t>& panel = M5.EPD.displayed();
+	std::vector<uint8_t> gray(M5EPD_PANEL_W * M5EPD_PANEL_H);
+	for (size_t i = 0; i < panel.size(); i++) {
+		gray[2 * i] = 255 - (panel[i] >> 4) * 17;
+		gray[2 * i + 1] = 255 - (panel[i] & 0x0F) * 17;
+	}
+	return gray;
+}
+
+struct Comparison {
+	const std::vector<uint8_t>* expected;
+	bool supported;
+	uint32_t differentPixels;
+};
+
+void compareRow(PNGDRAW* pDraw) {
+	Comparison* comparison = static_cast<Comparison*>(pDraw->pUser);
+	if (pDraw->iPixelType != PNG_PIXEL_GRAYSCALE || pDraw->iBpp != 8) {
+		comparison->supported = false;
+		return;
+	}
+	const uint8_t* expected = comparison->expected->data() + pDraw->y * M5EPD_PANEL_W;
+	for (int x = 0; x < pDraw->iWidth; x++)
+		comparison->differentPixels += pDraw->pPixels[x] != expected[x];
+}
+
+/**
+ * Compare the rendered pixels to a golden PNG written by this program.
+ * Returns a description of the difference, empty if the images are equal.
+ */
+String compareToGolden(const std::filesystem::path& path, const std::vector<uint8_t>& gray) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+		return "open failed";
+	std::vector<uint8_t> data(std::filesystem::file_size(path));
+	const size_t read = fread(data.data(), 1, data.size(), file);
+	fclose(file);
+	if (read != data.size())
+		return "read failed";
+
+	static PNG decoder;
+	Comparison comparison{&gray, true, 0};
+	if (decoder.openRAM(data.data(), data.size(), compareRow) != PNG_SUCCESS)
+		return "not a PNG";
+	String result;
+	if (decoder.getWidth() != M5EPD_PANEL_W || decoder.getHeight() != M5EPD_PANEL_H)
+		result = "size differs";
+	else if (decoder.decode(&comparison, 0) != PNG_SUCCESS)
+		result = "decode failed";
+	else if (!comparison.supported)
+		result = "not 8-bit grayscale";
+	else if (comparison.differentPixels > 0)
+		result = String(comparison.differentPixels) + " pixels differ";
+	decoder.close();
+	return result;
+}
+
+void printReport(const char* name, uint32_t drawUs) {
+	const auto& updates = M5.EPD.updates();
+	printf("%s: %u us, %zu updates\n", name, drawUs, updates.size());
+	for (const auto& u : updates) {
+		const uint32_t areaBytes = (u.w + 1) / 2 * u.h;
+		printf("  update %-5s %3u,%3u %3ux%3u  %6u/%6u bytes changed\n",
+		       EnergyLedger::epdModeNames[u.mode], u.x, u.y, u.w, u.h, u.bytesChanged, areaBytes);
+	}
+	for (const auto& s : gui::profile::takeSamples()) {
+		printf("  %*s%-6s %3u,%3u", 2 * s.depth, "", s.kind, s.pos.x, s.pos.y);
+		if (s.size.w > 0)
+			printf(" %3ux%3u", s.size.w, s.size.h);
+		String label = s.label.substring(0, 40);
+		label.replace("\n", " ");
+		printf("  %6u us  %s\n", s.us, label.c_str());
+	}
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	bool update = false;
+	bool compare = true;
+	std::filesystem::path outDir = ".pio/render";
+	std::filesystem::path goldenDir = "render/golden";
+	for (int i = 1; i < argc; i++) {
+		const String arg = argv[i];
+		if (arg == "--update") {
+			update = true;
+		} else if (arg == "--no-compare") {
+			compare = false;
+		} else if (arg == "--out" && i + 1 < argc) {
+			outDir = argv[++i];
+		} else if (arg == "--golden" && i + 1 < argc) {
+			goldenDir = argv[++i];
+		} else {
+			fprintf(stderr, "Usage: %s [--update | --no-compare] [--out DIR] [--golden DIR]\n",
+			        argv[0]);
+			return 2;
+		}
+	}
+	std::filesystem::create_directories(outDir);
+	std::filesystem::create_directories(goldenDir);
+
+	fixtures::begin();
+	M5.setBatteryVoltage(BATTERY_FULL_MV);
+
+	int failures = 0;
+	int missing = 0;
+	for (const Scene& scene : makeScenes()) {
+		M5.EPD.Clear(true);
+		if (scene.setup)
+			scene.setup();
+		M5.EPD.clearUpdates();
+		gui::profile::takeSamples();
+
+		const unsigned long start = micros();
+		scene.draw();
+		printReport(scene.name, micros() - start);
+
+		const std::vector<uint8_t> gray = panelToGray();
+		const String file = String(scene.name) + ".png";
+		render::writeGrayPng((outDir / file.c_str()).c_str(), gray.data(), M5EPD_PANEL_W,
+		                     M5EPD_PANEL_H);
+		if (update) {
+			render::writeGrayPng((goldenDir / file.c_str()).c_str(), gray.data(), M5EPD_PANEL_W,
+			                     M5EPD_PANEL_H);
+			continue;
+		}
+		if (!compare)
+			continue;
+		if (!std::filesystem::exists(goldenDir / file.c_str())) {
+			printf("  GOLDEN MISSING: run with --update on a known good tree\n");
+			missing++;
+			continue;
+		}
+		const String difference = compareToGolden(goldenDir / file.c_str(), gray);
+		if (!difference.isEmpty()) {
+			printf("  GOLDEN MISMATCH: %s\n", difference.c_str());
+			failures++;
+		}
+	}
+
+	if (!compare)
+		return 0;
+	printf("%d scenes differ from the golden images, %d have none\n", failures, missing);
+	return failures + missing > 0 ? 1 : 0;
+}
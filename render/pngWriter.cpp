@@ -0,0 +1,96 @@
+#include "pngWriter.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace render {
+
+namespace {
+// Largest payload of a stored deflate block
+const size_t STORED_BLOCK_MAX = 65535;
+
+std::array<uint32_t, 256> makeCrcTable() {
+	std::array<uint32_t, 256> table;
+	for (uint32_t n = 0; n < table.size(); n++) {
+		uint32_t c = n;
+		for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+		table[n] = c;
+	}
+	return table;
+}
+
+uint32_t crc32(const std::string& data) {
+	static const std::array<uint32_t, 256> table = makeCrcTable();
+	uint32_t c = 0xFFFFFFFF;
+	for (unsigned char byte : data) c = table[(c ^ byte) & 0xFF] ^ (c >> 8);
+	return c ^ 0xFFFFFFFF;
+}
+
+uint32_t adler32(const std::string& data) {
+	uint32_t a = 1, b = 0;
+	for (unsigned char byte : data) {
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	return b << 16 | a;
+}
+
+void putU32(std::string& out, uint32_t value) {
+	out.push_back(value >> 24);
+	out.push_back(value >> 16);
+	out.push_back(value >> 8);
+	out.push_back(value);
+}
+
+void putChunk(std::string& out, const char* type, const std::string& data) {
+	putU32(out, data.size());
+	const std::string typed = type + data;
+	out += typed;
+	putU32(out, crc32(typed));
+}
+}  // namespace
+
+bool writeGrayPng(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height) {
+	// Every row starts with filter type 0 (none)
+	std::string raw;
+	raw.reserve((width + 1) * height);
+	for (uint32_t y = 0; y < height; y++) {
+		raw.push_back(0);
+		raw.append((const char*)pixels + y * width, width);
+	}
+
+	std::string zlib = {0x78, 0x01};
+	bool last = false;
+	for (size_t offset = 0; !last; offset += STORED_BLOCK_MAX) {
+		const size_t length = std::min(STORED_BLOCK_MAX, raw.size() - offset);
+		last = offset + length == raw.size();
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(length & 0xFF);
+		zlib.push_back(length >> 8);
+		zlib.push_back(~length & 0xFF);
+		zlib.push_back((~length >> 8) & 0xFF);
+		zlib.append(raw, offset, length);
+	}
+	putU32(zlib, adler32(raw));
+
+	std::string header;
+	putU32(header, width);
+	putU32(header, height);
+	header += {8, 0, 0, 0, 0};  // Bit depth 8, grayscale, default compression, filter, interlace
+
+	std::string png = "\x89PNG\r\n\x1a\n";
+	putChunk(png, "IHDR", header);
+	putChunk(png, "IDAT", zlib);
+	putChunk(png, "IEND", "");
+
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+	const bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+	return fclose(file) == 0 && ok;
+}
+
+}  // namespace render
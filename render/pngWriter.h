@@ -0,0 +1,16 @@
+#ifndef RENDER_PNG_WRITER_H
+#define RENDER_PNG_WRITER_H
+
+#include <stdint.h>
+
+namespace render {
+
+/**
+ * Write an 8-bit grayscale PNG to a host path. The image data is stored in uncompressed
+ * deflate blocks, so the output only depends on the pixels.
+ */
+bool writeGrayPng(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height);
+
+}  // namespace render
+
+#endif
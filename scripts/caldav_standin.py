@@ -0,0 +1,171 @@
+import base64
+import click
+import hashlib
+import os
+from functools import partial
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import quote, unquote
+from xml.sax.saxutils import escape
+
+# Stand-in for a Radicale-like CalDAV server, for testing the CalDAV provider on a LAN.
+#
+# Serves a directory whose subdirectories are calendar collections of .ics files, one calendar
+# object per file. Supports PROPFIND for the display name, calendar-query REPORTs, GET, PUT and
+# DELETE. The time-range of a REPORT is ignored and every object of the collection is returned,
+# so the device has to do the filtering, like with a large calendar on a lazy server.
+# GET returns an ETag of the object, and a PUT with a stale If-Match fails with 412.
+# Set the calendar url of the device to http://<host>:<port>/<collection>/.
+
+
+class CalDAVHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.0"
+    credentials = None
+
+    def __init__(self, *args, directory, **kwargs):
+        self.directory = directory
+        super().__init__(*args, **kwargs)
+
+    def _authorized(self):
+        if self.credentials is None:
+            return True
+        expected = "Basic " + base64.b64encode(self.credentials.encode()).decode()
+        if self.headers.get("Authorization") == expected:
+            return True
+        self.send_response(401)
+        self.send_header("WWW-Authenticate", 'Basic realm="caldav"')
+        self.send_header("Content-Length", "0")
+        self.end_headers()
+        return False
+
+    def _path(self):
+        parts = [p for p in unquote(self.path.split("?")[0]).split("/") if p]
+        if any(p in (".", "..") for p in parts):
+            return None
+        return os.path.join(self.directory, *parts)
+
+    def _read_body(self):
+        length = int(self.headers.get("Content-Length", 0))
+        return self.rfile.read(length)
+
+    def _send(self, code, body=b"", content_type="text/plain; charset=utf-8", headers=None):
+        self.send_response(code)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.end_headers()
+        self.wfile.write(body)
+
+    @staticmethod
+    def _etag(data):
+        return '"' + hashlib.sha256(data).hexdigest()[:16] + '"'
+
+    def _multistatus(self, responses):
+        body = '<?xml version="1.0" encoding="utf-8"?>\n'
+        body += '<D:multistatus xmlns:D="DAV:" xmlns:C="urn:ietf:params:xml:ns:caldav">\n'
+        for href, prop in responses:
+            body += (f"<D:response><D:href>{escape(href)}</D:href><D:propstat><D:prop>{prop}"
+                     "</D:prop><D:status>HTTP/1.1 200 OK</D:status></D:propstat></D:response>\n")
+        body += "</D:multistatus>\n"
+        self._send(207, body.encode(), "application/xml; charset=utf-8")
+
+    def do_PROPFIND(self):
+        self._read_body()
+        if not self._authorized():
+            return
+        path = self._path()
+        if path is None or not os.path.isdir(path):
+            self._send(404)
+            return
+        name = os.path.basename(os.path.normpath(path))
+        display_name = os.path.join(path, ".displayname")
+        if os.path.isfile(display_name):
+            with open(display_name, encoding="utf-8") as f:
+                name = f.read().strip()
+        self._multistatus([(self.path, f"<D:displayname>{escape(name)}</D:displayname>")])
+
+    def do_REPORT(self):
+        self._read_body()
+        if not self._authorized():
+            return
+        path = self._path()
+        if path is None or not os.path.isdir(path):
+            self._send(404)
+            return
+        responses = []
+        collection = self.path if self.path.endswith("/") else self.path + "/"
+        for filename in sorted(os.listdir(path)):
+            if not filename.endswith(".ics"):
+                continue
+            with open(os.path.join(path, filename), encoding="utf-8") as f:
+                data = f.read()
+            responses.append((collection + quote(filename),
+                              f"<C:calendar-data>{escape(data)}</C:calendar-data>"))
+        self._multistatus(responses)
+
+    def do_GET(self):
+        if not self._authorized():
+            return
+        path = self._path()
+        if path is None or not os.path.isfile(path):
+            self._send(404)
+            return
+        with open(path, "rb") as f:
+            data = f.read()
+        self._send(200, data, "text/calendar; charset=utf-8", {"ETag": self._etag(data)})
+
+    def do_PUT(self):
+        body = self._read_body()
+        if not self._authorized():
+            return
+        path = self._path()
+        if path is None or not path.endswith(".ics") or not os.path.isdir(os.path.dirname(path)):
+            self._send(409)
+            return
+        exists = os.path.isfile(path)
+        if exists and self.headers.get("If-None-Match") == "*":
+            self._send(412)
+            return
+        if_match = self.headers.get("If-Match")
+        if if_match is not None:
+            current = None
+            if exists:
+                with open(path, "rb") as f:
+                    current = self._etag(f.read())
+            matches = exists if if_match == "*" else if_match == current
+            if not matches:
+                self._send(412)
+                return
+        with open(path, "wb") as f:
+            f.write(body)
+        self._send(204 if exists else 201)
+
+    def do_DELETE(self):
+        if not self._authorized():
+            return
+        path = self._path()
+        if path is None or not os.path.isfile(path):
+            self._send(404)
+            return
+        os.remove(path)
+        self._send(204)
+
+
+@click.command()
+@click.argument("directory", type=click.Path(exists=True, file_okay=False))
+@click.option("--port", default=5232, show_default=True)
+@click.option("--user", default=None, help="Require basic auth with this user")
+@click.option("--password", default="", help="Password of --user")
+def main(directory, port, user, password):
+    CalDAVHandler.credentials = f"{user}:{password}" if user else None
+    handler = partial(CalDAVHandler, directory=directory)
+    server = ThreadingHTTPServer(("0.0.0.0", port), handler)
+    click.echo(f"Serving the calendars in {directory} on port {port}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
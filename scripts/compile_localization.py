@@ -0,0 +1,99 @@
+import click
+import json
+import re
+import struct
+
+# Binary layout (all integers little-endian):
+#
+# Header:
+#   char[4]  magic "L10N"
+#   uint8    format version
+#   uint8    language count
+#   uint16   message count
+#   uint32   FNV-1a hash of the message names joined with ','
+# Language table, one entry per language:
+#   char[4]  language code, zero padded
+#   uint32   section offset from the start of the file
+#   uint32   section size
+# Language section:
+#   uint16[message count]  string offsets relative to the end of the offset index
+#   UTF-8 blob of zero terminated strings
+#
+# Strings are indexed directly by L10nMessage, so the order of the message names
+# is taken from the L10N_MESSAGES macro in localization.h.
+
+MAGIC = b"L10N"
+FORMAT_VERSION = 1
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def read_message_names(header_path):
+    with open(header_path, encoding="utf-8") as f:
+        header = f.read()
+
+    # The macro body is the define line and its backslash continuation lines
+    macro = re.search(r"^#define L10N_MESSAGES\(F\)((?:.*\\\n)*.*)$", header, re.M)
+    if not macro:
+        raise click.ClickException("L10N_MESSAGES not found in " + header_path)
+
+    return re.findall(r"F\((\w+)\)", macro.group(1))
+
+
+def compile_localization(json_path, header_path, out_path):
+    names = read_message_names(header_path)
+
+    with open(json_path, encoding="utf-8") as f:
+        messages = json.load(f)
+
+    languages = messages["supportedLanguages"]
+
+    sections = []
+    for lang in languages:
+        if len(lang.encode("ascii")) > 4:
+            raise click.ClickException("Language code too long: " + lang)
+
+        offsets = b""
+        blob = b""
+        for name in names:
+            if name not in messages or lang not in messages[name]:
+                raise click.ClickException(f"Localization '{lang}-{name}' not found.")
+            offsets += struct.pack("<H", len(blob))
+            blob += messages[name][lang].encode("utf-8") + b"\0"
+
+        if len(blob) > 0xFFFF:
+            raise click.ClickException("Too many localized strings for language " + lang)
+
+        sections.append(offsets + blob)
+
+    header = MAGIC + struct.pack("<BBHI", FORMAT_VERSION, len(languages), len(names),
+                                 fnv1a(",".join(names).encode("ascii")))
+
+    table = b""
+    offset = len(header) + 12 * len(languages)
+    for lang, section in zip(languages, sections):
+        table += struct.pack("<4sII", lang.encode("ascii"), offset, len(section))
+        offset += len(section)
+
+    with open(out_path, "wb") as f:
+        f.write(header + table + b"".join(sections))
+
+    click.echo(f"Compiled {len(names)} messages in {len(languages)} languages into {out_path}")
+
+
+@click.command()
+@click.option("--json", "json_path", default="./data/localization.json")
+@click.option("--header", "header_path", default="./src/localization.h")
+@click.option("--out", "out_path", default="./data/localization.bin")
+def main(json_path, header_path, out_path):
+    compile_localization(json_path, header_path, out_path)
+
+
+if __name__ == "__main__":
+    main()
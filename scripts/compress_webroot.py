@@ -0,0 +1,62 @@
+import click
+import gzip
+import hashlib
+import os
+
+# Precompresses the setup frontend for the device web server (see WebrootHandler in
+# src/configServer.cpp). Every file gets a .gz variant next to it when that is smaller, and an
+# index with one line per file is written for the server:
+#
+#   <url path> <etag> <1 if a .gz variant exists, else 0>
+#
+# The etag is a content hash, so it is a strong validator for both the fingerprinted assets and
+# index.html. The server reads the index once at start instead of probing the filesystem on
+# every request.
+
+INDEX_NAME = "etags.txt"
+ETAG_LENGTH = 16
+
+
+def compress_webroot(webroot):
+    entries = []
+    saved = 0
+
+    index_path = os.path.join(webroot, INDEX_NAME)
+    for root, dirs, files in os.walk(webroot):
+        dirs.sort()
+        for file in sorted(files):
+            path = os.path.join(root, file)
+            if file.endswith(".gz") or path == index_path:
+                continue
+
+            with open(path, "rb") as f:
+                data = f.read()
+
+            # mtime=0 keeps the output reproducible
+            compressed = gzip.compress(data, compresslevel=9, mtime=0)
+            has_gzip = len(compressed) < len(data)
+            if has_gzip:
+                with open(path + ".gz", "wb") as f:
+                    f.write(compressed)
+                saved += len(data) - len(compressed)
+            elif os.path.exists(path + ".gz"):
+                os.remove(path + ".gz")
+
+            url_path = "/" + os.path.relpath(path, webroot).replace(os.sep, "/")
+            etag = hashlib.sha256(data).hexdigest()[:ETAG_LENGTH]
+            entries.append(f"{url_path} {etag} {int(has_gzip)}\n")
+
+    with open(index_path, "w", encoding="ascii") as f:
+        f.writelines(entries)
+
+    click.echo(f"Indexed {len(entries)} files in {webroot}, gzip saves {saved} bytes per load")
+
+
+@click.command()
+@click.option("--webroot", default="./data/webroot")
+def main(webroot):
+    compress_webroot(webroot)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,148 @@
+import click
+import os
+import re
+
+# Generates src/timezones.cpp, a table mapping IANA (Olson) timezone names to POSIX TZ rules.
+#
+# The POSIX rule of a zone is the footer of its TZif (version 2+) file in the system zoneinfo
+# database. Names and rules are packed into one string blob ("name\0rule\0name\0rule\0...")
+# with a sorted offset index, so a lookup is a binary search over flash without allocations.
+
+SKIP_DIRS = {"posix", "right"}
+SKIP_FILES = {"posixrules", "localtime", "Factory"}
+
+OUTPUT_HEADER = """// This file is generated by scripts/generate_timezones.py, do not edit.
+// Source: {source} (tzdata {version})
+
+#include "timezones.h"
+
+namespace tzdb {{
+
+const uint16_t ZONE_COUNT = {count};
+
+const char ZONE_DATA[] =
+"""
+
+
+def read_posix_rule(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if not data.startswith(b"TZif") or data[4:5] not in (b"2", b"3", b"4"):
+        return None
+
+    # Footer is the last line of the file: "\n<posix rule>\n"
+    footer = data.rstrip(b"\n").rsplit(b"\n", 1)
+    if len(footer) != 2 or not footer[1]:
+        return None
+
+    return footer[1].decode("ascii")
+
+
+def read_zoneinfo(zoneinfo):
+    zones = {}
+    for root, dirs, files in os.walk(zoneinfo):
+        dirs[:] = [d for d in dirs if d not in SKIP_DIRS]
+        for file in files:
+            if file in SKIP_FILES:
+                continue
+            path = os.path.join(root, file)
+            name = os.path.relpath(path, zoneinfo).replace(os.sep, "/")
+            # Only Area/Location names (plus UTC) are used in config.json
+            if "/" not in name and name != "UTC":
+                continue
+            rule = read_posix_rule(path)
+            if rule:
+                zones[name] = rule
+    return zones
+
+
+def read_tzdata_version(zoneinfo):
+    try:
+        with open(os.path.join(zoneinfo, "tzdata.zi"), encoding="ascii") as f:
+            return f.readline().strip().replace("# version ", "")
+    except OSError:
+        return "unknown"
+
+
+def c_string(s):
+    return '"' + s.replace("\\", "\\\\").replace('"', '\\"') + '\\0"'
+
+
+def generate(zones, source, version, out_path):
+    names = sorted(zones.keys(), key=lambda n: n.encode("ascii"))
+
+    offsets = []
+    lines = []
+    offset = 0
+    for name in names:
+        offsets.append(offset)
+        lines.append("    " + c_string(name) + " " + c_string(zones[name]))
+        offset += len(name) + 1 + len(zones[name]) + 1
+
+    if offset > 0xFFFF:
+        raise click.ClickException("Zone data too large for 16 bit offsets")
+
+    with open(out_path, "w", encoding="ascii") as f:
+        f.write(OUTPUT_HEADER.format(source=source, version=version, count=len(names)))
+        f.write("\n".join(lines) + ";\n\n")
+        f.write("const uint16_t ZONE_INDEX[] = {\n")
+        for i in range(0, len(offsets), 12):
+            f.write("    " + ", ".join(str(o) for o in offsets[i:i + 12]) + ",\n")
+        f.write("};\n\n}  // namespace tzdb\n")
+
+    click.echo(f"Wrote {len(names)} zones ({offset} bytes of zone data) into {out_path}")
+
+
+def read_generated(path):
+    with open(path, encoding="ascii") as f:
+        source = f.read()
+    strings = re.findall(r'"((?:[^"\\]|\\.)*)\\0"', source)
+    return dict(zip(strings[0::2], strings[1::2]))
+
+
+def verify(zones, path):
+    generated = read_generated(path)
+    errors = 0
+
+    for name, rule in zones.items():
+        if name not in generated:
+            click.echo("Missing zone: " + name, err=True)
+            errors += 1
+        elif generated[name] != rule:
+            click.echo(f"Rule mismatch for {name}: {generated[name]} != {rule}", err=True)
+            errors += 1
+
+    for name in generated.keys() - zones.keys():
+        click.echo("Zone not in system zoneinfo: " + name, err=True)
+        errors += 1
+
+    names = list(generated.keys())
+    if names != sorted(names, key=lambda n: n.encode("ascii")):
+        click.echo("Zone index is not sorted", err=True)
+        errors += 1
+
+    if errors:
+        raise click.ClickException(f"{errors} differences against system zoneinfo")
+
+    click.echo(f"All {len(generated)} zones match system zoneinfo")
+
+
+@click.command()
+@click.option("--zoneinfo", default="/usr/share/zoneinfo")
+@click.option("--out", "out_path", default="./src/timezones.cpp")
+@click.option("--verify", "verify_only", is_flag=True,
+              help="Check an existing table against the system zoneinfo instead of generating")
+def main(zoneinfo, out_path, verify_only):
+    zones = read_zoneinfo(zoneinfo)
+    if not zones:
+        raise click.ClickException("No TZif files found in " + zoneinfo)
+
+    if verify_only:
+        verify(zones, out_path)
+    else:
+        generate(zones, zoneinfo, read_tzdata_version(zoneinfo), out_path)
+
+
+if __name__ == "__main__":
+    main()
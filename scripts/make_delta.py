@@ -0,0 +1,175 @@
+import click
+import hashlib
+import struct
+import zlib
+
+# Generates a delta patch between two firmware images, applied on the device by
+# applyFirmwareDelta (src/firmwareDelta.cpp) from the running partition into the inactive one.
+#
+# The patch is a zlib stream of:
+#
+# Header:
+#   char[4]   magic "MBDL"
+#   uint8     format version
+#   uint32    old image size
+#   uint8[32] old image SHA-256
+#   uint32    new image size
+#   uint8[32] new image SHA-256
+# Operations, producing the new image from start to end:
+#   uint8 OP_ADD,  uint32 old offset, uint32 length, uint8[length] bytes added to old bytes
+#   uint8 OP_DATA, uint32 length, uint8[length] literal bytes
+#   uint8 OP_END
+#
+# ADD works like in bsdiff: when code moves, most bytes of a region match the old image and only
+# embedded addresses change, so the added bytes are mostly zero and compress to almost nothing.
+# All integers are little-endian.
+
+MAGIC = b"MBDL"
+FORMAT_VERSION = 1
+
+OP_END = 0
+OP_ADD = 1
+OP_DATA = 2
+
+KEY_SIZE = 16  # Bytes used to find candidate matches in the old image
+MIN_MATCH = 32  # Shorter matches are stored as literal data
+MAX_MISS_RUN = 256  # Stop extending a match after this many bytes without improvement
+
+
+def index_old(old):
+    index = {}
+    for i in range(len(old) - KEY_SIZE + 1):
+        index.setdefault(old[i:i + KEY_SIZE], i)
+    return index
+
+
+def extend_match(old, o, new, n):
+    """Length of the approximate match maximizing 2 * equal bytes - length, like bsdiff."""
+    limit = min(len(old) - o, len(new) - n)
+    score = best_score = 0
+    best_len = 0
+    i = 0
+    while i < limit:
+        score += 1 if old[o + i] == new[n + i] else -1
+        i += 1
+        if score > best_score:
+            best_score = score
+            best_len = i
+        elif i - best_len > MAX_MISS_RUN:
+            break
+    return best_len
+
+
+def diff(old, new):
+    index = index_old(old)
+    ops = []
+    literal_start = 0
+    n = 0
+    # Try the alignment of the previous match first, it survives small insertions and edits
+    prev_delta = None
+    while n <= len(new) - KEY_SIZE:
+        candidates = []
+        if prev_delta is not None and 0 <= n + prev_delta < len(old):
+            candidates.append(n + prev_delta)
+        found = index.get(new[n:n + KEY_SIZE])
+        if found is not None:
+            candidates.append(found)
+
+        best_o, best_len = None, 0
+        for o in candidates:
+            length = extend_match(old, o, new, n)
+            if length > best_len:
+                best_o, best_len = o, length
+
+        if best_len < MIN_MATCH:
+            n += 1
+            continue
+
+        if literal_start < n:
+            ops.append((OP_DATA, new[literal_start:n]))
+        added = bytes((new[n + i] - old[best_o + i]) & 0xFF for i in range(best_len))
+        ops.append((OP_ADD, best_o, added))
+        prev_delta = best_o - n
+        n += best_len
+        literal_start = n
+
+    if literal_start < len(new):
+        ops.append((OP_DATA, new[literal_start:]))
+    return ops
+
+
+def encode(old, new, ops):
+    out = bytearray(MAGIC)
+    out += struct.pack("<BI", FORMAT_VERSION, len(old)) + hashlib.sha256(old).digest()
+    out += struct.pack("<I", len(new)) + hashlib.sha256(new).digest()
+    for op in ops:
+        if op[0] == OP_ADD:
+            out += struct.pack("<BII", OP_ADD, op[1], len(op[2])) + op[2]
+        else:
+            out += struct.pack("<BI", OP_DATA, len(op[1])) + op[1]
+    out += struct.pack("<B", OP_END)
+    return zlib.compress(bytes(out), 9)
+
+
+def apply_delta(old, patch):
+    """Reference implementation of the device side, used to verify generated patches."""
+    data = zlib.decompress(patch)
+    if data[:4] != MAGIC or data[4] != FORMAT_VERSION:
+        raise click.ClickException("Invalid patch header")
+    pos = 5
+    old_size, = struct.unpack_from("<I", data, pos)
+    old_digest = data[pos + 4:pos + 36]
+    pos += 36
+    new_size, = struct.unpack_from("<I", data, pos)
+    new_digest = data[pos + 4:pos + 36]
+    pos += 36
+    if old_size != len(old) or hashlib.sha256(old).digest() != old_digest:
+        raise click.ClickException("Patch was made for a different old image")
+
+    new = bytearray()
+    while True:
+        op = data[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        elif op == OP_ADD:
+            o, length = struct.unpack_from("<II", data, pos)
+            pos += 8
+            new += bytes((old[o + i] + data[pos + i]) & 0xFF for i in range(length))
+            pos += length
+        elif op == OP_DATA:
+            length, = struct.unpack_from("<I", data, pos)
+            pos += 4
+            new += data[pos:pos + length]
+            pos += length
+        else:
+            raise click.ClickException(f"Unknown operation {op}")
+
+    if len(new) != new_size or hashlib.sha256(new).digest() != new_digest:
+        raise click.ClickException("Patched image doesn't match")
+    return bytes(new)
+
+
+@click.command()
+@click.argument("old_firmware", type=click.Path(exists=True, dir_okay=False))
+@click.argument("new_firmware", type=click.Path(exists=True, dir_okay=False))
+@click.option("--out", "out_path", required=True)
+def main(old_firmware, new_firmware, out_path):
+    with open(old_firmware, "rb") as f:
+        old = f.read()
+    with open(new_firmware, "rb") as f:
+        new = f.read()
+
+    patch = encode(old, new, diff(old, new))
+    # Never publish a patch that doesn't reproduce the new image
+    apply_delta(old, patch)
+
+    with open(out_path, "wb") as f:
+        f.write(patch)
+
+    click.echo(f"Wrote {len(patch)} byte patch ({len(patch) / len(new):.1%} of {len(new)} bytes) "
+               f"into {out_path}")
+
+
+if __name__ == "__main__":
+    main()
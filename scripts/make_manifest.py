@@ -0,0 +1,50 @@
+import click
+import hashlib
+import json
+import os
+
+# Generates the firmware manifest used by resumable firmware downloads (see downloadFirmware in
+# src/myUpdate.cpp). The device downloads the image in chunks with HTTP Range requests and
+# verifies every chunk, so it can resume after a dropped connection and skip chunks that
+# already match in its inactive OTA partition.
+#
+# {"size": <image bytes>, "sha256": <image digest>, "chunk_size": <bytes>, "chunks": [<digest>, ...]}
+
+# Chunks are erased separately on the device, so the size must be a multiple of the flash sector
+FLASH_SECTOR_SIZE = 4096
+DEFAULT_CHUNK_SIZE = 64 * 1024
+
+
+def make_manifest(data, chunk_size):
+    return {
+        "size": len(data),
+        "sha256": hashlib.sha256(data).hexdigest(),
+        "chunk_size": chunk_size,
+        "chunks": [hashlib.sha256(data[i:i + chunk_size]).hexdigest()
+                   for i in range(0, len(data), chunk_size)],
+    }
+
+
+@click.command()
+@click.argument("firmware", type=click.Path(exists=True, dir_okay=False))
+@click.option("--chunk-size", default=DEFAULT_CHUNK_SIZE, show_default=True)
+@click.option("--out", "out_path", default=None,
+              help="Defaults to firmware.manifest.json next to the firmware")
+def main(firmware, chunk_size, out_path):
+    if chunk_size <= 0 or chunk_size % FLASH_SECTOR_SIZE != 0:
+        raise click.ClickException(f"Chunk size must be a multiple of {FLASH_SECTOR_SIZE}")
+
+    with open(firmware, "rb") as f:
+        data = f.read()
+
+    manifest = make_manifest(data, chunk_size)
+
+    out_path = out_path or os.path.join(os.path.dirname(firmware), "firmware.manifest.json")
+    with open(out_path, "w", encoding="ascii") as f:
+        json.dump(manifest, f)
+
+    click.echo(f"Wrote {len(manifest['chunks'])} chunks of {len(data)} bytes into {out_path}")
+
+
+if __name__ == "__main__":
+    main()
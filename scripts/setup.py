@@ -7,6 +7,10 @@ import tarfile
 import os
 import shutil
 
+from compile_localization import compile_localization
+from compress_webroot import compress_webroot
+from generate_timezones import generate, read_tzdata_version, read_zoneinfo
+
 
 @click.group(chain=True)
 def cli():
@@ -63,6 +67,28 @@ def frontend():
         shutil.rmtree("./data/webroot")
 
     shutil.copytree("./setup-frontend/dist", "./data/webroot")
+    compress_webroot("./data/webroot")
+
+    click.echo("Done")
+
+
+@cli.command()
+def localization():
+    click.echo("Compiling localization tables...")
+
+    compile_localization("./data/localization.json", "./src/localization.h",
+                         "./data/localization.bin")
+
+    click.echo("Done")
+
+
+@cli.command()
+@click.option("--zoneinfo", default="/usr/share/zoneinfo")
+def timezones(zoneinfo):
+    click.echo("Generating timezone table...")
+
+    generate(read_zoneinfo(zoneinfo), zoneinfo, read_tzdata_version(zoneinfo),
+             "./src/timezones.cpp")
 
     click.echo("Done")
 
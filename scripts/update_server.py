@@ -0,0 +1,94 @@
+import click
+import os
+import random
+import socket
+from functools import partial
+from http.server import SimpleHTTPRequestHandler, ThreadingHTTPServer
+
+# Stand-in for the firmware update bucket, for testing updates over an unreliable network.
+#
+# Serves a directory laid out like the bucket (current-version, v<version>/firmware.bin, ...)
+# with HTTP Range support, and cuts responses off at random. Build the firmware with
+# -DUPDATE_STORAGE_URL='"http://<host>:<port>"' to update from it.
+
+
+class FlakyHandler(SimpleHTTPRequestHandler):
+    drop_rate = 0.0
+
+    def send_head(self):
+        range_header = self.headers.get("Range")
+        if not range_header:
+            return super().send_head()
+
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return None
+
+        size = os.path.getsize(path)
+        try:
+            unit, spec = range_header.split("=", 1)
+            start_str, end_str = spec.split("-", 1)
+            start = int(start_str)
+            end = min(int(end_str) if end_str else size - 1, size - 1)
+            if unit != "bytes" or start > end:
+                raise ValueError
+        except ValueError:
+            self.send_error(416)
+            return None
+
+        f = open(path, "rb")
+        f.seek(start)
+        self.range_left = end - start + 1
+        self.send_response(206)
+        self.send_header("Content-Type", self.guess_type(path))
+        self.send_header("Content-Range", f"bytes {start}-{end}/{size}")
+        self.send_header("Content-Length", str(self.range_left))
+        self.send_header("Accept-Ranges", "bytes")
+        self.end_headers()
+        return f
+
+    def copyfile(self, source, outputfile):
+        left = getattr(self, "range_left", None)
+        # Drop somewhere in the middle of the body, like a lost WiFi connection
+        drop_at = None
+        if random.random() < self.drop_rate:
+            total = left if left is not None else os.fstat(source.fileno()).st_size
+            drop_at = random.randint(0, max(total - 1, 0))
+
+        sent = 0
+        while left is None or left > 0:
+            block = source.read(min(16 * 1024, left) if left is not None else 16 * 1024)
+            if not block:
+                break
+            if drop_at is not None and sent + len(block) > drop_at:
+                outputfile.write(block[:drop_at - sent])
+                self.log_message("Dropped connection after %d bytes", drop_at)
+                self.connection.shutdown(socket.SHUT_RDWR)
+                return
+            outputfile.write(block)
+            sent += len(block)
+            if left is not None:
+                left -= len(block)
+
+
+@click.command()
+@click.argument("directory", type=click.Path(exists=True, file_okay=False))
+@click.option("--port", default=8000, show_default=True)
+@click.option("--drop-rate", default=0.3, show_default=True,
+              help="Probability of cutting a response off midway")
+@click.option("--seed", type=int, default=None, help="Seed for reproducible drops")
+def main(directory, port, drop_rate, seed):
+    random.seed(seed)
+    FlakyHandler.drop_rate = drop_rate
+    handler = partial(FlakyHandler, directory=directory)
+    server = ThreadingHTTPServer(("0.0.0.0", port), handler)
+    click.echo(f"Serving {directory} on port {port}, dropping {drop_rate:.0%} of responses")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
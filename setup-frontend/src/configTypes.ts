@@ -10,6 +10,18 @@ export let defaultConfig: Config = {
 		room_email: "",
 		token: undefined,
 	},
+	gatewaysettings: {
+		host: "",
+		port: 8463,
+		key: "",
+		calendarid: "",
+	},
+	caldavsettings: {
+		url: "",
+		username: "",
+		password: "",
+	},
+	dashboard_rooms: [],
 	wifi: {
 		ssid: "",
 		password: "",
@@ -32,6 +44,8 @@ export let defaultConfig: Config = {
 	},
 	language: "FI",
 	autoupdate: false,
+	deep_sleep: false,
+	metrics_server: false,
 	update_channel: "stable",
 }
 
@@ -47,7 +61,7 @@ export interface Config {
 			refresh_token: string
 		}
 	}
-	calendar_provider: "google" | "microsoft"
+	calendar_provider: "google" | "microsoft" | "gateway" | "caldav"
 	mscalsettings: {
 		room_email: string
 		token: {
@@ -56,6 +70,26 @@ export interface Config {
 			refresh_token: string
 		}
 	}
+	// The provider of the LAN gateway is used, see gateway/README.md
+	gatewaysettings: {
+		host: string
+		port: number
+		key: string
+		// Calendar ID or room email, depending on the provider of the gateway
+		calendarid: string
+	}
+	// Calendar collection of a CalDAV server, or a read-only .ics file
+	caldavsettings: {
+		url: string
+		username: string
+		password: string
+	}
+	// Shows these rooms in a grid instead of booking the calendar above
+	dashboard_rooms: {
+		name: string
+		// Calendar ID or room email, depending on the provider
+		id: string
+	}[]
 	wifi: {
 		ssid: string
 		password: string
@@ -78,5 +112,7 @@ export interface Config {
 	}
 	language: string
 	autoupdate: boolean
+	deep_sleep: boolean
+	metrics_server: boolean
 	update_channel: "stable" | "beta"
 }
@@ -0,0 +1,90 @@
+#include "allocators.h"
+
+#include <esp_heap_caps.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace alloc {
+
+const std::array<const char*, (size_t)Pool::SIZE> poolNames{
+    "json",
+    "buffer",
+    "image",
+};
+
+namespace {
+// Size of the block is kept in front of it for the usage counters.
+// 8 bytes keep the 8 byte alignment of the heap.
+struct alignas(8) BlockHeader {
+	size_t size;
+};
+
+std::mutex usageMutex;  // Protects usages
+std::array<Usage, (size_t)Pool::SIZE> usages{};
+
+BlockHeader* header(void* ptr) { return static_cast<BlockHeader*>(ptr) - 1; }
+}  // namespace
+
+void* allocate(Pool pool, size_t size) {
+	const size_t total = sizeof(BlockHeader) + size;
+	bool fallback = false;
+	void* block = heap_caps_malloc(total, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+	if (!block) {
+		fallback = true;
+		block = heap_caps_malloc(total, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+	}
+
+	std::lock_guard<std::mutex> lock(usageMutex);
+	Usage& usage = usages[(size_t)pool];
+	if (!block) {
+		usage.failures++;
+		log_e("%s pool: allocation of %u bytes failed", poolNames[(size_t)pool], size);
+		return nullptr;
+	}
+
+	usage.allocations++;
+	usage.internalFallbacks += fallback;
+	usage.bytes += size;
+	usage.peakBytes = std::max(usage.peakBytes, usage.bytes);
+
+	BlockHeader* h = static_cast<BlockHeader*>(block);
+	h->size = size;
+	return h + 1;
+}
+
+void deallocate(Pool pool, void* ptr) {
+	if (!ptr)
+		return;
+
+	BlockHeader* h = header(ptr);
+	{
+		std::lock_guard<std::mutex> lock(usageMutex);
+		usages[(size_t)pool].bytes -= h->size;
+	}
+	heap_caps_free(h);
+}
+
+void* reallocate(Pool pool, void* ptr, size_t size) {
+	if (!ptr)
+		return allocate(pool, size);
+
+	// Only used to shrink documents, so a copy is fine
+	void* moved = allocate(pool, size);
+	if (!moved)
+		return nullptr;
+	memcpy(moved, ptr, std::min(size, header(ptr)->size));
+	deallocate(pool, ptr);
+	return moved;
+}
+
+Usage usage(Pool pool) {
+	std::lock_guard<std::mutex> lock(usageMutex);
+	return usages[(size_t)pool];
+}
+
+Buffer makeBuffer(Pool pool, size_t size) {
+	return Buffer(static_cast<uint8_t*>(allocate(pool, size)), BufferDeleter{pool});
+}
+
+}  // namespace alloc
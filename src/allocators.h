@@ -0,0 +1,74 @@
+#ifndef ALLOCATORS_H
+#define ALLOCATORS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <array>
+#include <memory>
+
+/**
+ * Placement policy for large transient buffers.
+ *
+ * Internal RAM is kept for DMA, the WiFi driver and TLS, everything large and short lived
+ * (json documents, decode and download buffers) goes to PSRAM. If PSRAM is full or missing,
+ * the allocation falls back to internal RAM and the fallback is counted.
+ *
+ * Every allocation belongs to a pool with its own usage counters, served on /metrics.
+ */
+namespace alloc {
+
+enum class Pool : size_t {
+	JSON,    // ArduinoJson documents
+	BUFFER,  // File, download and decompression buffers
+	IMAGE,   // Image decode buffers
+	SIZE
+};
+
+extern const std::array<const char*, (size_t)Pool::SIZE> poolNames;
+
+struct Usage {
+	uint32_t bytes;              // Currently allocated
+	uint32_t peakBytes;          // Highest bytes since boot
+	uint32_t allocations;        // Total count since boot
+	uint32_t internalFallbacks;  // Allocations that didn't fit in PSRAM
+	uint32_t failures;           // Allocations that didn't fit anywhere
+};
+
+/**
+ * Allocate from PSRAM, or from internal RAM if PSRAM is full. Returns nullptr on failure.
+ */
+void* allocate(Pool pool, size_t size);
+void deallocate(Pool pool, void* ptr);
+void* reallocate(Pool pool, void* ptr, size_t size);
+
+Usage usage(Pool pool);
+
+/**
+ * Allocator interface of ArduinoJson, see BasicJsonDocument.
+ */
+template <Pool P>
+struct PoolAllocator {
+	void* allocate(size_t size) { return alloc::allocate(P, size); }
+	void deallocate(void* ptr) { alloc::deallocate(P, ptr); }
+	void* reallocate(void* ptr, size_t size) { return alloc::reallocate(P, ptr, size); }
+};
+
+struct BufferDeleter {
+	Pool pool;
+	void operator()(uint8_t* ptr) const { deallocate(pool, ptr); }
+};
+using Buffer = std::unique_ptr<uint8_t[], BufferDeleter>;
+
+/**
+ * Byte buffer freed back to its pool. Check for nullptr, large buffers may not fit.
+ */
+Buffer makeBuffer(Pool pool, size_t size);
+
+}  // namespace alloc
+
+using SpiRamAllocator = alloc::PoolAllocator<alloc::Pool::JSON>;
+// Drop-in for DynamicJsonDocument, the document memory is in PSRAM
+using SpiRamJsonDocument = BasicJsonDocument<SpiRamAllocator>;
+
+#endif
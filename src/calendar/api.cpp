@@ -2,6 +2,8 @@
 
 #include <HTTPClient.h>
 
+#include <algorithm>
+
 #include "globals.h"
 #include "timeUtils.h"
 
@@ -34,6 +36,49 @@ utils::Result<Token, utils::Error> jsonToToken(JsonObjectConst obj) {
 	return TokenRes::makeOk(token);
 }
 
+namespace {
+const char* ACCESS_TOKEN_KEY = "tok-access";
+const char* ACCESS_TOKEN_EXPIRY_KEY = "tok-expiry";
+const char* ACCESS_TOKEN_OWNER_KEY = "tok-owner";
+
+// FNV-1a hash identifying the credentials that an access token was issued for
+uint32_t hashCredentials(const Token& token) {
+	uint32_t hash = 0x811C9DC5;
+	for (const String* s : {&token.clientId, &token.refreshToken}) {
+		for (const char* c = s->c_str(); *c; c++) {
+			hash ^= (uint8_t)*c;
+			hash *= 0x01000193;
+		}
+	}
+	return hash;
+}
+}  // namespace
+
+void saveAccessToken(const Token& token) {
+	preferences.putString(ACCESS_TOKEN_KEY, token.accessToken);
+	preferences.putLong64(ACCESS_TOKEN_EXPIRY_KEY, token.unixExpiry);
+	preferences.putUInt(ACCESS_TOKEN_OWNER_KEY, hashCredentials(token));
+}
+
+bool loadAccessToken(Token& token) {
+	if (!preferences.isKey(ACCESS_TOKEN_KEY)
+	    || preferences.getUInt(ACCESS_TOKEN_OWNER_KEY) != hashCredentials(token)) {
+		log_i("No stored access token");
+		return false;
+	}
+
+	time_t expiry = preferences.getLong64(ACCESS_TOKEN_EXPIRY_KEY);
+	if (expiry <= safeUTC.now() + TOKEN_EXPIRY_MARGIN_S) {
+		log_i("Stored access token has expired");
+		return false;
+	}
+
+	token.accessToken = preferences.getString(ACCESS_TOKEN_KEY);
+	token.unixExpiry = expiry;
+	log_i("Loaded access token, expires in %ld s", (long)(expiry - safeUTC.now()));
+	return true;
+}
+
 void tokenToJson(JsonObject& resultObj, const Token& token) {
 	resultObj["refresh_token"] = token.refreshToken;
 	resultObj["client_id"] = token.clientId;
@@ -41,31 +86,120 @@ void tokenToJson(JsonObject& resultObj, const Token& token) {
 	resultObj["scope"] = token.scope;
 }
 
-std::shared_ptr<cal::Error> parseJSONResponse(JsonDocument& doc, int httpCode,
-                                              const String& responseBody) {
+namespace {
+const char* RETRY_AFTER_HEADERS[] = {"Retry-After"};
+
+/**
+ * Seconds from a Retry-After value, either seconds or an HTTP date. Zero if not valid.
+ */
+time_t parseRetryAfter(const String& value) {
+	if (value.length() > 0 && isDigit(value[0]))
+		return value.toInt();
+	const time_t at = timeutils::parseHttpDate(value);
+	return at ? max(at - safeUTC.now(), (time_t)0) : 0;
+}
+}  // namespace
+
+void collectRetryAfter(HTTPClient& http) {
+	http.collectHeaders(RETRY_AFTER_HEADERS, sizeof(RETRY_AFTER_HEADERS) / sizeof(char*));
+}
+
+std::shared_ptr<cal::Error> checkHttpCode(int httpCode, HTTPClient* http) {
+	// Connections are not reused, so every response is preceded by a TLS handshake
+	energyLedger.countTlsHandshake();
+
 	// Negative codes are errors special to HTTPClient
 	if (httpCode < 0) {
 		String errStr = HTTPClient::errorToString(httpCode);
 		log_w("HTTP: %d, %s", httpCode, errStr.c_str());
-		return std::make_shared<cal::Error>(cal::Error::Type::HTTP,
-		                                    "HTTP: " + String(httpCode) + ", " + errStr.c_str());
+		auto err = std::make_shared<cal::Error>(
+		    cal::Error::Type::HTTP, "HTTP: " + String(httpCode) + ", " + errStr.c_str());
+		err->httpCode = httpCode;
+		return err;
 	}
 
+	std::shared_ptr<cal::Error> err;
 	if (httpCode < 200 || httpCode >= 300) {
 		String errStr = utils::httpCodeToString(httpCode);
 		log_w("HTTP response: %d, %s", httpCode, errStr.c_str());
-		return std::make_shared<cal::Error>(cal::Error::Type::HTTP,
-		                                    "HTTP: " + String(httpCode) + ", " + errStr);
+		err = std::make_shared<cal::Error>(cal::Error::Type::HTTP,
+		                                   "HTTP: " + String(httpCode) + ", " + errStr);
+		err->httpCode = httpCode;
 	}
 
-	DeserializationError err = deserializeJson(doc, responseBody);
-	if (err) {
-		String errStr = err.f_str();
-		log_w("deserializeJson() failed with code %s", errStr.c_str());
-		return std::make_shared<cal::Error>(cal::Error::Type::PARSE,
-		                                    "deserializeJson() failed with code " + errStr);
+	if (http && http->hasHeader(RETRY_AFTER_HEADERS[0])) {
+		if (err && (httpCode == 429 || httpCode == 503)) {
+			err->retryAfter = parseRetryAfter(http->header(RETRY_AFTER_HEADERS[0]));
+			log_w("Retry after %ld s", (long)err->retryAfter);
+		}
+		// Values are kept until the next collectHeaders, so a later response can't reuse it
+		collectRetryAfter(*http);
 	}
+	return err;
+}
+
+namespace {
+std::shared_ptr<cal::Error> toParseError(DeserializationError err) {
+	String errStr = err.f_str();
+	log_w("deserializeJson() failed with code %s", errStr.c_str());
+	return std::make_shared<cal::Error>(cal::Error::Type::PARSE,
+	                                    "deserializeJson() failed with code " + errStr);
+}
+}  // namespace
+
+std::shared_ptr<cal::Error> parseJSONResponse(JsonDocument& doc, int httpCode,
+                                              const String& responseBody, HTTPClient* http) {
+	auto httpErr = checkHttpCode(httpCode, http);
+	if (httpErr)
+		return httpErr;
+
+	DeserializationError err = deserializeJson(doc, responseBody);
+	if (err)
+		return toParseError(err);
 
 	return nullptr;
 }
-}  // namespace cal
\ No newline at end of file
+
+std::shared_ptr<cal::Error> parseJSONStream(JsonDocument& doc, int httpCode, Stream& body,
+                                            const JsonDocument& filter, HTTPClient* http) {
+	auto httpErr = checkHttpCode(httpCode, http);
+	if (httpErr)
+		return httpErr;
+
+	DeserializationError err
+	    = deserializeJson(doc, body, DeserializationOption::Filter(filter.as<JsonVariantConst>()));
+	if (err)
+		return toParseError(err);
+
+	return nullptr;
+}
+
+time_t parseJsonTimestamp(JsonVariantConst value) {
+	const JsonString text = value.as<JsonString>();
+	return text.isNull() ? 0 : timeutils::parseRfcTimestamp(text.c_str(), text.size());
+}
+
+RoomStatus roomStatusFromBusy(const String& name, std::vector<BusyPeriod>& busy, time_t now) {
+	std::sort(busy.begin(), busy.end(),
+	          [](const BusyPeriod& a, const BusyPeriod& b) { return a.start < b.start; });
+
+	RoomStatus status{name, RoomStatus::State::FREE, 0};
+	for (const BusyPeriod& period : busy) {
+		if (period.end <= now)
+			continue;
+		if (status.state == RoomStatus::State::BUSY) {
+			// Extend the current booking by the ones starting right after it
+			if (period.start > status.until)
+				break;
+			status.until = max(status.until, period.end);
+		} else if (period.start <= now) {
+			status.state = RoomStatus::State::BUSY;
+			status.until = period.end;
+		} else {
+			status.until = period.start;
+			break;
+		}
+	}
+	return status;
+}
+}  // namespace cal
@@ -4,11 +4,17 @@
 #include <Arduino.h>
 
 #include <memory>
+#include <vector>
 
 #include "utils.h"
 
+class HTTPClient;
+
 namespace cal {
 
+// Access tokens are refreshed when they would expire within this margin
+const time_t TOKEN_EXPIRY_MARGIN_S = 60;
+
 struct Token {
 	String accessToken;
 	String refreshToken;
@@ -56,6 +62,10 @@ struct Error {
 	Error(Type type, const String& message) : type{type}, message{message} {}
 	Type type;
 	String message;
+	// Status code of an HTTP error, negative for the connection errors of HTTPClient
+	int httpCode = 0;
+	// Seconds to wait before the next request, e.g. from the Retry-After of a 429 response
+	time_t retryAfter = 0;
 };
 
 struct CalendarStatus {
@@ -64,6 +74,30 @@ struct CalendarStatus {
 	std::shared_ptr<Event> nextEvent;
 };
 
+/**
+ * Room of the dashboard mode, id is a calendar id or a room email depending on the provider.
+ */
+struct Room {
+	String name;
+	String id;
+};
+
+struct RoomStatus {
+	enum class State { FREE, BUSY, UNKNOWN };
+	String name;
+	State state;
+	// End of the current booking when busy, start of the next booking when free.
+	// Zero when free for the rest of the day.
+	time_t until;
+
+	bool operator==(const RoomStatus& other) const {
+		return name == other.name && state == other.state && until == other.until;
+	};
+};
+
+// Rooms fetched in one request, a dashboard grid has no room for more
+const size_t ROOMS_MAX = 12;
+
 template <typename T>
 using Result = utils::Result<T, Error>;
 
@@ -81,9 +115,12 @@ class API {
 	 * Fetch new access tokens from API to ensure that other
 	 * API functions can be called.
 	 * Should be called every time before calling other functions.
-	 * Should only refresh if token is actually close to expiration.
+	 * Should only refresh if token expires before validUntil.
 	 */
-	virtual bool refreshAuth() = 0;
+	virtual bool refreshAuth(time_t validUntil) = 0;
+
+	// Expiry of the current access token, unix epoch seconds
+	virtual time_t getTokenExpiry() = 0;
 
 	virtual void registerSaveTokenFunc(std::function<void(const Token&)> saveTokenFunc) = 0;
 
@@ -115,14 +152,68 @@ class API {
 	virtual Result<Event> rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
 	                                      time_t newEndTime)
 	    = 0;
+
+	/**
+	 * Fetch whether each room is busy now and until when, in a single request.
+	 * Statuses are in the order of rooms, rooms that the provider can't read are UNKNOWN.
+	 * At most ROOMS_MAX rooms.
+	 */
+	virtual Result<std::vector<RoomStatus>> fetchRoomStatuses(const std::vector<Room>& rooms) = 0;
 };
 
 // Helpers:
 utils::Result<Token, utils::Error> jsonToToken(JsonObjectConst obj);
 void tokenToJson(JsonObject& resultObj, const Token& token);
 
+/**
+ * Access tokens are persisted in NVS instead of config.json, so that the first request after
+ * a boot doesn't need a refresh round-trip. The stored token is tied to the refresh token and
+ * ignored if the credentials in config.json change.
+ * NVS isn't encrypted, which exposes no more than the refresh token and client secret that
+ * config.json already holds on the unencrypted filesystem.
+ */
+void saveAccessToken(const Token& token);
+bool loadAccessToken(Token& token);
+
+/**
+ * Error of a response with a negative HTTPClient code or a non 2xx status, nullptr if ok.
+ * With http, the Retry-After of 429 and 503 responses goes to the retryAfter of the error.
+ */
+std::shared_ptr<cal::Error> checkHttpCode(int httpCode, HTTPClient* http = nullptr);
+
+/**
+ * Keep the Retry-After header of the responses of http for checkHttpCode.
+ * Call once when creating the client.
+ */
+void collectRetryAfter(HTTPClient& http);
+
 std::shared_ptr<cal::Error> parseJSONResponse(JsonDocument& doc, int httpCode,
-                                              const String& responseBody);
+                                              const String& responseBody,
+                                              HTTPClient* http = nullptr);
+
+/**
+ * Same as parseJSONResponse, but reads the body straight from the connection and keeps only
+ * the fields in filter, so the document size doesn't depend on the size of the response.
+ */
+std::shared_ptr<cal::Error> parseJSONStream(JsonDocument& doc, int httpCode, Stream& body,
+                                            const JsonDocument& filter,
+                                            HTTPClient* http = nullptr);
+
+/**
+ * RFC 3339 time of a JSON string, read in place from the document. 0 if it is not a string.
+ */
+time_t parseJsonTimestamp(JsonVariantConst value);
+
+struct BusyPeriod {
+	time_t start;
+	time_t end;
+};
+
+/**
+ * Room status from the busy periods of the room, sorts busy by start time.
+ * Adjacent periods are merged, so a room booked back to back is busy until the last one ends.
+ */
+RoomStatus roomStatusFromBusy(const String& name, std::vector<BusyPeriod>& busy, time_t now);
 
 }  // namespace cal
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "WiFi.h"
 #include "globals.h"
+#include "resumeState.h"
 
 #define API_QUEUE_LENGTH 10
 #define API_TASK_PRIORITY 5
@@ -9,47 +10,146 @@
 #define API_TASK_WIFI_CONNECT_MAX_RETRIES 7
 #define API_TASK_AUTH_MAX_RETRIES 3
 
+// Tokens are refreshed this long before they expire, so that a touch wake never waits for it
+#define API_TASK_TOKEN_REFRESH_AHEAD_S (STATUS_UPDATE_INTERVAL_S + 5 * SECS_PER_MIN)
+// The refresh may run this much earlier to share a wake with a status poll
+#define API_TASK_TOKEN_REFRESH_SLACK_S (15 * SECS_PER_MIN)
+// Bursts of user actions pass, a request loop is slowed to one request in 10 seconds
+#define API_TASK_RATE_LIMIT_BURST 6
+#define API_TASK_RATE_LIMIT_REFILL_S 10
+
 namespace cal {
+const std::array<const char*, (size_t)APITask::RequestType::SIZE> APITask::requestTypeNames{
+    "calendar_status",
+    "end_event",
+    "insert_event",
+    "reschedule_event",
+    "refresh_auth",
+    "network_job",
+    "room_statuses",
+};
+
+namespace {
+/**
+ * Runs func unless the rate limiter held the request back, err gets the error of the result.
+ */
+template <typename T>
+Result<T> runLimited(const std::function<Result<T>()>& func, std::shared_ptr<Error> heldBack,
+                     std::shared_ptr<Error>& err) {
+	Result<T> result = heldBack ? Result<T>::makeErr(heldBack) : func();
+	if (result.isErr())
+		err = result.err();
+	return result;
+}
+
+/**
+ * Frees the function of a request that was not run.
+ */
+void deleteFunc(APITask::RequestType type, void* func) {
+	switch (type) {
+		case APITask::RequestType::CALENDAR_STATUS:
+			delete static_cast<APITask::QueueFuncCalendarStatus*>(func);
+			break;
+		case APITask::RequestType::END_EVENT:
+		case APITask::RequestType::INSERT_EVENT:
+		case APITask::RequestType::RESCHEDULE_EVENT:
+			delete static_cast<APITask::QueueFuncEvent*>(func);
+			break;
+		case APITask::RequestType::ROOM_STATUSES:
+			delete static_cast<APITask::QueueFuncRoomStatuses*>(func);
+			break;
+		case APITask::RequestType::REFRESH_AUTH:
+			delete static_cast<time_t*>(func);
+			break;
+		case APITask::RequestType::NETWORK_JOB:
+			delete static_cast<APITask::QueueFuncJob*>(func);
+			break;
+		default:
+			log_e("APITask: Unhandled request type %u", type);
+			break;
+	}
+}
+}  // namespace
+
 void task(void* arg) {
 	APITask* apiTask = static_cast<APITask*>(arg);
 
 	for (;;) {
 		void* reqTemp;
 		xQueueReceive(apiTask->_queueHandle, &reqTemp, portMAX_DELAY);
-		auto count = sleepManager.scopedTaskCount();
+		auto count = sleepManager.adoptTaskCount();
 		auto req = toSmartPtr<APITask::QueueElement>(reqTemp);
 
 		auto startTime = millis();
 
+		// Held back requests fail right away, without connecting WiFi
+		std::shared_ptr<Error> heldBack;
+		if (req->type != APITask::RequestType::NETWORK_JOB) {
+			const time_t now = safeUTC.now();
+			const time_t until = apiTask->rateLimiter.acquire(now);
+			if (until) {
+				heldBack = RateLimiter::heldBackError(until, now);
+				log_w("APITask: %s held back, %s", APITask::requestTypeNames[(size_t)req->type],
+				      heldBack->message.c_str());
+			}
+		}
+
 		// TODO: return different error when wifi connection fails (don't leak memory of req->func)
-		wifiManager.waitWiFi();
+		if (!heldBack)
+			wifiManager.waitWiFi();
+
+		time_t validUntil = safeUTC.now() + TOKEN_EXPIRY_MARGIN_S;
+		if (req->type == APITask::RequestType::REFRESH_AUTH) {
+			auto requested = toSmartPtr<time_t>(req->func);
+			validUntil = max(validUntil, *requested);
+		}
 
+		// Tokens are normally refreshed ahead of time with REFRESH_AUTH, so this is the rare path.
 		// TODO: return error when auth refresh fails (don't leak memory of req->func)
-		for (int i = 0; i < API_TASK_AUTH_MAX_RETRIES; ++i) {
-			if (apiTask->_api->refreshAuth())
-				break;
-			delay(200);
+		if (req->type != APITask::RequestType::NETWORK_JOB && !heldBack) {
+			for (int i = 0; i < API_TASK_AUTH_MAX_RETRIES; ++i) {
+				if (apiTask->_api->refreshAuth(validUntil))
+					break;
+				delay(200);
+			}
+			apiTask->tokenExpiry = apiTask->_api->getTokenExpiry();
 		}
+		if (req->type != APITask::RequestType::NETWORK_JOB)
+			apiTask->scheduleTokenRefresh();
 
+		std::shared_ptr<Error> err;
 		switch (req->type) {
 			case APITask::RequestType::CALENDAR_STATUS: {
 				auto func = toSmartPtr<APITask::QueueFuncCalendarStatus>(req->func);
-				apiTask->callbackCalendarStatus((*func)());
+				apiTask->callbackCalendarStatus(runLimited(*func, heldBack, err));
 				break;
 			}
 			case APITask::RequestType::END_EVENT: {
 				auto func = toSmartPtr<APITask::QueueFuncEvent>(req->func);
-				apiTask->callbackEndEvent((*func)());
+				apiTask->callbackEndEvent(runLimited(*func, heldBack, err));
 				break;
 			}
 			case APITask::RequestType::INSERT_EVENT: {
 				auto func = toSmartPtr<APITask::QueueFuncEvent>(req->func);
-				apiTask->callbackInsertEvent((*func)());
+				apiTask->callbackInsertEvent(runLimited(*func, heldBack, err));
 				break;
 			}
 			case APITask::RequestType::RESCHEDULE_EVENT: {
 				auto func = toSmartPtr<APITask::QueueFuncEvent>(req->func);
-				apiTask->callbackRescheduleEvent((*func)());
+				apiTask->callbackRescheduleEvent(runLimited(*func, heldBack, err));
+				break;
+			}
+			case APITask::RequestType::ROOM_STATUSES: {
+				auto func = toSmartPtr<APITask::QueueFuncRoomStatuses>(req->func);
+				apiTask->callbackRoomStatuses(runLimited(*func, heldBack, err));
+				break;
+			}
+			case APITask::RequestType::REFRESH_AUTH:
+				// Already handled above, held back refreshes are retried at the next deadline
+				break;
+			case APITask::RequestType::NETWORK_JOB: {
+				auto func = toSmartPtr<APITask::QueueFuncJob>(req->func);
+				(*func)();
 				break;
 			}
 			default:
@@ -57,7 +157,15 @@ void task(void* arg) {
 				break;
 		}
 
-		log_i("Request completed in %u ms.", millis() - startTime);
+		// Refreshes only tell whether they succeeded, not whether the provider throttled them
+		if (!heldBack && req->type != APITask::RequestType::NETWORK_JOB
+		    && req->type != APITask::RequestType::REFRESH_AUTH)
+			apiTask->rateLimiter.record(err.get(), safeUTC.now());
+
+		const uint32_t elapsedMs = millis() - startTime;
+		log_i("Request completed in %u ms.", elapsedMs);
+		energyLedger.addTaskBusy(EnergyLedger::Task::API, elapsedMs);
+		metrics.observeRequest(req->type, elapsedMs);
 	}
 
 	vTaskDelete(NULL);
@@ -84,12 +192,43 @@ void APITask::rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
 	        }));
 }
 
+void APITask::fetchRoomStatuses(const std::vector<Room>& rooms) {
+	enqueue(RequestType::ROOM_STATUSES,
+	        new QueueFuncRoomStatuses([=]() { return _api->fetchRoomStatuses(rooms); }));
+}
+
+void APITask::refreshAuth(time_t validUntil) {
+	enqueue(RequestType::REFRESH_AUTH, new time_t(validUntil));
+}
+
+void APITask::runNetworkJob(const QueueFuncJob& job) {
+	enqueue(RequestType::NETWORK_JOB, new QueueFuncJob(job));
+}
+
+void APITask::scheduleTokenRefresh() {
+	time_t expiry = tokenExpiry;
+	if (expiry == 0)
+		return;  // No token yet, the first request gets one
+	// Retry at the next status poll if the refresh failed and the token is about to expire
+	time_t deadline = max(expiry - API_TASK_TOKEN_REFRESH_AHEAD_S,
+	                      safeUTC.now() + STATUS_UPDATE_INTERVAL_S);
+	scheduler.setDeadline(Scheduler::Job::TOKEN_REFRESH, deadline);
+}
+
 void APITask::enqueue(RequestType rt, void* func) {
 	QueueElement* data = new QueueElement{rt, func};
-	xQueueSend(_queueHandle, (void*)&data, 0);
+	// Keep awake until the request is completed, the task adopts this count
+	sleepManager.incrementTaskCounter();
+	if (xQueueSend(_queueHandle, (void*)&data, 0) != pdTRUE) {
+		log_e("APITask: queue full, request dropped");
+		sleepManager.decrementTaskCounter();
+		deleteFunc(rt, func);
+		delete data;
+	}
 };
 
-APITask::APITask(std::unique_ptr<API>&& api) : _api{std::move(api)} {
+APITask::APITask(std::unique_ptr<API>&& api)
+    : rateLimiter{API_TASK_RATE_LIMIT_BURST, API_TASK_RATE_LIMIT_REFILL_S}, _api{std::move(api)} {
 	_queueHandle = xQueueCreate(API_QUEUE_LENGTH, sizeof(APITask::QueueElement*));
 	assert(_queueHandle != NULL);
 
@@ -97,6 +236,19 @@ APITask::APITask(std::unique_ptr<API>&& api) : _api{std::move(api)} {
 	    = xTaskCreatePinnedToCore(task, "API Task", API_TASK_STACK_SIZE, static_cast<void*>(this),
 	                              API_TASK_PRIORITY, &_taskHandle, 1);
 	assert(taskCreateRes == pdPASS);
+	metrics.registerTask("api", _taskHandle, _queueHandle);
+
+	tokenExpiry = _api->getTokenExpiry();
+
+	scheduler.addJob(Scheduler::Job::TOKEN_REFRESH, 0, API_TASK_TOKEN_REFRESH_SLACK_S, [this]() {
+		log_i("Refreshing token in the background.");
+		// The window opens before the token expires, so ask for a token that outlives it
+		refreshAuth(tokenExpiry + 1);
+	});
+	scheduleTokenRefresh();
+
+	sleepManager.registerCallback(SleepManager::Callback::BEFORE_DEEP_SLEEP,
+	                              [this]() { resume::saveRateLimit(rateLimiter.getState()); });
 }
 
 }  // namespace cal
\ No newline at end of file
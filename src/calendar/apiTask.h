@@ -5,9 +5,12 @@
 #include <esp_event.h>
 #include <ezTime.h>
 
+#include <array>
+#include <atomic>
 #include <memory>
 
 #include "api.h"
+#include "rateLimiter.h"
 
 namespace cal {
 
@@ -15,7 +18,18 @@ class APITask {
   public:
 	APITask(std::unique_ptr<API>&& api);
 
-	enum class RequestType { CALENDAR_STATUS, END_EVENT, INSERT_EVENT, RESCHEDULE_EVENT };
+	enum class RequestType {
+		CALENDAR_STATUS,
+		END_EVENT,
+		INSERT_EVENT,
+		RESCHEDULE_EVENT,
+		REFRESH_AUTH,
+		NETWORK_JOB,
+		ROOM_STATUSES,
+		SIZE
+	};
+	static const std::array<const char*, (size_t)RequestType::SIZE> requestTypeNames;
+
 	struct QueueElement {
 		QueueElement(RequestType t, void* func) : type{t}, func{func} {}
 		RequestType type;
@@ -23,6 +37,8 @@ class APITask {
 	};
 	using QueueFuncCalendarStatus = std::function<Result<CalendarStatus>()>;
 	using QueueFuncEvent = std::function<Result<Event>()>;
+	using QueueFuncRoomStatuses = std::function<Result<std::vector<RoomStatus>>()>;
+	using QueueFuncJob = std::function<void()>;
 
 	// Callback must be set before calling
 	void fetchCalendarStatus();
@@ -40,6 +56,30 @@ class APITask {
 	void rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime, time_t newEndTime);
 	std::function<void(const Result<Event>&)> callbackRescheduleEvent;
 
+	// Callback must be set before calling
+	void fetchRoomStatuses(const std::vector<Room>& rooms);
+	std::function<void(const Result<std::vector<RoomStatus>>&)> callbackRoomStatuses;
+
+	/**
+	 * Refresh the access token in the background if it expires before validUntil.
+	 * Used to refresh during idle wakes, so that interactive requests don't wait for it.
+	 */
+	void refreshAuth(time_t validUntil);
+
+	/**
+	 * Run a job that needs the network but not the calendar API, e.g. a firmware version check.
+	 */
+	void runNetworkJob(const QueueFuncJob& job);
+
+	// Expiry of the current access token, readable from any task
+	std::atomic<time_t> tokenExpiry{0};
+	// Limits the requests of all types, a device has a single provider credential
+	RateLimiter rateLimiter;
+	/**
+	 * Schedule the next token refresh ahead of the current expiry.
+	 */
+	void scheduleTokenRefresh();
+
 	const std::unique_ptr<API> _api;
 	QueueHandle_t _queueHandle;
 
@@ -0,0 +1,871 @@
+#include "caldavApi.h"
+
+#include "globals.h"
+#include "timeUtils.h"
+#include "trace.h"
+
+namespace cal {
+
+namespace {
+const unsigned long READ_TIMEOUT_MS = 10 * 1000;
+const size_t READ_BUFFER_SIZE = 256;
+const size_t HREF_MAX_SIZE = 256;
+// A calendar object is read whole only when the device changes one of its events
+const size_t OBJECT_MAX_SIZE = 16 * 1024;
+// Bookings of a room kept for its status, more than a day of the dashboard has
+const size_t BUSY_MAX = 32;
+// Rewrites of an object that another client keeps changing between our GET and PUT
+const int CHANGE_MAX_ATTEMPTS = 3;
+
+// Retry-After for checkHttpCode, ETag for the If-Match of the PUT of a change
+const char* OBJECT_HEADERS[] = {"Retry-After", "ETag"};
+
+const char* QUERY_START
+    = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+      "<C:calendar-query xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">"
+      "<D:prop><C:calendar-data/></D:prop><C:filter>"
+      "<C:comp-filter name=\"VCALENDAR\"><C:comp-filter name=\"VEVENT\"><C:time-range start=\"";
+const char* QUERY_END = "\"/></C:comp-filter></C:comp-filter></C:filter></C:calendar-query>";
+const char* NAME_QUERY
+    = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+      "<D:propfind xmlns:D=\"DAV:\"><D:prop><D:displayname/></D:prop></D:propfind>";
+
+/**
+ * Picks the hrefs, the display name and the calendar-data texts out of a WebDAV multistatus
+ * response as it arrives, without building a tree. Calendar data goes to the parser with
+ * entities and CDATA decoded.
+ */
+class MultistatusScanner {
+  public:
+	explicit MultistatusScanner(ics::Parser* parser) : _parser(parser) {}
+
+	void feed(char c);
+	// The closing tag of the multistatus has been read
+	bool done() const { return _done; }
+	const char* href() const { return _href; }
+	const char* displayName() const { return _displayName; }
+
+  private:
+	enum class State : uint8_t { TEXT, TAG, ENTITY, MARKUP, CDATA };
+	enum class Field : uint8_t { NONE, HREF, DISPLAY_NAME, CALENDAR_DATA };
+
+	void _text(char c);
+	void _endTag();
+	void _endEntity();
+
+	ics::Parser* _parser;
+	State _state = State::TEXT;
+	Field _field = Field::NONE;
+	bool _done = false;
+
+	// Local name of the tag, without the namespace prefix
+	char _tag[32];
+	size_t _tagLength = 0;
+	bool _tagNameDone = false;
+	bool _closing = false;
+	bool _selfClosing = false;
+	char _quote = 0;
+
+	char _entity[12];
+	size_t _entityLength = 0;
+	// Characters of "[CDATA[" matched after "<!", SKIP_MARKUP for comments and declarations
+	uint8_t _markupMatched = 0;
+	uint8_t _brackets = 0;
+
+	char _href[HREF_MAX_SIZE] = "";
+	size_t _hrefLength = 0;
+	char _displayName[ics::TEXT_MAX_SIZE] = "";
+	size_t _displayNameLength = 0;
+
+	static const uint8_t SKIP_MARKUP = 0xFF;
+};
+
+void MultistatusScanner::feed(char c) {
+	switch (_state) {
+		case State::TEXT:
+			if (c == '<') {
+				_state = State::TAG;
+				_tagLength = 0;
+				_tagNameDone = false;
+				_closing = false;
+				_selfClosing = false;
+				_quote = 0;
+			} else if (c == '&') {
+				_state = State::ENTITY;
+				_entityLength = 0;
+			} else {
+				_text(c);
+			}
+			break;
+		case State::ENTITY:
+			if (c == ';') {
+				_endEntity();
+				_state = State::TEXT;
+			} else if (_entityLength < sizeof(_entity) - 1) {
+				_entity[_entityLength++] = c;
+			} else {
+				// Not an entity after all, drop it
+				_state = State::TEXT;
+			}
+			break;
+		case State::TAG:
+			if (_quote) {
+				if (c == _quote)
+					_quote = 0;
+			} else if (c == '>') {
+				_endTag();
+				_state = State::TEXT;
+			} else if (_tagLength == 0 && !_closing && (c == '!' || c == '?')) {
+				_state = State::MARKUP;
+				_markupMatched = c == '!' ? 0 : SKIP_MARKUP;
+			} else if (_tagLength == 0 && !_tagNameDone && c == '/') {
+				_closing = true;
+			} else if (c == '"' || c == '\'') {
+				_quote = c;
+				_tagNameDone = true;
+			} else {
+				_selfClosing = c == '/';
+				if (isSpace(c) || c == '/') {
+					_tagNameDone = _tagNameDone || _tagLength > 0;
+				} else if (!_tagNameDone) {
+					if (c == ':')
+						_tagLength = 0;
+					else if (_tagLength < sizeof(_tag) - 1)
+						_tag[_tagLength++] = c;
+				}
+			}
+			break;
+		case State::MARKUP: {
+			static const char CDATA_START[] = "[CDATA[";
+			if (_markupMatched != SKIP_MARKUP && c == CDATA_START[_markupMatched]) {
+				if (++_markupMatched == sizeof(CDATA_START) - 1) {
+					_state = State::CDATA;
+					_brackets = 0;
+				}
+			} else if (c == '>') {
+				_state = State::TEXT;
+			} else {
+				_markupMatched = SKIP_MARKUP;
+			}
+			break;
+		}
+		case State::CDATA:
+			if (c == ']') {
+				_brackets = min(_brackets + 1, 3);
+				// Only the last two can end the section, the rest is text
+				if (_brackets == 3) {
+					_text(']');
+					_brackets = 2;
+				}
+			} else if (c == '>' && _brackets == 2) {
+				_state = State::TEXT;
+			} else {
+				for (; _brackets > 0; _brackets--) _text(']');
+				_text(c);
+			}
+			break;
+	}
+}
+
+void MultistatusScanner::_text(char c) {
+	switch (_field) {
+		case Field::HREF:
+			if (_hrefLength < sizeof(_href) - 1 && !(_hrefLength == 0 && isSpace(c)))
+				_href[_hrefLength++] = c;
+			break;
+		case Field::DISPLAY_NAME:
+			if (_displayNameLength < sizeof(_displayName) - 1)
+				_displayName[_displayNameLength++] = c;
+			break;
+		case Field::CALENDAR_DATA:
+			_parser->feed(c);
+			break;
+		default:
+			break;
+	}
+}
+
+void MultistatusScanner::_endTag() {
+	_tag[_tagLength] = '\0';
+	if (_closing) {
+		if (_field == Field::HREF) {
+			while (_hrefLength > 0 && isSpace(_href[_hrefLength - 1])) _hrefLength--;
+			_href[_hrefLength] = '\0';
+		} else if (_field == Field::DISPLAY_NAME) {
+			_displayName[_displayNameLength] = '\0';
+		} else if (_field == Field::CALENDAR_DATA) {
+			_parser->endObject();
+		} else if (!strcmp(_tag, "multistatus")) {
+			_done = true;
+		}
+		_field = Field::NONE;
+		return;
+	}
+	if (_selfClosing)
+		return;
+
+	if (!strcmp(_tag, "href")) {
+		_field = Field::HREF;
+		_hrefLength = 0;
+	} else if (!strcmp(_tag, "displayname")) {
+		_field = Field::DISPLAY_NAME;
+		_displayNameLength = 0;
+	} else if (!strcmp(_tag, "calendar-data") && _parser) {
+		_field = Field::CALENDAR_DATA;
+	}
+}
+
+void MultistatusScanner::_endEntity() {
+	_entity[_entityLength] = '\0';
+	uint32_t code = 0;
+	if (_entity[0] == '#')
+		code = _entity[1] == 'x' || _entity[1] == 'X' ? strtoul(_entity + 2, nullptr, 16)
+		                                              : strtoul(_entity + 1, nullptr, 10);
+	else if (!strcmp(_entity, "lt"))
+		code = '<';
+	else if (!strcmp(_entity, "gt"))
+		code = '>';
+	else if (!strcmp(_entity, "amp"))
+		code = '&';
+	else if (!strcmp(_entity, "quot"))
+		code = '"';
+	else if (!strcmp(_entity, "apos"))
+		code = '\'';
+
+	// As UTF-8
+	if (code == 0) {
+		return;
+	} else if (code < 0x80) {
+		_text(code);
+	} else if (code < 0x800) {
+		_text(0xC0 | code >> 6);
+		_text(0x80 | (code & 0x3F));
+	} else if (code < 0x10000) {
+		_text(0xE0 | code >> 12);
+		_text(0x80 | (code >> 6 & 0x3F));
+		_text(0x80 | (code & 0x3F));
+	} else {
+		_text(0xF0 | code >> 18);
+		_text(0x80 | (code >> 12 & 0x3F));
+		_text(0x80 | (code >> 6 & 0x3F));
+		_text(0x80 | (code & 0x3F));
+	}
+}
+
+// A plain .ics file goes to the parser as is
+struct FeedSink {
+	ics::Parser& parser;
+	void feed(char c) { parser.feed(c); }
+	bool done() const { return false; }
+};
+
+// Collects a calendar object, stops as soon as it is longer than limit
+struct StringSink {
+	String& text;
+	size_t limit;
+	void feed(char c) { text += c; }
+	bool done() const { return text.length() > limit; }
+};
+
+/**
+ * Feeds the response body to sink as it arrives, until the sink is done or the server closes
+ * the connection. Returns the number of bytes read.
+ */
+template <typename Sink>
+size_t readBody(HTTPClient& http, Sink& sink) {
+	Stream& stream = http.getStream();
+	char buffer[READ_BUFFER_SIZE];
+	size_t total = 0;
+	unsigned long lastRead = millis();
+	while (!sink.done()) {
+		const int available = stream.available();
+		if (available <= 0) {
+			if (!http.connected() || millis() - lastRead > READ_TIMEOUT_MS)
+				break;
+			delay(1);
+			continue;
+		}
+		const size_t read = stream.readBytes(buffer, min((size_t)available, sizeof(buffer)));
+		for (size_t i = 0; i < read; i++) sink.feed(buffer[i]);
+		total += read;
+		lastRead = millis();
+	}
+	return total;
+}
+
+// End of the local day in UTC, the status and rooms show today only
+time_t endOfToday() { return safeMyTZ.tzTime(timeutils::getNextMidnight(safeMyTZ.now())); }
+
+String escapeText(const String& text) {
+	String escaped;
+	escaped.reserve(text.length());
+	for (size_t i = 0; i < text.length(); i++) {
+		const char c = text[i];
+		if (c == '\\' || c == ';' || c == ',')
+			escaped += '\\';
+		if (c == '\n')
+			escaped += "\\n";
+		else
+			escaped += c;
+	}
+	return escaped;
+}
+
+/**
+ * Content lines of a calendar object with their spans as written, for rewriting the object.
+ */
+class LineReader {
+  public:
+	explicit LineReader(const String& text) : _text(text) {}
+
+	bool next() {
+		if (_position >= _text.length())
+			return false;
+		start = _position;
+		do {
+			const int newline = _text.indexOf('\n', _position);
+			_position = newline < 0 ? _text.length() : newline + 1;
+		} while (_position < _text.length()
+		         && (_text[_position] == ' ' || _text[_position] == '\t'));
+		end = _position;
+
+		String line = _text.substring(start, end);
+		line.replace("\r\n ", "");
+		line.replace("\r\n\t", "");
+		line.replace("\n ", "");
+		line.replace("\n\t", "");
+		line.trim();
+		int valueStart = -1;
+		bool quoted = false;
+		for (size_t i = 0; i < line.length() && valueStart < 0; i++) {
+			if (line[i] == '"')
+				quoted = !quoted;
+			else if (line[i] == ':' && !quoted)
+				valueStart = i;
+		}
+		const String head = valueStart < 0 ? line : line.substring(0, valueStart);
+		value = valueStart < 0 ? "" : line.substring(valueStart + 1);
+		const int paramsStart = head.indexOf(';');
+		name = paramsStart < 0 ? head : head.substring(0, paramsStart);
+		params = paramsStart < 0 ? "" : head.substring(paramsStart + 1);
+		return true;
+	}
+
+	// Span of the line including folds and the line break
+	size_t start = 0;
+	size_t end = 0;
+	// Unfolded
+	String name;
+	String params;
+	String value;
+
+  private:
+	const String& _text;
+	size_t _position = 0;
+};
+
+bool isOneOf(const String& name, const char* const* names) {
+	for (; *names; names++)
+		if (name.equalsIgnoreCase(*names))
+			return true;
+	return false;
+}
+
+/**
+ * Copies the VEVENT block to out without its top level properties in dropped, with inserted
+ * after the BEGIN line.
+ */
+void copyEvent(const String& block, const char* const* dropped, const String& inserted,
+               String& out) {
+	LineReader lines(block);
+	int depth = 0;
+	while (lines.next()) {
+		if (lines.name.equalsIgnoreCase("END"))
+			depth--;
+		const bool drop = depth == 1 && isOneOf(lines.name, dropped);
+		if (!drop) {
+			out += block.substring(lines.start, lines.end);
+			if (!out.endsWith("\n"))
+				out += "\r\n";
+		}
+		if (lines.name.equalsIgnoreCase("BEGIN") && ++depth == 1)
+			out += inserted;
+	}
+}
+
+String timesText(time_t start, time_t end) {
+	char text[17];
+	String times = "DTSTAMP:";
+	ics::formatUtc(safeUTC.now(), text);
+	times += String(text) + "\r\nDTSTART:";
+	ics::formatUtc(start, text);
+	times += String(text) + "\r\nDTEND:";
+	ics::formatUtc(end, text);
+	return times + text + "\r\n";
+}
+
+// RECURRENCE-ID in the same form as the DTSTART of the series, as RFC 5545 asks
+String recurrenceIdText(const ics::DateTime& seriesStart, time_t recurrenceId,
+                        ics::TimeResolver& resolver) {
+	char text[17];
+	switch (seriesStart.kind) {
+		case ics::DateTime::Kind::UTC:
+			ics::formatUtc(recurrenceId, text);
+			return "RECURRENCE-ID:" + String(text) + "\r\n";
+		case ics::DateTime::Kind::ZONED:
+			// The wall clock time formatted as if it was UTC, without the Z
+			ics::formatUtc(resolver.toLocal(recurrenceId, seriesStart.tzid), text);
+			text[15] = '\0';
+			return "RECURRENCE-ID;TZID=" + String(seriesStart.tzid) + ":" + text + "\r\n";
+		case ics::DateTime::Kind::DATE:
+			ics::formatUtc(resolver.toLocal(recurrenceId, ""), text);
+			text[8] = '\0';
+			return "RECURRENCE-ID;VALUE=DATE:" + String(text) + "\r\n";
+		default:
+			ics::formatUtc(resolver.toLocal(recurrenceId, ""), text);
+			text[15] = '\0';
+			return "RECURRENCE-ID:" + String(text) + "\r\n";
+	}
+}
+
+/**
+ * Moves an event of the calendar object to [newStart, newEnd), newStart zero keeps the start.
+ * A recurring instance without an override gets one after the series, with the properties of
+ * the series. Returns nullptr and the new object in out on success.
+ */
+std::shared_ptr<Error> rewriteObject(const String& object, time_t recurrenceId, time_t newStart,
+                                     time_t newEnd, ics::TimeResolver& resolver, String& out) {
+	struct Block {
+		size_t start = 0;
+		size_t end = 0;
+		ics::DateTime dtstart;
+	};
+	Block target;
+	Block series;
+
+	LineReader lines(object);
+	int depth = 0;
+	Block block;
+	time_t blockRecurrenceId = 0;
+	bool blockRecurs = false;
+	while (lines.next()) {
+		if (lines.name.equalsIgnoreCase("BEGIN")) {
+			if (depth > 0 || lines.value.equalsIgnoreCase("VEVENT")) {
+				if (++depth == 1) {
+					block = Block{lines.start};
+					blockRecurrenceId = 0;
+					blockRecurs = false;
+				}
+			}
+		} else if (lines.name.equalsIgnoreCase("END") && depth > 0) {
+			if (--depth > 0)
+				continue;
+			block.end = lines.end;
+			if (recurrenceId ? blockRecurrenceId == recurrenceId : !blockRecurrenceId) {
+				if (!target.end)
+					target = block;
+			} else if (recurrenceId && blockRecurs && !blockRecurrenceId) {
+				series = block;
+			}
+		} else if (depth == 1 && lines.name.equalsIgnoreCase("DTSTART")) {
+			ics::parseDateTime(lines.params.c_str(), lines.value.c_str(), block.dtstart);
+		} else if (depth == 1 && lines.name.equalsIgnoreCase("RECURRENCE-ID")) {
+			ics::DateTime time;
+			if (ics::parseDateTime(lines.params.c_str(), lines.value.c_str(), time))
+				blockRecurrenceId = resolver.toUtc(time);
+		} else if (depth == 1 && lines.name.equalsIgnoreCase("RRULE")) {
+			blockRecurs = true;
+		}
+	}
+
+	static const char* const TIMES[] = {"DTSTART", "DTEND", "DURATION", "DTSTAMP", nullptr};
+	if (target.end) {
+		const time_t start = newStart ? newStart : resolver.toUtc(target.dtstart);
+		out = object.substring(0, target.start);
+		copyEvent(object.substring(target.start, target.end), TIMES, timesText(start, newEnd),
+		          out);
+		out += object.substring(target.end);
+		return nullptr;
+	}
+	if (series.end) {
+		static const char* const SERIES[] = {"DTSTART", "DTEND", "DURATION", "DTSTAMP", "RRULE",
+		                                     "RDATE",   "EXDATE", "EXRULE",  nullptr};
+		const time_t start = newStart ? newStart : recurrenceId;
+		out = object.substring(0, series.end);
+		copyEvent(object.substring(series.start, series.end), SERIES,
+		          recurrenceIdText(series.dtstart, recurrenceId, resolver)
+		              + timesText(start, newEnd),
+		          out);
+		out += object.substring(series.end);
+		return nullptr;
+	}
+	return std::make_shared<Error>(Error::Type::LOGICAL, "Event not found in the calendar");
+}
+}  // namespace
+
+CalDAVAPI::CalDAVAPI(const String& calendarUrl, const String& username, const String& password)
+    : _calendarUrl{calendarUrl}, _username{username}, _password{password} {
+	_readOnly = _calendarUrl.endsWith(".ics");
+	if (!_readOnly && !_calendarUrl.endsWith("/"))
+		_calendarUrl += "/";
+	const int scheme = _calendarUrl.indexOf("://");
+	const int path = _calendarUrl.indexOf('/', scheme < 0 ? 0 : scheme + 3);
+	_origin = path < 0 ? _calendarUrl : _calendarUrl.substring(0, path);
+	_http.setReuse(false);
+	collectRetryAfter(_http);
+}
+
+void CalDAVAPI::begin(const String& url) {
+	_http.begin(url);
+	if (!_username.isEmpty())
+		_http.setAuthorization(_username.c_str(), _password.c_str());
+}
+
+String CalDAVAPI::resolve(const String& href) const {
+	if (href.startsWith("http://") || href.startsWith("https://"))
+		return href;
+	return _origin + (href.startsWith("/") ? "" : "/") + href;
+}
+
+std::shared_ptr<Error> CalDAVAPI::query(const String& url, time_t start, time_t end,
+                                        OccurrenceHandler handler) {
+	const bool file = url.endsWith(".ics");
+	MultistatusScanner scanner(&_parser);
+	_parser.begin(start, end, [&](const ics::Occurrence& occurrence) {
+		// Files are read-only, their events are only told apart
+		String id = file ? String(occurrence.uid) : String(scanner.href());
+		if (occurrence.recurrenceId)
+			id += "#" + String(occurrence.recurrenceId);
+		handler(id, occurrence);
+	});
+
+	// BUILD REQUEST
+	begin(url);
+	// HTTP/1.0 responses are not chunked, so the events can be parsed straight from the stream
+	_http.useHTTP10(true);
+
+	// SEND REQUEST
+	int httpCode;
+	if (file) {
+		httpCode = _http.GET();
+	} else {
+		char startText[17];
+		char endText[17];
+		ics::formatUtc(start, startText);
+		ics::formatUtc(end, endText);
+		_http.addHeader("Content-Type", "application/xml; charset=utf-8");
+		_http.addHeader("Depth", "1");
+		httpCode = _http.sendRequest("REPORT", String(QUERY_START) + startText + "\" end=\""
+		                                           + endText + QUERY_END);
+	}
+
+	// PARSE RESPONSE AS ICALENDAR
+	auto err = checkHttpCode(httpCode, &_http);
+	size_t size = 0;
+	if (!err && file) {
+		FeedSink sink{_parser};
+		size = readBody(_http, sink);
+		_parser.endObject();
+	} else if (!err) {
+		size = readBody(_http, scanner);
+		if (!scanner.done())
+			err = std::make_shared<Error>(Error::Type::PARSE, "CalDAV response ended early");
+	}
+	_http.end();
+	_http.useHTTP10(false);
+	TRACE_HTTP("Streamed %u bytes of events from %s", size, url.c_str());
+	return err;
+}
+
+Result<String> CalDAVAPI::getCalendarName() {
+	// Collection or file name, if the server has no display name
+	String path = _calendarUrl.substring(_origin.length());
+	if (path.endsWith("/"))
+		path.remove(path.length() - 1);
+	String name = path.substring(path.lastIndexOf('/') + 1);
+	if (_readOnly) {
+		name.replace(".ics", "");
+		return Result<String>::makeOk(new String(name));
+	}
+
+	// SEND REQUEST
+	begin(_calendarUrl);
+	_http.useHTTP10(true);
+	_http.addHeader("Content-Type", "application/xml; charset=utf-8");
+	_http.addHeader("Depth", "0");
+	int httpCode = _http.sendRequest("PROPFIND", NAME_QUERY);
+
+	// PARSE RESPONSE
+	auto err = checkHttpCode(httpCode, &_http);
+	MultistatusScanner scanner(nullptr);
+	if (!err)
+		readBody(_http, scanner);
+	_http.end();
+	_http.useHTTP10(false);
+	if (err)
+		return Result<String>::makeErr(err);
+
+	if (scanner.displayName()[0])
+		name = scanner.displayName();
+	return Result<String>::makeOk(new String(name));
+}
+
+Result<CalendarStatus> CalDAVAPI::fetchCalendarStatus() {
+	// Get calendar name if not already set
+	if (_calendarName.length() == 0) {
+		auto res = getCalendarName();
+		if (res.isErr())
+			return Result<CalendarStatus>::makeErr(res.err());
+		_calendarName = *res.ok();
+	}
+
+	auto status = std::make_shared<CalendarStatus>();
+	status->name = _calendarName;
+
+	// Events come in no particular order, keep the earliest current and next ones
+	const time_t now = safeUTC.now();
+	auto err = query(_calendarUrl, now, endOfToday(),
+	                 [&](const String& id, const ics::Occurrence& occurrence) {
+		                 // Whole day events are not shown, like with the other providers
+		                 if (occurrence.allDay)
+			                 return;
+		                 std::shared_ptr<Event>& slot
+		                     = occurrence.start <= now ? status->currentEvent : status->nextEvent;
+		                 if (slot && slot->unixStartTime <= occurrence.start)
+			                 return;
+		                 slot = std::make_shared<Event>(Event{
+		                     .id = id,
+		                     .creator = occurrence.creator,
+		                     .summary = occurrence.summary[0] ? occurrence.summary : "(No title)",
+		                     .unixStartTime = occurrence.start,
+		                     .unixEndTime = occurrence.end,
+		                 });
+	                 });
+	if (err)
+		return Result<CalendarStatus>::makeErr(err);
+	return Result<CalendarStatus>::makeOk(status);
+}
+
+Result<Event> CalDAVAPI::endEvent(const String& eventId) {
+	return changeEvent(eventId, 0, safeUTC.now());
+}
+
+Result<Event> CalDAVAPI::insertEvent(time_t startTime, time_t endTime) {
+	if (_readOnly) {
+		return Result<Event>::makeErr(
+		    new Error(Error::Type::LOGICAL, "The calendar is a read-only file"));
+	}
+
+	// Check that insertion is possible
+	Result<bool> isFreeRes = isFree(startTime, endTime);
+	if (isFreeRes.isErr())
+		return Result<Event>::makeErr(isFreeRes.err());
+	if (*isFreeRes.ok() == false) {
+		return Result<Event>::makeErr(new Error(
+		    Error::Type::LOGICAL, "Couldn't insert, it would overlap with another event"));
+	}
+
+	// CREATE PAYLOAD
+	// Also the file name, so nothing that the server would escape in its hrefs
+	const String uid = String(safeUTC.now()) + "-" + String(micros(), HEX) + "-m5booking";
+	const String summary = l10n.msg(L10nMessage::NEW_EVENT_SUMMARY);
+	String payload = "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//Monad Booking//M5Paper//EN\r\n"
+	                 "BEGIN:VEVENT\r\nUID:"
+	                 + uid + "\r\n" + timesText(startTime, endTime)
+	                 + "SUMMARY:" + escapeText(summary) + "\r\nEND:VEVENT\r\nEND:VCALENDAR\r\n";
+
+	// SEND REQUEST
+	const String href = _calendarUrl.substring(_origin.length()) + uid + ".ics";
+	begin(resolve(href));
+	_http.addHeader("Content-Type", "text/calendar; charset=utf-8");
+	// Never replace an existing object
+	_http.addHeader("If-None-Match", "*");
+	int httpCode = _http.PUT(payload);
+	payload.clear();
+	_http.end();
+
+	auto err = checkHttpCode(httpCode, &_http);
+	if (err)
+		return Result<Event>::makeErr(err);
+
+	return Result<Event>::makeOk(new Event{
+	    .id = href,
+	    .creator = _username,
+	    .summary = summary,
+	    .unixStartTime = startTime,
+	    .unixEndTime = endTime,
+	});
+}
+
+Result<Event> CalDAVAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
+                                         time_t newEndTime) {
+	// Check that rescheduling is possible
+	Result<bool> isFreeRes = isFree(newStartTime, newEndTime, event->id);
+	if (isFreeRes.isErr())
+		return Result<Event>::makeErr(isFreeRes.err());
+	if (*isFreeRes.ok() == false) {
+		return Result<Event>::makeErr(new Error(
+		    Error::Type::LOGICAL, "Couldn't reschedule, it would overlap with another event"));
+	}
+	return changeEvent(event->id, newStartTime, newEndTime);
+}
+
+Result<Event> CalDAVAPI::changeEvent(const String& eventId, time_t newStartTime,
+                                     time_t newEndTime) {
+	if (_readOnly) {
+		return Result<Event>::makeErr(
+		    new Error(Error::Type::LOGICAL, "The calendar is a read-only file"));
+	}
+	// 412 means the object changed after we read it, the change is redone on its new version
+	for (int attempt = 1;; attempt++) {
+		Result<Event> result = tryChangeEvent(eventId, newStartTime, newEndTime);
+		if (result.isOk() || result.err()->httpCode != 412)
+			return result;
+		if (attempt == CHANGE_MAX_ATTEMPTS) {
+			result.err()->message = "The event keeps changing on the server, try again";
+			return result;
+		}
+		log_w("Event %s changed on the server, retrying", eventId.c_str());
+	}
+}
+
+Result<Event> CalDAVAPI::tryChangeEvent(const String& eventId, time_t newStartTime,
+                                        time_t newEndTime) {
+	const int hash = eventId.indexOf('#');
+	const String href = hash < 0 ? eventId : eventId.substring(0, hash);
+	const time_t recurrenceId = hash < 0 ? 0 : eventId.substring(hash + 1).toInt();
+	const String url = resolve(href);
+
+	// GET THE CALENDAR OBJECT
+	begin(url);
+	// HTTP/1.0 responses are not chunked, so the read below is capped at the object itself
+	_http.useHTTP10(true);
+	_http.collectHeaders(OBJECT_HEADERS, sizeof(OBJECT_HEADERS) / sizeof(char*));
+	int httpCode = _http.GET();
+	// Read first, checkHttpCode collects only Retry-After from now on
+	const String etag = _http.header("ETag");
+	auto err = checkHttpCode(httpCode, &_http);
+	String object;
+	const int size = _http.getSize();
+	if (!err && size > (int)OBJECT_MAX_SIZE)
+		err = std::make_shared<Error>(Error::Type::PARSE, "Event is too large to change");
+	if (!err) {
+		// The size is unknown without Content-Length, the sink stops past the limit
+		if (size > 0)
+			object.reserve(size);
+		StringSink sink{object, OBJECT_MAX_SIZE};
+		readBody(_http, sink);
+		if (sink.done())
+			err = std::make_shared<Error>(Error::Type::PARSE, "Event is too large to change");
+		else if (size >= 0 && object.length() != (size_t)size)
+			err = std::make_shared<Error>(Error::Type::PARSE, "Event download ended early");
+	}
+	_http.end();
+	_http.useHTTP10(false);
+	if (err)
+		return Result<Event>::makeErr(err);
+
+	String payload;
+	err = rewriteObject(object, recurrenceId, newStartTime, newEndTime, _resolver, payload);
+	object.clear();
+	if (err)
+		return Result<Event>::makeErr(err);
+
+	// The changed event, also checks that the rewritten object parses
+	std::shared_ptr<Event> event;
+	_parser.begin(newEndTime - 1, newEndTime + 1,
+	              [&](const ics::Occurrence& occurrence) {
+		              if (occurrence.recurrenceId != recurrenceId || occurrence.end != newEndTime)
+			              return;
+		              event = std::make_shared<Event>(Event{
+		                  .id = eventId,
+		                  .creator = occurrence.creator,
+		                  .summary = occurrence.summary[0] ? occurrence.summary : "(No title)",
+		                  .unixStartTime = occurrence.start,
+		                  .unixEndTime = occurrence.end,
+		              });
+	              });
+	_parser.feed(payload.c_str(), payload.length());
+	_parser.endObject();
+	if (!event)
+		return Result<Event>::makeErr(new Error(Error::Type::PARSE, "Changed event not found"));
+
+	// SEND REQUEST
+	begin(url);
+	_http.addHeader("Content-Type", "text/calendar; charset=utf-8");
+	// Fails with 412 instead of overwriting a change made after the GET
+	if (!etag.isEmpty())
+		_http.addHeader("If-Match", etag);
+	httpCode = _http.PUT(payload);
+	payload.clear();
+	_http.end();
+	err = checkHttpCode(httpCode, &_http);
+	if (err)
+		return Result<Event>::makeErr(err);
+
+	return Result<Event>::makeOk(event);
+}
+
+Result<bool> CalDAVAPI::isFree(time_t startTime, time_t endTime, const String& ignoreId) {
+	bool free = true;
+	auto err = query(_calendarUrl, startTime, endTime,
+	                 [&](const String& id, const ics::Occurrence& occurrence) {
+		                 if (occurrence.busy && !occurrence.allDay && id != ignoreId)
+			                 free = false;
+	                 });
+	if (err)
+		return Result<bool>::makeErr(err);
+	return Result<bool>::makeOk(new bool(free));
+}
+
+Result<std::vector<RoomStatus>> CalDAVAPI::fetchRoomStatuses(const std::vector<Room>& rooms) {
+	using RoomsResult = Result<std::vector<RoomStatus>>;
+	if (rooms.size() > ROOMS_MAX) {
+		return RoomsResult::makeErr(new Error(Error::Type::LOGICAL, "Too many rooms, at most "
+		                                                                 + String(ROOMS_MAX)
+		                                                                 + " are supported"));
+	}
+
+	// CalDAV has no query over several calendars, so every room is a request of its own
+	const time_t now = safeUTC.now();
+	const time_t end = endOfToday();
+	auto statuses = new std::vector<RoomStatus>();
+	statuses->reserve(rooms.size());
+	std::vector<BusyPeriod> busy;
+	busy.reserve(BUSY_MAX);
+	std::shared_ptr<Error> lastErr;
+	size_t failed = 0;
+	for (const Room& room : rooms) {
+		String url = resolve(room.id);
+		if (!url.endsWith("/") && !url.endsWith(".ics"))
+			url += "/";
+
+		busy.clear();
+		auto err = query(url, now, end, [&](const String& id, const ics::Occurrence& occurrence) {
+			if (!occurrence.busy || occurrence.allDay)
+				return;
+			if (busy.size() == BUSY_MAX) {
+				log_w("Too many bookings in %s, dropped one", room.name.c_str());
+				return;
+			}
+			busy.push_back(BusyPeriod{occurrence.start, occurrence.end});
+		});
+		if (err) {
+			log_w("Room %s: %s", room.name.c_str(), err->message.c_str());
+			statuses->push_back(RoomStatus{room.name, RoomStatus::State::UNKNOWN, 0});
+			lastErr = err;
+			failed++;
+			continue;
+		}
+		statuses->push_back(roomStatusFromBusy(room.name, busy, now));
+	}
+
+	// A server that can't be reached at all is an error, not a grid of unknown rooms
+	if (!rooms.empty() && failed == rooms.size()) {
+		delete statuses;
+		return RoomsResult::makeErr(lastErr);
+	}
+	return RoomsResult::makeOk(statuses);
+}
+
+}  // namespace cal
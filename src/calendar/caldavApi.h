@@ -0,0 +1,87 @@
+#ifndef CALDAVAPI_H
+#define CALDAVAPI_H
+
+#include <HTTPClient.h>
+
+#include "api.h"
+#include "ics.h"
+
+namespace cal {
+
+/**
+ * Calendar of a CalDAV server, e.g. Radicale, Nextcloud or Baïkal, with HTTP basic auth.
+ *
+ * Events of a time range are fetched with a calendar-query REPORT and streamed through the
+ * iCalendar parser, so the memory used doesn't depend on the size of the calendar. Recurring
+ * events are expanded on the device, only inside the fetched range.
+ *
+ * Whole day events are not shown and don't make the room busy, they are usually notes like
+ * holidays. The url of a plain .ics file is shown read-only, bookings from the device fail.
+ */
+class CalDAVAPI : public API {
+  public:
+	/**
+	 * calendarUrl is the calendar collection, e.g. https://dav.example.com/rooms/room1/.
+	 * Room ids of the dashboard are collection urls or absolute paths on the same server.
+	 */
+	CalDAVAPI(const String& calendarUrl, const String& username, const String& password);
+
+	// Basic auth has no token
+	bool refreshAuth(time_t validUntil) override final { return true; }
+	time_t getTokenExpiry() override final { return 0; }
+	void registerSaveTokenFunc(std::function<void(const Token&)> saveTokenFunc) override final {}
+
+	Result<CalendarStatus> fetchCalendarStatus() override final;
+	Result<Event> endEvent(const String& eventId) override final;
+	Result<Event> insertEvent(time_t startTime, time_t endTime) override final;
+	Result<Event> rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
+	                              time_t newEndTime) override final;
+	Result<std::vector<RoomStatus>> fetchRoomStatuses(
+	    const std::vector<Room>& rooms) override final;
+
+  private:
+	// Event ids are the href of the calendar object, and "#" and the recurrence id for instances
+	using OccurrenceHandler = std::function<void(const String& id, const ics::Occurrence&)>;
+
+	/**
+	 * Streams the events of the calendar at url overlapping [start, end) to handler.
+	 */
+	std::shared_ptr<Error> query(const String& url, time_t start, time_t end,
+	                             OccurrenceHandler handler);
+
+	Result<bool> isFree(time_t startTime, time_t endTime, const String& ignoreId = "");
+
+	Result<String> getCalendarName();
+
+	/**
+	 * Moves the instance eventId to [newStartTime, newEndTime), newStartTime zero keeps the
+	 * start. An instance of a recurring event gets an override, the rest of the series stays.
+	 * The object is replaced only if it is still the version that was read, otherwise the
+	 * change is redone a few times before it fails.
+	 */
+	Result<Event> changeEvent(const String& eventId, time_t newStartTime, time_t newEndTime);
+	// One read and conditional write of changeEvent, an HTTP 412 error if the object changed
+	Result<Event> tryChangeEvent(const String& eventId, time_t newStartTime, time_t newEndTime);
+
+	void begin(const String& url);
+	// Absolute url of an href of the server
+	String resolve(const String& href) const;
+
+	String _calendarUrl;
+	String _username;
+	String _password;
+	// scheme://host[:port] of the calendar url
+	String _origin;
+	// A plain .ics file instead of a CalDAV collection
+	bool _readOnly;
+	String _calendarName;
+
+	ics::TimeResolver _resolver;
+	ics::Parser _parser{_resolver};
+
+	HTTPClient _http;
+};
+
+}  // namespace cal
+
+#endif
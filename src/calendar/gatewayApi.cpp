@@ -0,0 +1,168 @@
+#include "gatewayApi.h"
+
+#include "trace.h"
+
+namespace cal {
+
+namespace {
+const int32_t CONNECT_TIMEOUT_MS = 3000;
+// WiFiClient of this core takes its read timeout in seconds
+const uint32_t READ_TIMEOUT_S = 10;
+
+std::shared_ptr<Error> unexpectedResponse(gateway::Type type) {
+	log_w("Gateway: unexpected response type 0x%02x", (uint8_t)type);
+	return std::make_shared<Error>(Error::Type::PARSE, "Gateway: unexpected response");
+}
+}  // namespace
+
+GatewayAPI::GatewayAPI(const String& host, uint16_t port, const String& key,
+                       const String& calendarId)
+    : _host{host}, _port{port}, _key{key}, _calendarId{calendarId} {}
+
+std::shared_ptr<Error> GatewayAPI::exchange(const gateway::Request& request,
+                                            gateway::Response& response) {
+	const size_t requestSize = gateway::encodeRequest(request, _frame.data(), _frame.size());
+	if (requestSize == 0)
+		return std::make_shared<Error>(Error::Type::LOGICAL, "Gateway: request too large");
+
+	if (!_client.connect(_host.c_str(), _port, CONNECT_TIMEOUT_MS)) {
+		log_w("Gateway: connecting to %s:%u failed", _host.c_str(), _port);
+		return std::make_shared<Error>(Error::Type::HTTP, "Gateway: connection failed");
+	}
+	_client.setTimeout(READ_TIMEOUT_S);
+
+	if (_client.write(_frame.data(), requestSize) != requestSize) {
+		_client.stop();
+		return std::make_shared<Error>(Error::Type::HTTP, "Gateway: send failed");
+	}
+
+	int payloadSize = -1;
+	if (_client.readBytes((char*)_frame.data(), gateway::HEADER_SIZE) == gateway::HEADER_SIZE)
+		payloadSize = gateway::payloadSize(_frame.data());
+	const bool received = payloadSize >= 0
+	                      && _client.readBytes((char*)_frame.data() + gateway::HEADER_SIZE,
+	                                           payloadSize)
+	                             == (size_t)payloadSize;
+	_client.stop();
+	if (!received)
+		return std::make_shared<Error>(Error::Type::HTTP, "Gateway: no valid response");
+
+	const size_t responseSize = gateway::HEADER_SIZE + payloadSize;
+	TRACE_HTTP("Gateway: sent %u bytes, received %u bytes", requestSize, responseSize);
+	if (!gateway::decodeResponse(_frame.data(), responseSize, response))
+		return std::make_shared<Error>(Error::Type::PARSE, "Gateway: malformed response");
+
+	if (response.type == gateway::Type::ERROR) {
+		log_w("Gateway: %s", response.message.c_str());
+		auto err = std::make_shared<Error>(response.errorType, response.message);
+		err->retryAfter = response.retryAfter;
+		return err;
+	}
+	return nullptr;
+}
+
+Result<CalendarStatus> GatewayAPI::fetchCalendarStatus() {
+	gateway::Request request{};
+	request.type = gateway::Type::STATUS;
+	request.key = _key;
+	request.calendarId = _calendarId;
+	request.knownHash = _status ? _statusHash : 0;
+
+	gateway::Response response{};
+	auto err = exchange(request, response);
+	if (err)
+		return Result<CalendarStatus>::makeErr(err);
+
+	if (response.type == gateway::Type::STATUS_OK) {
+		_status = std::make_shared<CalendarStatus>(response.status);
+		_statusHash = response.hash;
+	} else if (response.type != gateway::Type::NOT_MODIFIED || !_status
+	           || response.hash != _statusHash) {
+		return Result<CalendarStatus>::makeErr(unexpectedResponse(response.type));
+	}
+
+	// The caller owns the result, the events are never modified so they can be shared
+	return Result<CalendarStatus>::makeOk(new CalendarStatus(*_status));
+}
+
+Result<Event> GatewayAPI::eventResult(const gateway::Request& request) {
+	gateway::Response response{};
+	auto err = exchange(request, response);
+	if (err)
+		return Result<Event>::makeErr(err);
+	if (response.type != gateway::Type::EVENT_OK)
+		return Result<Event>::makeErr(unexpectedResponse(response.type));
+
+	// The calendar changed, so the next status is fetched in full
+	_status = nullptr;
+	return Result<Event>::makeOk(new Event(response.event));
+}
+
+Result<Event> GatewayAPI::endEvent(const String& eventId) {
+	gateway::Request request{};
+	request.type = gateway::Type::END_EVENT;
+	request.key = _key;
+	request.calendarId = _calendarId;
+	request.eventId = eventId;
+	return eventResult(request);
+}
+
+Result<Event> GatewayAPI::insertEvent(time_t startTime, time_t endTime) {
+	gateway::Request request{};
+	request.type = gateway::Type::INSERT_EVENT;
+	request.key = _key;
+	request.calendarId = _calendarId;
+	request.startTime = startTime;
+	request.endTime = endTime;
+	return eventResult(request);
+}
+
+Result<Event> GatewayAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
+                                          time_t newEndTime) {
+	gateway::Request request{};
+	request.type = gateway::Type::RESCHEDULE_EVENT;
+	request.key = _key;
+	request.calendarId = _calendarId;
+	request.event = *event;
+	request.startTime = newStartTime;
+	request.endTime = newEndTime;
+	return eventResult(request);
+}
+
+Result<std::vector<RoomStatus>> GatewayAPI::fetchRoomStatuses(const std::vector<Room>& rooms) {
+	using RoomsResult = Result<std::vector<RoomStatus>>;
+	if (rooms.size() > ROOMS_MAX) {
+		return RoomsResult::makeErr(new Error(Error::Type::LOGICAL, "Too many rooms, at most "
+		                                                                 + String(ROOMS_MAX)
+		                                                                 + " are supported"));
+	}
+
+	gateway::Request request{};
+	request.type = gateway::Type::ROOM_STATUSES;
+	request.key = _key;
+	for (const Room& room : rooms) request.roomIds.push_back(room.id);
+	// The hash is only valid for the same rooms, the dashboard rooms don't change while running
+	request.knownHash = _roomStatuses.size() == rooms.size() ? _roomStatusesHash : 0;
+
+	gateway::Response response{};
+	auto err = exchange(request, response);
+	if (err)
+		return RoomsResult::makeErr(err);
+
+	if (response.type == gateway::Type::ROOM_STATUSES_OK) {
+		if (response.roomStatuses.size() != rooms.size())
+			return RoomsResult::makeErr(unexpectedResponse(response.type));
+		_roomStatuses = std::move(response.roomStatuses);
+		_roomStatusesHash = response.hash;
+	} else if (response.type != gateway::Type::NOT_MODIFIED
+	           || response.hash != _roomStatusesHash) {
+		return RoomsResult::makeErr(unexpectedResponse(response.type));
+	}
+
+	// Names are not sent, they come from the rooms
+	auto statuses = new std::vector<RoomStatus>(_roomStatuses);
+	for (size_t i = 0; i < rooms.size(); i++) (*statuses)[i].name = rooms[i].name;
+	return RoomsResult::makeOk(statuses);
+}
+
+}  // namespace cal
@@ -0,0 +1,61 @@
+#ifndef GATEWAY_API_H
+#define GATEWAY_API_H
+
+#include <WiFi.h>
+
+#include <array>
+
+#include "api.h"
+#include "gatewayProtocol.h"
+
+namespace cal {
+
+/**
+ * Calendar of a LAN gateway instead of the provider, see gateway/README.md.
+ * The gateway owns the provider token, so there is nothing to refresh on the device,
+ * and requests are plain TCP with small binary frames instead of HTTPS and json.
+ */
+class GatewayAPI : public API {
+  public:
+	GatewayAPI(const String& host, uint16_t port, const String& key, const String& calendarId);
+
+	bool refreshAuth(time_t validUntil) override final { return true; }
+	// No token, so the API task schedules no refresh
+	time_t getTokenExpiry() override final { return 0; }
+	Result<CalendarStatus> fetchCalendarStatus() override final;
+	Result<Event> endEvent(const String& eventId) override final;
+	Result<Event> insertEvent(time_t startTime, time_t endTime) override final;
+	Result<Event> rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
+	                              time_t newEndTime) override final;
+	Result<std::vector<RoomStatus>> fetchRoomStatuses(
+	    const std::vector<Room>& rooms) override final;
+
+	void registerSaveTokenFunc(std::function<void(const Token&)> saveTokenFunc) override final {}
+
+  private:
+	/**
+	 * Send request in its own connection and read the response.
+	 * Error frames of the gateway are returned as errors.
+	 */
+	std::shared_ptr<Error> exchange(const gateway::Request& request, gateway::Response& response);
+
+	Result<Event> eventResult(const gateway::Request& request);
+
+	String _host;
+	uint16_t _port;
+	String _key;
+	String _calendarId;
+
+	// Last statuses from the gateway, returned again when the gateway answers NOT_MODIFIED
+	std::shared_ptr<CalendarStatus> _status;
+	uint32_t _statusHash = 0;
+	std::vector<RoomStatus> _roomStatuses;
+	uint32_t _roomStatusesHash = 0;
+
+	WiFiClient _client;
+	std::array<uint8_t, gateway::FRAME_MAX_SIZE> _frame;
+};
+
+}  // namespace cal
+
+#endif
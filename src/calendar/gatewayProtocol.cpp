@@ -0,0 +1,386 @@
+#include "gatewayProtocol.h"
+
+namespace cal {
+namespace gateway {
+
+namespace {
+const uint8_t MAGIC[2] = {'M', 'B'};
+const size_t STRING_MAX_SIZE = 255;
+
+const uint8_t HAS_CURRENT_EVENT = 0x01;
+const uint8_t HAS_NEXT_EVENT = 0x02;
+
+/**
+ * Appends fields to a buffer, overflow is remembered and fails the whole frame.
+ */
+class Writer {
+  public:
+	Writer(uint8_t* buffer, size_t capacity)
+	    : _buffer(buffer), _capacity(min(capacity, FRAME_MAX_SIZE)) {}
+
+	void header(Type type) {
+		u8(MAGIC[0]);
+		u8(MAGIC[1]);
+		u8(PROTOCOL_VERSION);
+		u8((uint8_t)type);
+		u16(0);  // Payload size, set by finish()
+	}
+
+	void u8(uint8_t value) {
+		if (_size >= _capacity) {
+			_failed = true;
+			return;
+		}
+		_buffer[_size++] = value;
+	}
+
+	void u16(uint16_t value) {
+		u8(value >> 8);
+		u8(value);
+	}
+
+	void u32(uint32_t value) {
+		u16(value >> 16);
+		u16(value);
+	}
+
+	void time(time_t value) { u32(value > 0 ? (uint32_t)value : 0); }
+
+	// Long texts are cut at a character boundary
+	void text(const String& value) {
+		size_t length = min((size_t)value.length(), STRING_MAX_SIZE);
+		// Don't end in the middle of a multibyte character, continuation bytes are 10xxxxxx
+		if (length < value.length()) {
+			while (length > 0 && ((uint8_t)value[length] & 0xC0) == 0x80) length--;
+		}
+		bytes(value.c_str(), length);
+	}
+
+	// A cut id would point to the wrong thing, so a long id fails the frame
+	void id(const String& value) {
+		if (value.length() > STRING_MAX_SIZE) {
+			_failed = true;
+			return;
+		}
+		bytes(value.c_str(), value.length());
+	}
+
+	void event(const Event& event) {
+		id(event.id);
+		text(event.creator);
+		text(event.summary);
+		time(event.unixStartTime);
+		time(event.unixEndTime);
+	}
+
+	/**
+	 * Content after the header is used for hashing.
+	 */
+	const uint8_t* payload() const { return _buffer + HEADER_SIZE; }
+	size_t payloadSize() const { return _size - HEADER_SIZE; }
+
+	size_t finish() {
+		if (_failed || _size < HEADER_SIZE)
+			return 0;
+		const size_t size = payloadSize();
+		_buffer[4] = size >> 8;
+		_buffer[5] = size;
+		return _size;
+	}
+
+  private:
+	void bytes(const char* data, size_t length) {
+		u8(length);
+		if (_size + length > _capacity) {
+			_failed = true;
+			return;
+		}
+		memcpy(_buffer + _size, data, length);
+		_size += length;
+	}
+
+	uint8_t* _buffer;
+	size_t _capacity;
+	size_t _size = 0;
+	bool _failed = false;
+};
+
+/**
+ * Reads fields of a payload, reading past the end fails the whole frame.
+ */
+class Reader {
+  public:
+	Reader(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+	uint8_t u8() {
+		if (_position >= _size) {
+			_failed = true;
+			return 0;
+		}
+		return _data[_position++];
+	}
+
+	uint16_t u16() {
+		const uint16_t high = u8();
+		return high << 8 | u8();
+	}
+
+	uint32_t u32() {
+		const uint32_t high = u16();
+		return high << 16 | u16();
+	}
+
+	time_t time() { return u32(); }
+
+	String string() {
+		const size_t length = u8();
+		if (_position + length > _size) {
+			_failed = true;
+			return String();
+		}
+		String value((const char*)_data + _position, length);
+		_position += length;
+		return value;
+	}
+
+	Event event() {
+		Event event;
+		event.id = string();
+		event.creator = string();
+		event.summary = string();
+		event.unixStartTime = time();
+		event.unixEndTime = time();
+		return event;
+	}
+
+	// True if the whole payload was read without overflow
+	bool finished() const { return !_failed && _position == _size; }
+
+  private:
+	const uint8_t* _data;
+	size_t _size;
+	size_t _position = 0;
+	bool _failed = false;
+};
+
+void writeStatusContent(Writer& w, const CalendarStatus& status) {
+	w.text(status.name);
+	w.u8((status.currentEvent ? HAS_CURRENT_EVENT : 0) | (status.nextEvent ? HAS_NEXT_EVENT : 0));
+	if (status.currentEvent)
+		w.event(*status.currentEvent);
+	if (status.nextEvent)
+		w.event(*status.nextEvent);
+}
+
+void writeRoomStatusesContent(Writer& w, const std::vector<RoomStatus>& statuses) {
+	w.u8(statuses.size());
+	for (const RoomStatus& status : statuses) {
+		w.u8((uint8_t)status.state);
+		w.time(status.until);
+	}
+}
+
+// FNV-1a, zero is reserved for "no content"
+uint32_t hashPayload(const uint8_t* data, size_t size) {
+	uint32_t hash = 0x811C9DC5;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 0x01000193;
+	}
+	return hash ? hash : 1;
+}
+
+/**
+ * Checks the header and returns a reader of the payload, or false if the frame is malformed.
+ */
+bool openFrame(const uint8_t* frame, size_t size, Type& type, Reader& reader) {
+	if (size < HEADER_SIZE || payloadSize(frame) != (int)(size - HEADER_SIZE))
+		return false;
+	type = (Type)frame[3];
+	reader = Reader(frame + HEADER_SIZE, size - HEADER_SIZE);
+	return true;
+}
+}  // namespace
+
+size_t encodeRequest(const Request& request, uint8_t* buffer, size_t capacity) {
+	Writer w(buffer, capacity);
+	w.header(request.type);
+	w.text(request.key);
+	switch (request.type) {
+		case Type::STATUS:
+			w.id(request.calendarId);
+			w.u32(request.knownHash);
+			break;
+		case Type::END_EVENT:
+			w.id(request.calendarId);
+			w.id(request.eventId);
+			break;
+		case Type::INSERT_EVENT:
+			w.id(request.calendarId);
+			w.time(request.startTime);
+			w.time(request.endTime);
+			break;
+		case Type::RESCHEDULE_EVENT:
+			w.id(request.calendarId);
+			w.event(request.event);
+			w.time(request.startTime);
+			w.time(request.endTime);
+			break;
+		case Type::ROOM_STATUSES:
+			if (request.roomIds.size() > ROOMS_MAX)
+				return 0;
+			w.u32(request.knownHash);
+			w.u8(request.roomIds.size());
+			for (const String& id : request.roomIds) w.id(id);
+			break;
+		default:
+			return 0;
+	}
+	return w.finish();
+}
+
+size_t encodeResponse(const Response& response, uint8_t* buffer, size_t capacity) {
+	Writer w(buffer, capacity);
+	w.header(response.type);
+	switch (response.type) {
+		case Type::STATUS_OK:
+			w.u32(response.hash);
+			writeStatusContent(w, response.status);
+			break;
+		case Type::NOT_MODIFIED:
+			w.u32(response.hash);
+			break;
+		case Type::EVENT_OK:
+			w.event(response.event);
+			break;
+		case Type::ROOM_STATUSES_OK:
+			w.u32(response.hash);
+			writeRoomStatusesContent(w, response.roomStatuses);
+			break;
+		case Type::ERROR:
+			w.u8((uint8_t)response.errorType);
+			w.text(response.message);
+			w.time(response.retryAfter);
+			break;
+		default:
+			return 0;
+	}
+	return w.finish();
+}
+
+int payloadSize(const uint8_t* header) {
+	if (header[0] != MAGIC[0] || header[1] != MAGIC[1] || header[2] != PROTOCOL_VERSION)
+		return -1;
+	const size_t size = header[4] << 8 | header[5];
+	return size + HEADER_SIZE <= FRAME_MAX_SIZE ? size : -1;
+}
+
+bool decodeRequest(const uint8_t* frame, size_t size, Request& request) {
+	Reader r(nullptr, 0);
+	if (!openFrame(frame, size, request.type, r))
+		return false;
+	request.key = r.string();
+	switch (request.type) {
+		case Type::STATUS:
+			request.calendarId = r.string();
+			request.knownHash = r.u32();
+			break;
+		case Type::END_EVENT:
+			request.calendarId = r.string();
+			request.eventId = r.string();
+			break;
+		case Type::INSERT_EVENT:
+			request.calendarId = r.string();
+			request.startTime = r.time();
+			request.endTime = r.time();
+			break;
+		case Type::RESCHEDULE_EVENT:
+			request.calendarId = r.string();
+			request.event = r.event();
+			request.startTime = r.time();
+			request.endTime = r.time();
+			break;
+		case Type::ROOM_STATUSES: {
+			request.knownHash = r.u32();
+			const size_t count = r.u8();
+			if (count > ROOMS_MAX)
+				return false;
+			request.roomIds.clear();
+			for (size_t i = 0; i < count; i++) request.roomIds.push_back(r.string());
+			break;
+		}
+		default:
+			return false;
+	}
+	return r.finished();
+}
+
+bool decodeResponse(const uint8_t* frame, size_t size, Response& response) {
+	Reader r(nullptr, 0);
+	if (!openFrame(frame, size, response.type, r))
+		return false;
+	switch (response.type) {
+		case Type::STATUS_OK: {
+			response.hash = r.u32();
+			response.status.name = r.string();
+			const uint8_t flags = r.u8();
+			response.status.currentEvent
+			    = flags & HAS_CURRENT_EVENT ? std::make_shared<Event>(r.event()) : nullptr;
+			response.status.nextEvent
+			    = flags & HAS_NEXT_EVENT ? std::make_shared<Event>(r.event()) : nullptr;
+			break;
+		}
+		case Type::NOT_MODIFIED:
+			response.hash = r.u32();
+			break;
+		case Type::EVENT_OK:
+			response.event = r.event();
+			break;
+		case Type::ROOM_STATUSES_OK: {
+			response.hash = r.u32();
+			const size_t count = r.u8();
+			if (count > ROOMS_MAX)
+				return false;
+			response.roomStatuses.clear();
+			for (size_t i = 0; i < count; i++) {
+				const uint8_t state = r.u8();
+				const time_t until = r.time();
+				if (state > (uint8_t)RoomStatus::State::UNKNOWN)
+					return false;
+				response.roomStatuses.push_back(RoomStatus{"", (RoomStatus::State)state, until});
+			}
+			break;
+		}
+		case Type::ERROR: {
+			const uint8_t errorType = r.u8();
+			if (errorType > (uint8_t)Error::Type::LOGICAL)
+				return false;
+			response.errorType = (Error::Type)errorType;
+			response.message = r.string();
+			response.retryAfter = r.time();
+			break;
+		}
+		default:
+			return false;
+	}
+	return r.finished();
+}
+
+uint32_t hashStatus(const CalendarStatus& status) {
+	std::vector<uint8_t> buffer(FRAME_MAX_SIZE);
+	Writer w(buffer.data(), buffer.size());
+	w.header(Type::STATUS_OK);
+	writeStatusContent(w, status);
+	return hashPayload(w.payload(), w.payloadSize());
+}
+
+uint32_t hashRoomStatuses(const std::vector<RoomStatus>& statuses) {
+	std::vector<uint8_t> buffer(FRAME_MAX_SIZE);
+	Writer w(buffer.data(), buffer.size());
+	w.header(Type::ROOM_STATUSES_OK);
+	writeRoomStatusesContent(w, statuses);
+	return hashPayload(w.payload(), w.payloadSize());
+}
+
+}  // namespace gateway
+}  // namespace cal
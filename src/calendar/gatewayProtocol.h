@@ -0,0 +1,108 @@
+#ifndef GATEWAY_PROTOCOL_H
+#define GATEWAY_PROTOCOL_H
+
+#include <Arduino.h>
+
+#include <vector>
+
+#include "api.h"
+
+/**
+ * Binary protocol between the devices and the LAN calendar gateway, see gateway/README.md.
+ *
+ * One request and one response per TCP connection. A frame is a 6 byte header
+ * (magic "MB", protocol version, message type, big-endian payload length) and the payload.
+ * Integers are big-endian, times are unix seconds as uint32, strings are a length byte and
+ * UTF-8 bytes. Texts longer than 255 bytes are truncated, ids that long don't fit a frame.
+ *
+ * Status responses carry a hash of their content. A device sends the hash of the status it
+ * already has, and the gateway answers NOT_MODIFIED with only the hash when nothing changed.
+ */
+namespace cal {
+namespace gateway {
+
+const uint16_t DEFAULT_PORT = 8463;
+const uint8_t PROTOCOL_VERSION = 2;
+const size_t HEADER_SIZE = 6;
+const size_t FRAME_MAX_SIZE = 4096;
+
+enum class Type : uint8_t {
+	// Requests, the first field is always the shared key of the gateway
+	STATUS = 0x01,
+	END_EVENT = 0x02,
+	INSERT_EVENT = 0x03,
+	RESCHEDULE_EVENT = 0x04,
+	ROOM_STATUSES = 0x05,
+	// Responses
+	STATUS_OK = 0x81,
+	NOT_MODIFIED = 0x82,
+	EVENT_OK = 0x83,
+	ROOM_STATUSES_OK = 0x84,
+	ERROR = 0x85,
+};
+
+struct Request {
+	Type type;
+	String key;
+	// STATUS, END_EVENT, INSERT_EVENT and RESCHEDULE_EVENT
+	String calendarId;
+	// STATUS and ROOM_STATUSES, hash of the content the device has, zero if none
+	uint32_t knownHash;
+	// END_EVENT
+	String eventId;
+	// RESCHEDULE_EVENT
+	Event event;
+	// INSERT_EVENT and RESCHEDULE_EVENT
+	time_t startTime;
+	time_t endTime;
+	// ROOM_STATUSES
+	std::vector<String> roomIds;
+};
+
+struct Response {
+	Type type;
+	// STATUS_OK, NOT_MODIFIED and ROOM_STATUSES_OK
+	uint32_t hash;
+	// STATUS_OK
+	CalendarStatus status;
+	// EVENT_OK
+	Event event;
+	// ROOM_STATUSES_OK, in the order of the requested rooms and without names
+	std::vector<RoomStatus> roomStatuses;
+	// ERROR
+	Error::Type errorType;
+	String message;
+	// Seconds until the gateway takes requests to the provider again, zero if not throttled
+	time_t retryAfter;
+};
+
+/**
+ * Encode a message into buffer. Returns the frame size, or 0 if the message doesn't fit
+ * FRAME_MAX_SIZE or capacity.
+ */
+size_t encodeRequest(const Request& request, uint8_t* buffer, size_t capacity);
+size_t encodeResponse(const Response& response, uint8_t* buffer, size_t capacity);
+
+/**
+ * Payload size of a frame from its header, or -1 if the header is not a frame of this
+ * protocol version.
+ */
+int payloadSize(const uint8_t* header);
+
+/**
+ * Decode a whole frame, header included. Returns false on a malformed frame.
+ */
+bool decodeRequest(const uint8_t* frame, size_t size, Request& request);
+bool decodeResponse(const uint8_t* frame, size_t size, Response& response);
+
+/**
+ * Content hashes of STATUS_OK and ROOM_STATUSES_OK, never zero.
+ * Room names are not sent, so they are not part of the hash.
+ */
+uint32_t hashStatus(const CalendarStatus& status);
+uint32_t hashRoomStatuses(const std::vector<RoomStatus>& statuses);
+
+}  // namespace gateway
+}  // namespace cal
+
+#endif
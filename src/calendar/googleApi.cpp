@@ -2,6 +2,7 @@
 
 #include "globals.h"
 #include "timeUtils.h"
+#include "trace.h"
 #include "utils.h"
 
 namespace cal {
@@ -19,21 +20,39 @@ const int LIST_MAX_EVENTS = 16;
 const int EVENT_MAX_SIZE = 1024;
 
 const int EVENT_LIST_MAX_SIZE = LIST_MAX_EVENTS * EVENT_MAX_SIZE;
+
+// Token response is only an access token, its expiry and scope
+const int AUTH_RESPONSE_MAX_SIZE = 1024;
+const int PAYLOAD_MAX_SIZE = 256;
+
+// Largest request is a payload and an event list
+const int JSON_ARENA_SIZE = PAYLOAD_MAX_SIZE + EVENT_LIST_MAX_SIZE;
+
+// Free/busy payload lists the calendar ids, resource ids are around 60 characters
+const int FREEBUSY_PAYLOAD_MAX_SIZE = 2048;
+const int FREEBUSY_FILTER_MAX_SIZE = 256;
+// Rest of the arena for the response. Only the busy periods are kept, around 100 bytes each,
+// so a dozen rooms fit with ten bookings each.
+const int FREEBUSY_RESPONSE_MAX_SIZE
+    = JSON_ARENA_SIZE - FREEBUSY_PAYLOAD_MAX_SIZE - FREEBUSY_FILTER_MAX_SIZE;
+static_assert(FREEBUSY_RESPONSE_MAX_SIZE >= 12 * 1024, "Free/busy response must fit the arena");
 }  // namespace
 
 GoogleAPI::GoogleAPI(const Token& token, const String& calendarId)
-    : _token{token}, _calendarId{calendarId} {
+    : _token{token}, _calendarId{calendarId}, _arena{"google", JSON_ARENA_SIZE} {
 	_http.setReuse(false);
+	collectRetryAfter(_http);
 };
 
-bool GoogleAPI::refreshAuth() {
+bool GoogleAPI::refreshAuth(time_t validUntil) {
 	log_i("Refreshing token...");
-	if (_token.unixExpiry + 60 > safeUTC.now()) {
+	if (_token.unixExpiry > validUntil) {
 		log_i("Token doesn't need refreshing");
 		return true;
 	}
 
 	// BUILD REQUEST
+	_arena.reset();
 	_http.begin("https://oauth2.googleapis.com/token");
 	_http.addHeader("Content-Type", "application/x-www-form-urlencoded");
 
@@ -47,8 +66,8 @@ bool GoogleAPI::refreshAuth() {
 	_http.end();
 	// log_i("Received refresh auth response:\n%s", responseBody.c_str());
 	log_i("Received refresh auth response: hidden");
-	DynamicJsonDocument doc(EVENT_LIST_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	ArenaJsonDocument doc(_arena, AUTH_RESPONSE_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return false;
 
@@ -60,12 +79,14 @@ bool GoogleAPI::refreshAuth() {
 		_token.refreshToken = doc["refresh_token"].as<String>();
 		_saveTokenFunc(_token);
 	}
+	saveAccessToken(_token);
 
 	return true;
 };
 
 Result<CalendarStatus> GoogleAPI::fetchCalendarStatus() {
 	// BUILD REQUEST
+	_arena.reset();
 	time_t now = safeMyTZ.now();
 
 	String timeMin = safeMyTZ.dateTime(now, RFC3339);
@@ -92,9 +113,9 @@ Result<CalendarStatus> GoogleAPI::fetchCalendarStatus() {
 	// PARSE RESPONSE AS JSON
 	String responseBody = _http.getString();
 	_http.end();
-	log_i("Received event list response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(EVENT_LIST_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event list response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_LIST_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<CalendarStatus>::makeErr(err);
 
@@ -128,6 +149,7 @@ Result<CalendarStatus> GoogleAPI::fetchCalendarStatus() {
 
 Result<Event> GoogleAPI::endEvent(const String& eventId) {
 	// BUILD REQUEST
+	_arena.reset();
 	String nowStr = safeMyTZ.dateTime(RFC3339);
 	String url = "https://www.googleapis.com/calendar/v3/calendars/" + _calendarId + "/events/"
 	             + eventId + "?fields=" + EVENT_FIELDS;
@@ -136,7 +158,7 @@ Result<Event> GoogleAPI::endEvent(const String& eventId) {
 	_http.addHeader("Authorization", "Bearer " + _token.accessToken);
 
 	// CREATE PAYLOAD
-	StaticJsonDocument<256> payloadDoc;
+	ArenaJsonDocument payloadDoc(_arena, PAYLOAD_MAX_SIZE);
 	payloadDoc["end"]["dateTime"] = nowStr;
 	payloadDoc["end"]["timeZone"] = safeMyTZ.getOlson();
 	String payload = "";
@@ -150,9 +172,9 @@ Result<Event> GoogleAPI::endEvent(const String& eventId) {
 	String responseBody = _http.getString();
 	_http.end();
 
-	log_i("Received event patch response:\n%s", responseBody.c_str());
-	StaticJsonDocument<1024> doc;
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event patch response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<Event>::makeErr(err);
 
@@ -177,6 +199,7 @@ Result<Event> GoogleAPI::insertEvent(time_t startTime, time_t endTime) {
 	}
 
 	// BUILD REQUEST
+	_arena.reset();
 	String url = "https://www.googleapis.com/calendar/v3/calendars/" + _calendarId
 	             + "/events?fields=" + EVENT_FIELDS;
 	_http.begin(url);
@@ -184,7 +207,7 @@ Result<Event> GoogleAPI::insertEvent(time_t startTime, time_t endTime) {
 	_http.addHeader("Authorization", "Bearer " + _token.accessToken);
 
 	// CREATE PAYLOAD
-	StaticJsonDocument<256> payloadDoc;
+	ArenaJsonDocument payloadDoc(_arena, PAYLOAD_MAX_SIZE);
 	payloadDoc["start"]["dateTime"] = safeMyTZ.dateTime(startTime, UTC_TIME, RFC3339);
 	payloadDoc["start"]["timeZone"] = safeMyTZ.getOlson();
 	payloadDoc["end"]["dateTime"] = safeMyTZ.dateTime(endTime, UTC_TIME, RFC3339);
@@ -203,9 +226,9 @@ Result<Event> GoogleAPI::insertEvent(time_t startTime, time_t endTime) {
 	String responseBody = _http.getString();
 	_http.end();
 
-	log_i("Received event insert response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(1024);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event insert response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<Event>::makeErr(err);
 
@@ -231,6 +254,7 @@ Result<Event> GoogleAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t ne
 	}
 
 	// BUILD REQUEST
+	_arena.reset();
 	String url = "https://www.googleapis.com/calendar/v3/calendars/" + _calendarId + "/events/"
 	             + event->id + "?fields=" + EVENT_FIELDS;
 	_http.begin(url);
@@ -238,7 +262,7 @@ Result<Event> GoogleAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t ne
 	_http.addHeader("Authorization", "Bearer " + _token.accessToken);
 
 	// CREATE PAYLOAD
-	StaticJsonDocument<256> payloadDoc;
+	ArenaJsonDocument payloadDoc(_arena, PAYLOAD_MAX_SIZE);
 	payloadDoc["start"]["dateTime"] = safeMyTZ.dateTime(newStartTime, UTC_TIME, RFC3339);
 	payloadDoc["start"]["timeZone"] = safeMyTZ.getOlson();
 	payloadDoc["end"]["dateTime"] = safeMyTZ.dateTime(newEndTime, UTC_TIME, RFC3339);
@@ -254,9 +278,9 @@ Result<Event> GoogleAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t ne
 	String responseBody = _http.getString();
 	_http.end();
 
-	log_i("Received event patch response:\n%s", responseBody.c_str());
-	StaticJsonDocument<1024> doc;
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event patch response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<Event>::makeErr(err);
 
@@ -270,6 +294,76 @@ Result<Event> GoogleAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t ne
 	return Result<Event>::makeOk(newEvent);
 }
 
+Result<std::vector<RoomStatus>> GoogleAPI::fetchRoomStatuses(const std::vector<Room>& rooms) {
+	using RoomsResult = Result<std::vector<RoomStatus>>;
+	if (rooms.size() > ROOMS_MAX) {
+		return RoomsResult::makeErr(new Error(Error::Type::LOGICAL, "Too many rooms, at most "
+		                                                                 + String(ROOMS_MAX)
+		                                                                 + " are supported"));
+	}
+
+	// BUILD REQUEST
+	_arena.reset();
+	time_t now = safeMyTZ.now();
+	_http.begin("https://www.googleapis.com/calendar/v3/freeBusy");
+	_http.addHeader("Content-Type", "application/json");
+	_http.addHeader("Authorization", "Bearer " + _token.accessToken);
+	// HTTP/1.0 responses are not chunked, so the json can be parsed straight from the stream
+	_http.useHTTP10(true);
+
+	// CREATE PAYLOAD
+	ArenaJsonDocument payloadDoc(_arena, FREEBUSY_PAYLOAD_MAX_SIZE);
+	payloadDoc["timeMin"] = safeMyTZ.dateTime(now, RFC3339);
+	payloadDoc["timeMax"] = safeMyTZ.dateTime(timeutils::getNextMidnight(now), RFC3339);
+	JsonArray items = payloadDoc.createNestedArray("items");
+	for (const Room& room : rooms) items.createNestedObject()["id"] = room.id;
+	String payload = "";
+	serializeJson(payloadDoc, payload);
+
+	// SEND REQUEST
+	int httpCode = _http.POST(payload);
+	payload.clear();
+
+	// PARSE RESPONSE AS JSON
+	ArenaJsonDocument filter(_arena, FREEBUSY_FILTER_MAX_SIZE);
+	JsonObject calendarFilter = filter["calendars"].createNestedObject("*");
+	JsonObject busyFilter = calendarFilter["busy"].createNestedObject();
+	busyFilter["start"] = true;
+	busyFilter["end"] = true;
+	calendarFilter["errors"] = true;
+
+	ArenaJsonDocument doc(_arena, FREEBUSY_RESPONSE_MAX_SIZE);
+	auto err = parseJSONStream(doc, httpCode, _http.getStream(), filter, &_http);
+	_http.end();
+	_http.useHTTP10(false);
+	if (err)
+		return RoomsResult::makeErr(err);
+	TRACE_HTTP("Received free/busy response, %u bytes kept", doc.memoryUsage());
+
+	// PARSE JSON AS ROOM STATUSES
+	auto statuses = new std::vector<RoomStatus>();
+	statuses->reserve(rooms.size());
+	std::vector<BusyPeriod> busy;
+	now = safeUTC.now();
+	for (const Room& room : rooms) {
+		JsonObjectConst calendar = doc["calendars"][room.id];
+		if (calendar.isNull() || calendar.containsKey("errors")) {
+			log_w("No free/busy for room %s", room.id.c_str());
+			statuses->push_back(RoomStatus{room.name, RoomStatus::State::UNKNOWN, 0});
+			continue;
+		}
+
+		busy.clear();
+		for (JsonObjectConst period : calendar["busy"].as<JsonArrayConst>()) {
+			busy.push_back(
+			    BusyPeriod{parseJsonTimestamp(period["start"]), parseJsonTimestamp(period["end"])});
+		}
+		statuses->push_back(roomStatusFromBusy(room.name, busy, now));
+	}
+
+	return RoomsResult::makeOk(statuses);
+}
+
 bool GoogleAPI::isRoomAccepted(JsonObjectConst eventObject) {
 	JsonArrayConst attendees = eventObject["attendees"].as<JsonArrayConst>();
 	for (JsonObjectConst attendee : attendees) {
@@ -282,6 +376,7 @@ bool GoogleAPI::isRoomAccepted(JsonObjectConst eventObject) {
 
 Result<bool> GoogleAPI::isFree(time_t startTime, time_t endTime, const String& ignoreId) {
 	// BUILD REQUEST
+	_arena.reset();
 	String timeMin = safeMyTZ.dateTime(startTime, UTC_TIME, RFC3339);
 	timeMin.replace("+", "%2b");
 	String timeMax = safeMyTZ.dateTime(endTime, UTC_TIME, RFC3339);
@@ -304,9 +399,9 @@ Result<bool> GoogleAPI::isFree(time_t startTime, time_t endTime, const String& i
 	// PARSE RESPONSE AS JSON
 	String responseBody = _http.getString();
 	_http.end();
-	log_i("Received event isFree response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(EVENT_LIST_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event isFree response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_LIST_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<bool>::makeErr(err);
 
@@ -339,8 +434,8 @@ std::shared_ptr<Event> GoogleAPI::extractEvent(JsonObjectConst object, bool igno
 
 	// Extract the values from the JSON object
 
-	time_t startTime = timeutils::parseRfcTimestamp(object["start"]["dateTime"]);
-	time_t endTime = timeutils::parseRfcTimestamp(object["end"]["dateTime"]);
+	time_t startTime = parseJsonTimestamp(object["start"]["dateTime"]);
+	time_t endTime = parseJsonTimestamp(object["end"]["dateTime"]);
 
 	return std::shared_ptr<Event>(new Event{
 	    .id = object["id"],
@@ -0,0 +1,666 @@
+#include "ics.h"
+
+#include "globals.h"
+#include "trace.h"
+
+namespace cal {
+namespace ics {
+
+namespace {
+const int64_t DAY_S = 24 * 60 * 60;
+// Instances of long recurring events are looked for at most this many days before the window
+const int32_t EXPAND_DAYS_MAX = 14;
+// Instances of COUNT limited rules are counted from the first one, at most this many days
+const int32_t COUNT_DAYS_MAX = 100 * 366;
+
+int64_t floorDiv(int64_t a, int64_t b) { return a / b - (a % b != 0 && (a < 0) != (b < 0)); }
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day) {
+	year -= month <= 2;
+	const int32_t era = (year >= 0 ? year : year - 399) / 400;
+	const uint32_t yearOfEra = year - era * 400;
+	const uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097 + (int32_t)dayOfEra - 719468;
+}
+
+void civilFromDays(int32_t days, int32_t& year, uint32_t& month, uint32_t& day) {
+	days += 719468;
+	const int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+	const uint32_t dayOfEra = days - era * 146097;
+	const uint32_t yearOfEra
+	    = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	const uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	const uint32_t monthIndex = (5 * dayOfYear + 2) / 153;
+	day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+	month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+	year = (int32_t)yearOfEra + era * 400 + (month <= 2);
+}
+
+// 0 is Sunday, 1970-01-01 was a Thursday
+int weekday(int32_t days) {
+	const int dayOfWeek = (days + 4) % 7;
+	return dayOfWeek < 0 ? dayOfWeek + 7 : dayOfWeek;
+}
+
+uint32_t daysInMonth(int32_t year, uint32_t month) {
+	static const uint8_t DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	return month == 2 && leap ? 29 : DAYS[month - 1];
+}
+
+// FNV-1a, pairs overrides with the instances of their recurring event
+uint32_t hashUid(const char* uid) {
+	uint32_t hash = 2166136261u;
+	for (; *uid; uid++) hash = (hash ^ (uint8_t)*uid) * 16777619u;
+	return hash;
+}
+
+// Cuts a UTF-8 sequence left incomplete at the end of text by truncation
+void trimUtf8(char* text, size_t length) {
+	size_t lead = length;
+	while (lead > 0 && ((uint8_t)text[lead - 1] & 0xC0) == 0x80) lead--;
+	if (lead == 0)
+		return;
+	const uint8_t c = text[lead - 1];
+	const size_t expected = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+	if (length - (lead - 1) < expected)
+		text[lead - 1] = '\0';
+}
+
+void copyText(char* destination, size_t size, const char* source) {
+	const size_t length = min(strlen(source), size - 1);
+	memcpy(destination, source, length);
+	destination[length] = '\0';
+	trimUtf8(destination, length);
+}
+
+// TEXT values escape commas, semicolons, backslashes and newlines, newlines become spaces
+void unescapeText(char* value) {
+	char* out = value;
+	for (const char* in = value; *in; in++) {
+		if (*in == '\\' && in[1]) {
+			in++;
+			*out++ = *in == 'n' || *in == 'N' ? ' ' : *in;
+		} else {
+			*out++ = *in;
+		}
+	}
+	*out = '\0';
+}
+
+// Finds the parameter name=value in params, value without quotes
+bool findParam(const char* params, const char* name, char* value, size_t size) {
+	const size_t nameLength = strlen(name);
+	const char* p = params;
+	while (p && *p) {
+		if (strncasecmp(p, name, nameLength) == 0 && p[nameLength] == '=') {
+			p += nameLength + 1;
+			size_t length = 0;
+			bool quoted = false;
+			for (; *p && (quoted || *p != ';'); p++) {
+				if (*p == '"')
+					quoted = !quoted;
+				else if (length + 1 < size)
+					value[length++] = *p;
+			}
+			value[length] = '\0';
+			return true;
+		}
+		bool quoted = false;
+		for (; *p && (quoted || *p != ';'); p++)
+			if (*p == '"')
+				quoted = !quoted;
+		if (*p == ';')
+			p++;
+	}
+	return false;
+}
+
+int digits(const char* text, int count) {
+	int value = 0;
+	for (int i = 0; i < count; i++) {
+		if (!isDigit(text[i]))
+			return -1;
+		value = value * 10 + text[i] - '0';
+	}
+	return value;
+}
+
+// Seconds of a DURATION value, e.g. PT1H30M, negative if invalid or negative
+int32_t parseDuration(const char* value) {
+	if (*value == '+')
+		value++;
+	if (*value++ != 'P')
+		return -1;
+	int32_t total = 0;
+	int32_t number = 0;
+	for (; *value; value++) {
+		if (isDigit(*value)) {
+			number = number * 10 + *value - '0';
+			continue;
+		}
+		switch (*value) {
+			case 'T':
+				break;
+			case 'W':
+				total += number * 7 * DAY_S;
+				break;
+			case 'D':
+				total += number * DAY_S;
+				break;
+			case 'H':
+				total += number * 60 * 60;
+				break;
+			case 'M':
+				total += number * 60;
+				break;
+			case 'S':
+				total += number;
+				break;
+			default:
+				return -1;
+		}
+		number = 0;
+	}
+	return total;
+}
+
+int parseWeekday(const char* text) {
+	static const char* const NAMES[] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+	for (int i = 0; i < 7; i++)
+		if (strncasecmp(text, NAMES[i], 2) == 0)
+			return i;
+	return -1;
+}
+}  // namespace
+
+int64_t DateTime::localSeconds() const {
+	return daysFromCivil(year, month, day) * DAY_S + hour * 60 * 60 + minute * 60 + second;
+}
+
+bool parseDateTime(const char* params, const char* value, DateTime& result) {
+	result = DateTime();
+	const size_t length = strlen(value);
+	const int year = length >= 8 ? digits(value, 4) : -1;
+	const int month = year >= 0 ? digits(value + 4, 2) : -1;
+	const int day = month >= 0 ? digits(value + 6, 2) : -1;
+	if (month < 1 || month > 12 || day < 1 || day > 31)
+		return false;
+	result.year = year;
+	result.month = month;
+	result.day = day;
+
+	char type[16];
+	if (length == 8 || (findParam(params, "VALUE", type, sizeof(type)) && !strcmp(type, "DATE"))) {
+		result.kind = DateTime::Kind::DATE;
+		return true;
+	}
+
+	const int hour = length >= 15 && value[8] == 'T' ? digits(value + 9, 2) : -1;
+	const int minute = hour >= 0 ? digits(value + 11, 2) : -1;
+	const int second = minute >= 0 ? digits(value + 13, 2) : -1;
+	if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60)
+		return false;
+	result.hour = hour;
+	result.minute = minute;
+	result.second = second;
+
+	if (value[15] == 'Z')
+		result.kind = DateTime::Kind::UTC;
+	else if (findParam(params, "TZID", result.tzid, sizeof(result.tzid)))
+		result.kind = DateTime::Kind::ZONED;
+	else
+		result.kind = DateTime::Kind::FLOATING;
+	return true;
+}
+
+void formatUtc(time_t time, char* buffer) {
+	tmElements_t tm;
+	ezt::breakTime(time, tm);
+	snprintf(buffer, 17, "%04d%02d%02dT%02d%02d%02dZ", tm.Year + 1970, tm.Month, tm.Day, tm.Hour,
+	         tm.Minute, tm.Second);
+}
+
+Timezone* TimeResolver::_zone(const char* tzid) {
+	if (!tzid || !*tzid)
+		return nullptr;
+	if (strncmp(tzid, _tzid, sizeof(_tzid) - 1) != 0) {
+		copyText(_tzid, sizeof(_tzid), tzid);
+		// Some clients prefix the Olson name, e.g. /mozilla.org/20050126_1/Europe/Helsinki
+		const char* name = tzid;
+		const char* posix = nullptr;
+		while (name && !(posix = tzdb::lookupPosix(name))) {
+			name = strchr(name + 1, '/');
+			if (name)
+				name++;
+		}
+		_tzFound = posix != nullptr;
+		if (_tzFound)
+			_tz.setPosix(posix, name);
+		else
+			log_w("Unknown timezone %s, using the device timezone", tzid);
+	}
+	return _tzFound ? &_tz : nullptr;
+}
+
+time_t TimeResolver::toUtc(int64_t localSeconds, const char* tzid) {
+	Timezone* zone = _zone(tzid);
+	return zone ? zone->tzTime(localSeconds, LOCAL_TIME)
+	            : safeMyTZ.tzTime(localSeconds, LOCAL_TIME);
+}
+
+int64_t TimeResolver::toLocal(time_t utc, const char* tzid) {
+	Timezone* zone = _zone(tzid);
+	return zone ? zone->tzTime(utc, UTC_TIME) : safeMyTZ.tzTime(utc, UTC_TIME);
+}
+
+time_t TimeResolver::toUtc(const DateTime& time) {
+	switch (time.kind) {
+		case DateTime::Kind::UTC:
+			return time.localSeconds();
+		case DateTime::Kind::ZONED:
+			return toUtc(time.localSeconds(), time.tzid);
+		case DateTime::Kind::FLOATING:
+		case DateTime::Kind::DATE:
+			return toUtc(time.localSeconds(), "");
+		default:
+			return 0;
+	}
+}
+
+void Parser::begin(time_t windowStart, time_t windowEnd, Handler handler) {
+	_windowStart = windowStart;
+	_windowEnd = windowEnd;
+	_handler = handler;
+	_lineLength = 0;
+	_lineBreak = false;
+	_inEvent = false;
+	_nested = 0;
+	_pendingCount = 0;
+	_overrideCount = 0;
+}
+
+void Parser::feed(char c) {
+	if (c == '\r' || c == '\n') {
+		_lineBreak = true;
+		return;
+	}
+	if (_lineBreak) {
+		_lineBreak = false;
+		// A line starting with whitespace continues the previous one
+		if (c == ' ' || c == '\t')
+			return;
+		_endLine();
+	}
+	if (_lineLength < LINE_MAX_SIZE - 1)
+		_line[_lineLength++] = c;
+}
+
+void Parser::endObject() {
+	if (_lineLength > 0)
+		_endLine();
+	_lineBreak = false;
+	_inEvent = false;
+	_flushPending();
+}
+
+void Parser::_endLine() {
+	_line[_lineLength] = '\0';
+	_lineLength = 0;
+
+	char* name = _line;
+	while (*name == ' ' || *name == '\t') name++;
+	char* params = nullptr;
+	char* value = nullptr;
+	bool quoted = false;
+	for (char* p = name; *p; p++) {
+		if (*p == '"') {
+			quoted = !quoted;
+		} else if (*p == ';' && !params && !quoted) {
+			*p = '\0';
+			params = p + 1;
+		} else if (*p == ':' && !quoted) {
+			*p = '\0';
+			value = p + 1;
+			break;
+		}
+	}
+	if (!value)
+		return;
+	if (!params)
+		params = value - 1;
+
+	if (!strcasecmp(name, "BEGIN")) {
+		if (_inEvent) {
+			_nested++;
+		} else if (!strcasecmp(value, "VEVENT")) {
+			_inEvent = true;
+			_nested = 0;
+			_event.uid[0] = '\0';
+			_event.summary[0] = '\0';
+			_event.creator[0] = '\0';
+			_event.start = DateTime();
+			_event.end = DateTime();
+			_event.duration = -1;
+			_event.recurrenceId = 0;
+			_event.rule = Rule();
+			_event.exdateCount = 0;
+			_event.cancelled = false;
+			_event.transparent = false;
+		}
+	} else if (!strcasecmp(name, "END")) {
+		if (_inEvent && _nested > 0) {
+			_nested--;
+		} else if (_inEvent && !strcasecmp(value, "VEVENT")) {
+			_inEvent = false;
+			_endEvent();
+		} else if (!strcasecmp(value, "VCALENDAR")) {
+			_flushPending();
+		}
+	} else if (_inEvent && _nested == 0) {
+		_property(name, params, value);
+	}
+}
+
+void Parser::_property(const char* name, const char* params, char* value) {
+	if (!strcasecmp(name, "UID")) {
+		copyText(_event.uid, sizeof(_event.uid), value);
+	} else if (!strcasecmp(name, "SUMMARY")) {
+		unescapeText(value);
+		copyText(_event.summary, sizeof(_event.summary), value);
+	} else if (!strcasecmp(name, "ORGANIZER")) {
+		if (!findParam(params, "CN", _event.creator, sizeof(_event.creator))) {
+			if (!strncasecmp(value, "mailto:", 7))
+				value += 7;
+			copyText(_event.creator, sizeof(_event.creator), value);
+		}
+	} else if (!strcasecmp(name, "DTSTART")) {
+		parseDateTime(params, value, _event.start);
+	} else if (!strcasecmp(name, "DTEND")) {
+		parseDateTime(params, value, _event.end);
+	} else if (!strcasecmp(name, "DURATION")) {
+		_event.duration = parseDuration(value);
+	} else if (!strcasecmp(name, "RECURRENCE-ID")) {
+		DateTime recurrenceId;
+		if (parseDateTime(params, value, recurrenceId))
+			_event.recurrenceId = _resolver.toUtc(recurrenceId);
+	} else if (!strcasecmp(name, "RRULE")) {
+		_parseRule(value);
+	} else if (!strcasecmp(name, "EXDATE")) {
+		char* saveptr = nullptr;
+		for (char* item = strtok_r(value, ",", &saveptr); item;
+		     item = strtok_r(nullptr, ",", &saveptr)) {
+			DateTime exdate;
+			if (!parseDateTime(params, item, exdate))
+				continue;
+			if (_event.exdateCount == EXDATES_MAX) {
+				log_w("Too many EXDATEs in %s", _event.uid);
+				break;
+			}
+			_event.exdates[_event.exdateCount++] = _resolver.toUtc(exdate);
+		}
+	} else if (!strcasecmp(name, "STATUS")) {
+		_event.cancelled = !strcasecmp(value, "CANCELLED");
+	} else if (!strcasecmp(name, "TRANSP")) {
+		_event.transparent = !strcasecmp(value, "TRANSPARENT");
+	}
+}
+
+void Parser::_parseRule(char* value) {
+	Rule& rule = _event.rule;
+	char* saveptr = nullptr;
+	for (char* part = strtok_r(value, ";", &saveptr); part;
+	     part = strtok_r(nullptr, ";", &saveptr)) {
+		char* partValue = strchr(part, '=');
+		if (!partValue)
+			continue;
+		*partValue++ = '\0';
+
+		if (!strcasecmp(part, "FREQ")) {
+			if (!strcasecmp(partValue, "DAILY"))
+				rule.frequency = Rule::Frequency::DAILY;
+			else if (!strcasecmp(partValue, "WEEKLY"))
+				rule.frequency = Rule::Frequency::WEEKLY;
+			else if (!strcasecmp(partValue, "MONTHLY"))
+				rule.frequency = Rule::Frequency::MONTHLY;
+			else if (!strcasecmp(partValue, "YEARLY"))
+				rule.frequency = Rule::Frequency::YEARLY;
+			else
+				rule.unsupported = true;
+		} else if (!strcasecmp(part, "INTERVAL")) {
+			rule.interval = max(1, atoi(partValue));
+		} else if (!strcasecmp(part, "COUNT")) {
+			rule.count = max(1, atoi(partValue));
+		} else if (!strcasecmp(part, "UNTIL")) {
+			parseDateTime("", partValue, rule.until);
+		} else if (!strcasecmp(part, "BYDAY")) {
+			for (char* day = partValue; day && *day;) {
+				char* next = strchr(day, ',');
+				if (next)
+					*next++ = '\0';
+				const int ordinal = atoi(day);
+				while (*day == '+' || *day == '-' || isDigit(*day)) day++;
+				const int weekday = parseWeekday(day);
+				// One nth weekday, or any number of plain weekdays
+				if (weekday < 0 || ordinal < -5 || ordinal > 5
+				    || (ordinal && (rule.weekdays || rule.weekdayOrdinal))
+				    || (!ordinal && rule.weekdayOrdinal)) {
+					rule.unsupported = true;
+				} else {
+					rule.weekdays |= 1 << weekday;
+					rule.weekdayOrdinal = ordinal;
+				}
+				day = next;
+			}
+		} else if (!strcasecmp(part, "BYMONTHDAY")) {
+			rule.monthDay = atoi(partValue);
+			if (strchr(partValue, ',') || rule.monthDay < 1 || rule.monthDay > 31)
+				rule.unsupported = true;
+		} else if (!strcasecmp(part, "BYMONTH")) {
+			rule.month = atoi(partValue);
+			if (strchr(partValue, ',') || rule.month < 1 || rule.month > 12)
+				rule.unsupported = true;
+		} else if (strcasecmp(part, "WKST") != 0) {
+			// BYSETPOS, BYWEEKNO, BYYEARDAY and the time parts
+			rule.unsupported = true;
+		}
+	}
+	// Nth weekdays only make sense within a month
+	if (rule.weekdayOrdinal && rule.frequency != Rule::Frequency::MONTHLY
+	    && !(rule.frequency == Rule::Frequency::YEARLY && rule.month))
+		rule.unsupported = true;
+	if (rule.frequency == Rule::Frequency::YEARLY && rule.weekdays && !rule.month)
+		rule.unsupported = true;
+}
+
+namespace {
+// The day of month and weekday parts of monthly and yearly rules
+bool monthDayMatches(const Rule& rule, const DateTime& start, int32_t year,
+                     uint32_t month, uint32_t day, int dayOfWeek) {
+	if (rule.weekdays) {
+		if (!(rule.weekdays & (1 << dayOfWeek)))
+			return false;
+		if (rule.weekdayOrdinal > 0)
+			return (int)(day - 1) / 7 + 1 == rule.weekdayOrdinal;
+		if (rule.weekdayOrdinal < 0)
+			return (int)(daysInMonth(year, month) - day) / 7 + 1 == -rule.weekdayOrdinal;
+		return true;
+	}
+	return day == (rule.monthDay ? rule.monthDay : start.day);
+}
+
+// Whether an instance of rule starts on the local day, days since 1970-01-01
+bool occursOn(const Rule& rule, const DateTime& start, int32_t day) {
+	const int32_t first = daysFromCivil(start.year, start.month, start.day);
+	if (day < first)
+		return false;
+	// DTSTART is always the first instance
+	if (day == first)
+		return true;
+
+	int32_t year;
+	uint32_t month, dayOfMonth;
+	civilFromDays(day, year, month, dayOfMonth);
+	const int dayOfWeek = weekday(day);
+	switch (rule.frequency) {
+		case Rule::Frequency::DAILY:
+			return (day - first) % rule.interval == 0
+			       && (!rule.weekdays || rule.weekdays & (1 << dayOfWeek));
+		case Rule::Frequency::WEEKLY: {
+			// Weeks start on Monday, the default WKST
+			const int32_t firstWeek = first - (weekday(first) + 6) % 7;
+			const int32_t week = day - (dayOfWeek + 6) % 7;
+			const uint8_t weekdays = rule.weekdays ? rule.weekdays : 1 << weekday(first);
+			return (week - firstWeek) / 7 % rule.interval == 0 && weekdays & (1 << dayOfWeek);
+		}
+		case Rule::Frequency::MONTHLY: {
+			const int32_t months = (year - start.year) * 12 + (int32_t)month - start.month;
+			return months % rule.interval == 0
+			       && monthDayMatches(rule, start, year, month, dayOfMonth, dayOfWeek);
+		}
+		case Rule::Frequency::YEARLY:
+			return (year - start.year) % rule.interval == 0
+			       && month == (rule.month ? rule.month : start.month)
+			       && monthDayMatches(rule, start, year, month, dayOfMonth, dayOfWeek);
+		default:
+			return false;
+	}
+}
+}  // namespace
+
+void Parser::_endEvent() {
+	if (!_event.start.isSet())
+		return;
+	const time_t start = _resolver.toUtc(_event.start);
+	time_t duration = 0;
+	if (_event.end.isSet())
+		duration = max((time_t)0, _resolver.toUtc(_event.end) - start);
+	else if (_event.duration >= 0)
+		duration = _event.duration;
+	else if (_event.start.kind == DateTime::Kind::DATE)
+		duration = DAY_S;
+
+	if (_event.recurrenceId) {
+		// Replaces an instance of the recurring event with the same UID
+		if (_overrideCount < OVERRIDES_MAX)
+			_overrides[_overrideCount++] = Override{hashUid(_event.uid), _event.recurrenceId};
+		else
+			log_w("Too many overridden instances, %s may show twice", _event.uid);
+		if (!_event.cancelled)
+			_emit(_event, start, start + duration, _event.recurrenceId);
+		return;
+	}
+	if (_event.cancelled)
+		return;
+	if (_event.rule.frequency == Rule::Frequency::NONE) {
+		_emit(_event, start, start + duration, 0);
+	} else if (_event.rule.unsupported) {
+		log_w("Recurrence rule of %s is not supported, showing the first instance", _event.uid);
+		if (_overlapsWindow(start, start + duration))
+			_addPending(_event, start, start + duration);
+	} else {
+		_expand(_event, duration);
+	}
+}
+
+void Parser::_expand(const VEvent& event, time_t duration) {
+	const Rule& rule = event.rule;
+	// Instances of UTC start times recur in UTC, others in the wall clock time of their zone
+	const bool utc = event.start.kind == DateTime::Kind::UTC;
+	const char* tzid = event.start.kind == DateTime::Kind::ZONED ? event.start.tzid : "";
+	auto toUtc = [&](int64_t local) { return utc ? local : _resolver.toUtc(local, tzid); };
+	auto toLocal = [&](time_t time) { return utc ? time : _resolver.toLocal(time, tzid); };
+
+	const int64_t startLocal = event.start.localSeconds();
+	const int32_t first = floorDiv(startLocal, DAY_S);
+	const int64_t timeOfDay = startLocal - first * DAY_S;
+
+	// Days with instances that can overlap the window, a day of slack for DST changes
+	const int32_t lastDay = floorDiv(toLocal(_windowEnd), DAY_S) + 1;
+	int32_t day = floorDiv(toLocal(_windowStart - duration), DAY_S) - 1;
+	day = max(max(day, lastDay - EXPAND_DAYS_MAX), first);
+
+	time_t until = 0;
+	if (rule.until.kind == DateTime::Kind::DATE)
+		until = toUtc(rule.until.localSeconds() + DAY_S - 1);
+	else if (rule.until.isSet())
+		until = _resolver.toUtc(rule.until);
+
+	uint32_t index = 0;
+	if (rule.count) {
+		if (day - first > COUNT_DAYS_MAX)
+			return;
+		for (int32_t d = first; d < day && index < rule.count; d++)
+			if (occursOn(rule, event.start, d))
+				index++;
+	}
+
+	for (; day <= lastDay; day++) {
+		if (!occursOn(rule, event.start, day))
+			continue;
+		if (rule.count && index++ >= rule.count)
+			break;
+		const time_t start = toUtc(day * DAY_S + timeOfDay);
+		if ((until && start > until) || start >= _windowEnd)
+			break;
+		if (!_overlapsWindow(start, start + duration))
+			continue;
+		bool excluded = false;
+		for (uint8_t i = 0; i < event.exdateCount && !excluded; i++)
+			excluded = event.exdates[i] == start;
+		if (!excluded)
+			_addPending(event, start, start + duration);
+	}
+}
+
+bool Parser::_overlapsWindow(time_t start, time_t end) const {
+	return start < _windowEnd && (end > _windowStart || start >= _windowStart);
+}
+
+void Parser::_emit(const VEvent& event, time_t start, time_t end, time_t recurrenceId) {
+	if (!_overlapsWindow(start, end))
+		return;
+	_handler(Occurrence{event.uid, event.summary, event.creator, start, end, recurrenceId,
+	                    !event.transparent, event.start.kind == DateTime::Kind::DATE});
+}
+
+void Parser::_addPending(const VEvent& event, time_t start, time_t end) {
+	if (_pendingCount == PENDING_MAX) {
+		log_w("Too many recurring instances in the window, dropped one of %s", event.uid);
+		return;
+	}
+	Pending& pending = _pending[_pendingCount++];
+	pending.uidHash = hashUid(event.uid);
+	copyText(pending.uid, sizeof(pending.uid), event.uid);
+	copyText(pending.summary, sizeof(pending.summary), event.summary);
+	copyText(pending.creator, sizeof(pending.creator), event.creator);
+	pending.start = start;
+	pending.end = end;
+	pending.recurrenceId = start;
+	pending.busy = !event.transparent;
+	pending.allDay = event.start.kind == DateTime::Kind::DATE;
+}
+
+void Parser::_flushPending() {
+	for (size_t i = 0; i < _pendingCount; i++) {
+		const Pending& pending = _pending[i];
+		bool overridden = false;
+		for (size_t j = 0; j < _overrideCount && !overridden; j++) {
+			overridden = _overrides[j].uidHash == pending.uidHash
+			             && _overrides[j].recurrenceId == pending.recurrenceId;
+		}
+		if (overridden)
+			continue;
+		_handler(Occurrence{pending.uid, pending.summary, pending.creator, pending.start,
+		                    pending.end, pending.recurrenceId, pending.busy, pending.allDay});
+	}
+	TRACE_HTTP("Calendar object done, %u recurring instances, %u overrides", _pendingCount,
+	           _overrideCount);
+	_pendingCount = 0;
+	_overrideCount = 0;
+}
+
+}  // namespace ics
+}  // namespace cal
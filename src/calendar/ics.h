@@ -0,0 +1,211 @@
+#ifndef ICS_H
+#define ICS_H
+
+#include <Arduino.h>
+#include <ezTime.h>
+
+#include <functional>
+
+/**
+ * Streaming iCalendar (RFC 5545) parser of the CalDAV provider.
+ *
+ * The text is fed a byte at a time and never held in memory. Lines are unfolded into a fixed
+ * line buffer, and only the properties the device shows are kept from each VEVENT. Recurring
+ * events are expanded only inside the window the parser was started with, by checking the
+ * days of the window against the rule instead of iterating from the first instance.
+ *
+ * Everything is sized up front, so the memory used doesn't depend on the size of the calendar.
+ * Values longer than their buffer are truncated, and instances beyond PENDING_MAX in a window
+ * are dropped with a warning.
+ */
+namespace cal {
+namespace ics {
+
+// Longest unfolded content line kept, the rest of the line is dropped
+const size_t LINE_MAX_SIZE = 320;
+const size_t TEXT_MAX_SIZE = 96;
+const size_t UID_MAX_SIZE = 128;
+const size_t TZID_MAX_SIZE = 48;
+const size_t EXDATES_MAX = 16;
+// Instances of recurring events in the window, held until their overrides have been seen
+const size_t PENDING_MAX = 8;
+const size_t OVERRIDES_MAX = 32;
+
+/**
+ * A DATE or DATE-TIME value as written, resolved to UTC with a TimeResolver.
+ */
+struct DateTime {
+	enum class Kind : uint8_t { NONE, UTC, ZONED, FLOATING, DATE };
+	Kind kind = Kind::NONE;
+	uint16_t year = 0;
+	uint8_t month = 0;
+	uint8_t day = 0;
+	uint8_t hour = 0;
+	uint8_t minute = 0;
+	uint8_t second = 0;
+	// Set for ZONED
+	char tzid[TZID_MAX_SIZE] = "";
+
+	bool isSet() const { return kind != Kind::NONE; }
+	// Seconds since the epoch as if the wall clock time was UTC
+	int64_t localSeconds() const;
+};
+
+/**
+ * Parses value with the TZID and VALUE parameters in params, e.g. "TZID=Europe/Helsinki".
+ * Returns false if value is not a DATE or DATE-TIME.
+ */
+bool parseDateTime(const char* params, const char* value, DateTime& result);
+
+/**
+ * Writes time as a UTC DATE-TIME, e.g. "20240312T081000Z". buffer must fit 17 bytes.
+ */
+void formatUtc(time_t time, char* buffer);
+
+/**
+ * Converts wall clock times to UTC and back, in the timezones of the bundled table.
+ *
+ * Floating times, dates and TZIDs that are not in the table, e.g. Windows timezone names,
+ * use the device timezone. Keeps the timezone of the last TZID, a calendar rarely has more.
+ */
+class TimeResolver {
+  public:
+	time_t toUtc(const DateTime& time);
+	time_t toUtc(int64_t localSeconds, const char* tzid);
+	int64_t toLocal(time_t utc, const char* tzid);
+
+  private:
+	// nullptr for the device timezone
+	Timezone* _zone(const char* tzid);
+
+	Timezone _tz;
+	char _tzid[TZID_MAX_SIZE] = "";
+	bool _tzFound = false;
+};
+
+/**
+ * Recurrence rule (RRULE) of an event, the parts the parser expands.
+ */
+struct Rule {
+	enum class Frequency : uint8_t { NONE, DAILY, WEEKLY, MONTHLY, YEARLY };
+	Frequency frequency = Frequency::NONE;
+	uint16_t interval = 1;
+	// Zero if not limited
+	uint16_t count = 0;
+	DateTime until;
+	// Bit per weekday, bit 0 is Sunday
+	uint8_t weekdays = 0;
+	// Nth weekday of the month, e.g. -1 for the last, zero for every weekday in weekdays
+	int8_t weekdayOrdinal = 0;
+	uint8_t monthDay = 0;
+	uint8_t month = 0;
+	// Parts the parser doesn't expand, e.g. BYSETPOS or several BYMONTHDAYs
+	bool unsupported = false;
+};
+
+/**
+ * An instance of an event overlapping the window of the parser.
+ */
+struct Occurrence {
+	const char* uid;
+	const char* summary;
+	const char* creator;
+	time_t start;
+	time_t end;
+	// Original start of the instance, zero if the event doesn't recur
+	time_t recurrenceId;
+	// TRANSP:TRANSPARENT events don't make the room busy
+	bool busy;
+	bool allDay;
+};
+
+class Parser {
+  public:
+	using Handler = std::function<void(const Occurrence& occurrence)>;
+
+	Parser(TimeResolver& resolver) : _resolver(resolver) {}
+
+	/**
+	 * Start a new text, handler gets the instances overlapping [windowStart, windowEnd).
+	 */
+	void begin(time_t windowStart, time_t windowEnd, Handler handler);
+
+	void feed(char c);
+	void feed(const char* data, size_t size) {
+		for (size_t i = 0; i < size; i++) feed(data[i]);
+	}
+
+	/**
+	 * End of the text of a calendar object, e.g. a CalDAV calendar-data element.
+	 * Instances of recurring events are handled here, after all their overrides are known.
+	 */
+	void endObject();
+
+  private:
+	struct VEvent {
+		char uid[UID_MAX_SIZE];
+		char summary[TEXT_MAX_SIZE];
+		char creator[TEXT_MAX_SIZE];
+		DateTime start;
+		DateTime end;
+		// Seconds, negative if not given
+		int32_t duration;
+		time_t recurrenceId;
+		Rule rule;
+		time_t exdates[EXDATES_MAX];
+		uint8_t exdateCount;
+		bool cancelled;
+		bool transparent;
+	};
+
+	struct Pending {
+		uint32_t uidHash;
+		char uid[UID_MAX_SIZE];
+		char summary[TEXT_MAX_SIZE];
+		char creator[TEXT_MAX_SIZE];
+		time_t start;
+		time_t end;
+		time_t recurrenceId;
+		bool busy;
+		bool allDay;
+	};
+
+	struct Override {
+		uint32_t uidHash;
+		time_t recurrenceId;
+	};
+
+	void _endLine();
+	void _property(const char* name, const char* params, char* value);
+	void _parseRule(char* value);
+	void _endEvent();
+	void _expand(const VEvent& event, time_t duration);
+	void _emit(const VEvent& event, time_t start, time_t end, time_t recurrenceId);
+	void _addPending(const VEvent& event, time_t start, time_t end);
+	void _flushPending();
+	bool _overlapsWindow(time_t start, time_t end) const;
+
+	TimeResolver& _resolver;
+	Handler _handler;
+	time_t _windowStart = 0;
+	time_t _windowEnd = 0;
+
+	char _line[LINE_MAX_SIZE];
+	size_t _lineLength = 0;
+	bool _lineBreak = false;
+
+	bool _inEvent = false;
+	// Components nested in the VEVENT, e.g. VALARM
+	uint8_t _nested = 0;
+	VEvent _event;
+
+	Pending _pending[PENDING_MAX];
+	size_t _pendingCount = 0;
+	Override _overrides[OVERRIDES_MAX];
+	size_t _overrideCount = 0;
+};
+
+}  // namespace ics
+}  // namespace cal
+
+#endif
@@ -0,0 +1,31 @@
+#include "jsonArena.h"
+
+#include "globals.h"
+
+namespace cal {
+
+JsonArena::JsonArena(const char* name, size_t capacity)
+    : _name{name},
+      _buffer{alloc::makeBuffer(alloc::Pool::JSON, capacity)},
+      _capacity{capacity} {
+	assert(_buffer);
+	metrics.registerJsonArena(this);
+}
+
+JsonArena::~JsonArena() { metrics.unregisterJsonArena(this); }
+
+void JsonArena::reset() { _used = 0; }
+
+char* JsonArena::take(size_t capacity) {
+	// Keeps the alignment ArduinoJson expects from its memory pool
+	assert(capacity % 8 == 0);
+	assert(_used + capacity <= _capacity);
+
+	char* begin = reinterpret_cast<char*>(_buffer.get()) + _used;
+	_used += capacity;
+	if (_used > _peak)
+		_peak = _used;
+	return begin;
+}
+
+}  // namespace cal
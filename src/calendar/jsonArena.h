@@ -0,0 +1,64 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <ArduinoJson.h>
+
+#include <atomic>
+
+#include "allocators.h"
+
+namespace cal {
+
+/**
+ * Memory for the json documents of calendar API requests, owned by the provider.
+ *
+ * The arena is allocated once, sized for the largest request of the provider. Every request
+ * resets it and takes its payload and response documents from it, so requests don't allocate
+ * for json at all and the peak usage is known.
+ *
+ * Not thread safe, the provider is only used from the API task.
+ */
+class JsonArena {
+  public:
+	/**
+	 * Name is used in metrics and must be a string literal.
+	 */
+	JsonArena(const char* name, size_t capacity);
+	~JsonArena();
+
+	/**
+	 * Start a new request, documents taken before are invalid after this.
+	 */
+	void reset();
+
+	/**
+	 * Take the next capacity bytes for a document, capacity must be a multiple of 8.
+	 * Request sizes are constants, so running out is a programming error.
+	 */
+	char* take(size_t capacity);
+
+	const char* name() const { return _name; }
+	size_t capacity() const { return _capacity; }
+	// Highest usage of a single request, readable from any task
+	size_t peak() const { return _peak; }
+
+  private:
+	const char* _name;
+	alloc::Buffer _buffer;
+	size_t _capacity;
+	size_t _used = 0;
+	std::atomic<size_t> _peak{0};
+};
+
+/**
+ * Json document backed by a JsonArena instead of the heap.
+ */
+class ArenaJsonDocument : public JsonDocument {
+  public:
+	ArenaJsonDocument(JsonArena& arena, size_t capacity)
+	    : JsonDocument(arena.take(capacity), capacity) {}
+};
+
+}  // namespace cal
+
+#endif
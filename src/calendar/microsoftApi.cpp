@@ -2,6 +2,7 @@
 
 #include "globals.h"
 #include "timeUtils.h"
+#include "trace.h"
 #include "utils.h"
 
 namespace cal {
@@ -10,23 +11,40 @@ namespace {
 const int EVENT_LIST_MAX_SIZE = 4096;
 const char* EVENT_FIELDS = "id,subject,organizer,start,end";
 const int NAME_GET_MAX_SIZE = 1024;
+const int EVENT_MAX_SIZE = 1024;
+const int AUTH_RESPONSE_MAX_SIZE = 4096;
+const int PAYLOAD_MAX_SIZE = 256;
+
+// Schedule payload lists the room emails
+const int SCHEDULE_PAYLOAD_MAX_SIZE = 2048;
+const int SCHEDULE_FILTER_MAX_SIZE = 256;
+// Only the status and times of schedule items are kept, around 150 bytes each,
+// so a dozen rooms fit with six bookings each
+const int SCHEDULE_RESPONSE_MAX_SIZE = 12 * 1024;
+
+// Largest request is the room schedule, a token response or an event list is not larger
+const int JSON_ARENA_SIZE
+    = SCHEDULE_PAYLOAD_MAX_SIZE + SCHEDULE_FILTER_MAX_SIZE + SCHEDULE_RESPONSE_MAX_SIZE;
+static_assert(PAYLOAD_MAX_SIZE + EVENT_LIST_MAX_SIZE <= JSON_ARENA_SIZE,
+              "Event list must fit the arena");
+static_assert(AUTH_RESPONSE_MAX_SIZE <= JSON_ARENA_SIZE, "Token response must fit the arena");
 }  // namespace
 
 MicrosoftAPI::MicrosoftAPI(const Token& token, const String& calendarId)
-    : _token{token}, _roomEmail{calendarId} {
+    : _token{token}, _roomEmail{calendarId}, _arena{"microsoft", JSON_ARENA_SIZE} {
 	_http.setReuse(false);
+	collectRetryAfter(_http);
 };
 
-const int AUTH_RESPONSE_MAX_SIZE = 4096;
-
-bool MicrosoftAPI::refreshAuth() {
+bool MicrosoftAPI::refreshAuth(time_t validUntil) {
 	log_i("Refreshing token...");
-	if (_token.unixExpiry + 60 > safeUTC.now()) {
+	if (_token.unixExpiry > validUntil) {
 		log_i("Token doesn't need refreshing");
 		return true;
 	}
 
 	// BUILD REQUEST
+	_arena.reset();
 	_http.begin("https://login.microsoftonline.com/organizations/oauth2/v2.0/token");
 	_http.addHeader("Content-Type", "application/x-www-form-urlencoded");
 
@@ -38,8 +56,8 @@ bool MicrosoftAPI::refreshAuth() {
 	String responseBody = _http.getString();
 	_http.end();
 	// log_i("Received refresh auth response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(AUTH_RESPONSE_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	ArenaJsonDocument doc(_arena, AUTH_RESPONSE_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return false;
 
@@ -51,6 +69,7 @@ bool MicrosoftAPI::refreshAuth() {
 		_token.refreshToken = doc["refresh_token"].as<String>();
 		_saveTokenFunc(_token);
 	}
+	saveAccessToken(_token);
 
 	return true;
 };
@@ -65,6 +84,7 @@ Result<CalendarStatus> MicrosoftAPI::fetchCalendarStatus() {
 	}
 
 	// BUILD REQUEST
+	_arena.reset();
 	time_t now = safeMyTZ.now();
 
 	String timeMin = safeMyTZ.dateTime(now, RFC3339);
@@ -89,9 +109,9 @@ Result<CalendarStatus> MicrosoftAPI::fetchCalendarStatus() {
 	// PARSE RESPONSE AS JSON
 	String responseBody = _http.getString();
 	_http.end();
-	log_i("Received event list response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(EVENT_LIST_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event list response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_LIST_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<CalendarStatus>::makeErr(err);
 
@@ -124,6 +144,7 @@ Result<CalendarStatus> MicrosoftAPI::fetchCalendarStatus() {
 
 Result<Event> MicrosoftAPI::endEvent(const String& eventId) {
 	/// BUILD REQUEST
+	_arena.reset();
 	String nowStr = safeMyTZ.dateTime(RFC3339);
 	String url = "https://graph.microsoft.com/v1.0/users/" + _roomEmail + "/events/" + eventId
 	             + "?$select=" + EVENT_FIELDS;
@@ -133,7 +154,7 @@ Result<Event> MicrosoftAPI::endEvent(const String& eventId) {
 	_http.addHeader("Prefer", "outlook.timezone=\"UTC\"");
 
 	// CREATE PAYLOAD
-	StaticJsonDocument<256> payloadDoc;
+	ArenaJsonDocument payloadDoc(_arena, PAYLOAD_MAX_SIZE);
 	payloadDoc["end"]["dateTime"] = nowStr;
 	payloadDoc["end"]["timeZone"] = safeMyTZ.getOlson();
 	String payload = "";
@@ -147,9 +168,9 @@ Result<Event> MicrosoftAPI::endEvent(const String& eventId) {
 	String responseBody = _http.getString();
 	_http.end();
 
-	log_i("Received event patch response:\n%s", responseBody.c_str());
-	StaticJsonDocument<1024> doc;
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event patch response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<Event>::makeErr(err);
 
@@ -174,6 +195,7 @@ Result<Event> MicrosoftAPI::insertEvent(time_t startTime, time_t endTime) {
 	}
 
 	// BUILD REQUEST
+	_arena.reset();
 	String url = "https://graph.microsoft.com/v1.0/users/" + _roomEmail
 	             + "/events/?$select=" + String(EVENT_FIELDS);
 	_http.begin(url);
@@ -182,7 +204,7 @@ Result<Event> MicrosoftAPI::insertEvent(time_t startTime, time_t endTime) {
 	_http.addHeader("Authorization", "Bearer " + _token.accessToken);
 
 	// CREATE PAYLOAD
-	StaticJsonDocument<256> payloadDoc;
+	ArenaJsonDocument payloadDoc(_arena, PAYLOAD_MAX_SIZE);
 	payloadDoc["start"]["dateTime"] = safeMyTZ.dateTime(startTime, UTC_TIME, RFC3339);
 	payloadDoc["start"]["timeZone"] = safeMyTZ.getOlson();
 	payloadDoc["end"]["dateTime"] = safeMyTZ.dateTime(endTime, UTC_TIME, RFC3339);
@@ -201,9 +223,9 @@ Result<Event> MicrosoftAPI::insertEvent(time_t startTime, time_t endTime) {
 	String responseBody = _http.getString();
 	_http.end();
 
-	log_i("Received event insert response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(1024);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event insert response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<Event>::makeErr(err);
 
@@ -229,6 +251,7 @@ Result<Event> MicrosoftAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t
 	}
 
 	/// BUILD REQUEST
+	_arena.reset();
 	String nowStr = safeMyTZ.dateTime(RFC3339);
 	String url = "https://graph.microsoft.com/v1.0/users/" + _roomEmail + "/events/" + event->id
 	             + "?$select=" + EVENT_FIELDS;
@@ -238,7 +261,7 @@ Result<Event> MicrosoftAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t
 	_http.addHeader("Prefer", "outlook.timezone=\"UTC\"");
 
 	// CREATE PAYLOAD
-	StaticJsonDocument<256> payloadDoc;
+	ArenaJsonDocument payloadDoc(_arena, PAYLOAD_MAX_SIZE);
 	payloadDoc["start"]["dateTime"] = safeMyTZ.dateTime(newStartTime, UTC_TIME, RFC3339);
 	payloadDoc["start"]["timeZone"] = safeMyTZ.getOlson();
 	payloadDoc["end"]["dateTime"] = safeMyTZ.dateTime(newEndTime, UTC_TIME, RFC3339);
@@ -254,9 +277,9 @@ Result<Event> MicrosoftAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t
 	String responseBody = _http.getString();
 	_http.end();
 
-	log_i("Received event patch response:\n%s", responseBody.c_str());
-	StaticJsonDocument<1024> doc;
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event patch response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<Event>::makeErr(err);
 
@@ -272,6 +295,7 @@ Result<Event> MicrosoftAPI::rescheduleEvent(std::shared_ptr<Event> event, time_t
 
 Result<bool> MicrosoftAPI::isFree(time_t startTime, time_t endTime, const String& ignoreId) {
 	// BUILD REQUEST
+	_arena.reset();
 	String timeMin = safeMyTZ.dateTime(startTime, UTC_TIME, RFC3339);
 	timeMin.replace("+", "%2b");
 	// Add milliseconds to ignore events that end in this second
@@ -296,9 +320,9 @@ Result<bool> MicrosoftAPI::isFree(time_t startTime, time_t endTime, const String
 	// PARSE RESPONSE AS JSON
 	String responseBody = _http.getString();
 	_http.end();
-	log_i("Received event list response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(EVENT_LIST_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received event list response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, EVENT_LIST_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<bool>::makeErr(err);
 
@@ -315,7 +339,97 @@ Result<bool> MicrosoftAPI::isFree(time_t startTime, time_t endTime, const String
 	return Result<bool>::makeOk(new bool(true));
 }
 
-Result<String> MicrosoftAPI::getRoomName() {  // BUILD REQUEST
+Result<std::vector<RoomStatus>> MicrosoftAPI::fetchRoomStatuses(const std::vector<Room>& rooms) {
+	using RoomsResult = Result<std::vector<RoomStatus>>;
+	if (rooms.size() > ROOMS_MAX) {
+		return RoomsResult::makeErr(new Error(Error::Type::LOGICAL, "Too many rooms, at most "
+		                                                                 + String(ROOMS_MAX)
+		                                                                 + " are supported"));
+	}
+
+	// BUILD REQUEST
+	_arena.reset();
+	time_t now = safeMyTZ.now();
+	// Schedules of other mailboxes are readable through the signed in user
+	_http.begin("https://graph.microsoft.com/v1.0/me/calendar/getSchedule");
+	_http.addHeader("Content-Type", "application/json");
+	_http.addHeader("Authorization", "Bearer " + _token.accessToken);
+	_http.addHeader("Prefer", "outlook.timezone=\"UTC\"");
+	// HTTP/1.0 responses are not chunked, so the json can be parsed straight from the stream
+	_http.useHTTP10(true);
+
+	// CREATE PAYLOAD
+	ArenaJsonDocument payloadDoc(_arena, SCHEDULE_PAYLOAD_MAX_SIZE);
+	JsonArray schedules = payloadDoc.createNestedArray("schedules");
+	for (const Room& room : rooms) schedules.add(room.id);
+	payloadDoc["startTime"]["dateTime"] = safeMyTZ.dateTime(now, "Y-m-d~TH:i:s");
+	payloadDoc["startTime"]["timeZone"] = safeMyTZ.getOlson();
+	payloadDoc["endTime"]["dateTime"]
+	    = safeMyTZ.dateTime(timeutils::getNextMidnight(now), "Y-m-d~TH:i:s");
+	payloadDoc["endTime"]["timeZone"] = safeMyTZ.getOlson();
+	String payload = "";
+	serializeJson(payloadDoc, payload);
+
+	// SEND REQUEST
+	int httpCode = _http.POST(payload);
+	payload.clear();
+
+	// PARSE RESPONSE AS JSON
+	ArenaJsonDocument filter(_arena, SCHEDULE_FILTER_MAX_SIZE);
+	JsonObject scheduleFilter = filter["value"].createNestedObject();
+	scheduleFilter["scheduleId"] = true;
+	scheduleFilter["error"] = true;
+	JsonObject itemFilter = scheduleFilter["scheduleItems"].createNestedObject();
+	itemFilter["status"] = true;
+	itemFilter["start"]["dateTime"] = true;
+	itemFilter["end"]["dateTime"] = true;
+
+	ArenaJsonDocument doc(_arena, SCHEDULE_RESPONSE_MAX_SIZE);
+	auto err = parseJSONStream(doc, httpCode, _http.getStream(), filter, &_http);
+	_http.end();
+	_http.useHTTP10(false);
+	if (err)
+		return RoomsResult::makeErr(err);
+	TRACE_HTTP("Received schedule response, %u bytes kept", doc.memoryUsage());
+
+	// PARSE JSON AS ROOM STATUSES
+	auto statuses = new std::vector<RoomStatus>();
+	statuses->reserve(rooms.size());
+	std::vector<BusyPeriod> busy;
+	JsonArrayConst values = doc["value"].as<JsonArrayConst>();
+	now = safeUTC.now();
+	for (const Room& room : rooms) {
+		JsonObjectConst schedule;
+		for (JsonObjectConst value : values) {
+			if (room.id.equalsIgnoreCase(value["scheduleId"].as<String>())) {
+				schedule = value;
+				break;
+			}
+		}
+		if (schedule.isNull() || schedule.containsKey("error")) {
+			log_w("No schedule for room %s", room.id.c_str());
+			statuses->push_back(RoomStatus{room.name, RoomStatus::State::UNKNOWN, 0});
+			continue;
+		}
+
+		// Tentative and out of office bookings count as busy
+		busy.clear();
+		for (JsonObjectConst item : schedule["scheduleItems"].as<JsonArrayConst>()) {
+			if (item["status"] == "free")
+				continue;
+			// Times are UTC without an offset, see the Prefer header
+			busy.push_back(BusyPeriod{parseJsonTimestamp(item["start"]["dateTime"]),
+			                          parseJsonTimestamp(item["end"]["dateTime"])});
+		}
+		statuses->push_back(roomStatusFromBusy(room.name, busy, now));
+	}
+
+	return RoomsResult::makeOk(statuses);
+}
+
+Result<String> MicrosoftAPI::getRoomName() {
+	// BUILD REQUEST
+	_arena.reset();
 	String url = "https://graph.microsoft.com/v1.0/users/" + _roomEmail + "/calendar?$select=owner";
 
 	_http.begin(url);
@@ -327,9 +441,9 @@ Result<String> MicrosoftAPI::getRoomName() {  // BUILD REQUEST
 	// PARSE RESPONSE AS JSON
 	String responseBody = _http.getString();
 	_http.end();
-	log_i("Received room name response:\n%s", responseBody.c_str());
-	DynamicJsonDocument doc(NAME_GET_MAX_SIZE);
-	auto err = parseJSONResponse(doc, httpCode, responseBody);
+	TRACE_HTTP("Received room name response:\n%s", responseBody.c_str());
+	ArenaJsonDocument doc(_arena, NAME_GET_MAX_SIZE);
+	auto err = parseJSONResponse(doc, httpCode, responseBody, &_http);
 	if (err)
 		return Result<String>::makeErr(err);
 
@@ -337,8 +451,9 @@ Result<String> MicrosoftAPI::getRoomName() {  // BUILD REQUEST
 }
 
 std::shared_ptr<Event> MicrosoftAPI::extractEvent(JsonObjectConst object) {
-	auto start = timeutils::parseRfcTimestamp(object["start"]["dateTime"].as<String>() + "Z");
-	auto end = timeutils::parseRfcTimestamp(object["end"]["dateTime"].as<String>() + "Z");
+	// Times are UTC without an offset, see the Prefer header
+	auto start = parseJsonTimestamp(object["start"]["dateTime"]);
+	auto end = parseJsonTimestamp(object["end"]["dateTime"]);
 	return std::shared_ptr<Event>(new Event{
 	    .id = object["id"],
 	    // object["organizer"]["emailAddress"]["name"] could also be used
@@ -5,6 +5,7 @@
 #include <HTTPClient.h>
 
 #include "api.h"
+#include "jsonArena.h"
 #include "utils.h"
 
 namespace cal {
@@ -13,12 +14,15 @@ class MicrosoftAPI : public API {
   public:
 	MicrosoftAPI(const Token& token, const String& roomEmail);
 
-	bool refreshAuth() override final;
+	bool refreshAuth(time_t validUntil) override final;
+	time_t getTokenExpiry() override final { return _token.unixExpiry; }
 	Result<CalendarStatus> fetchCalendarStatus() override final;
 	Result<Event> endEvent(const String& eventId) override final;
 	Result<Event> insertEvent(time_t startTime, time_t endTime) override final;
 	Result<Event> rescheduleEvent(std::shared_ptr<Event> event, time_t newStartTime,
 	                              time_t newEndTime) override final;
+	Result<std::vector<RoomStatus>> fetchRoomStatuses(
+	    const std::vector<Room>& rooms) override final;
 
 	void registerSaveTokenFunc(std::function<void(const Token&)> saveTokenFunc) {
 		_saveTokenFunc = saveTokenFunc;
@@ -42,6 +46,8 @@ class MicrosoftAPI : public API {
 	Token _token;
 	String _roomEmail;
 	String _roomName;
+	// Documents of the current request, reset at the start of every request
+	JsonArena _arena;
 
 	HTTPClient _http;
 };
@@ -4,6 +4,7 @@
 
 #include "globals.h"
 #include "gui/guiTask.h"
+#include "resumeState.h"
 
 namespace cal {
 
@@ -13,7 +14,14 @@ void Model::_handleError(size_t reqType, std::shared_ptr<Error> error) {
 	// Logical errors are most likely caused by out of date information, so we need to update it
 	if (reqType != (size_t)GuiReq::UPDATE && error->type == Error::Type::LOGICAL)
 		updateStatus();
+	// Don't poll again before the provider or the rate limiter lets the request through
+	if (reqType == (size_t)GuiReq::UPDATE && error->retryAfter > 0) {
+		const time_t notBefore = safeUTC.now() + error->retryAfter;
+		if (scheduler.getDeadline(Scheduler::Job::STATUS_POLL) < notBefore)
+			scheduler.setDeadline(Scheduler::Job::STATUS_POLL, notBefore);
+	}
 	log_e("%s", error->message.c_str());
+	eventLog.append(EventLog::Type::ERROR, error->message);
 	_guiTask->error((GuiReq)reqType, error);
 }
 
@@ -30,20 +38,15 @@ Model::Model(APITask& apiTask) : _apiTask{apiTask} {
 	_apiTask.callbackEndEvent = std::bind(&Model::_onEndEvent, this, _1);
 	_apiTask.callbackInsertEvent = std::bind(&Model::_onInsertEvent, this, _1);
 	_apiTask.callbackRescheduleEvent = std::bind(&Model::_onExtendEvent, this, _1);
+	_apiTask.callbackRoomStatuses = std::bind(&Model::_onRoomStatuses, this, _1);
 
-	sleepManager.registerCallback(SleepManager::Callback::BEFORE_SLEEP, [this]() {
-		time_t now = safeUTC.now();
-		if (_nextStatusUpdate <= now) {
-			updateStatus();  // This will cancel sleep
-		}
-	});
+	scheduler.addJob(Scheduler::Job::STATUS_POLL, STATUS_UPDATE_INTERVAL_S,
+	                 STATUS_UPDATE_SLACK_S, [this]() { updateStatus(); });
 
-	sleepManager.registerCallback(SleepManager::Callback::AFTER_WAKE_TIMER, [this]() {
-		time_t now = safeUTC.now();
-		// Take into account inaccuracies in sleep time with -2
-		if (_nextStatusUpdate >= now - 2) {
-			updateStatus();
-		};
+	sleepManager.registerCallback(SleepManager::Callback::BEFORE_DEEP_SLEEP, [this]() {
+		std::lock_guard<std::mutex> lock(_statusMutex);
+		if (_status)
+			resume::saveStatus(*_status);
 	});
 }
 
@@ -170,11 +173,18 @@ void Model::_onExtendEvent(const Result<Event>& result) {
 	_guiTask->success(GuiReq::OTHER, _status);
 }
 
+void Model::resumeStatus(std::shared_ptr<CalendarStatus> status) {
+	std::lock_guard<std::mutex> lock(_statusMutex);
+	_status = status;
+}
+
 void Model::updateStatus() {
 	log_i("Fetching calendar status.");
-	_nextStatusUpdate = safeUTC.now() + STATUS_UPDATE_INTERVAL_S;
-	sleepManager.nextWakeTime = _nextStatusUpdate;
-	_apiTask.fetchCalendarStatus();
+	scheduler.reschedule(Scheduler::Job::STATUS_POLL);
+	if (_rooms.empty())
+		_apiTask.fetchCalendarStatus();
+	else
+		_apiTask.fetchRoomStatuses(_rooms);
 }
 
 void Model::_onCalendarStatus(const Result<CalendarStatus>& result) {
@@ -202,6 +212,25 @@ void Model::_onCalendarStatus(const Result<CalendarStatus>& result) {
 	_guiTask->success(GuiReq::UPDATE, _status);
 }
 
+void Model::_onRoomStatuses(const Result<std::vector<RoomStatus>>& result) {
+	std::lock_guard<std::mutex> lock(_statusMutex);
+	log_i("Received room statuses.");
+
+	if (result.isErr()) {
+		return _handleError((size_t)GuiReq::UPDATE, result.err());
+	}
+
+	// Don't send an update to GUI if nothing changed
+	if (_roomStatuses && *_roomStatuses == *result.ok()) {
+		_guiTask->showRoomStatuses(nullptr);
+		return;
+	}
+
+	_roomStatuses = result.ok();
+
+	_guiTask->showRoomStatuses(_roomStatuses);
+}
+
 bool Model::_areEqual(std::shared_ptr<Event> event1, std::shared_ptr<Event> event2) const {
 	if (!!event1 != !!event2)
 		return false;
@@ -53,8 +53,20 @@ class Model {
 	void extendCurrentEvent(int seconds);
 
 	/**
-	 * Fetch the current status of the calendar.
-	 * Also updates sleep timings in sleep manager.
+	 * Restore status saved before deep sleep, instead of waiting for the first fetch.
+	 * The next fetch is scheduled by the restored Scheduler deadlines.
+	 */
+	void resumeStatus(std::shared_ptr<CalendarStatus> status);
+
+	/**
+	 * Show the statuses of these rooms instead of the calendar of the device (dashboard mode).
+	 * Set before the first updateStatus, booking is not available in this mode.
+	 */
+	void setRooms(const std::vector<Room>& rooms) { _rooms = rooms; }
+
+	/**
+	 * Fetch the current status of the calendar, or of the rooms in dashboard mode.
+	 * Also moves the next scheduled status poll forward.
 	 */
 	void updateStatus();
 
@@ -63,6 +75,7 @@ class Model {
 	void _onEndEvent(const Result<Event>& result);
 	void _onInsertEvent(const Result<Event>& result);
 	void _onExtendEvent(const Result<Event>& result);
+	void _onRoomStatuses(const Result<std::vector<RoomStatus>>& result);
 
 	bool _areEqual(std::shared_ptr<Event> event1, std::shared_ptr<Event> event2) const;
 
@@ -85,13 +98,14 @@ class Model {
 	template <typename T>
 	utils::Result<T> _handleStateErrorSync(utils::Error* error);
 
-	// Protects _status;
+	// Protects _status and _roomStatuses;
 	std::mutex _statusMutex;
 	// Remember to protect with mutex as multiple tasks call functions of Model.
 	std::shared_ptr<CalendarStatus> _status = std::make_shared<CalendarStatus>();
+	std::shared_ptr<std::vector<RoomStatus>> _roomStatuses = nullptr;
 
-	// Unix UTC seconds
-	time_t _nextStatusUpdate = 0;
+	// Rooms of the dashboard mode, empty when showing the calendar of the device
+	std::vector<Room> _rooms;
 
 	APITask& _apiTask;
 	gui::GUITask* _guiTask = nullptr;
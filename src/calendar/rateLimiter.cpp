@@ -0,0 +1,122 @@
+#include "rateLimiter.h"
+
+#include <esp_system.h>
+#include <ezTime.h>
+
+namespace cal {
+
+namespace {
+const time_t BACKOFF_BASE_S = 30;
+const time_t BACKOFF_MAX_S = 10 * SECS_PER_MIN;
+const time_t OPEN_BASE_S = 5 * SECS_PER_MIN;
+const time_t OPEN_MAX_S = 2 * SECS_PER_HOUR;
+
+/**
+ * Random time in [delay / 2, delay], so retries don't line up but still wait at least half.
+ */
+time_t jitter(time_t delay) { return delay / 2 + esp_random() % (delay / 2 + 1); }
+
+// Doubles the delay for every step, up to maxDelay
+time_t exponential(time_t base, uint8_t steps, time_t maxDelay) {
+	return min(base << min(steps, (uint8_t)16), maxDelay);
+}
+
+/**
+ * Responses that tell to slow down. Other failures, e.g. a declined booking or a lost
+ * connection, say nothing about the quota.
+ */
+bool isThrottled(const Error& err) {
+	return err.type == Error::Type::HTTP
+	       && (err.httpCode == 429 || err.httpCode >= 500 || err.retryAfter > 0);
+}
+}  // namespace
+
+RateLimiter::RateLimiter(uint16_t capacity, time_t refillS)
+    : _capacity{capacity},
+      _refillS{refillS},
+      _state{
+          .tokens = capacity,
+          .refilledAt = 0,
+          .failures = 0,
+          .circuit = Circuit::CLOSED,
+          .blockedUntil = 0,
+      } {}
+
+void RateLimiter::_refill(time_t now) {
+	if (_state.tokens >= _capacity || now < _state.refilledAt) {
+		// Also when the clock has jumped back, e.g. when it was set from NTP
+		_state.refilledAt = now;
+		return;
+	}
+	const time_t added = (now - _state.refilledAt) / _refillS;
+	_state.tokens = min((time_t)_capacity, _state.tokens + added);
+	_state.refilledAt += added * _refillS;
+}
+
+time_t RateLimiter::acquire(time_t now) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (now < _state.blockedUntil)
+		return _state.blockedUntil;
+
+	if (_state.circuit == Circuit::OPEN) {
+		log_i("Probing whether the provider has recovered");
+		_state.circuit = Circuit::HALF_OPEN;
+	}
+
+	_refill(now);
+	if (_state.tokens == 0)
+		return _state.refilledAt + _refillS;
+	_state.tokens--;
+	return 0;
+}
+
+void RateLimiter::record(const Error* err, time_t now) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!err) {
+		if (_state.circuit != Circuit::CLOSED)
+			log_i("Provider has recovered, circuit closed");
+		_state.failures = 0;
+		_state.circuit = Circuit::CLOSED;
+		return;
+	}
+	if (!isThrottled(*err))
+		return;
+
+	_state.failures = min(_state.failures + 1, 0xFF);
+	time_t delay;
+	if (_state.failures >= FAILURES_TO_OPEN) {
+		_state.circuit = Circuit::OPEN;
+		delay = jitter(exponential(OPEN_BASE_S, _state.failures - FAILURES_TO_OPEN, OPEN_MAX_S));
+	} else {
+		delay = jitter(exponential(BACKOFF_BASE_S, _state.failures - 1, BACKOFF_MAX_S));
+	}
+	delay = max(delay, err->retryAfter);
+	_state.blockedUntil = now + delay;
+	log_w("Provider is throttling (%u in a row), holding requests back for %ld s%s",
+	      _state.failures, (long)delay, _state.circuit == Circuit::OPEN ? ", circuit open" : "");
+}
+
+RateLimiter::Circuit RateLimiter::circuit() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _state.circuit;
+}
+
+RateLimiter::State RateLimiter::getState() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _state;
+}
+
+void RateLimiter::setState(const State& state) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state = state;
+	_state.tokens = min(_state.tokens, _capacity);
+}
+
+std::shared_ptr<Error> RateLimiter::heldBackError(time_t until, time_t now) {
+	auto err = std::make_shared<Error>(
+	    Error::Type::HTTP, "Too many requests, next one in " + String(until - now) + " s");
+	err->retryAfter = until - now;
+	return err;
+}
+
+}  // namespace cal
@@ -0,0 +1,81 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+
+#include <memory>
+#include <mutex>
+
+#include "api.h"
+
+namespace cal {
+
+/**
+ * Client side limit of the requests sent with one provider credential, shared by all request
+ * types.
+ *
+ * A token bucket spaces the requests out, so a burst of touches or a polling loop can't run
+ * through the provider quota. Responses that ask to slow down (429 and 5xx) hold the following
+ * requests back for an exponential backoff with jitter, at least as long as their Retry-After.
+ * After FAILURES_TO_OPEN of them in a row the circuit opens for longer, and when it has been
+ * open long enough a single request probes whether the provider has recovered.
+ *
+ * The jitter spreads out the devices that were throttled at the same moment, so a fleet comes
+ * back gradually instead of all at once.
+ */
+class RateLimiter {
+  public:
+	enum class Circuit : uint8_t { CLOSED, OPEN, HALF_OPEN };
+
+	// Throttled responses in a row that open the circuit
+	static const uint8_t FAILURES_TO_OPEN = 3;
+
+	/**
+	 * Everything the limiter knows, kept over deep sleep.
+	 */
+	struct State {
+		uint16_t tokens;
+		time_t refilledAt;
+		uint8_t failures;
+		Circuit circuit;
+		time_t blockedUntil;
+	};
+
+	/**
+	 * Bursts of at most capacity requests, and one more every refillS seconds.
+	 */
+	RateLimiter(uint16_t capacity, time_t refillS);
+
+	/**
+	 * Take a token for a request sent at now. Returns 0 if the request may be sent, otherwise
+	 * the time until which requests are held back.
+	 */
+	time_t acquire(time_t now);
+
+	/**
+	 * Record the result of a sent request, err is nullptr on success.
+	 */
+	void record(const Error* err, time_t now);
+
+	Circuit circuit();
+	State getState();
+	void setState(const State& state);
+
+	/**
+	 * Error of a request held back until `until`, its retryAfter is the time left.
+	 */
+	static std::shared_ptr<Error> heldBackError(time_t until, time_t now);
+
+  private:
+	void _refill(time_t now);
+
+	const uint16_t _capacity;
+	const time_t _refillS;
+
+	std::mutex _mutex;
+	State _state;
+};
+
+}  // namespace cal
+
+#endif
@@ -1,57 +1,256 @@
 #include "configServer.h"
 
+#include <rom/crc.h>
+
 #include <memory>
 
+#include "globals.h"
+
 namespace config {
 
+namespace {
+// Compact when the journal grows beyond a single LittleFS block
+const size_t JOURNAL_MAX_SIZE = 4096;
+// Written by scripts/compress_webroot.py
+const char* WEBROOT_INDEX_NAME = "/etags.txt";
+// Interval of the metrics snapshots sent on /events
+const uint32_t METRICS_EVENT_INTERVAL_MS = 1000;
+const size_t METRICS_EVENT_DOC_SIZE = 2048;
+const uint32_t METRICS_TASK_STACK_SIZE = 4096;
+const UBaseType_t METRICS_TASK_PRIORITY = 1;
+
+Result<bool> makeError(const String& errMsg) {
+	log_e("%s", errMsg.c_str());
+	return Result<bool>::makeErr(
+	    std::make_shared<ConfigError_t>(ConfigError_t{.errorMessage = errMsg}));
+}
+}  // namespace
+
 void ConfigStore::loadConfig() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
 	// Release old memory if it exists
-	config_ = DynamicJsonDocument(4096);
+	config_ = SpiRamJsonDocument(4096);
 
-	log_i("Trying to load %s.json from flash...", configFileName_.c_str());
+	log_i("Trying to load %s from flash...", snapshotPath().c_str());
 
-	File configFileHandle = fs_.open(configFileName_ + ".json", FILE_READ);
+	File configFileHandle = fs_.open(snapshotPath(), FILE_READ);
 	if (configFileHandle) {
 		auto err = deserializeJson(config_, configFileHandle);
 		if (err) {
-			log_e("Error deserializing %s.json: %s", configFileName_.c_str(), err.c_str());
+			log_e("Error deserializing %s: %s", snapshotPath().c_str(), err.c_str());
 		}
-		log_i("%s.json loaded from flash", configFileName_.c_str());
+		log_i("%s loaded from flash", snapshotPath().c_str());
 		configFileHandle.close();
-		return;
+	} else {
+		log_i("No existing config file found on flash");
 	}
 
-	log_i("No existing config file found on flash");
+	if (!replayJournal()) {
+		log_w("Dropped broken journal records, compacting");
+		writeSnapshot();
+	}
 };
 
-Result<bool> ConfigStore::mergeConfig(JsonVariantConst newConfig) {
-	File configFileHandle = fs_.open(configFileName_ + ".json", FILE_WRITE);
+bool ConfigStore::replayJournal() {
+	if (!fs_.exists(journalPath()))
+		return true;
+
+	File journal = fs_.open(journalPath(), FILE_READ);
+	if (!journal)
+		return true;
+
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[JOURNAL_RECORD_MAX_SIZE]);
+	// Strings are copied from the buffer, so the document needs some headroom
+	SpiRamJsonDocument patch(JOURNAL_RECORD_MAX_SIZE * 2);
+	size_t records = 0;
+	bool valid = true;
 
-	if (!configFileHandle) {
-		String errMsg = "Cannot open configfile for writing";
-		log_e("%s", errMsg.c_str());
-		return Result<bool>::makeErr(
-		    std::make_shared<ConfigError_t>(ConfigError_t{.errorMessage = errMsg}));
+	// Record: uint16_t payload length, MessagePack payload, uint32_t crc32 of payload
+	while (journal.available()) {
+		uint16_t length = 0;
+		uint32_t crc = 0;
+		if (journal.read((uint8_t*)&length, sizeof(length)) != sizeof(length)
+		    || length > JOURNAL_RECORD_MAX_SIZE || journal.read(buffer.get(), length) != length
+		    || journal.read((uint8_t*)&crc, sizeof(crc)) != sizeof(crc)
+		    || crc != crc32_le(0, buffer.get(), length)) {
+			valid = false;
+			break;
+		}
+
+		if (deserializeMsgPack(patch, buffer.get(), length)) {
+			valid = false;
+			break;
+		}
+		utils::merge(config_.as<JsonVariant>(), patch.as<JsonVariantConst>());
+		records++;
 	}
+	journal.close();
+
+	config_.garbageCollect();
+	log_i("Replayed %u config journal records", records);
+
+	return valid;
+}
 
-	DynamicJsonDocument copy = getConfigJsonCopy();
+Result<bool> ConfigStore::appendJournal(JsonVariantConst patch) {
+	const size_t length = measureMsgPack(patch);
+	if (length > JOURNAL_RECORD_MAX_SIZE)
+		return writeSnapshot();
 
-	utils::merge(copy.as<JsonVariant>(), newConfig);
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[length]);
+	serializeMsgPack(patch, buffer.get(), length);
+	const uint16_t length16 = length;
+	const uint32_t crc = crc32_le(0, buffer.get(), length);
 
-	serializeJson(copy, configFileHandle);
+	File journal = fs_.open(journalPath(), FILE_APPEND, true);
+	if (!journal)
+		return makeError("Cannot open config journal for writing");
+
+	bool ok = journal.write((const uint8_t*)&length16, sizeof(length16)) == sizeof(length16)
+	          && journal.write(buffer.get(), length) == length
+	          && journal.write((const uint8_t*)&crc, sizeof(crc)) == sizeof(crc);
+	const size_t journalSize = journal.size();
+	journal.close();
+
+	if (!ok)
+		return makeError("Config journal write failed");
+
+	if (journalSize > JOURNAL_MAX_SIZE)
+		return writeSnapshot();
+
+	return Result<bool>::makeOk(std::make_shared<bool>(true));
+}
+
+Result<bool> ConfigStore::writeSnapshot() {
+	const String tmpPath = snapshotPath() + ".tmp";
+	File configFileHandle = fs_.open(tmpPath, FILE_WRITE);
+
+	if (!configFileHandle)
+		return makeError("Cannot open configfile for writing");
+
+	size_t written = serializeJson(config_, configFileHandle);
 	configFileHandle.close();
 
+	if (written == 0 || !fs_.rename(tmpPath, snapshotPath())) {
+		fs_.remove(tmpPath);
+		return makeError("Config snapshot write failed");
+	}
+
+	// The snapshot now contains every journal record. Should we lose power before the journal is
+	// removed, replaying it again is harmless as merges are idempotent.
+	fs_.remove(journalPath());
+
 	return Result<bool>::makeOk(std::make_shared<bool>(true));
+}
+
+Result<bool> ConfigStore::mergeConfig(JsonVariantConst newConfig) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	utils::merge(config_.as<JsonVariant>(), newConfig);
+	config_.garbageCollect();
+	if (config_.overflowed())
+		log_e("Config document overflowed, some values were not saved in memory");
+
+	return appendJournal(newConfig);
 };
 
+JsonVariant ConfigStore::addKeyPath(JsonDocument& doc, const String& keyPath) {
+	JsonVariant target = doc.to<JsonVariant>();
+
+	int begin = 0;
+	while (true) {
+		int dot = keyPath.indexOf('.', begin);
+		target = target.getOrAddMember(keyPath.substring(begin, dot == -1 ? keyPath.length() : dot));
+		if (dot == -1)
+			return target;
+		begin = dot + 1;
+	}
+}
+
+Result<bool> ConfigStore::compact() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return writeSnapshot();
+}
+
 Result<bool> ConfigStore::remove() {
+	std::lock_guard<std::mutex> lock(mutex_);
 	config_.clear();
-	auto err = fs_.remove(configFileName_);
-	return !err ? Result<bool>::makeOk(std::make_shared<bool>(true))
-	            : Result<bool>::makeErr(
-	                new ConfigError_t{.errorMessage = "Could not remove config file from flash"});
+	fs_.remove(journalPath());
+	bool removed = !fs_.exists(snapshotPath()) || fs_.remove(snapshotPath());
+	return removed ? Result<bool>::makeOk(std::make_shared<bool>(true))
+	               : Result<bool>::makeErr(
+	                   new ConfigError_t{.errorMessage = "Could not remove config file from flash"});
 };
 
+WebrootHandler::WebrootHandler(fs::FS& fs, const String& root) : fs_(fs), root_(root) {
+	File index = fs_.open(root_ + WEBROOT_INDEX_NAME, FILE_READ);
+	if (!index) {
+		log_e("%s%s not found, the setup page is not served", root_.c_str(), WEBROOT_INDEX_NAME);
+		return;
+	}
+
+	// Line: <path> <etag> <1 if a .gz variant exists, else 0>
+	while (index.available()) {
+		String line = index.readStringUntil('\n');
+		int etagStart = line.indexOf(' ');
+		int gzipStart = line.lastIndexOf(' ');
+		if (etagStart <= 0 || gzipStart <= etagStart)
+			continue;
+		files_[line.substring(0, etagStart)] = FileEntry{
+		    line.substring(etagStart + 1, gzipStart), line.substring(gzipStart + 1) == "1"};
+	}
+	index.close();
+	log_i("Indexed %u webroot files", files_.size());
+}
+
+String WebrootHandler::filePath(const String& url) {
+	return url == "/" ? String("/index.html") : url;
+}
+
+bool WebrootHandler::canHandle(AsyncWebServerRequest* request) {
+	if (request->method() != HTTP_GET || files_.find(filePath(request->url())) == files_.end())
+		return false;
+
+	// Headers are parsed after this, only the interesting ones are kept
+	request->addInterestingHeader("Accept-Encoding");
+	request->addInterestingHeader("If-None-Match");
+	return true;
+}
+
+void WebrootHandler::handleRequest(AsyncWebServerRequest* request) {
+	const String path = filePath(request->url());
+	const FileEntry& entry = files_.find(path)->second;
+
+	const bool gzip = entry.hasGzip && request->hasHeader("Accept-Encoding")
+	                  && request->header("Accept-Encoding").indexOf("gzip") != -1;
+	// Encodings are different representations, so they need different strong ETags
+	const String etag = "\"" + entry.etag + (gzip ? "-gz" : "") + "\"";
+
+	AsyncWebServerResponse* response;
+	if (request->hasHeader("If-None-Match")
+	    && request->header("If-None-Match").indexOf(etag) != -1) {
+		response = request->beginResponse(304);
+	} else {
+		File file = fs_.open(root_ + path + (gzip ? ".gz" : ""), FILE_READ);
+		if (!file) {
+			request->send(404, "application/json", "{\"error\":\"Path does not exist\"}");
+			return;
+		}
+		// Content type is picked from the path, Content-Encoding from the .gz file name
+		response = request->beginResponse(file, path);
+	}
+
+	response->addHeader("ETag", etag);
+	// Assets are fingerprinted, index.html is revalidated on every load
+	response->addHeader("Cache-Control", path.startsWith("/assets/")
+	                                         ? "max-age=31536000, immutable"
+	                                         : "no-cache");
+	if (entry.hasGzip)
+		response->addHeader("Vary", "Accept-Encoding");
+	request->send(response);
+}
+
 bool ConfigServer::canHandle(AsyncWebServerRequest* request) {
 	return request->url() == "/config" and request->method() == HTTP_GET;
 };
@@ -93,15 +292,28 @@ void ConfigServer::start() {
 
 	server_->addHandler(configHandler);
 
-	// Serve index.html without cache on the empty path
-	server_->on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
-		request->send(LittleFS, "/webroot/index.html");
+	// Daily energy ledger aggregates, newest first
+	server_->on("/energy", HTTP_GET, [](AsyncWebServerRequest* request) {
+		AsyncResponseStream* response = request->beginResponseStream("application/json");
+		SpiRamJsonDocument doc(ENERGY_LEDGER_DAYS * 512);
+		energyLedger.toJson(doc.to<JsonArray>());
+		serializeJson(doc, *response);
+		request->send(response);
 	});
 
-	// Serve assets with a large max-age to save bandwith.
-	// They are fingerprinted to handle content updates.
-	server_->serveStatic("/assets/", LittleFS, "/webroot/assets")
-	    .setCacheControl("max-age=31536000");
+	// Boots, shutdowns and errors, newest first. /events is the metrics event stream.
+	server_->on("/eventlog", HTTP_GET, [](AsyncWebServerRequest* request) {
+		AsyncResponseStream* response = request->beginResponseStream("application/json");
+		SpiRamJsonDocument doc(EVENT_LOG_RECORDS * 192);
+		eventLog.toJson(doc.to<JsonArray>());
+		serializeJson(doc, *response);
+		request->send(response);
+	});
+
+	// index.html on the empty path and the fingerprinted assets
+	server_->addHandler(new WebrootHandler(LittleFS, "/webroot"));
+
+	addMetricsHandlers();
 
 	server_->onNotFound([](AsyncWebServerRequest* request) {
 		request->send(404, "application/json", "{\"error\":\"Path does not exist\"}");
@@ -110,4 +322,102 @@ void ConfigServer::start() {
 	server_->begin();
 };
 
+void ConfigServer::startMetrics() {
+	server_ = new AsyncWebServer(port_);
+	addMetricsHandlers();
+
+	server_->onNotFound([](AsyncWebServerRequest* request) {
+		request->send(404, "application/json", "{\"error\":\"Path does not exist\"}");
+	});
+
+	server_->begin();
+}
+
+void ConfigServer::addMetricsHandlers() {
+	server_->on("/metrics", HTTP_GET, [](AsyncWebServerRequest* request) {
+		// Prometheus text exposition format
+		AsyncResponseStream* response = request->beginResponseStream("text/plain; version=0.0.4");
+		metrics.writePrometheus(*response);
+		request->send(response);
+	});
+
+	server_->on("/events", HTTP_GET,
+	            [this](AsyncWebServerRequest* request) { streamMetrics(request); });
+
+	// Snapshots are built on a task of their own, the metrics mutex and the JSON are too heavy
+	// for the esp_timer task
+	auto task = [](void* arg) {
+		auto server = static_cast<ConfigServer*>(arg);
+		for (;;) {
+			// Idle without clients, the first stream wakes the task
+			if (server->metricsStreams_ == 0)
+				ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			vTaskDelay(pdMS_TO_TICKS(METRICS_EVENT_INTERVAL_MS));
+			server->publishMetrics();
+		}
+	};
+	if (xTaskCreate(task, "Metrics events", METRICS_TASK_STACK_SIZE, this, METRICS_TASK_PRIORITY,
+	                &metricsTask_)
+	    != pdPASS)
+		log_e("Could not start the metrics event task");
+}
+
+void ConfigServer::publishMetrics() {
+	if (metricsStreams_ == 0)
+		return;
+
+	SpiRamJsonDocument doc(METRICS_EVENT_DOC_SIZE);
+	metrics.toJson(doc.to<JsonObject>());
+	auto event = std::make_shared<String>("id: " + String(millis()) + "\nevent: metrics\ndata: ");
+	serializeJson(doc, *event);
+	*event += "\n\n";
+
+	std::lock_guard<std::mutex> lock(metricsEventMutex_);
+	metricsEvent_ = event;
+	metricsEventId_++;
+}
+
+void ConfigServer::streamMetrics(AsyncWebServerRequest* request) {
+	// Freed with the response when the client disconnects
+	struct EventStream {
+		explicit EventStream(ConfigServer* server) : server{server} {
+			if (server->metricsStreams_++ == 0 && server->metricsTask_)
+				xTaskNotifyGive(server->metricsTask_);
+		}
+		~EventStream() { server->metricsStreams_--; }
+
+		ConfigServer* server;
+		// Being written, a comment first so the headers go out before the first snapshot
+		std::shared_ptr<const String> event = std::make_shared<const String>(":\n\n");
+		size_t written = 0;
+		uint32_t eventId = 0;
+	};
+	auto stream = std::make_shared<EventStream>(this);
+	{
+		std::lock_guard<std::mutex> lock(metricsEventMutex_);
+		stream->eventId = metricsEventId_;
+	}
+
+	// The filler runs on the async_tcp task whenever the socket can take more. Only this task
+	// writes the socket, RESPONSE_TRY_AGAIN waits for the next poll.
+	AsyncWebServerResponse* response = request->beginChunkedResponse(
+	    "text/event-stream",
+	    [this, stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+		    if (stream->written == stream->event->length()) {
+			    std::lock_guard<std::mutex> lock(metricsEventMutex_);
+			    if (!metricsEvent_ || stream->eventId == metricsEventId_)
+				    return RESPONSE_TRY_AGAIN;
+			    stream->event = metricsEvent_;
+			    stream->eventId = metricsEventId_;
+			    stream->written = 0;
+		    }
+		    const size_t n = std::min(maxLen, (size_t)(stream->event->length() - stream->written));
+		    memcpy(buffer, stream->event->c_str() + stream->written, n);
+		    stream->written += n;
+		    return n;
+	    });
+	response->addHeader("Cache-Control", "no-cache");
+	request->send(response);
+}
+
 }  // namespace config
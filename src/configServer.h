@@ -8,8 +8,14 @@
 #include <ESPAsyncWebServer.h>
 #include <LittleFS.h>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include "ArduinoJson.h"
 #include "AsyncJson.h"
+#include "allocators.h"
 #include "utils.h"
 
 namespace config {
@@ -24,7 +30,13 @@ using Result = utils::Result<T, ConfigError_t>;
 /**
  * Configuration management
  *
- * Load, save and handle the configuration
+ * Load, save and handle the configuration.
+ *
+ * The configuration is stored as a json snapshot and an append-only journal of
+ * MessagePack encoded patches. Updates only append a record to the journal, the snapshot is
+ * rewritten (atomically via a temporary file) when the journal grows too large.
+ * Records with a bad checksum, e.g. from a power loss mid-write, are dropped when loading.
+ * Reads are served from the in-memory document.
  */
 class ConfigStore {
   public:
@@ -32,18 +44,17 @@ class ConfigStore {
 	 * Load existing configuration from flash to memory, if any any
 	 */
 	ConfigStore(fs::FS& fs, String configFileName = "/config")
-	    : fs_(fs), configFileName_(configFileName), config_{DynamicJsonDocument(4096)} {
+	    : fs_(fs), configFileName_(configFileName), config_{SpiRamJsonDocument(4096)} {
 		loadConfig();
 	};
 	/**
-	 * Returns constant reference to the configuration object
-	 */
-	JsonObjectConst getConfigJson() { return config_.as<JsonObjectConst>(); };
-
-	/**
-	 * Returns a copy to the configuration object
+	 * Returns a copy of the configuration object. There is no view of the live document, as
+	 * updates from other tasks reallocate it.
 	 */
-	DynamicJsonDocument getConfigJsonCopy() { return config_; };
+	SpiRamJsonDocument getConfigJsonCopy() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return config_;
+	};
 
 	/**
 	 * Load configuration form flash and discard previously loaded config, if any
@@ -53,15 +64,82 @@ class ConfigStore {
 	 * Merge new config with old if it exists and save to disk.
 	 */
 	Result<bool> mergeConfig(JsonVariantConst newConfig);
+	/**
+	 * Set a single value by a dot separated key path, e.g. "gcalsettings.token.refresh_token".
+	 * The update is written as a single journal record, so it is either fully saved or not at all.
+	 */
+	template <typename T>
+	Result<bool> setValue(const String& keyPath, const T& value) {
+		SpiRamJsonDocument patch(JOURNAL_RECORD_MAX_SIZE);
+		if (!addKeyPath(patch, keyPath).set(value) || patch.overflowed())
+			return Result<bool>::makeErr(std::make_shared<ConfigError_t>(
+			    ConfigError_t{.errorMessage = "Config value too large: " + keyPath}));
+		return mergeConfig(patch);
+	}
+	/**
+	 * Rewrite the snapshot from memory and clear the journal.
+	 */
+	Result<bool> compact();
 	/**
 	 * Delete current configuration from memory and flash
 	 */
 	Result<bool> remove();
 
+	static const size_t JOURNAL_RECORD_MAX_SIZE = 2048;
+
   protected:
+	/**
+	 * Create nested objects for keyPath in doc and return the innermost variant.
+	 */
+	static JsonVariant addKeyPath(JsonDocument& doc, const String& keyPath);
+
+	String snapshotPath() const { return configFileName_ + ".json"; }
+	String journalPath() const { return configFileName_ + ".journal"; }
+
+	/**
+	 * Apply valid journal records to config_.
+	 * Returns false if the journal ended in a broken record.
+	 */
+	bool replayJournal();
+	Result<bool> appendJournal(JsonVariantConst patch);
+	Result<bool> writeSnapshot();
+
 	fs::FS& fs_;
 	String configFileName_;
-	DynamicJsonDocument config_;
+	SpiRamJsonDocument config_;
+	// Protects config_ and the files
+	std::mutex mutex_;
+};
+
+/**
+ * Serves the setup frontend from a webroot directory built by scripts/compress_webroot.py.
+ *
+ * The .gz variant of a file is sent when the client accepts gzip. Every file has a strong
+ * content hash ETag, so revalidation is answered with 304 without touching the file.
+ * The file index is read once, so a request costs a single file open.
+ */
+class WebrootHandler : public AsyncWebHandler {
+  public:
+	WebrootHandler(fs::FS& fs, const String& root);
+
+	bool canHandle(AsyncWebServerRequest* request) override;
+	void handleRequest(AsyncWebServerRequest* request) override;
+
+	bool isRequestHandlerTrivial() override final { return false; };
+
+  protected:
+	struct FileEntry {
+		String etag;
+		bool hasGzip;
+	};
+
+	/// Map "/" to index.html, other paths are served as is
+	static String filePath(const String& url);
+
+	fs::FS& fs_;
+	String root_;
+	// Keyed by path relative to the webroot
+	std::map<String, FileEntry> files_;
 };
 
 class ConfigServer : public AsyncWebHandler {
@@ -79,11 +157,26 @@ class ConfigServer : public AsyncWebHandler {
 	/// Call this to start the server
 	void start();
 
+	/// Start only the read-only /metrics and /events endpoints, used while running normally
+	void startMetrics();
+
   protected:
+	void addMetricsHandlers();
+	/// Build the metrics snapshot for the clients of /events, on the metrics task
+	void publishMetrics();
+	/// Stream the snapshots to a client of /events, its socket is written on the async_tcp task
+	void streamMetrics(AsyncWebServerRequest* request);
+
 	uint16_t port_;
 	ConfigStore* configStore_;
 	AsyncWebServer* server_ = nullptr;
-	AsyncEventSource events_{"/events"};
+
+	std::mutex metricsEventMutex_;  // Protects metricsEvent_ and metricsEventId_
+	// Latest snapshot, formatted as a server-sent event
+	std::shared_ptr<const String> metricsEvent_;
+	uint32_t metricsEventId_ = 0;
+	std::atomic<int> metricsStreams_{0};
+	TaskHandle_t metricsTask_ = nullptr;
 };
 
 }  // namespace config
@@ -0,0 +1,248 @@
+#include "energyLedger.h"
+
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <sys/time.h>
+
+#include "globals.h"
+
+namespace {
+const char* NVS_NAMESPACE = "energy";
+const char* NVS_DAYS_KEY = "days";
+const char* NVS_INDEX_KEY = "index";
+
+const uint32_t RTC_LEDGER_MAGIC = 0x454C4731;  // "ELG1"
+
+// Aggregates are kept here over deep sleep, as all other RAM is lost
+struct RTCLedger {
+	uint32_t magic;
+	size_t dayIndex;
+	std::array<EnergyLedger::Stats, ENERGY_LEDGER_DAYS> days;
+	int64_t sleepStartUs;
+};
+RTC_DATA_ATTR RTCLedger rtcLedger;
+
+// System time keeps running in deep sleep, unlike millis()
+int64_t systemTimeUs() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// Time before this is considered not synced yet
+const time_t MIN_VALID_TIME = 1577836800;  // 2020-01-01
+
+uint32_t currentDate() {
+	time_t now = safeMyTZ.now();
+	if (now < MIN_VALID_TIME)
+		return 0;
+	return safeMyTZ.dateTime(now, "Ymd").toInt();
+}
+
+void addStats(EnergyLedger::Stats& to, const EnergyLedger::Stats& from) {
+	to.wakeCount += from.wakeCount;
+	to.awakeMs += from.awakeMs;
+	to.lightSleepMs += from.lightSleepMs;
+	to.deepSleepMs += from.deepSleepMs;
+	to.wifiAssociatedMs += from.wifiAssociatedMs;
+	to.tlsHandshakes += from.tlsHandshakes;
+	for (size_t i = 0; i < to.taskBusyMs.size(); i++) to.taskBusyMs[i] += from.taskBusyMs[i];
+	for (size_t i = 0; i < to.epdRefreshes.size(); i++) to.epdRefreshes[i] += from.epdRefreshes[i];
+	to.batteryMv = from.batteryMv;
+}
+}  // namespace
+
+const std::array<const char*, (size_t)EnergyLedger::Task::SIZE> EnergyLedger::taskNames{
+    "api",
+    "gui",
+};
+
+const std::array<const char*, ENERGY_LEDGER_EPD_MODE_COUNT> EnergyLedger::epdModeNames{
+    "INIT", "DU", "GC16", "GL16", "GLR16", "GLD16", "DU4", "A2", "NONE",
+};
+
+EnergyLedger::EnergyLedger() {}
+
+void EnergyLedger::begin(bool resumeFromDeepSleep) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_wakeStartMs = millis();
+
+	bool rtcValid = rtcLedger.magic == RTC_LEDGER_MAGIC;
+	rtcLedger.magic = 0;
+	if (resumeFromDeepSleep && rtcValid) {
+		// This wake started when the chip did
+		_wakeStartMs = 0;
+		_days = rtcLedger.days;
+		_dayIndex = rtcLedger.dayIndex;
+		_today().deepSleepMs += (systemTimeUs() - rtcLedger.sleepStartUs) / 1000 - millis();
+		return;
+	}
+
+	Preferences prefs;
+	if (!prefs.begin(NVS_NAMESPACE, true)) {
+		log_i("No energy ledger stored");
+		return;
+	}
+	// Layout of Stats may change between versions, discard old data in that case
+	if (prefs.getBytesLength(NVS_DAYS_KEY) == sizeof(_days)) {
+		prefs.getBytes(NVS_DAYS_KEY, _days.data(), sizeof(_days));
+		_dayIndex = prefs.getUInt(NVS_INDEX_KEY) % ENERGY_LEDGER_DAYS;
+	}
+	prefs.end();
+}
+
+void EnergyLedger::setWiFiAssociated(bool associated) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (associated == _wifiAssociated)
+		return;
+	_wifiAssociated = associated;
+
+	uint32_t now = millis();
+	if (associated)
+		_wifiAssociatedSinceMs = now;
+	else
+		_wake.wifiAssociatedMs += now - _wifiAssociatedSinceMs;
+}
+
+void EnergyLedger::countTlsHandshake() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_wake.tlsHandshakes++;
+}
+
+void EnergyLedger::addTaskBusy(Task task, uint32_t ms) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_wake.taskBusyMs[(size_t)task] += ms;
+}
+
+void EnergyLedger::countEpdRefresh(m5epd_update_mode_t mode) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if ((size_t)mode < _wake.epdRefreshes.size())
+		_wake.epdRefreshes[mode]++;
+}
+
+void EnergyLedger::beginSleep() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint32_t now = millis();
+	_foldWake(now);
+	_sleepStartMs = now;
+}
+
+void EnergyLedger::endSleep() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint32_t now = millis();
+	_today().lightSleepMs += now - _sleepStartMs;
+	_wakeStartMs = now;
+}
+
+void EnergyLedger::beginDeepSleep() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_foldWake(millis());
+	rtcLedger.days = _days;
+	rtcLedger.dayIndex = _dayIndex;
+	rtcLedger.sleepStartUs = systemTimeUs();
+	rtcLedger.magic = RTC_LEDGER_MAGIC;
+}
+
+void EnergyLedger::persist() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_foldWake(millis());
+	_persist();
+}
+
+EnergyLedger::Stats EnergyLedger::current() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint32_t now = millis();
+	Stats wake = _wake;
+	if (_wifiAssociated)
+		wake.wifiAssociatedMs += now - _wifiAssociatedSinceMs;
+	wake.wakeCount = 1;
+	wake.awakeMs = now - _wakeStartMs;
+
+	Stats today = _today();
+	wake.batteryMv = today.batteryMv;
+	addStats(today, wake);
+	return today;
+}
+
+void EnergyLedger::toJson(JsonArray days) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (size_t i = 0; i < ENERGY_LEDGER_DAYS; i++) {
+		const Stats& day = _days[(_dayIndex + ENERGY_LEDGER_DAYS - i) % ENERGY_LEDGER_DAYS];
+		if (day.wakeCount == 0)
+			continue;
+
+		JsonObject obj = days.createNestedObject();
+		obj["date"] = day.date;
+		obj["wake_count"] = day.wakeCount;
+		obj["awake_ms"] = day.awakeMs;
+		obj["light_sleep_ms"] = day.lightSleepMs;
+		obj["deep_sleep_ms"] = day.deepSleepMs;
+		obj["battery_mv"] = day.batteryMv;
+		obj["wifi_associated_ms"] = day.wifiAssociatedMs;
+		obj["tls_handshakes"] = day.tlsHandshakes;
+
+		JsonObject busy = obj.createNestedObject("task_busy_ms");
+		for (size_t t = 0; t < day.taskBusyMs.size(); t++) busy[taskNames[t]] = day.taskBusyMs[t];
+
+		JsonObject epd = obj.createNestedObject("epd_refreshes");
+		for (size_t m = 0; m < day.epdRefreshes.size(); m++)
+			if (day.epdRefreshes[m] > 0)
+				epd[epdModeNames[m]] = day.epdRefreshes[m];
+	}
+}
+
+void EnergyLedger::_foldWake(uint32_t now) {
+	if (_wifiAssociated) {
+		_wake.wifiAssociatedMs += now - _wifiAssociatedSinceMs;
+		_wifiAssociatedSinceMs = now;
+	}
+	_wake.wakeCount = 1;
+	_wake.awakeMs = now - _wakeStartMs;
+	_wake.batteryMv = M5.getBatteryVoltage();
+
+	uint32_t epdRefreshes = 0;
+	for (auto count : _wake.epdRefreshes) epdRefreshes += count;
+	log_i("Wake took %u ms: wifi %u ms, %u TLS handshakes, api %u ms, gui %u ms, %u EPD refreshes",
+	      _wake.awakeMs, _wake.wifiAssociatedMs, _wake.tlsHandshakes,
+	      _wake.taskBusyMs[(size_t)Task::API], _wake.taskBusyMs[(size_t)Task::GUI], epdRefreshes);
+
+	addStats(_today(), _wake);
+	_wake = Stats{};
+	_wakeStartMs = now;
+}
+
+EnergyLedger::Stats& EnergyLedger::_today() {
+	uint32_t date = currentDate();
+	Stats& newest = _days[_dayIndex];
+
+	// Time not synced yet or still the same day
+	if (date == 0 || newest.date == date)
+		return newest;
+
+	// Counters collected before the first time sync belong to the first known day
+	if (newest.date == 0) {
+		newest.date = date;
+		return newest;
+	}
+
+	bool rollover = newest.wakeCount > 0;
+	_dayIndex = (_dayIndex + 1) % ENERGY_LEDGER_DAYS;
+	_days[_dayIndex] = Stats{};
+	_days[_dayIndex].date = date;
+	if (rollover)
+		_persist();
+
+	return _days[_dayIndex];
+}
+
+void EnergyLedger::_persist() {
+	Preferences prefs;
+	if (!prefs.begin(NVS_NAMESPACE)) {
+		log_e("Energy ledger NVS open failed");
+		return;
+	}
+	prefs.putBytes(NVS_DAYS_KEY, _days.data(), sizeof(_days));
+	prefs.putUInt(NVS_INDEX_KEY, _dayIndex);
+	prefs.end();
+	log_i("Energy ledger saved");
+}
@@ -0,0 +1,105 @@
+#ifndef ENERGY_LEDGER_H
+#define ENERGY_LEDGER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <M5EPD.h>
+
+#include <array>
+#include <mutex>
+
+// How many daily aggregates are kept in NVS
+#define ENERGY_LEDGER_DAYS 14
+
+// UPDATE_MODE_INIT ... UPDATE_MODE_NONE
+#define ENERGY_LEDGER_EPD_MODE_COUNT (UPDATE_MODE_NONE + 1)
+
+/**
+ * Records where the awake time, and therefore the battery, goes.
+ *
+ * Counters are collected per wake and folded into a daily aggregate when going to sleep.
+ * Daily aggregates are persisted in NVS on shutdown and day rollover,
+ * and served as json by the config server.
+ */
+class EnergyLedger {
+  public:
+	enum class Task : size_t { API, GUI, SIZE };
+
+	static const std::array<const char*, (size_t)Task::SIZE> taskNames;
+	static const std::array<const char*, ENERGY_LEDGER_EPD_MODE_COUNT> epdModeNames;
+
+	struct Stats {
+		uint32_t date;  // Local date as YYYYMMDD, 0 if not known
+		uint32_t wakeCount;
+		uint32_t awakeMs;
+		uint32_t lightSleepMs;
+		uint32_t deepSleepMs;
+		uint32_t wifiAssociatedMs;
+		uint32_t tlsHandshakes;
+		std::array<uint32_t, (size_t)Task::SIZE> taskBusyMs;
+		std::array<uint32_t, ENERGY_LEDGER_EPD_MODE_COUNT> epdRefreshes;
+		uint32_t batteryMv;  // Battery voltage at the end of the latest wake
+	};
+
+	EnergyLedger();
+
+	/**
+	 * Load persisted daily aggregates, call once NVS is available.
+	 * When resuming from deep sleep they are restored from RTC memory instead,
+	 * and the length of the deep sleep is recorded.
+	 */
+	void begin(bool resumeFromDeepSleep = false);
+
+	void setWiFiAssociated(bool associated);
+	void countTlsHandshake();
+	void addTaskBusy(Task task, uint32_t ms);
+	void countEpdRefresh(m5epd_update_mode_t mode);
+
+	/**
+	 * Close the current wake and fold it into today's aggregate.
+	 * Called by SleepManager right before light sleep.
+	 */
+	void beginSleep();
+	/**
+	 * Record the sleep length and start a new wake.
+	 */
+	void endSleep();
+	/**
+	 * Close the current wake and keep the aggregates in RTC memory over deep sleep.
+	 */
+	void beginDeepSleep();
+
+	/**
+	 * Fold the current wake and write daily aggregates to NVS.
+	 */
+	void persist();
+
+	/**
+	 * Today's aggregate including the current wake, without closing the wake.
+	 */
+	Stats current();
+
+	/**
+	 * Serialize daily aggregates, newest first, into an array of objects.
+	 */
+	void toJson(JsonArray days);
+
+  private:
+	void _foldWake(uint32_t now);
+	Stats& _today();
+	void _persist();
+
+	std::mutex _mutex;  // Protects everything below
+
+	Stats _wake{};
+	uint32_t _wakeStartMs = 0;
+	uint32_t _sleepStartMs = 0;
+	uint32_t _wifiAssociatedSinceMs = 0;
+	bool _wifiAssociated = false;
+
+	// Ring of daily aggregates, _days[_dayIndex] is the newest
+	std::array<Stats, ENERGY_LEDGER_DAYS> _days{};
+	size_t _dayIndex = 0;
+};
+
+#endif
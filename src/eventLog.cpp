@@ -0,0 +1,105 @@
+#include "eventLog.h"
+
+#include "globals.h"
+
+namespace {
+const char* EVENT_LOG_PATH = "/events.log";
+}  // namespace
+
+const std::array<const char*, (size_t)EventLog::Type::SIZE> EventLog::typeNames{
+    "boot", "setup_boot", "shutdown", "error"};
+
+void EventLog::begin(fs::FS& fs) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_fs = &fs;
+
+	File file = fs.open(EVENT_LOG_PATH, FILE_READ);
+	if (file && file.size() == EVENT_LOG_RECORDS * sizeof(Record)) {
+		Record record;
+		uint32_t lastSeq = 0;
+		while (file.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+			if (record.seq > lastSeq) {
+				record.text[sizeof(record.text) - 1] = '\0';
+				lastSeq = record.seq;
+				_lastType = record.type;
+				_lastText = String(record.text);
+			}
+		}
+		file.close();
+		_nextSeq = lastSeq + 1;
+		return;
+	}
+	file.close();
+
+	// Missing, or from a build with a different number of records
+	log_i("Creating the event log");
+	file = fs.open(EVENT_LOG_PATH, FILE_WRITE, true);
+	if (!file) {
+		log_e("Could not create the event log");
+		_fs = nullptr;
+		return;
+	}
+	const Record empty{};
+	for (size_t i = 0; i < EVENT_LOG_RECORDS; i++)
+		file.write((const uint8_t*)&empty, sizeof(empty));
+	file.close();
+	_nextSeq = 1;
+}
+
+void EventLog::append(Type type, const String& text) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_fs)
+		return;
+	if (type == Type::ERROR && type == _lastType && text == _lastText)
+		return;
+
+	Record record{};
+	record.seq = _nextSeq;
+	record.time = safeUTC.now();
+	record.type = type;
+	strncpy(record.text, text.c_str(), sizeof(record.text) - 1);
+
+	File file = _fs->open(EVENT_LOG_PATH, "r+");
+	if (!file || !file.seek((record.seq % EVENT_LOG_RECORDS) * sizeof(Record))
+	    || file.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+		log_e("Could not write to the event log");
+		return;
+	}
+	file.close();
+	_nextSeq++;
+	_lastType = type;
+	_lastText = text;
+}
+
+std::vector<EventLog::Entry> EventLog::recent(size_t maxCount) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<Entry> entries;
+	if (!_fs)
+		return entries;
+	File file = _fs->open(EVENT_LOG_PATH, FILE_READ);
+	if (!file)
+		return entries;
+
+	const uint32_t count = min((uint32_t)min(maxCount, (size_t)EVENT_LOG_RECORDS), _nextSeq - 1);
+	for (uint32_t seq = _nextSeq - 1; seq >= _nextSeq - count && seq > 0; seq--) {
+		Record record;
+		if (!file.seek((seq % EVENT_LOG_RECORDS) * sizeof(Record))
+		    || file.read((uint8_t*)&record, sizeof(record)) != sizeof(record)
+		    || record.seq != seq || record.type >= Type::SIZE)
+			break;
+		record.text[sizeof(record.text) - 1] = '\0';
+		entries.push_back(Entry{record.seq, (time_t)record.time, record.type, record.text});
+	}
+	file.close();
+	return entries;
+}
+
+void EventLog::toJson(JsonArray entries) {
+	for (const Entry& entry : recent()) {
+		JsonObject obj = entries.createNestedObject();
+		obj["seq"] = entry.seq;
+		obj["time"] = entry.time;
+		obj["type"] = typeNames[(size_t)entry.type];
+		obj["text"] = entry.text;
+	}
+}
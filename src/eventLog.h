@@ -0,0 +1,76 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+// Records kept in the ring, older ones are overwritten
+#define EVENT_LOG_RECORDS 64
+
+/**
+ * Log of boots, shutdowns and errors on the filesystem, kept over power cycles.
+ *
+ * The log is a preallocated file of fixed size records used as a ring. Every record carries
+ * an increasing sequence number, so an append overwrites a single record in place and no
+ * head pointer needs to be written: the head is found by scanning the sequence numbers once
+ * in begin(). LittleFS writes a changed block to a new location, which spreads the writes
+ * over the partition, and a record is either fully written or not at all.
+ *
+ * Repeats of the latest error are not written again, so a failing poll doesn't wear the
+ * flash.
+ */
+class EventLog {
+  public:
+	enum class Type : uint8_t { BOOT, SETUP_BOOT, SHUTDOWN, ERROR, SIZE };
+
+	static const std::array<const char*, (size_t)Type::SIZE> typeNames;
+
+	struct Entry {
+		uint32_t seq;
+		time_t time;
+		Type type;
+		String text;
+	};
+
+	/**
+	 * Find the head of the log, creating the file if needed. Call after mounting fs.
+	 */
+	void begin(fs::FS& fs);
+
+	/**
+	 * Write an entry timestamped now, text is truncated to fit a record.
+	 */
+	void append(Type type, const String& text);
+
+	/**
+	 * At most maxCount latest entries, newest first.
+	 */
+	std::vector<Entry> recent(size_t maxCount = EVENT_LOG_RECORDS);
+
+	/**
+	 * Serialize the entries, newest first, into an array of objects.
+	 */
+	void toJson(JsonArray entries);
+
+  private:
+	struct Record {
+		uint32_t seq;  // Zero for an unused record
+		uint32_t time;
+		Type type;
+		char text[55];
+	};
+	static_assert(sizeof(Record) == 64, "Records must not straddle flash pages");
+
+	fs::FS* _fs = nullptr;
+	std::mutex _mutex;  // Protects everything below and the file
+	uint32_t _nextSeq = 1;
+	Type _lastType = Type::SIZE;
+	String _lastText;
+};
+
+#endif
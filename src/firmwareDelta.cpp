@@ -0,0 +1,248 @@
+#include "firmwareDelta.h"
+
+#include <esp32/rom/miniz.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+
+#include <algorithm>
+
+#include "allocators.h"
+#include "updateDownload.h"
+
+// Format is documented in scripts/make_delta.py
+#define DELTA_FORMAT_VERSION 1
+#define DELTA_OP_END 0
+#define DELTA_OP_ADD 1
+#define DELTA_OP_DATA 2
+
+#define DELTA_INPUT_BUFFER_SIZE 4096
+#define DELTA_WORK_BUFFER_SIZE 4096
+
+namespace {
+
+struct __attribute__((packed)) DeltaHeader {
+	char magic[4];
+	uint8_t version;
+	uint32_t oldSize;
+	uint8_t oldDigest[32];
+	uint32_t newSize;
+	uint8_t newDigest[32];
+};
+
+/**
+ * Pulls zlib compressed bytes from a stream and hands out the decompressed bytes.
+ * Decompression uses the ROM inflater, the output buffer doubles as the 32 KiB dictionary.
+ * The dictionary is in PSRAM, internal RAM is needed by TLS during the download.
+ */
+class InflateReader {
+  public:
+	InflateReader(Stream& source)
+	    : _source{source},
+	      _inflator{new tinfl_decompressor},
+	      _input{new uint8_t[DELTA_INPUT_BUFFER_SIZE]},
+	      _dict{alloc::makeBuffer(alloc::Pool::BUFFER, TINFL_LZ_DICT_SIZE)} {
+		tinfl_init(_inflator.get());
+	}
+
+	bool allocated() const { return !!_dict; }
+
+	/**
+	 * Read exactly size bytes, returns false on a truncated or corrupt stream.
+	 */
+	bool read(uint8_t* dest, size_t size) {
+		while (size > 0) {
+			if (_available == 0 && !_inflate())
+				return false;
+			size_t n = std::min(size, _available);
+			memcpy(dest, _dict.get() + _readPos, n);
+			_readPos += n;
+			_available -= n;
+			dest += n;
+			size -= n;
+		}
+		return true;
+	}
+
+  private:
+	bool _inflate() {
+		while (true) {
+			if (_inputPos == _inputSize && !_sourceDone) {
+				_inputSize = _source.readBytes(_input.get(), DELTA_INPUT_BUFFER_SIZE);
+				_inputPos = 0;
+				_sourceDone = _inputSize == 0;
+			}
+
+			size_t inBytes = _inputSize - _inputPos;
+			size_t outBytes = TINFL_LZ_DICT_SIZE - _writePos;
+			int flags = TINFL_FLAG_PARSE_ZLIB_HEADER;
+			if (!_sourceDone)
+				flags |= TINFL_FLAG_HAS_MORE_INPUT;
+			tinfl_status status
+			    = tinfl_decompress(_inflator.get(), _input.get() + _inputPos, &inBytes, _dict.get(),
+			                       _dict.get() + _writePos, &outBytes, flags);
+			_inputPos += inBytes;
+
+			if (outBytes > 0) {
+				_readPos = _writePos;
+				_available = outBytes;
+				_writePos = (_writePos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+				return true;
+			}
+			if (status == TINFL_STATUS_DONE || status < TINFL_STATUS_DONE
+			    || (status == TINFL_STATUS_NEEDS_MORE_INPUT && _sourceDone))
+				return false;
+		}
+	}
+
+	Stream& _source;
+	std::unique_ptr<tinfl_decompressor> _inflator;
+	std::unique_ptr<uint8_t[]> _input;
+	alloc::Buffer _dict;
+	size_t _inputPos = 0;
+	size_t _inputSize = 0;
+	bool _sourceDone = false;
+	size_t _writePos = 0;
+	size_t _readPos = 0;
+	size_t _available = 0;
+};
+
+class OtaWriter {
+  public:
+	OtaWriter() { mbedtls_sha256_init(&_ctx); }
+	~OtaWriter() {
+		mbedtls_sha256_free(&_ctx);
+		if (_handle)
+			esp_ota_abort(_handle);
+	}
+
+	bool begin(const esp_partition_t* target, size_t size) {
+		mbedtls_sha256_starts_ret(&_ctx, 0);
+		return esp_ota_begin(target, size, &_handle) == ESP_OK;
+	}
+
+	bool write(const uint8_t* data, size_t size) {
+		mbedtls_sha256_update_ret(&_ctx, data, size);
+		_written += size;
+		return esp_ota_write(_handle, data, size) == ESP_OK;
+	}
+
+	/**
+	 * Finish the OTA write, which also validates the image.
+	 */
+	bool end(const uint8_t* expectedDigest) {
+		uint8_t digest[32];
+		mbedtls_sha256_finish_ret(&_ctx, digest);
+		if (memcmp(digest, expectedDigest, sizeof(digest)) != 0)
+			return false;
+		esp_err_t err = esp_ota_end(_handle);
+		_handle = 0;
+		return err == ESP_OK;
+	}
+
+	size_t written() const { return _written; }
+
+  private:
+	esp_ota_handle_t _handle = 0;
+	mbedtls_sha256_context _ctx;
+	size_t _written = 0;
+};
+
+std::unique_ptr<utils::Error> deltaError(const String& message) {
+	return utils::make_unique<utils::Error>("Firmware delta: " + message);
+}
+
+}  // namespace
+
+bool partitionDigest(const esp_partition_t* partition, size_t offset, size_t size,
+                     uint8_t* digest) {
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[SPI_FLASH_SEC_SIZE]);
+	mbedtls_sha256_context ctx;
+	mbedtls_sha256_init(&ctx);
+	mbedtls_sha256_starts_ret(&ctx, 0);
+	bool ok = true;
+	for (size_t pos = 0; pos < size && ok; pos += SPI_FLASH_SEC_SIZE) {
+		size_t n = std::min((size_t)SPI_FLASH_SEC_SIZE, size - pos);
+		ok = esp_partition_read(partition, offset + pos, buffer.get(), n) == ESP_OK;
+		if (ok)
+			mbedtls_sha256_update_ret(&ctx, buffer.get(), n);
+	}
+	mbedtls_sha256_finish_ret(&ctx, digest);
+	mbedtls_sha256_free(&ctx);
+	return ok;
+}
+
+std::unique_ptr<utils::Error> applyFirmwareDelta(Stream& patch, const esp_partition_t* source,
+                                                 const esp_partition_t* target,
+                                                 const String& expectedDigest) {
+	InflateReader reader(patch);
+	if (!reader.allocated())
+		return deltaError("out of memory.");
+
+	DeltaHeader header;
+	if (!reader.read((uint8_t*)&header, sizeof(header)) || memcmp(header.magic, "MBDL", 4) != 0
+	    || header.version != DELTA_FORMAT_VERSION) {
+		return deltaError("invalid header.");
+	}
+
+	// Images built locally or by an older release have no patch, the full image is used instead
+	uint8_t digest[32];
+	if (header.oldSize > source->size || !partitionDigest(source, 0, header.oldSize, digest)
+	    || memcmp(digest, header.oldDigest, sizeof(digest)) != 0) {
+		return deltaError("made for a different running image.");
+	}
+	// The header is as untrusted as the rest of the patch, the manifest names the new image
+	if (hexDigest(header.newDigest) != expectedDigest) {
+		return deltaError("made for a different new image.");
+	}
+	if (header.newSize > target->size) {
+		return deltaError("new image doesn't fit the OTA partition.");
+	}
+
+	OtaWriter writer;
+	if (!writer.begin(target, header.newSize))
+		return deltaError("couldn't begin OTA write.");
+
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[DELTA_WORK_BUFFER_SIZE]);
+	std::unique_ptr<uint8_t[]> oldBuffer(new uint8_t[DELTA_WORK_BUFFER_SIZE]);
+
+	while (true) {
+		uint8_t op;
+		if (!reader.read(&op, 1))
+			return deltaError("truncated.");
+		if (op == DELTA_OP_END)
+			break;
+
+		uint32_t oldOffset = 0;
+		uint32_t length;
+		if ((op == DELTA_OP_ADD && !reader.read((uint8_t*)&oldOffset, sizeof(oldOffset)))
+		    || !reader.read((uint8_t*)&length, sizeof(length))) {
+			return deltaError("truncated.");
+		}
+		if (op != DELTA_OP_ADD && op != DELTA_OP_DATA)
+			return deltaError("unknown operation " + String(op) + ".");
+		if (writer.written() + length > header.newSize
+		    || (op == DELTA_OP_ADD && oldOffset + length > header.oldSize)) {
+			return deltaError("operation out of bounds.");
+		}
+
+		for (uint32_t pos = 0; pos < length; pos += DELTA_WORK_BUFFER_SIZE) {
+			size_t n = std::min((size_t)DELTA_WORK_BUFFER_SIZE, (size_t)(length - pos));
+			if (!reader.read(buffer.get(), n))
+				return deltaError("truncated.");
+			if (op == DELTA_OP_ADD) {
+				if (esp_partition_read(source, oldOffset + pos, oldBuffer.get(), n) != ESP_OK)
+					return deltaError("couldn't read running image.");
+				for (size_t i = 0; i < n; i++) buffer[i] += oldBuffer[i];
+			}
+			if (!writer.write(buffer.get(), n))
+				return deltaError("OTA write failed.");
+		}
+	}
+
+	if (writer.written() != header.newSize || !writer.end(header.newDigest)) {
+		return deltaError("patched image doesn't match.");
+	}
+
+	log_i("Firmware delta applied, %u bytes written", writer.written());
+	return nullptr;
+}
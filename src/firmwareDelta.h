@@ -0,0 +1,27 @@
+#ifndef FIRMWARE_DELTA_H
+#define FIRMWARE_DELTA_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+#include <memory>
+
+#include "utils.h"
+
+/**
+ * SHA-256 of a partition region. Returns false if the flash read fails.
+ */
+bool partitionDigest(const esp_partition_t* partition, size_t offset, size_t size,
+                     uint8_t* digest);
+
+/**
+ * Apply a delta patch made by scripts/make_delta.py.
+ * The old image is read from source and the new image is written into target with the OTA API,
+ * the target is not activated. Fails if source doesn't contain the image the patch was made for,
+ * or if the patch doesn't make the image of expectedDigest, the hex SHA-256 from the manifest.
+ */
+std::unique_ptr<utils::Error> applyFirmwareDelta(Stream& patch, const esp_partition_t* source,
+                                                 const esp_partition_t* target,
+                                                 const String& expectedDigest);
+
+#endif
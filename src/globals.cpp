@@ -3,8 +3,12 @@
 Timezone _myTZ;
 SafeTimezone safeMyTZ{_myTZ};
 SafeTimezone safeUTC{UTC};
+Metrics metrics;  // Tasks register themselves, keep before sleepManager
 SleepManager sleepManager;
+Scheduler scheduler;  // Registers SleepManager callbacks, keep after sleepManager
 WiFiManager wifiManager;
+EnergyLedger energyLedger;
+EventLog eventLog;
 Localization l10n;
 Preferences preferences;
 PNG png;
@@ -16,5 +20,3 @@ const String CURRENT_VERSION
     = String(VERSION_MAJOR) + "." + String(VERSION_MINOR) + "." + String(VERSION_PATCH);
 
 String UPDATE_CHANNEL = "stable";
-utils::Result<String> latestVersionResult
-    = utils::Result<String>::makeErr(new utils::Error("Not initialized."));
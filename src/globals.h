@@ -4,9 +4,13 @@
 #include <PNGdec.h>
 #include <Preferences.h>
 
+#include "energyLedger.h"
+#include "eventLog.h"
 #include "localization.h"
+#include "metrics.h"
 #include "myUpdate.h"
 #include "safeTimezone.h"
+#include "scheduler.h"
 #include "sleepManager.h"
 #include "wifiManager.h"
 
@@ -19,14 +23,17 @@ const m5epd_update_mode_t MY_UPDATE_MODE = UPDATE_MODE_GC16;
 
 extern SafeTimezone safeMyTZ;
 extern SafeTimezone safeUTC;
+extern Metrics metrics;
 extern SleepManager sleepManager;
+extern Scheduler scheduler;
 extern WiFiManager wifiManager;
+extern EnergyLedger energyLedger;
+extern EventLog eventLog;
 extern Localization l10n;
 extern Preferences preferences;
 extern PNG png;
 
 extern String UPDATE_CHANNEL;
 extern const String CURRENT_VERSION;
-extern utils::Result<String> latestVersionResult;
 
 #endif
\ No newline at end of file
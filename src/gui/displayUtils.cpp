@@ -27,6 +27,16 @@ void wakeDisplay() {
 	M5.EPD.Active();
 }
 
+void pushCanvas(M5EPD_Canvas& canvas, m5epd_update_mode_t mode) {
+	canvas.pushCanvas(0, 0, mode);
+	energyLedger.countEpdRefresh(mode);
+}
+
+void updateArea(Pos pos, Size size, m5epd_update_mode_t mode) {
+	M5.EPD.UpdateArea(pos.x, pos.y, size.w, size.h, mode);
+	energyLedger.countEpdRefresh(mode);
+}
+
 void readPartFromCanvas(Pos pos, Size size, M5EPD_Canvas& canvas, uint16_t canvasWidth,
                         uint8_t* partBuffer) {
 	uint8_t* frameBuffer = (uint8_t*)canvas.frameBuffer();
@@ -23,6 +23,14 @@ void sleepDisplay();
  */
 void wakeDisplay();
 
+/**
+ * Push a canvas or refresh an area of the display.
+ * Use these instead of calling canvas.pushCanvas() or M5.EPD.UpdateArea() directly,
+ * they count the refreshes in the energy ledger.
+ */
+void pushCanvas(M5EPD_Canvas& canvas, m5epd_update_mode_t mode);
+void updateArea(Pos pos, Size size, m5epd_update_mode_t mode);
+
 void readPartFromCanvas(Pos pos, Size size, M5EPD_Canvas& canvas, uint16_t canvasWidth,
                         uint8_t* partBuffer);
 
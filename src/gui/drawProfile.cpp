@@ -0,0 +1,34 @@
+#include "drawProfile.h"
+
+#ifdef GUI_DRAW_PROFILE
+
+namespace gui {
+namespace profile {
+
+namespace {
+std::vector<Sample> samples;
+uint8_t depth = 0;
+}  // namespace
+
+Scope::Scope(const char* kind, const String& label, Pos pos, Size size)
+    : _index{samples.size()} {
+	samples.push_back(Sample{kind, label, pos, size, depth, 0});
+	depth++;
+	_start = micros();
+}
+
+Scope::~Scope() {
+	samples[_index].us = micros() - _start;
+	depth--;
+}
+
+std::vector<Sample> takeSamples() {
+	std::vector<Sample> taken;
+	taken.swap(samples);
+	return taken;
+}
+
+}  // namespace profile
+}  // namespace gui
+
+#endif
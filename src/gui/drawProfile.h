@@ -0,0 +1,59 @@
+#ifndef DRAW_PROFILE_H
+#define DRAW_PROFILE_H
+
+#include <Arduino.h>
+
+#include <vector>
+
+#include "elements/element.h"
+
+/**
+ * Per element draw timing, compiled in with -DGUI_DRAW_PROFILE.
+ *
+ * Elements open a scope when they draw to a canvas. Elements drawn by other elements, e.g. the
+ * text of a button, are recorded with a larger depth. The host renderer in render/ reports
+ * the samples, disabled scopes compile to nothing.
+ */
+#ifdef GUI_DRAW_PROFILE
+#define DRAW_PROFILE_SCOPE(kind, label, pos, size) \
+	gui::profile::Scope _drawProfileScope(kind, label, pos, size)
+#else
+#define DRAW_PROFILE_SCOPE(...) \
+	do {                        \
+	} while (0)
+#endif
+
+namespace gui {
+namespace profile {
+
+struct Sample {
+	const char* kind;
+	String label;
+	Pos pos;
+	Size size;
+	uint8_t depth;
+	uint32_t us;
+};
+
+#ifdef GUI_DRAW_PROFILE
+class Scope {
+  public:
+	Scope(const char* kind, const String& label, Pos pos, Size size);
+	~Scope();
+
+  private:
+	size_t _index;
+	unsigned long _start;
+};
+
+/**
+ * Take the samples recorded since the last call, in the order the draws started.
+ * Only call from the task that draws.
+ */
+std::vector<Sample> takeSamples();
+#endif
+
+}  // namespace profile
+}  // namespace gui
+
+#endif
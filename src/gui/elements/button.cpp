@@ -1,6 +1,7 @@
 #include "button.h"
 
 #include "M5EPD.h"
+#include "gui/drawProfile.h"
 #include "utils.h"
 
 namespace gui {
@@ -21,6 +22,7 @@ void Button::drawToCanvas(M5EPD_Canvas& canvas) {
 	if (_hidden) {
 		return;
 	}
+	DRAW_PROFILE_SCOPE("button", "", _pos, _size);
 
 	if (_text) {
 		_text->drawToCanvas(canvas);
@@ -2,6 +2,9 @@
 
 #include "LittleFS.h"
 #include "globals.h"
+#include "gui/displayUtils.h"
+#include "gui/drawProfile.h"
+#include "trace.h"
 
 namespace gui {
 
@@ -62,16 +65,17 @@ void Image::draw(m5epd_update_mode_t updateMode) {
 	if (res1 == PNG_SUCCESS) {
 		int res2 = png.decode(this, 0);
 		if (res2 == PNG_SUCCESS && updateMode != UPDATE_MODE_NONE) {
-			M5.EPD.UpdateArea(pos.x, pos.y, png.getWidth(), png.getHeight(), updateMode);
+			updateArea(pos, Size{(uint16_t)png.getWidth(), (uint16_t)png.getHeight()}, updateMode);
 		}
 	}
 	if (!_reverseColor)
 		M5.EPD.SetColorReverse(false);
-	log_d("Frame drawing took %u ms.", millis() - beginTime);
+	TRACE_GUI("Frame drawing took %lu ms.", millis() - beginTime);
 	png.close();
 }
 
 void Image::drawToCanvas(M5EPD_Canvas& canvas) {
+	DRAW_PROFILE_SCOPE("image", _path, pos, Size{});
 	int beginTime = millis();
 
 	_canvas = &canvas;
@@ -79,7 +83,7 @@ void Image::drawToCanvas(M5EPD_Canvas& canvas) {
 	if (res1 == PNG_SUCCESS) {
 		int res2 = png.decode(this, 0);
 	}
-	log_d("Frame drawing took %u ms.", millis() - beginTime);
+	TRACE_GUI("Frame drawing took %lu ms.", millis() - beginTime);
 	png.close();
 }
 
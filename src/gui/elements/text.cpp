@@ -1,6 +1,7 @@
 #include "text.h"
 
 #include "M5EPD.h"
+#include "gui/drawProfile.h"
 
 namespace gui {
 
@@ -23,6 +24,7 @@ void Text::drawToCanvas(M5EPD_Canvas& canvas) {
 	if (_hidden) {
 		return;
 	}
+	DRAW_PROFILE_SCOPE("text", _text, _pos, _size);
 
 	// log_i("Drawing text: %s", _text.c_str());
 
@@ -10,7 +10,7 @@ namespace gui {
 const char* FONT_BOLD = "/interbold.ttf";
 const char* FONT_REGULAR = "/interregular.ttf";
 
-GUI::GUI(GUITask* guiTask) : _guiTask(guiTask) {
+GUI::GUI(GUITask* guiTask, bool resume) : _guiTask(guiTask) {
 	M5EPD_Canvas font(&M5.EPD);
 	font.setTextFont(1);
 	font.loadFont(FONT_BOLD, LittleFS);
@@ -35,7 +35,9 @@ GUI::GUI(GUITask* guiTask) : _guiTask(guiTask) {
 	_shutdownScreen = utils::make_unique<ShutdownScreen>();
 	_screens[SCR_SHUTDOWN] = _shutdownScreen.get();
 
-	switchToScreen(SCR_LOADING);
+	// Display still shows the main screen when resuming from deep sleep
+	if (!resume)
+		switchToScreen(SCR_LOADING);
 }
 
 void GUI::initMain(cal::Model* model) {
@@ -54,15 +56,7 @@ void GUI::initMain(cal::Model* model) {
 	};
 	_confirmFreeScreen->onCancel = [this]() { switchToScreen(SCR_MAIN); };
 
-	// SETTINGS SCREEN
-	_settingsScreen = utils::make_unique<SettingsScreen>();
-	_screens[SCR_SETTINGS] = _settingsScreen.get();
-	_settingsScreen->onBack = [this]() { switchToScreen(SCR_MAIN); };
-	_settingsScreen->onGoSetup = [this]() { startSetup(false); };
-	_settingsScreen->onStartUpdate = [this]() {
-		preferences.putBool(MANUAL_UPDATE_KEY, true);
-		utils::forceRestart();
-	};
+	_initSettings();
 
 	// MAIN SCREEN
 	_mainScreen = utils::make_unique<MainScreen>();
@@ -108,6 +102,37 @@ void GUI::initMain(cal::Model* model) {
 	_mainScreen->onGoSettings = [this]() { switchToScreen(SCR_SETTINGS); };
 }
 
+void GUI::initRooms(cal::Model* model) {
+	_model = model;
+	_homeScreen = SCR_ROOMS;
+
+	_initSettings();
+
+	// ROOM GRID SCREEN
+	_roomGridScreen = utils::make_unique<RoomGridScreen>();
+	_screens[SCR_ROOMS] = _roomGridScreen.get();
+	_roomGridScreen->onGoSettings = [this]() { switchToScreen(SCR_SETTINGS); };
+}
+
+void GUI::_initSettings() {
+	_settingsScreen = utils::make_unique<SettingsScreen>();
+	_screens[SCR_SETTINGS] = _settingsScreen.get();
+	_settingsScreen->onBack = [this]() { switchToScreen(_homeScreen); };
+	_settingsScreen->onGoSetup = [this]() { startSetup(false); };
+	_settingsScreen->onStartUpdate = [this]() {
+		preferences.putBool(MANUAL_UPDATE_KEY, true);
+		utils::forceRestart();
+	};
+}
+
+void GUI::resumeMain(std::shared_ptr<cal::CalendarStatus> status) {
+	log_i("Resuming main screen");
+	_status = status;
+	_mainScreen->setStatus(status);
+	_mainScreen->prime();
+	_currentScreen = SCR_MAIN;
+}
+
 void GUI::handleTouch(int16_t x, int16_t y) {
 	// Negatives mean touch up
 	if (x < 0 || y < 0) {
@@ -126,8 +151,8 @@ void GUI::wake() {}
 
 void GUI::sleep() {
 	log_i("Setting screen to sleep");
-	if (_currentScreen != SCR_MAIN) {
-		switchToScreen(SCR_MAIN);
+	if (_currentScreen != _homeScreen) {
+		switchToScreen(_homeScreen);
 	}
 
 	sleepDisplay();
@@ -163,12 +188,35 @@ void GUI::showCalendarStatus(std::shared_ptr<cal::CalendarStatus> status) {
 	}
 }
 
+void GUI::showRoomStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses) {
+	log_i("Setting room statuses");
+	if (_loading)
+		stopLoading();
+
+	_roomGridScreen->setStatuses(statuses);
+
+	// Nothing is drawn over the grid, so a reduced draw is always possible on it
+	if (_currentScreen == SCR_ROOMS)
+		_roomGridScreen->reducedDraw(MY_UPDATE_MODE);
+	else if (_currentScreen == SCR_LOADING)
+		switchToScreen(SCR_ROOMS);
+}
+
 void GUI::showError(const String& error) {
 	log_i("Showing error");
 	bool wasLoading = _loading;
 	if (_loading)
 		stopLoading();
 
+	if (_homeScreen == SCR_ROOMS) {
+		_roomGridScreen->setError(error);
+		if (_currentScreen == SCR_ROOMS)
+			_roomGridScreen->reducedDraw(MY_UPDATE_MODE);
+		else if (_currentScreen == SCR_LOADING)
+			switchToScreen(SCR_ROOMS);
+		return;
+	}
+
 	_mainScreen->setError(error);
 
 	if (_currentScreen == SCR_MAIN) {
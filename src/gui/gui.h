@@ -11,6 +11,7 @@
 #include "screens/confirmFreeScreen.h"
 #include "screens/loadingScreen.h"
 #include "screens/mainScreen.h"
+#include "screens/roomGridScreen.h"
 #include "screens/screen.h"
 #include "screens/settingsScreen.h"
 #include "screens/setupScreen.h"
@@ -26,9 +27,11 @@ namespace gui {
  */
 class GUI {
   public:
-	GUI(GUITask* guiTask);
+	GUI(GUITask* guiTask, bool resume = false);
 
 	void initMain(cal::Model* model);
+	void initRooms(cal::Model* model);
+	void resumeMain(std::shared_ptr<cal::CalendarStatus> status);
 
 	enum ScreenIdx {
 		SCR_LOADING,
@@ -37,6 +40,7 @@ class GUI {
 		SCR_SETUP,
 		SCR_CONFIRM_FREE,
 		SCR_SHUTDOWN,
+		SCR_ROOMS,
 		SCR_SIZE
 	};
 
@@ -45,6 +49,7 @@ class GUI {
 	void handleTouch(int16_t x = -1, int16_t y = -1);
 
 	void showCalendarStatus(std::shared_ptr<cal::CalendarStatus> status);
+	void showRoomStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses);
 	void showError(const String& error);
 
 	void wake();
@@ -61,6 +66,8 @@ class GUI {
 	void showShutdownScreen(String message, bool isError);
 
   private:
+	void _initSettings();
+
 	// Non owning pointers
 	cal::Model* _model;
 	GUITask* _guiTask;
@@ -71,11 +78,14 @@ class GUI {
 	std::unique_ptr<ConfirmFreeScreen> _confirmFreeScreen = nullptr;
 	std::unique_ptr<ShutdownScreen> _shutdownScreen = nullptr;
 	std::unique_ptr<SettingsScreen> _settingsScreen = nullptr;
+	std::unique_ptr<RoomGridScreen> _roomGridScreen = nullptr;
 
 	// Non owning pointers
 	std::array<Screen*, SCR_SIZE> _screens{};
 
 	ScreenIdx _currentScreen = SCR_LOADING;
+	// Screen shown when idle, the room grid in dashboard mode
+	ScreenIdx _homeScreen = SCR_MAIN;
 
 	bool _touching = false;
 
@@ -1,6 +1,7 @@
 #include "guiTask.h"
 
 #include "globals.h"
+#include "trace.h"
 
 #define GUI_QUEUE_LENGTH 40
 #define GUI_TASK_PRIORITY 5
@@ -16,10 +17,13 @@ void task(void* arg) {
 	for (;;) {
 		void* reqTemp;
 		xQueueReceive(guiTask->_queueHandle, &reqTemp, portMAX_DELAY);
-		auto counter = sleepManager.scopedTaskCount();
+		auto counter = sleepManager.adoptTaskCount();
 		auto req = toSmartPtr<GUITask::QueueElement>(reqTemp);
 		auto func = toSmartPtr<GUITask::QueueFunc>(req->func);
+		auto startTime = micros();
 		(*func)();
+		TRACE_GUI("GUI request took %lu us", micros() - startTime);
+		energyLedger.addTaskBusy(EnergyLedger::Task::GUI, (micros() - startTime) / 1000);
 
 		// Fix "watchdog triggered" crash by giving some processing time to idle tasks
 		delay(5);
@@ -28,13 +32,14 @@ void task(void* arg) {
 	vTaskDelete(NULL);
 }
 
-GUITask::GUITask() : _gui(this) {
+GUITask::GUITask(bool resume) : _gui(this, resume) {
 	using namespace std::placeholders;
 	M5.TP.onTouch(std::bind(&GUITask::touchDown, this, _1), std::bind(&GUITask::touchUp, this));
 
 	_queueHandle = xQueueCreate(GUI_QUEUE_LENGTH, sizeof(GUITask::QueueElement*));
 	xTaskCreatePinnedToCore(task, "GUI", GUI_TASK_STACK_SIZE, static_cast<void*>(this),
 	                        GUI_TASK_PRIORITY, &_taskHandle, 0);
+	metrics.registerTask("gui", _taskHandle, _queueHandle);
 
 	sleepManager.registerCallback(SleepManager::Callback::BEFORE_SLEEP, [this]() { sleep(); });
 
@@ -48,12 +53,22 @@ GUITask::GUITask() : _gui(this) {
 
 void GUITask::initMain(cal::Model* model) { _gui.initMain(model); }
 
+void GUITask::initRooms(cal::Model* model) { _gui.initRooms(model); }
+
+void GUITask::resumeMain(std::shared_ptr<cal::CalendarStatus> status) {
+	_enqueue(new QueueFunc([=]() { _gui.resumeMain(status); }));
+}
+
 void GUITask::startSetup(bool useAP) { _gui.startSetup(useAP); }
 
 void GUITask::success(Request type, std::shared_ptr<cal::CalendarStatus> status) {
 	_enqueue(new QueueFunc([=]() { _gui.showCalendarStatus(status); }));
 }
 
+void GUITask::showRoomStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses) {
+	_enqueue(new QueueFunc([=]() { _gui.showRoomStatuses(statuses); }));
+}
+
 String GUITask::errorEnumToString(GUITask::Request type) {
 	switch (type) {
 		case GUITask::Request::RESERVE:
@@ -109,7 +124,14 @@ void GUITask::showShutdownScreen(const String& shutdownText, bool isError) {
 
 void GUITask::_enqueue(void* func) {
 	QueueElement* data = new QueueElement{func};
-	xQueueSend(_queueHandle, (void*)&data, 0);
+	// Keep awake until the request is completed, the task adopts this count
+	sleepManager.incrementTaskCounter();
+	if (xQueueSend(_queueHandle, (void*)&data, 0) != pdTRUE) {
+		log_e("GUITask: queue full, request dropped");
+		sleepManager.decrementTaskCounter();
+		delete static_cast<QueueFunc*>(func);
+		delete data;
+	}
 }
 
 }  // namespace gui
\ No newline at end of file
@@ -21,7 +21,11 @@ namespace gui {
  */
 class GUITask {
   public:
-	GUITask();
+	/**
+	 * Set resume when waking from deep sleep, the loading screen is not drawn
+	 * as the display still shows the main screen.
+	 */
+	GUITask(bool resume = false);
 
 	// Created on construction
 	GUI _gui;
@@ -42,6 +46,18 @@ class GUITask {
 	 */
 	void initMain(cal::Model* model);
 
+	/**
+	 * Initialize the room grid screen of the dashboard mode instead of the main screen.
+	 * This is done synchronously.
+	 */
+	void initRooms(cal::Model* model);
+
+	/**
+	 * Show the main screen with a status restored from deep sleep without redrawing it.
+	 * Call after initMain.
+	 */
+	void resumeMain(std::shared_ptr<cal::CalendarStatus> status);
+
 	/**
 	 * @brief Called when an operation is executed successfully
 	 *
@@ -50,6 +66,11 @@ class GUITask {
 	 */
 	void success(Request type, std::shared_ptr<cal::CalendarStatus> status);
 
+	/**
+	 * Called with new room statuses in dashboard mode, null if they haven't changed.
+	 */
+	void showRoomStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses);
+
 	/**
 	 * @brief Called when an operation caused error
 	 *
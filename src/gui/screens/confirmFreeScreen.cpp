@@ -45,7 +45,7 @@ void ConfirmFreeScreen::draw(m5epd_update_mode_t mode) {
 	for (auto& t : _texts) t->drawToCanvas(c);
 	for (auto& b : _buttons) b->drawToCanvas(c);
 	wakeDisplay();
-	c.pushCanvas(0, 0, mode);
+	pushCanvas(c, mode);
 	sleepDisplay();
 }
 
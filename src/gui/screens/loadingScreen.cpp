@@ -22,7 +22,7 @@ void LoadingScreen::draw(m5epd_update_mode_t mode) {
 	for (auto& t : _texts) t->drawToCanvas(c);
 	for (auto& b : _buttons) b->drawToCanvas(c);
 	wakeDisplay();
-	c.pushCanvas(0, 0, mode);
+	pushCanvas(c, mode);
 	sleepDisplay();
 }
 
@@ -45,7 +45,7 @@ void LoadingScreen::setText(String text) {
 	M5EPD_Canvas& c = getScreenBuffer();
 	for (auto& t : _texts) t->drawToCanvas(c);
 	wakeDisplay();
-	c.pushCanvas(0, 0, MY_UPDATE_MODE);
+	pushCanvas(c, MY_UPDATE_MODE);
 	delay(30);
 }
 
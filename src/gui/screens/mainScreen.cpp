@@ -181,6 +181,8 @@ void MainScreen::draw(m5epd_update_mode_t mode) { _drawImpl(mode, false); }
 
 void MainScreen::reducedDraw(m5epd_update_mode_t mode) { _drawImpl(mode, true); }
 
+void MainScreen::prime() { _drawImpl(UPDATE_MODE_NONE, false); }
+
 const Pos POS_1 = Pos{.x = 748, .y = 20};
 const Size SIZE_1 = Size{.w = 200, .h = 30};
 uint8_t* part1_buf = new uint8_t[SIZE_1.w * SIZE_1.h / 2];
@@ -233,11 +235,11 @@ void MainScreen::_drawImpl(m5epd_update_mode_t mode, bool allowReducedDraw) {
 		wakeDisplay();
 		// Update top right part with battery level and clock
 		M5.EPD.WritePartGram4bpp(POS_1.x, POS_1.y, SIZE_1.w, SIZE_1.h, part1_buf);
-		M5.EPD.UpdateArea(POS_1.x, POS_1.y, SIZE_1.w, SIZE_1.h, mode);
+		updateArea(POS_1, SIZE_1, mode);
 
 		// Update clock on left side
 		M5.EPD.WritePartGram4bpp(POS_2.x, POS_2.y, SIZE_2.w, SIZE_2.h, part2_buf);
-		M5.EPD.UpdateArea(POS_2.x, POS_2.y, SIZE_2.w, SIZE_2.h, mode);
+		updateArea(POS_2, SIZE_2, mode);
 		sleepDisplay();
 	} else {
 		for (auto& p : _panels) p->drawToCanvas(c);
@@ -247,9 +249,11 @@ void MainScreen::_drawImpl(m5epd_update_mode_t mode, bool allowReducedDraw) {
 		if (_batteryImage == 0) {
 			_batteryWarningIcon.drawToCanvas(c);
 		}
-		wakeDisplay();
-		c.pushCanvas(0, 0, mode);
-		sleepDisplay();
+		if (mode != UPDATE_MODE_NONE) {
+			wakeDisplay();
+			pushCanvas(c, mode);
+			sleepDisplay();
+		}
 	}
 
 	_statusChanged = false;
@@ -73,6 +73,13 @@ class MainScreen : public Screen {
 	 */
 	void reducedDraw(m5epd_update_mode_t mode);
 
+	/**
+	 * Render into the screen buffer without updating the display.
+	 * Used when resuming from deep sleep: the display still shows this screen, but the buffer
+	 * was lost, and reducedDraw needs it to only update what changed.
+	 */
+	void prime();
+
 	void handleTouch(int16_t x = -1, int16_t y = -1) override;
 
 	// Callbacks the GUI class can register to (they fire on button presses)
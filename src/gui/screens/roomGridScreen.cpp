@@ -0,0 +1,138 @@
+#include "roomGridScreen.h"
+
+#include "globals.h"
+#include "gui/displayUtils.h"
+
+namespace gui {
+
+namespace {
+const int HEADER_H = 80;
+const int GAP = 8;
+const int CELL_W = (960 - (RoomGridScreen::GRID_COLUMNS + 1) * GAP) / RoomGridScreen::GRID_COLUMNS;
+const int CELL_H = (540 - HEADER_H - RoomGridScreen::GRID_ROWS * GAP) / RoomGridScreen::GRID_ROWS;
+const int CELL_PAD = 12;
+
+// Cell colors by cal::RoomStatus::State
+const std::array<uint8_t, 3> CELL_COLORS{R_PNL, L_PNL_TAKEN, R_PNL_TAKEN};
+const std::array<uint8_t, 3> CELL_TEXT_COLORS{BK, WH, BK};
+
+const Pos CLOCK_POS = Pos{.x = 872, .y = 20};
+const Size CLOCK_SIZE = Size{.w = 74, .h = 30};
+uint8_t* clockBuf = new uint8_t[CLOCK_SIZE.w * CLOCK_SIZE.h / 2];
+
+String untilStr(L10nMessage message, time_t until) {
+	String text = l10n.msg(message);
+	text.replace("{}", safeMyTZ.dateTime(until, UTC_TIME, "G:i"));
+	return text;
+}
+}  // namespace
+
+RoomGridScreen::RoomGridScreen() {
+	ADD_PNL(PNL_MAIN, Panel(Pos{0, 0}, Size{960, 540}, WH));
+
+	ADD_TXT(TXT_CLOCK,
+	        Text(CLOCK_POS, CLOCK_SIZE, "00:00", FS_NORMAL, BK, WH, false, Align::RIGHT));
+	ADD_TXT(TXT_ERROR, Text(Pos{96, 8}, Size{760, HEADER_H - 16}, "", FS_NORMAL, BK, 1));
+
+	ADD_BTN(BTN_SETTINGS, Button(Pos{16, 12}, Size{64, 56}, "/images/settingsWhite.png",
+	                             [this]() { onGoSettings(); }));
+
+	ASSERT_ALL_ELEMENTS();
+
+	for (int i = 0; i < _cells.size(); i++) {
+		const Pos pos{uint16_t(GAP + (i % GRID_COLUMNS) * (CELL_W + GAP)),
+		              uint16_t(HEADER_H + (i / GRID_COLUMNS) * (CELL_H + GAP))};
+		const int txt_w = CELL_W - 2 * CELL_PAD;
+		Cell& cell = _cells[i];
+		cell.panel.reset(new Panel(pos, Size{CELL_W, CELL_H}, R_PNL));
+		cell.name.reset(new Text(Pos{uint16_t(pos.x + CELL_PAD), uint16_t(pos.y + CELL_PAD)},
+		                         Size{txt_w, 44}, "", FS_HEADER, BK, R_PNL, true));
+		cell.state.reset(new Text(Pos{uint16_t(pos.x + CELL_PAD), uint16_t(pos.y + CELL_H - 52)},
+		                          Size{txt_w, 40}, "", FS_NORMAL, BK, R_PNL));
+	}
+
+	_texts[TXT_ERROR]->hide();
+}
+
+void RoomGridScreen::_updateCell(Cell& cell, const cal::RoomStatus& status) {
+	cell.name->setText(status.name);
+	switch (status.state) {
+		case cal::RoomStatus::State::FREE:
+			cell.state->setText(status.until ? untilStr(L10nMessage::ROOM_FREE_UNTIL, status.until)
+			                                 : l10n.msg(L10nMessage::ROOM_FREE_TODAY));
+			break;
+		case cal::RoomStatus::State::BUSY:
+			cell.state->setText(untilStr(L10nMessage::ROOM_BUSY_UNTIL, status.until));
+			break;
+		default:
+			cell.state->setText(l10n.msg(L10nMessage::ROOM_NO_STATUS));
+			break;
+	}
+
+	const uint8_t color = CELL_COLORS[(size_t)status.state];
+	const uint8_t textColor = CELL_TEXT_COLORS[(size_t)status.state];
+	cell.panel->setColor(color);
+	cell.name->setColors(textColor, color);
+	cell.state->setColors(textColor, color);
+}
+
+void RoomGridScreen::setStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses) {
+	if (statuses) {
+		_changed = true;
+		_statuses = statuses;
+		for (size_t i = 0; i < _statuses->size() && i < _cells.size(); i++)
+			_updateCell(_cells[i], (*_statuses)[i]);
+	}
+
+	// Calling setStatuses means that no error happened
+	if (!_texts[TXT_ERROR]->isHidden()) {
+		_changed = true;
+		_texts[TXT_ERROR]->hide();
+	}
+}
+
+void RoomGridScreen::setError(const String& error) {
+	_changed = true;
+	_texts[TXT_ERROR]->show();
+	_texts[TXT_ERROR]->setText(error);
+}
+
+void RoomGridScreen::draw(m5epd_update_mode_t mode) { _drawImpl(mode, false); }
+
+void RoomGridScreen::reducedDraw(m5epd_update_mode_t mode) { _drawImpl(mode, true); }
+
+void RoomGridScreen::_drawImpl(m5epd_update_mode_t mode, bool allowReducedDraw) {
+	_texts[TXT_CLOCK]->setText(safeMyTZ.dateTime("G:i"));
+
+	M5EPD_Canvas& c = getScreenBuffer();
+	if (allowReducedDraw && !_changed) {
+		_texts[TXT_CLOCK]->drawToCanvas(c);
+		readPartFromCanvas(CLOCK_POS, CLOCK_SIZE, c, M5EPD_PANEL_W, clockBuf);
+		wakeDisplay();
+		M5.EPD.WritePartGram4bpp(CLOCK_POS.x, CLOCK_POS.y, CLOCK_SIZE.w, CLOCK_SIZE.h, clockBuf);
+		updateArea(CLOCK_POS, CLOCK_SIZE, mode);
+		sleepDisplay();
+		return;
+	}
+
+	for (auto& p : _panels) p->drawToCanvas(c);
+	for (auto& t : _texts) t->drawToCanvas(c);
+	for (auto& b : _buttons) b->drawToCanvas(c);
+	const size_t roomCount = _statuses ? min(_statuses->size(), _cells.size()) : 0;
+	for (size_t i = 0; i < roomCount; i++) {
+		_cells[i].panel->drawToCanvas(c);
+		_cells[i].name->drawToCanvas(c);
+		_cells[i].state->drawToCanvas(c);
+	}
+	wakeDisplay();
+	pushCanvas(c, mode);
+	sleepDisplay();
+
+	_changed = false;
+}
+
+void RoomGridScreen::handleTouch(int16_t x, int16_t y) {
+	for (auto& b : _buttons) b->handleTouch(x, y);
+}
+
+}  // namespace gui
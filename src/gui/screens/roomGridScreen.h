@@ -0,0 +1,74 @@
+#ifndef ROOM_GRID_SCREEN_H
+#define ROOM_GRID_SCREEN_H
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "calendar/api.h"
+#include "gui/elements/button.h"
+#include "gui/elements/panel.h"
+#include "gui/elements/text.h"
+#include "screen.h"
+
+namespace gui {
+
+/**
+ * Dashboard of many rooms, shows whether each room is free and until when.
+ * Rooms are laid out in a fixed grid of cal::ROOMS_MAX cells, unused cells stay blank.
+ */
+class RoomGridScreen : public Screen {
+  public:
+	RoomGridScreen();
+	~RoomGridScreen(){};
+
+	enum PanelIdx { PNL_MAIN, PNL_SIZE };
+	enum TextIdx { TXT_CLOCK, TXT_ERROR, TXT_SIZE };
+	enum ButtonIdx { BTN_SETTINGS, BTN_SIZE };
+
+	static const int GRID_COLUMNS = 4;
+	static const int GRID_ROWS = 3;
+
+	/**
+	 * Statuses are null if they haven't changed.
+	 */
+	void setStatuses(std::shared_ptr<std::vector<cal::RoomStatus>> statuses);
+	void setError(const String& error);
+
+	void draw(m5epd_update_mode_t mode) override;
+
+	/**
+	 * Only update the clock if the statuses and the error are the same as in the last draw.
+	 * The current screen must already be this screen.
+	 */
+	void reducedDraw(m5epd_update_mode_t mode);
+
+	void handleTouch(int16_t x = -1, int16_t y = -1) override;
+
+	// Callbacks the GUI class can register to (they fire on button presses)
+	std::function<void()> onGoSettings = nullptr;
+
+  private:
+	struct Cell {
+		std::unique_ptr<Panel> panel;
+		std::unique_ptr<Text> name;
+		std::unique_ptr<Text> state;
+	};
+
+	void _updateCell(Cell& cell, const cal::RoomStatus& status);
+
+	void _drawImpl(m5epd_update_mode_t mode, bool allowReducedDraw);
+
+	std::shared_ptr<std::vector<cal::RoomStatus>> _statuses = nullptr;
+	bool _changed = true;
+
+	std::array<std::unique_ptr<Panel>, PNL_SIZE> _panels;
+	std::array<std::unique_ptr<Text>, TXT_SIZE> _texts;
+	std::array<std::unique_ptr<Button>, BTN_SIZE> _buttons;
+
+	std::array<Cell, GRID_COLUMNS * GRID_ROWS> _cells;
+	static_assert(GRID_COLUMNS * GRID_ROWS == cal::ROOMS_MAX, "Every room needs a cell");
+};
+}  // namespace gui
+
+#endif
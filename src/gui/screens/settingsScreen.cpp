@@ -5,6 +5,9 @@
 
 namespace gui {
 
+// Lines left in the text box below the versions
+const size_t SETTINGS_EVENTS_SHOWN = 3;
+
 SettingsScreen::SettingsScreen() {
 	const int txt_pad_x = 60;
 	const int txt_pad_y = 120;
@@ -15,14 +18,10 @@ SettingsScreen::SettingsScreen() {
 	ADD_TXT(TXT_TITLE, Text(Pos{txt_pad_x, txt_pad_y}, Size{txt_w, 78},
 	                        l10n.msg(L10nMessage::SETTINGS), FS_TITLE, BK, WH, true));
 
-	String mainText
-	    = l10n.msg(L10nMessage::VERSION) + ": " + CURRENT_VERSION + " (" + UPDATE_CHANNEL + ")\n";
-	if (latestVersionResult.isOk()) {
-		mainText += l10n.msg(L10nMessage::LATEST_VERSION) + ": " + *latestVersionResult.ok();
-	}
+	// Text is set in draw, the latest version is checked in the background
 	ADD_TXT(TXT_MAIN,
 	        Text(Pos{txt_pad_x, txt_pad_y + 78 + 20}, Size{txt_w, 540 - 78 - 20 - txt_pad_y * 2},
-	             mainText, FS_NORMAL, BK, WH));
+	             "", FS_NORMAL, BK, WH));
 
 	ADD_BTN(BTN_SETTINGS,
 	        Button(Pos{15, 15}, Size{64, 56}, "/images/settingsWhite.png", [this]() { onBack(); }));
@@ -35,14 +34,29 @@ SettingsScreen::SettingsScreen() {
 }
 
 void SettingsScreen::draw(m5epd_update_mode_t mode) {
-	_buttons[BTN_UPDATE]->show(latestVersionResult.isOk()
-	                           && *latestVersionResult.ok() != CURRENT_VERSION);
+	const auto latestVersion = getLatestVersion();
+	String mainText
+	    = l10n.msg(L10nMessage::VERSION) + ": " + CURRENT_VERSION + " (" + UPDATE_CHANNEL + ")\n";
+	if (latestVersion.isOk()) {
+		mainText += l10n.msg(L10nMessage::LATEST_VERSION) + ": " + *latestVersion.ok();
+	}
+	const auto events = eventLog.recent(SETTINGS_EVENTS_SHOWN);
+	if (!events.empty()) {
+		mainText += "\n" + l10n.msg(L10nMessage::RECENT_EVENTS) + ":";
+		for (const auto& event : events) {
+			mainText += "\n" + safeMyTZ.dateTime(event.time, UTC_TIME, "d.m. H:i");
+			mainText += "  " + event.text;
+		}
+	}
+	_texts[TXT_MAIN]->setText(mainText);
+
+	_buttons[BTN_UPDATE]->show(latestVersion.isOk() && *latestVersion.ok() != CURRENT_VERSION);
 	M5EPD_Canvas& c = getScreenBuffer();
 	for (auto& p : _panels) p->drawToCanvas(c);
 	for (auto& t : _texts) t->drawToCanvas(c);
 	for (auto& b : _buttons) b->drawToCanvas(c);
 	wakeDisplay();
-	c.pushCanvas(0, 0, mode);
+	pushCanvas(c, mode);
 	sleepDisplay();
 }
 
@@ -60,7 +60,7 @@ void SetupScreen::draw(m5epd_update_mode_t mode) {
 	for (auto& b : _buttons) b->drawToCanvas(c);
 	drawQRCode(c);
 	wakeDisplay();
-	c.pushCanvas(0, 0, mode);
+	pushCanvas(c, mode);
 	sleepDisplay();
 }
 
@@ -25,7 +25,7 @@ void ShutdownScreen::draw(m5epd_update_mode_t mode) {
 	for (auto& b : _buttons) b->drawToCanvas(c);
 	_logo.drawToCanvas(c);
 	wakeDisplay();
-	c.pushCanvas(0, 0, mode);
+	pushCanvas(c, mode);
 	sleepDisplay();
 }
 
@@ -1,57 +1,119 @@
 #include "localization.h"
 
-#include <ArduinoJson.h>
 #include <LittleFS.h>
 
 #include "utils.h"
 
+namespace {
+const char* L10N_TABLE_PATH = "/localization.bin";
+const uint8_t L10N_TABLE_VERSION = 1;
+
+// Layout is documented in scripts/compile_localization.py
+struct __attribute__((packed)) TableHeader {
+	char magic[4];
+	uint8_t version;
+	uint8_t languageCount;
+	uint16_t messageCount;
+	uint32_t namesHash;
+};
+
+struct __attribute__((packed)) LanguageEntry {
+	char code[4];
+	uint32_t offset;
+	uint32_t size;
+};
+
 /**
- * Read localized messages from file and insert them into global "messages" as a side effect.
+ * FNV-1a hash of message names joined with ','.
+ * Used to detect a table that was compiled against a different L10N_MESSAGES list.
+ */
+uint32_t hashMessageNames() {
+	uint32_t hash = 0x811C9DC5;
+	auto add = [&hash](char c) {
+		hash ^= (uint8_t)c;
+		hash *= 0x01000193;
+	};
+	for (size_t i = 0; i < messageNames.size(); i++) {
+		if (i > 0)
+			add(',');
+		for (const char* c = messageNames[i].c_str(); *c; c++) add(*c);
+	}
+	return hash;
+}
+}  // namespace
+
+/**
+ * Read localized messages of a single language from the precompiled table.
+ * Only the section of the selected language is read into memory.
  * Returns an error or nullptr.
  */
 std::unique_ptr<utils::Error> Localization::_readMessages(const String& lang) {
-	log_i("Trying to load localization.json from flash...");
-	DynamicJsonDocument doc(1024 * 16);
-	File handle = LittleFS.open("/localization.json", FILE_READ);
+	log_i("Trying to load localization.bin from flash...");
+	File handle = LittleFS.open(L10N_TABLE_PATH, FILE_READ);
 
 	if (!handle) {
-		return utils::make_unique<utils::Error>("Could not open localization.json.");
+		return utils::make_unique<utils::Error>("Could not open localization.bin.");
 	}
 
-	// Create filter to not waste memory on unused languages
-	DynamicJsonDocument filter(1024 * 2);
-	filter["supportedLanguages"] = true;
-	for (const String& name : messageNames) {
-		filter[name][lang] = true;
+	TableHeader header;
+	if (handle.read((uint8_t*)&header, sizeof(header)) != sizeof(header)
+	    || memcmp(header.magic, "L10N", 4) != 0 || header.version != L10N_TABLE_VERSION) {
+		return utils::make_unique<utils::Error>("localization.bin: invalid header.");
 	}
 
-	auto err = deserializeJson(doc, handle, DeserializationOption::Filter(filter));
-	if (err) {
-		return utils::make_unique<utils::Error>(String("Error deserializing localization.json: ")
-		                                        + err.c_str() + ".");
+	if (header.messageCount != (uint16_t)L10nMessage::SIZE
+	    || header.namesHash != hashMessageNames()) {
+		return utils::make_unique<utils::Error>(
+		    "localization.bin doesn't match firmware messages, rebuild the filesystem.");
 	}
 
+	LanguageEntry entry;
 	bool isSupported = false;
-	for (JsonVariantConst obj : doc["supportedLanguages"].as<JsonArrayConst>()) {
-		if (lang == obj.as<String>()) {
+	for (uint8_t i = 0; i < header.languageCount; i++) {
+		if (handle.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) {
+			return utils::make_unique<utils::Error>("localization.bin: truncated language table.");
+		}
+		// Codes shorter than four characters are zero padded
+		if (lang.length() <= sizeof(entry.code)
+		    && strncmp(entry.code, lang.c_str(), sizeof(entry.code)) == 0) {
 			isSupported = true;
+			break;
 		}
 	}
 	if (!isSupported)
-		return utils::make_unique<utils::Error>("localization.json: language '" + lang
+		return utils::make_unique<utils::Error>("localization.bin: language '" + lang
 		                                        + "' not supported.");
 
+	const size_t indexSize = sizeof(uint16_t) * (size_t)L10nMessage::SIZE;
+	if (entry.size <= indexSize) {
+		return utils::make_unique<utils::Error>("localization.bin: invalid language section.");
+	}
+
+	alloc::Buffer table = alloc::makeBuffer(alloc::Pool::BUFFER, entry.size);
+	if (!table) {
+		return utils::make_unique<utils::Error>("localization.bin: out of memory.");
+	}
+	if (!handle.seek(entry.offset) || handle.read(table.get(), entry.size) != entry.size) {
+		return utils::make_unique<utils::Error>("localization.bin: truncated language section.");
+	}
+	handle.close();
+
+	// Blob must be zero terminated, otherwise a corrupt offset could read past the buffer
+	const uint16_t* offsets = reinterpret_cast<const uint16_t*>(table.get());
+	const size_t blobSize = entry.size - indexSize;
+	if (table[entry.size - 1] != '\0') {
+		return utils::make_unique<utils::Error>("localization.bin: invalid language section.");
+	}
 	for (size_t msg = 0; msg < (size_t)L10nMessage::SIZE; msg++) {
-		_messages[msg] = doc[messageNames[msg]][lang].as<String>();
-		if (_messages[msg] == "null") {
+		if (offsets[msg] >= blobSize) {
 			return utils::make_unique<utils::Error>(String("Localization '") + lang + "-"
 			                                        + messageNames[msg] + "' not found.");
 		}
 	}
 
-#if CORE_DEBUG_LEVEL > 3
-	serializeJsonPretty(doc, Serial);
-#endif
+	_table = std::move(table);
+	_offsets = offsets;
+	_blob = reinterpret_cast<const char*>(_table.get() + indexSize);
 
 	return nullptr;
 }
@@ -65,7 +127,16 @@ std::unique_ptr<utils::Error> Localization::setLanguage(const String& lang) {
 		return nullptr;
 
 	_currentLang = lang;
-	return _readMessages(_currentLang);
+
+	auto startTime = micros();
+	auto err = _readMessages(_currentLang);
+	log_i("Localization '%s' loaded in %lu us.", lang.c_str(), micros() - startTime);
+
+	return err;
 }
 
-String Localization::msg(L10nMessage message) { return _messages[(size_t)message]; }
+String Localization::msg(L10nMessage message) {
+	if (!_blob)
+		return "";
+	return String(_blob + _offsets[(size_t)message]);
+}
@@ -4,9 +4,12 @@
 #include <array>
 #include <memory>
 
+#include "allocators.h"
 #include "utils.h"
 
-// Add message names here, they must have corresponding keys in localization.json
+// Add message names here, they must have corresponding keys in localization.json.
+// localization.json is compiled into localization.bin by scripts/compile_localization.py,
+// which uses the order of this list to index the binary table.
 #define L10N_MESSAGES(F)  \
 	F(BOOK)               \
 	F(FREE)               \
@@ -25,7 +28,12 @@
 	F(NEW_EVENT_SUMMARY)  \
 	F(UPDATE)             \
 	F(LATEST_VERSION)     \
-	F(CHARGE_ME)
+	F(CHARGE_ME)          \
+	F(ROOM_FREE_UNTIL)    \
+	F(ROOM_BUSY_UNTIL)    \
+	F(ROOM_FREE_TODAY)    \
+	F(ROOM_NO_STATUS)     \
+	F(RECENT_EVENTS)
 
 #define L10N_MESSAGE_AS_ENUM(M) M,
 #define L10N_MESSAGE_AS_STRING(M) #M,
@@ -45,7 +53,13 @@ class Localization {
 	std::unique_ptr<utils::Error> _readMessages(const String& lang);
 
 	String _currentLang = "";
-	L10nStringArray _messages{};
+
+	// Section of the selected language from localization.bin:
+	// an offset index of L10nMessage::SIZE uint16_t values followed by a blob of
+	// zero terminated UTF-8 strings.
+	alloc::Buffer _table = nullptr;
+	const uint16_t* _offsets = nullptr;
+	const char* _blob = nullptr;
 };
 
 #endif
\ No newline at end of file
@@ -3,22 +3,31 @@
 #include <M5EPD.h>
 #include <Preferences.h>
 #include <esp_crt_bundle.h>
+#include <esp_system.h>
 #include <esp_tls.h>
 #include <esp_wifi.h>
 
+#include <atomic>
 #include <memory>
 
+#include "allocators.h"
 #include "calendar/apiTask.h"
+#include "calendar/caldavApi.h"
+#include "calendar/gatewayApi.h"
 #include "calendar/googleApi.h"
 #include "calendar/microsoftApi.h"
 #include "calendar/model.h"
+#include "configServer.h"
 #include "globals.h"
 #include "gui/guiTask.h"
 #include "localization.h"
 #include "myUpdate.h"
+#include "resumeState.h"
 #include "safeTimezone.h"
 #include "sleepManager.h"
 #include "timeUtils.h"
+#include "timezones.h"
+#include "trace.h"
 #include "utils.h"
 
 // Format the filesystem automatically if not formatted already
@@ -32,10 +41,40 @@
 
 #define SETUP_HOLD_BUTTON_MS 10000
 
+// Periods and slacks of scheduled jobs, slack lets a job share a wake with a status poll
+#define BATTERY_SAMPLE_INTERVAL_S (10 * SECS_PER_MIN)
+#define BATTERY_SAMPLE_SLACK_S (2 * SECS_PER_MIN)
+#define FIRMWARE_CHECK_INTERVAL_S SECS_PER_DAY
+#define FIRMWARE_CHECK_SLACK_S (6 * SECS_PER_HOUR)
+#define RTC_SYNC_INTERVAL_S (6 * SECS_PER_HOUR)
+#define RTC_SYNC_SLACK_S (2 * SECS_PER_HOUR)
+
 std::unique_ptr<config::ConfigStore> configStore = nullptr;
 std::unique_ptr<cal::APITask> apiTask = nullptr;
 std::unique_ptr<gui::GUITask> guiTask = nullptr;
 std::unique_ptr<cal::Model> calendarModel = nullptr;
+// Serves /metrics and /events when enabled in config
+std::unique_ptr<config::ConfigServer> metricsServer = nullptr;
+// Set by the background version check, the device restarts to update before its next sleep
+std::atomic<bool> updatePending{false};
+
+/**
+ * Set the local timezone from the bundled table or the NVS cache.
+ * Timezones missing from both are fetched from the timezone server and cached,
+ * unless allowNetwork is false. Returns false if the timezone was not set.
+ */
+bool setupTimezone(const String& IANATimeZone, bool allowNetwork) {
+	bool inTable = tzdb::lookupPosix(IANATimeZone.c_str()) != nullptr;
+	if (!inTable && safeMyTZ.setCache(String("timezones"), IANATimeZone))
+		return true;
+	if (!inTable && !allowNetwork)
+		return false;
+
+	auto startTime = micros();
+	safeMyTZ.setLocation(IANATimeZone);
+	log_i("Timezone '%s' set in %lu us.", IANATimeZone.c_str(), micros() - startTime);
+	return true;
+}
 
 bool setupTime(const String& IANATimeZone) {
 	Serial.println("Setting up time");
@@ -54,8 +93,7 @@ bool setupTime(const String& IANATimeZone) {
 		delay(2000);  // retry
 	}
 
-	if (!safeMyTZ.setCache(String("timezones"), IANATimeZone))
-		safeMyTZ.setLocation(IANATimeZone);
+	setupTimezone(IANATimeZone, true);
 
 	return true;
 }
@@ -74,10 +112,47 @@ void syncRTCFromEzTime() {
 	M5.RTC.setTime(&dateTime.time);
 }
 
+/**
+ * Correct the RTC from NTP, the RTC keeps time between boots and drifts slowly.
+ */
+void syncTimeFromNTP() {
+	time_t t;
+	unsigned long measuredAt;
+	if (!ezt::queryNTP(NTP_SERVER, t, measuredAt)) {
+		log_e("NTP query failed");
+		return;
+	}
+	safeUTC.setTime(t + (millis() - measuredAt) / 1000);
+	syncRTCFromEzTime();
+	log_i("RTC synced from NTP: %s", safeMyTZ.dateTime(RFC3339).c_str());
+}
+
+const char* resetReasonToString(esp_reset_reason_t reason) {
+	switch (reason) {
+		case ESP_RST_POWERON:
+			return "power on";
+		case ESP_RST_SW:
+			return "restart";
+		case ESP_RST_PANIC:
+			return "panic";
+		case ESP_RST_INT_WDT:
+		case ESP_RST_TASK_WDT:
+		case ESP_RST_WDT:
+			return "watchdog";
+		case ESP_RST_DEEPSLEEP:
+			return "deep sleep";
+		case ESP_RST_BROWNOUT:
+			return "brownout";
+		default:
+			return "other";
+	}
+}
+
 void handleBootError(const String& message) {
 	// Try to sync from rtc in case there is some kind of time
 	syncEzTimeFromRTC();
 	log_e("%s", message.c_str());
+	eventLog.append(EventLog::Type::ERROR, message);
 	if (guiTask) {
 		guiTask->showShutdownScreen(message + "\nRetrying automatically in "
 		                                + String(ERROR_REBOOT_DELAY_S / 60) + " min...",
@@ -95,6 +170,7 @@ void onBeforeFilesystemWrite() {
 }
 
 void autoUpdateFirmware() {
+	const auto latestVersionResult = getLatestVersion();
 	if (latestVersionResult.isErr() || *latestVersionResult.ok() == CURRENT_VERSION)
 		return;
 
@@ -118,6 +194,28 @@ std::unique_ptr<cal::APITask> createApiTask(JsonObjectConst config) {
 	cal::API* api = nullptr;
 
 	const String provider = config["calendar_provider"] | "google";
+	if (provider == "gateway") {
+		JsonObjectConst settings = config["gatewaysettings"];
+		if (!settings["host"].is<const char*>() || !settings["calendarid"].is<const char*>()) {
+			handleBootError("Gateway host or calendar id is missing.");
+			return nullptr;
+		}
+		// The gateway owns the provider token
+		api = new cal::GatewayAPI{settings["host"], settings["port"] | cal::gateway::DEFAULT_PORT,
+		                          settings["key"] | "", settings["calendarid"]};
+		return utils::make_unique<cal::APITask>(std::unique_ptr<cal::API>(api));
+	}
+	if (provider == "caldav") {
+		JsonObjectConst settings = config["caldavsettings"];
+		if (!settings["url"].is<const char*>()) {
+			handleBootError("CalDAV calendar url is missing.");
+			return nullptr;
+		}
+		api = new cal::CalDAVAPI{settings["url"], settings["username"] | "",
+		                         settings["password"] | ""};
+		return utils::make_unique<cal::APITask>(std::unique_ptr<cal::API>(api));
+	}
+
 	const String key = provider == "google" ? "gcalsettings" : "mscalsettings";
 
 	auto tokenRes = cal::jsonToToken(config[key]["token"]);
@@ -125,6 +223,8 @@ std::unique_ptr<cal::APITask> createApiTask(JsonObjectConst config) {
 		handleBootError(tokenRes.err()->message);
 		return nullptr;
 	}
+	cal::loadAccessToken(*tokenRes.ok());
+
 	if (provider == "google") {
 		api = new cal::GoogleAPI{*tokenRes.ok(), config[key]["calendarid"]};
 	} else if (provider == "microsoft") {
@@ -135,21 +235,166 @@ std::unique_ptr<cal::APITask> createApiTask(JsonObjectConst config) {
 	}
 
 	api->registerSaveTokenFunc([key](const cal::Token& token) {
-		auto newConfig = DynamicJsonDocument(4096);
-		JsonObject newKey = newConfig.createNestedObject(key);
-		JsonObject newToken = newKey.createNestedObject("token");
-		cal::tokenToJson(newToken, token);
-
-		// log_i("Saving token");
-		// token.print();
-		serializeJsonPretty(newConfig, Serial);
-		configStore->mergeConfig(newConfig);
-		log_i("Updated token saved");
+		// Only the refresh token is persisted in config, so update just that key
+		auto result = configStore->setValue(key + ".token.refresh_token", token.refreshToken);
+		if (result.isOk())
+			log_i("Updated token saved");
 	});
 
 	return utils::make_unique<cal::APITask>(std::unique_ptr<cal::API>(api));
 }
 
+/**
+ * Rooms of the dashboard mode from config, empty if the device shows its own calendar.
+ * Returns false after handling the error if the rooms are invalid.
+ */
+bool parseDashboardRooms(JsonArrayConst config, std::vector<cal::Room>& rooms) {
+	for (JsonObjectConst room : config) {
+		if (!room["id"].is<const char*>()) {
+			handleBootError("Dashboard room is missing an id.");
+			return false;
+		}
+		rooms.push_back(cal::Room{room["name"] | room["id"].as<String>(), room["id"]});
+	}
+	if (rooms.size() > cal::ROOMS_MAX) {
+		handleBootError("Too many dashboard rooms, at most " + String(cal::ROOMS_MAX) + ".");
+		return false;
+	}
+	return true;
+}
+
+void registerDeepSleepCallbacks() {
+	sleepManager.registerCallback(SleepManager::Callback::BEFORE_DEEP_SLEEP,
+	                              []() { resume::saveSchedule(scheduler.getDeadlines()); });
+}
+
+/**
+ * Check the latest version in the background. A new version is installed on the next boot,
+ * so with autoupdate enabled the device restarts when it is idle, see registerScheduledJobs.
+ */
+void checkLatestVersionJob(bool autoupdate) {
+	auto result = checkLatestVersion(UPDATE_CHANNEL);
+	if (!autoupdate || result.isErr() || *result.ok() == CURRENT_VERSION)
+		return;
+
+	if (utils::getBatteryLevel() < 0.4) {
+		log_i("Battery level too low to update firmware");
+		return;
+	}
+
+	log_i("New firmware v%s available, updating before the next sleep", result.ok()->c_str());
+	preferences.putBool(MANUAL_UPDATE_KEY, true);
+	updatePending = true;
+}
+
+/**
+ * Jobs of the model and api task are registered by themselves.
+ * versionCheckedAt is the time of the cached version check, 0 if there is none.
+ */
+void registerScheduledJobs(bool autoupdate, time_t versionCheckedAt) {
+	scheduler.addJob(Scheduler::Job::BATTERY_SAMPLE, BATTERY_SAMPLE_INTERVAL_S,
+	                 BATTERY_SAMPLE_SLACK_S, []() { utils::sampleBatteryVoltage(); });
+	scheduler.addJob(Scheduler::Job::FIRMWARE_CHECK, FIRMWARE_CHECK_INTERVAL_S,
+	                 FIRMWARE_CHECK_SLACK_S, [autoupdate]() {
+		                 apiTask->runNetworkJob(
+		                     [autoupdate]() { checkLatestVersionJob(autoupdate); });
+	                 });
+	// Cache expires a period after the check. If there is none, the check is already overdue
+	// and runs before the first sleep.
+	scheduler.setDeadline(Scheduler::Job::FIRMWARE_CHECK,
+	                      versionCheckedAt + FIRMWARE_CHECK_INTERVAL_S);
+	scheduler.addJob(Scheduler::Job::RTC_SYNC, RTC_SYNC_INTERVAL_S, RTC_SYNC_SLACK_S,
+	                 []() { apiTask->runNetworkJob(syncTimeFromNTP); });
+
+	// Sleep starts only when there are no touches and no requests, so a booking isn't cut off
+	sleepManager.registerCallback(SleepManager::Callback::BEFORE_SLEEP, []() {
+		if (updatePending) {
+			log_i("Restarting to update firmware");
+			utils::forceRestart();
+		}
+	});
+}
+
+/**
+ * Boot after a deep sleep with the state saved in RTC memory.
+ * WiFi, NTP and the firmware version check are skipped, the model fetches
+ * a new status when it is due and connects WiFi for that.
+ * Returns false if the state can't be resumed, normal boot should be used instead.
+ */
+bool resumeBoot(JsonObjectConst config) {
+	// Room statuses of the dashboard mode are not saved, they are fetched on every boot
+	if (config["dashboard_rooms"].size() > 0) {
+		log_i("Dashboard mode, can't resume");
+		return false;
+	}
+
+	auto status = resume::restoreStatus();
+	if (!status) {
+		log_i("No calendar status saved, can't resume");
+		return false;
+	}
+
+	syncEzTimeFromRTC();
+	if (!setupTimezone(config["timezone"], false)) {
+		log_i("Timezone not available offline, can't resume");
+		return false;
+	}
+
+	// Keep awake until the main screen is restored
+	auto taskCount = sleepManager.scopedTaskCount();
+
+	guiTask = utils::make_unique<gui::GUITask>(true);
+
+	auto error = l10n.setLanguage(config["language"]);
+	if (error) {
+		handleBootError(error->message);
+		return true;
+	}
+
+	bool timerWake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+	sleepManager.setOnTimes(config["awake"]);
+	sleepManager.setWiFiKeepConnected(config["wifi"]["keep_connected"] | false);
+	sleepManager.setDeepSleep(config["deep_sleep"] | false, timerWake);
+
+	wifiManager.setStation(config["wifi"]["ssid"], config["wifi"]["password"]);
+
+	sleepManager.registerCallback(SleepManager::Callback::AFTER_WAKE,
+	                              []() { syncEzTimeFromRTC(); });
+	registerDeepSleepCallbacks();
+
+	UPDATE_CHANNEL = config["update_channel"] | String("stable");
+	time_t versionCheckedAt = loadCachedLatestVersion(UPDATE_CHANNEL);
+
+	apiTask = createApiTask(config);
+	if (!apiTask) {
+		return true;  // Error already handled
+	}
+	cal::RateLimiter::State rateLimit;
+	if (resume::restoreRateLimit(rateLimit))
+		apiTask->rateLimiter.setState(rateLimit);
+
+	calendarModel = utils::make_unique<cal::Model>(*apiTask);
+	calendarModel->registerGUITask(guiTask.get());
+	guiTask->initMain(calendarModel.get());
+	guiTask->resumeMain(status);
+	calendarModel->resumeStatus(status);
+
+	registerScheduledJobs(config["autoupdate"] | false, versionCheckedAt);
+	scheduler.setDeadlines(resume::restoreSchedule());
+	// Same as after a light sleep, a timer wake was meant for the earliest deadline
+	time_t now = safeUTC.now();
+	if (timerWake)
+		scheduler.runDue(now + SCHEDULER_EARLY_WAKE_TOLERANCE_S);
+	else if (scheduler.anyOverdue(now))
+		scheduler.runDue(now);
+
+	if (!timerWake)
+		sleepManager.refreshTouchWake();
+
+	preferences.putBool(CURR_BOOT_SUCCESS_KEY, true);
+	return true;
+}
+
 void normalBoot(JsonObjectConst config) {
 	guiTask = utils::make_unique<gui::GUITask>();
 	guiTask->startLoading();
@@ -163,6 +408,7 @@ void normalBoot(JsonObjectConst config) {
 
 	sleepManager.setOnTimes(config["awake"]);
 	sleepManager.setWiFiKeepConnected(config["wifi"]["keep_connected"] | false);
+	sleepManager.setDeepSleep(config["deep_sleep"] | false);
 
 	if (!wifiManager.openStation(config["wifi"]["ssid"], config["wifi"]["password"],
 	                             BOOT_WIFI_CONNECT_MAX_RETRIES)) {
@@ -175,6 +421,12 @@ void normalBoot(JsonObjectConst config) {
 		return;
 	}
 
+	// Reachable only while awake, as the network is down in sleep
+	if (config["metrics_server"] | false) {
+		metricsServer = utils::make_unique<config::ConfigServer>(80, configStore.get());
+		metricsServer->startMetrics();
+	}
+
 	if (!setupTime(config["timezone"])) {
 		handleBootError("Couldn't sync with NTP server.");
 		return;
@@ -185,14 +437,22 @@ void normalBoot(JsonObjectConst config) {
 	sleepManager.registerCallback(SleepManager::Callback::AFTER_WAKE,
 	                              []() { syncEzTimeFromRTC(); });
 
+	registerDeepSleepCallbacks();
+
+	// Version is checked in the background, boot only reads the cached result
 	UPDATE_CHANNEL = config["update_channel"] | String("stable");
-	latestVersionResult = getLatestFirmwareVersion(UPDATE_CHANNEL);
-	if (preferences.getBool(LAST_BOOT_SUCCESS_KEY)
-	    && (config["autoupdate"] | false || preferences.getBool(MANUAL_UPDATE_KEY))) {
+	time_t versionCheckedAt = loadCachedLatestVersion(UPDATE_CHANNEL);
+	// Updates are requested from settings or by the background check when autoupdate is enabled
+	if (preferences.getBool(LAST_BOOT_SUCCESS_KEY) && preferences.getBool(MANUAL_UPDATE_KEY)) {
 		preferences.putBool(MANUAL_UPDATE_KEY, false);
 		autoUpdateFirmware();
 	}
 
+	std::vector<cal::Room> rooms;
+	if (!parseDashboardRooms(config["dashboard_rooms"], rooms)) {
+		return;  // Error already handled
+	}
+
 	apiTask = createApiTask(config);
 	if (!apiTask) {
 		return;  // Error already handled
@@ -200,10 +460,19 @@ void normalBoot(JsonObjectConst config) {
 
 	calendarModel = utils::make_unique<cal::Model>(*apiTask);
 	calendarModel->registerGUITask(guiTask.get());
-	guiTask->initMain(calendarModel.get());
+	if (rooms.empty()) {
+		guiTask->initMain(calendarModel.get());
+	} else {
+		calendarModel->setRooms(rooms);
+		guiTask->initRooms(calendarModel.get());
+	}
 	calendarModel->updateStatus();
 
-	// utils::addBootLogEntry("[" + safeMyTZ.dateTime(RFC3339) + "] normal boot");
+	registerScheduledJobs(config["autoupdate"] | false, versionCheckedAt);
+
+	eventLog.append(EventLog::Type::BOOT,
+	                String("Boot, reset by ") + resetReasonToString(esp_reset_reason())
+	                    + (preferences.getBool(LAST_BOOT_SUCCESS_KEY) ? "" : ", last boot failed"));
 
 	preferences.putBool(CURR_BOOT_SUCCESS_KEY, true);
 }
@@ -250,8 +519,7 @@ void setupBoot() {
 
 	guiTask->startSetup(true);
 
-	// utils::addBootLogEntry("[" + safeMyTZ.dateTime(RFC3339)
-	//                        + "] setup boot (timestamp unreliable)");
+	eventLog.append(EventLog::Type::SETUP_BOOT, "Setup boot, timestamp unreliable");
 }
 
 void setup() {
@@ -266,14 +534,29 @@ void setup() {
 	delay(100);
 #endif
 
+	// State in RTC memory is used once, a crash while resuming leads to a normal boot
+	bool resuming = resume::isResuming();
+	resume::invalidate();
+
 	M5.begin(true, false, !USE_EXTERNAL_SERIAL, true, true);
+	if (resuming) {
+		// Main power was held over deep sleep, M5.begin has driven it high again
+		gpio_hold_dis((gpio_num_t)M5EPD_MAIN_PWR_PIN);
+		gpio_deep_sleep_hold_dis();
+	}
 	M5.EPD.SetRotation(0);
-	M5.EPD.Clear(true);
+	// Screen content survives deep sleep, only clear it on a cold boot
+	if (!resuming) {
+		M5.EPD.Clear(true);
+		energyLedger.countEpdRefresh(UPDATE_MODE_INIT);
+	}
 	M5.RTC.begin();
 
 	Serial.println("========== Monad Booking v" + CURRENT_VERSION + " ==========");
 	Serial.println("Booting up...");
 
+	trace::begin();
+
 	if (!preferences.begin("main")) {
 		log_e("Preferences begin failed");
 	}
@@ -282,30 +565,31 @@ void setup() {
 	preferences.putBool(CURR_BOOT_SUCCESS_KEY, false);
 	log_i("Last boot success: %d", preferences.getBool(LAST_BOOT_SUCCESS_KEY));
 
+	energyLedger.begin(resuming);
+
 	if (!LittleFS.begin(FORMAT_LITTLEFS_IF_FAILED)) {
 		log_e("LittleFS Mount Failed");
 		return;
 	}
+	recoverFileSystemUpdate();
+	eventLog.begin(LittleFS);
 
-	// Default png buffer uses internal ram, this way we can use our psram
-	uint8_t* imageBuffer = new uint8_t[PNG_BUFFER_SIZE];
+	// Default png buffer uses internal ram, this way we can use our psram. Kept until reboot.
+	uint8_t* imageBuffer = alloc::makeBuffer(alloc::Pool::IMAGE, PNG_BUFFER_SIZE).release();
 	png.setBuffer(imageBuffer);
 
 	configStore = utils::make_unique<config::ConfigStore>(LittleFS);
-	JsonObjectConst config = configStore->getConfigJson();
+	// Boot reads a copy, the API task may save a refreshed token and reallocate the live config
+	const SpiRamJsonDocument configCopy = configStore->getConfigJsonCopy();
+	JsonObjectConst config = configCopy.as<JsonObjectConst>();
 
-	bool forceSetup = detectButtonHold();
+	bool forceSetup = !resuming && detectButtonHold();
 	if (!forceSetup && config.begin() != config.end()) {
-		normalBoot(config);
+		if (!resuming || !resumeBoot(config))
+			normalBoot(config);
 	} else {
 		setupBoot();
 	}
-
-	// Serial.println("Boot log: ");
-	// auto entries = utils::getBootLog();
-	// for (int i = entries.size() - 1; i >= 0; --i) {
-	// 	Serial.println(entries[i]);
-	// }
 }
 
 void loop() { vTaskDelete(NULL); }
@@ -0,0 +1,215 @@
+#include "metrics.h"
+
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+
+#include <algorithm>
+
+#include "allocators.h"
+#include "calendar/jsonArena.h"
+#include "globals.h"
+
+namespace {
+struct HeapRegion {
+	const char* name;
+	uint32_t caps;
+};
+
+const std::array<HeapRegion, 2> heapRegions{{
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"psram", MALLOC_CAP_SPIRAM},
+}};
+
+uint32_t epdRefreshTotal(const EnergyLedger::Stats& stats) {
+	uint32_t total = 0;
+	for (auto count : stats.epdRefreshes) total += count;
+	return total;
+}
+}  // namespace
+
+const std::array<uint32_t, METRICS_LATENCY_BUCKET_COUNT> Metrics::latencyBucketsMs{
+    100, 250, 500, 1000, 2500, 5000, 10000, 30000,
+};
+
+void Metrics::observeRequest(cal::APITask::RequestType type, uint32_t ms) {
+	if ((size_t)type >= _latencies.size())
+		return;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	Latency& latency = _latencies[(size_t)type];
+	size_t bucket = 0;
+	while (bucket < latencyBucketsMs.size() && ms > latencyBucketsMs[bucket]) bucket++;
+	latency.buckets[bucket]++;
+	latency.count++;
+	latency.sumMs += ms;
+	latency.maxMs = max(latency.maxMs, ms);
+	latency.lastMs = ms;
+}
+
+void Metrics::registerTask(const char* name, TaskHandle_t task, QueueHandle_t queue) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_tasks.push_back(RegisteredTask{name, task, queue});
+}
+
+void Metrics::registerJsonArena(const cal::JsonArena* arena) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_arenas.push_back(arena);
+}
+
+void Metrics::unregisterJsonArena(const cal::JsonArena* arena) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_arenas.erase(std::remove(_arenas.begin(), _arenas.end(), arena), _arenas.end());
+}
+
+void Metrics::writePrometheus(Print& out) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	out.print("# HELP booking_api_request_duration_ms API task request latency.\n"
+	          "# TYPE booking_api_request_duration_ms histogram\n");
+	for (size_t type = 0; type < _latencies.size(); type++) {
+		const Latency& latency = _latencies[type];
+		const char* name = cal::APITask::requestTypeNames[type];
+		uint32_t cumulative = 0;
+		for (size_t b = 0; b < latencyBucketsMs.size(); b++) {
+			cumulative += latency.buckets[b];
+			out.printf("booking_api_request_duration_ms_bucket{type=\"%s\",le=\"%u\"} %u\n", name,
+			           latencyBucketsMs[b], cumulative);
+		}
+		out.printf("booking_api_request_duration_ms_bucket{type=\"%s\",le=\"+Inf\"} %u\n", name,
+		           latency.count);
+		out.printf("booking_api_request_duration_ms_sum{type=\"%s\"} %llu\n", name, latency.sumMs);
+		out.printf("booking_api_request_duration_ms_count{type=\"%s\"} %u\n", name, latency.count);
+	}
+
+	out.print("# HELP booking_queue_depth Requests waiting in a task queue.\n"
+	          "# TYPE booking_queue_depth gauge\n");
+	for (const auto& t : _tasks)
+		out.printf("booking_queue_depth{queue=\"%s\"} %u\n", t.name,
+		           uxQueueMessagesWaiting(t.queue));
+
+	out.print("# HELP booking_task_stack_min_free_bytes Stack high-water mark of a task.\n"
+	          "# TYPE booking_task_stack_min_free_bytes gauge\n");
+	for (const auto& t : _tasks)
+		out.printf("booking_task_stack_min_free_bytes{task=\"%s\"} %u\n", t.name,
+		           uxTaskGetStackHighWaterMark(t.task));
+
+	out.print("# HELP booking_heap_free_bytes Free heap.\n"
+	          "# TYPE booking_heap_free_bytes gauge\n");
+	for (const auto& region : heapRegions)
+		out.printf("booking_heap_free_bytes{region=\"%s\"} %u\n", region.name,
+		           heap_caps_get_free_size(region.caps));
+	out.print("# HELP booking_heap_min_free_bytes Lowest free heap since boot.\n"
+	          "# TYPE booking_heap_min_free_bytes gauge\n");
+	for (const auto& region : heapRegions)
+		out.printf("booking_heap_min_free_bytes{region=\"%s\"} %u\n", region.name,
+		           heap_caps_get_minimum_free_size(region.caps));
+
+	out.print("# HELP booking_alloc_bytes Bytes allocated from an allocator pool.\n"
+	          "# TYPE booking_alloc_bytes gauge\n");
+	for (size_t pool = 0; pool < (size_t)alloc::Pool::SIZE; pool++)
+		out.printf("booking_alloc_bytes{pool=\"%s\"} %u\n", alloc::poolNames[pool],
+		           alloc::usage((alloc::Pool)pool).bytes);
+	out.print("# HELP booking_alloc_peak_bytes Highest bytes allocated from an allocator pool.\n"
+	          "# TYPE booking_alloc_peak_bytes gauge\n");
+	for (size_t pool = 0; pool < (size_t)alloc::Pool::SIZE; pool++)
+		out.printf("booking_alloc_peak_bytes{pool=\"%s\"} %u\n", alloc::poolNames[pool],
+		           alloc::usage((alloc::Pool)pool).peakBytes);
+	out.print("# HELP booking_alloc_total Allocations from an allocator pool by placement.\n"
+	          "# TYPE booking_alloc_total counter\n");
+	for (size_t pool = 0; pool < (size_t)alloc::Pool::SIZE; pool++) {
+		const alloc::Usage usage = alloc::usage((alloc::Pool)pool);
+		const char* name = alloc::poolNames[pool];
+		out.printf("booking_alloc_total{pool=\"%s\",placement=\"psram\"} %u\n", name,
+		           usage.allocations - usage.internalFallbacks);
+		out.printf("booking_alloc_total{pool=\"%s\",placement=\"internal\"} %u\n", name,
+		           usage.internalFallbacks);
+		out.printf("booking_alloc_total{pool=\"%s\",placement=\"failed\"} %u\n", name,
+		           usage.failures);
+	}
+
+	out.print("# HELP booking_json_arena_capacity_bytes Json arena of a calendar provider.\n"
+	          "# TYPE booking_json_arena_capacity_bytes gauge\n");
+	for (const auto* arena : _arenas)
+		out.printf("booking_json_arena_capacity_bytes{arena=\"%s\"} %u\n", arena->name(),
+		           arena->capacity());
+	out.print("# HELP booking_json_arena_peak_bytes Highest json arena usage of a request.\n"
+	          "# TYPE booking_json_arena_peak_bytes gauge\n");
+	for (const auto* arena : _arenas)
+		out.printf("booking_json_arena_peak_bytes{arena=\"%s\"} %u\n", arena->name(),
+		           arena->peak());
+
+	// Counters of the energy ledger restart every day
+	const EnergyLedger::Stats today = energyLedger.current();
+	out.print("# HELP booking_wakes_today Wakes from sleep today, including the current one.\n"
+	          "# TYPE booking_wakes_today gauge\n");
+	out.printf("booking_wakes_today %u\n", today.wakeCount);
+	out.print("# HELP booking_awake_ms_today Time spent awake today.\n"
+	          "# TYPE booking_awake_ms_today gauge\n");
+	out.printf("booking_awake_ms_today %u\n", today.awakeMs);
+	out.print("# HELP booking_epd_refreshes_today Display refreshes today by update mode.\n"
+	          "# TYPE booking_epd_refreshes_today gauge\n");
+	for (size_t m = 0; m < today.epdRefreshes.size(); m++)
+		out.printf("booking_epd_refreshes_today{mode=\"%s\"} %u\n", EnergyLedger::epdModeNames[m],
+		           today.epdRefreshes[m]);
+
+	out.print("# HELP booking_uptime_seconds Time since boot.\n"
+	          "# TYPE booking_uptime_seconds gauge\n");
+	out.printf("booking_uptime_seconds %u\n", (uint32_t)(millis() / 1000));
+
+	if (WiFi.isConnected()) {
+		out.print("# HELP booking_wifi_rssi_dbm Signal strength of the access point.\n"
+		          "# TYPE booking_wifi_rssi_dbm gauge\n");
+		out.printf("booking_wifi_rssi_dbm %d\n", WiFi.RSSI());
+	}
+}
+
+void Metrics::toJson(JsonObject obj) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	obj["uptime_s"] = millis() / 1000;
+
+	JsonObject requests = obj.createNestedObject("requests");
+	for (size_t type = 0; type < _latencies.size(); type++) {
+		const Latency& latency = _latencies[type];
+		if (latency.count == 0)
+			continue;
+		JsonObject request = requests.createNestedObject(cal::APITask::requestTypeNames[type]);
+		request["count"] = latency.count;
+		request["avg_ms"] = (uint32_t)(latency.sumMs / latency.count);
+		request["max_ms"] = latency.maxMs;
+		request["last_ms"] = latency.lastMs;
+	}
+
+	JsonObject queues = obj.createNestedObject("queue_depth");
+	JsonObject stacks = obj.createNestedObject("stack_min_free");
+	for (const auto& t : _tasks) {
+		queues[t.name] = uxQueueMessagesWaiting(t.queue);
+		stacks[t.name] = uxTaskGetStackHighWaterMark(t.task);
+	}
+
+	JsonObject heap = obj.createNestedObject("heap");
+	for (const auto& region : heapRegions) {
+		JsonObject r = heap.createNestedObject(region.name);
+		r["free"] = heap_caps_get_free_size(region.caps);
+		r["min_free"] = heap_caps_get_minimum_free_size(region.caps);
+	}
+
+	JsonObject pools = obj.createNestedObject("alloc");
+	for (size_t pool = 0; pool < (size_t)alloc::Pool::SIZE; pool++) {
+		const alloc::Usage usage = alloc::usage((alloc::Pool)pool);
+		JsonObject p = pools.createNestedObject(alloc::poolNames[pool]);
+		p["bytes"] = usage.bytes;
+		p["peak_bytes"] = usage.peakBytes;
+		p["internal_fallbacks"] = usage.internalFallbacks;
+	}
+
+	JsonObject arenas = obj.createNestedObject("json_arena_peak");
+	for (const auto* arena : _arenas) arenas[arena->name()] = arena->peak();
+
+	const EnergyLedger::Stats today = energyLedger.current();
+	obj["wakes_today"] = today.wakeCount;
+	obj["epd_refreshes_today"] = epdRefreshTotal(today);
+
+	if (WiFi.isConnected())
+		obj["rssi"] = WiFi.RSSI();
+}
@@ -0,0 +1,75 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include "calendar/apiTask.h"
+
+namespace cal {
+class JsonArena;
+}
+
+// Finite buckets of the request latency histogram, +Inf is implicit
+#define METRICS_LATENCY_BUCKET_COUNT 8
+
+/**
+ * Runtime metrics for profiling a device in place, without a serial cable.
+ *
+ * Request latencies are recorded as requests complete. Heap, queue depths, stack high-water marks
+ * and WiFi RSSI are read when the metrics are rendered, and wake and EPD refresh counts come from
+ * the energy ledger. ConfigServer serves them as Prometheus text on /metrics
+ * and as periodic json snapshots on /events.
+ */
+class Metrics {
+  public:
+	// Upper bounds of the latency histogram buckets
+	static const std::array<uint32_t, METRICS_LATENCY_BUCKET_COUNT> latencyBucketsMs;
+
+	/**
+	 * Record the latency of a completed API task request, including WiFi and auth waits.
+	 */
+	void observeRequest(cal::APITask::RequestType type, uint32_t ms);
+
+	/**
+	 * Report the depth of a queue and the stack high-water mark of the task consuming it.
+	 * Name must be a string literal.
+	 */
+	void registerTask(const char* name, TaskHandle_t task, QueueHandle_t queue);
+
+	/**
+	 * Report the capacity and peak usage of a calendar provider's json arena.
+	 */
+	void registerJsonArena(const cal::JsonArena* arena);
+	void unregisterJsonArena(const cal::JsonArena* arena);
+
+	void writePrometheus(Print& out);
+	void toJson(JsonObject obj);
+
+  private:
+	struct Latency {
+		std::array<uint32_t, METRICS_LATENCY_BUCKET_COUNT + 1> buckets;  // Not cumulative
+		uint32_t count;
+		uint64_t sumMs;
+		uint32_t maxMs;
+		uint32_t lastMs;
+	};
+
+	struct RegisteredTask {
+		const char* name;
+		TaskHandle_t task;
+		QueueHandle_t queue;
+	};
+
+	std::mutex _mutex;  // Protects everything below
+
+	std::array<Latency, (size_t)cal::APITask::RequestType::SIZE> _latencies{};
+	std::vector<RegisteredTask> _tasks;
+	std::vector<const cal::JsonArena*> _arenas;
+};
+
+#endif
@@ -4,16 +4,36 @@
 #define DEST_FS_USES_LITTLEFS
 #include <ESP32-targz.h>
 #include <HTTPClient.h>
-#include <HttpsOTAUpdate.h>
 #include <M5EPD.h>
-#include <cert.h>
+#include <mbedtls/sha256.h>
 
+#include <algorithm>
+#include <mutex>
+
+#include "allocators.h"
 #include "esp_ota_ops.h"
+#include "firmwareDelta.h"
 #include "globals.h"
+#include "updateDownload.h"
 #include "utils.h"
 
-#define UPDATE_SERVER_CERT GOOGLE_API_FULL_CHAIN_CERT
+// Can be overridden with a build flag, e.g. to test against scripts/update_server.py
+#ifndef UPDATE_STORAGE_URL
 #define UPDATE_STORAGE_URL "https://storage.googleapis.com/no-booking-binaries"
+#endif
+
+// New filesystem is unpacked here and moved into place once the firmware has been written
+#define FS_STAGING_DIR "/next"
+// Existence of the marker means the update is committed and must be finished on boot
+#define FS_COMMIT_MARKER "/fs-commit"
+#define FS_PHASE_COMMITTED "committed"
+// The boot partition was switched on recovery, the old firmware running again means it failed
+#define FS_PHASE_SWITCHED "switched"
+#define FS_PHASE_ASSETS_CLEANED "assets-cleaned"
+
+#define FIRMWARE_MANIFEST_DOC_SIZE 8192
+// Read timeout of the filesystem archive
+#define FILE_SYSTEM_TIMEOUT_MS 10000
 
 String getUrlBase(const String& channel) {
 	return String(UPDATE_STORAGE_URL) + (channel == "beta" ? "/beta" : "");
@@ -23,9 +43,10 @@ utils::Result<String> getLatestFirmwareVersion(const String& channel) {
 	HTTPClient http;
 	http.setReuse(false);
 
-	http.begin(getUrlBase(channel) + "/current-version");
+	beginUpdateRequest(http, getUrlBase(channel) + "/current-version");
 
 	const int httpCode = http.GET();
+	energyLedger.countTlsHandshake();
 
 	if (httpCode != 200) {
 		log_e("http returned code %d", httpCode);
@@ -47,43 +68,248 @@ utils::Result<String> getLatestFirmwareVersion(const String& channel) {
 	return utils::Result<String>::makeOk(new String(version));
 }
 
-std::unique_ptr<utils::Error> downloadUpdateFile(const String& url, const String& filename) {
+namespace {
+std::mutex latestVersionMutex;  // Protects latestVersion
+utils::Result<String> latestVersion
+    = utils::Result<String>::makeErr(new utils::Error("Not checked yet."));
+
+void setLatestVersion(const utils::Result<String>& result) {
+	std::lock_guard<std::mutex> lock(latestVersionMutex);
+	latestVersion = result;
+}
+}  // namespace
+
+utils::Result<String> getLatestVersion() {
+	std::lock_guard<std::mutex> lock(latestVersionMutex);
+	return latestVersion;
+}
+
+time_t loadCachedLatestVersion(const String& channel) {
+	if (preferences.getString(LATEST_VERSION_CHANNEL_KEY) != channel)
+		return 0;
+	const String version = preferences.getString(LATEST_VERSION_KEY);
+	if (version.isEmpty())
+		return 0;
+
+	setLatestVersion(utils::Result<String>::makeOk(new String(version)));
+	return preferences.getLong64(LATEST_VERSION_CHECKED_KEY);
+}
+
+utils::Result<String> checkLatestVersion(const String& channel) {
+	auto result = getLatestFirmwareVersion(channel);
+	if (result.isErr())
+		return result;  // Keep the cached version
+
+	preferences.putString(LATEST_VERSION_KEY, *result.ok());
+	preferences.putString(LATEST_VERSION_CHANNEL_KEY, channel);
+	preferences.putLong64(LATEST_VERSION_CHECKED_KEY, safeUTC.now());
+	setLatestVersion(result);
+	return result;
+}
+
+/**
+ * Stream adapter that computes the SHA-256 of everything read through it.
+ */
+class Sha256Stream : public Stream {
+  public:
+	Sha256Stream(Stream* source) : _source{source} {
+		mbedtls_sha256_init(&_ctx);
+		mbedtls_sha256_starts_ret(&_ctx, 0);
+	}
+	~Sha256Stream() { mbedtls_sha256_free(&_ctx); }
+
+	int available() override { return _source->available(); }
+	int peek() override { return _source->peek(); }
+	int read() override {
+		int c = _source->read();
+		if (c >= 0) {
+			uint8_t byte = c;
+			mbedtls_sha256_update_ret(&_ctx, &byte, 1);
+			_bytes++;
+		}
+		return c;
+	}
+	size_t readBytes(char* buffer, size_t length) override {
+		size_t n = _source->readBytes(buffer, length);
+		mbedtls_sha256_update_ret(&_ctx, (const uint8_t*)buffer, n);
+		_bytes += n;
+		return n;
+	}
+	size_t write(uint8_t) override { return 0; }
+
+	/**
+	 * Lowercase hex digest, call once after everything has been read.
+	 */
+	String hexDigest() {
+		uint8_t digest[32];
+		mbedtls_sha256_finish_ret(&_ctx, digest);
+		return ::hexDigest(digest);
+	}
+
+	size_t bytesRead() const { return _bytes; }
+
+  private:
+	Stream* _source;
+	mbedtls_sha256_context _ctx;
+	size_t _bytes = 0;
+};
+
+/**
+ * Relative paths (starting with '/') of all files under root, recursively.
+ */
+void listTree(const String& root, const String& relative, std::vector<String>& files) {
+	File dir = LittleFS.open(root + relative);
+	if (!dir || !dir.isDirectory())
+		return;
+
+	while (File f = dir.openNextFile()) {
+		const String path = relative + "/" + f.name();
+		const bool isDirectory = f.isDirectory();
+		f.close();
+		if (isDirectory)
+			listTree(root, path, files);
+		else
+			files.push_back(path);
+	}
+}
+
+void removeTree(const String& root) {
+	File dir = LittleFS.open(root);
+	if (!dir)
+		return;
+	if (!dir.isDirectory()) {
+		dir.close();
+		LittleFS.remove(root);
+		return;
+	}
+
+	std::vector<String> entries;
+	while (File f = dir.openNextFile()) {
+		entries.push_back(root + "/" + f.name());
+		f.close();
+	}
+	dir.close();
+
+	for (const auto& entry : entries) removeTree(entry);
+	LittleFS.rmdir(root);
+}
+
+void makeParentDirs(const String& path) {
+	for (int i = path.indexOf('/', 1); i > 0; i = path.indexOf('/', i + 1)) {
+		LittleFS.mkdir(path.substring(0, i));  // Fails harmlessly if it already exists
+	}
+}
+
+/**
+ * Commit marker content: the phase, a newline and the label of the OTA partition of the new
+ * firmware.
+ */
+struct CommitMarker {
+	String phase;
+	String partition;
+};
+
+bool readCommitMarker(CommitMarker& marker) {
+	File file = LittleFS.open(FS_COMMIT_MARKER, FILE_READ);
+	if (!file)
+		return false;
+	marker.phase = file.readStringUntil('\n');
+	marker.partition = file.readString();
+	file.close();
+	return true;
+}
+
+/**
+ * LittleFS commits the file on close, so the marker is either the old or the new one.
+ */
+bool writeCommitMarker(const CommitMarker& marker) {
+	const String content = marker.phase + "\n" + marker.partition;
+	File file = LittleFS.open(FS_COMMIT_MARKER, FILE_WRITE);
+	if (!file)
+		return false;
+	const bool written = file.print(content) == content.length();
+	file.close();
+	return written;
+}
+
+/**
+ * Move staged files over the live filesystem.
+ * Safe to call again after an interruption, the commit marker tracks progress. If a file can't
+ * be moved, the marker and the rest of the staging are kept and the move is retried on boot.
+ * Returns true if the update is complete.
+ */
+bool applyStagedFileSystem(CommitMarker marker) {
 	auto startTime = millis();
 
+	std::vector<String> staged;
+	listTree(FS_STAGING_DIR, "", staged);
+
+	// Assets are fingerprinted, so old ones would never be overwritten and would pile up
+	if (marker.phase != FS_PHASE_ASSETS_CLEANED) {
+		std::vector<String> assets;
+		listTree("/webroot/assets", "", assets);
+		for (const auto& asset : assets) {
+			const String path = "/webroot/assets" + asset;
+			if (std::find(staged.begin(), staged.end(), path) == staged.end())
+				LittleFS.remove(path);
+		}
+		marker.phase = FS_PHASE_ASSETS_CLEANED;
+		writeCommitMarker(marker);
+	}
+
+	size_t failed = 0;
+	for (const auto& path : staged) {
+		makeParentDirs(path);
+		// LittleFS rename replaces an existing file atomically
+		if (!LittleFS.rename(FS_STAGING_DIR + path, path)) {
+			log_e("Couldn't move staged file %s", path.c_str());
+			failed++;
+		}
+	}
+	if (failed > 0) {
+		log_e("%u of %u staged files not moved, retrying on the next boot", failed,
+		      staged.size());
+		return false;
+	}
+
+	removeTree(FS_STAGING_DIR);
+	LittleFS.remove(FS_COMMIT_MARKER);
+
+	log_i("Applied %u staged files in %u ms", staged.size(), millis() - startTime);
+	return true;
+}
+
+utils::Result<String> fetchExpectedDigest(const String& url) {
 	HTTPClient http;
 	http.setReuse(false);
 
-	http.begin(url);
+	beginUpdateRequest(http, url);
 
 	const int httpCode = http.GET();
+	energyLedger.countTlsHandshake();
 
 	if (httpCode != 200) {
 		log_e("http returned code %d", httpCode);
 		http.end();
-		return utils::make_unique<utils::Error>("Firmware updater HTTP returned "
-		                                        + String(httpCode));
-	}
-
-	File file = LittleFS.open(filename, "w", true);
-
-	if (!file) {
-		http.end();
-		return utils::make_unique<utils::Error>("Firmware updater couldn't open file " + filename);
+		return utils::Result<String>::makeErr(
+		    new utils::Error("Firmware updater HTTP returned " + String(httpCode)));
 	}
 
-	int bytes = http.writeToStream(&file);
+	// Same format as sha256sum output, the digest is the first word
+	String digest = http.getString();
 	http.end();
-	if (bytes < 0) {
-		file.close();
-		return utils::make_unique<utils::Error>("Firmware updater file write failed, code: "
-		                                        + String(bytes));
-	}
-
-	log_i("Download done in %u ms", millis() - startTime);
+	digest.trim();
+	int space = digest.indexOf(' ');
+	if (space > 0)
+		digest = digest.substring(0, space);
+	digest.toLowerCase();
 
-	file.close();
+	if (digest.length() != 64) {
+		return utils::Result<String>::makeErr(
+		    new utils::Error("Firmware updater got an invalid digest: " + digest));
+	}
 
-	return nullptr;
+	return utils::Result<String>::makeOk(new String(digest));
 }
 
 std::unique_ptr<TarGzUnpacker> makeTarGzUnpacker() {
@@ -109,97 +335,316 @@ std::unique_ptr<TarGzUnpacker> makeTarGzUnpacker() {
 	return unpacker;
 }
 
-void HttpEvent(HttpEvent_t* event) {
-	switch (event->event_id) {
-		case HTTP_EVENT_ERROR:
-			Serial.println("Http Event Error");
-			break;
-		case HTTP_EVENT_ON_CONNECTED:
-			Serial.println("Http Event On Connected");
-			break;
-		case HTTP_EVENT_HEADER_SENT:
-			Serial.println("Http Event Header Sent");
-			break;
-		case HTTP_EVENT_ON_HEADER:
-			Serial.printf("Http Event On Header, key=%s, value=%s\n", event->header_key,
-			              event->header_value);
-			break;
-		case HTTP_EVENT_ON_DATA:
-			Serial.print(".");
-			break;
-		case HTTP_EVENT_ON_FINISH:
-			Serial.println("Http Event On Finish");
-			break;
-		case HTTP_EVENT_DISCONNECTED:
-			Serial.println("Http Event Disconnected");
-			break;
+utils::Result<FirmwareManifest> fetchManifest(const String& url) {
+	HTTPClient http;
+	http.setReuse(false);
+
+	beginUpdateRequest(http, url);
+
+	const int httpCode = http.GET();
+	energyLedger.countTlsHandshake();
+
+	if (httpCode != 200) {
+		log_e("http returned code %d", httpCode);
+		http.end();
+		return utils::Result<FirmwareManifest>::makeErr(
+		    new utils::Error("Firmware updater HTTP returned " + String(httpCode)));
 	}
+
+	SpiRamJsonDocument doc(FIRMWARE_MANIFEST_DOC_SIZE);
+	DeserializationError err = deserializeJson(doc, http.getStream());
+	http.end();
+	if (err) {
+		return utils::Result<FirmwareManifest>::makeErr(
+		    new utils::Error("Firmware manifest invalid: " + String(err.c_str())));
+	}
+
+	auto manifest = new FirmwareManifest{
+	    .size = doc["size"] | 0u,
+	    .sha256 = doc["sha256"] | "",
+	    .chunkSize = doc["chunk_size"] | 0u,
+	    .chunks = {},
+	};
+	for (JsonVariantConst chunk : doc["chunks"].as<JsonArrayConst>()) {
+		manifest->chunks.push_back(chunk.as<String>());
+	}
+
+	// Chunks are erased and written separately, so they must be aligned to flash sectors
+	const size_t chunkSize = manifest->chunkSize;
+	if (manifest->size == 0 || chunkSize == 0 || chunkSize % SPI_FLASH_SEC_SIZE != 0
+	    || manifest->chunks.size() != (manifest->size + chunkSize - 1) / chunkSize) {
+		delete manifest;
+		return utils::Result<FirmwareManifest>::makeErr(
+		    new utils::Error("Firmware manifest has invalid chunks."));
+	}
+
+	return utils::Result<FirmwareManifest>::makeOk(manifest);
 }
 
-std::unique_ptr<utils::Error> updateFirmware(const String& newVersion, const String& channel,
-                                             const std::function<void()> onBeforeFormat) {
-	auto count = sleepManager.scopedTaskCount();
+String partitionSha256(const esp_partition_t* partition, size_t offset, size_t size) {
+	uint8_t digest[32];
+	if (!partitionDigest(partition, offset, size, digest))
+		return "";
+	return hexDigest(digest);
+}
 
-	LittleFS.rmdir("/tmp");
+/**
+ * Patch the running image into the inactive OTA partition with a delta from the previous
+ * release. Deltas are published only for the previous release of the channel.
+ * The patched image must match the digest in the manifest.
+ */
+std::unique_ptr<utils::Error> downloadFirmwareDelta(const String& urlBase,
+                                                    const FirmwareManifest& manifest) {
+	auto startTime = millis();
 
-	log_i("Downloading new filesystem...");
-	auto err = downloadUpdateFile(getUrlBase(channel) + "/v" + newVersion + "/file-system.tar.gz",
-	                              "/tmp/file-system.tar.gz");
+	HTTPClient http;
+	http.setReuse(false);
+
+	beginUpdateRequest(http, urlBase + "/delta-from-v" + CURRENT_VERSION + ".bin");
+
+	const int httpCode = http.GET();
+	energyLedger.countTlsHandshake();
+
+	if (httpCode != 200) {
+		http.end();
+		return utils::make_unique<utils::Error>("No firmware delta, HTTP returned "
+		                                        + String(httpCode));
+	}
+
+	// The partition is rewritten, chunks trusted from earlier progress are no longer there
+	preferences.remove(UPDATE_PROGRESS_CHUNK_KEY);
+
+	const int size = http.getSize();
+	auto err = applyFirmwareDelta(*http.getStreamPtr(), esp_ota_get_running_partition(),
+	                              esp_ota_get_next_update_partition(NULL), manifest.sha256);
+	http.end();
 	if (err)
 		return err;
 
-	const String firmwareUpdateUrl = getUrlBase(channel) + "/v" + newVersion + "/firmware.bin";
+	log_i("Firmware delta of %d bytes applied in %u ms", size, millis() - startTime);
+
+	return nullptr;
+}
+
+/**
+ * Inactive OTA partition as the target of a chunked download.
+ */
+class PartitionTarget : public ChunkTarget {
+  public:
+	PartitionTarget(const esp_partition_t* partition) : _partition{partition} {}
+
+	String digest(size_t offset, size_t size) override {
+		return partitionSha256(_partition, offset, size);
+	}
+
+	bool write(size_t offset, const uint8_t* data, size_t size) override {
+		// Erase whole sectors, the end of the last chunk may not be sector aligned
+		size_t eraseSize = (size + SPI_FLASH_SEC_SIZE - 1) / SPI_FLASH_SEC_SIZE * SPI_FLASH_SEC_SIZE;
+		return esp_partition_erase_range(_partition, offset, eraseSize) == ESP_OK
+		       && esp_partition_write(_partition, offset, data, size) == ESP_OK;
+	}
+
+  private:
+	const esp_partition_t* _partition;
+};
+
+/**
+ * Download the firmware image into the inactive OTA partition without activating it,
+ * see downloadFirmwareChunks.
+ */
+std::unique_ptr<utils::Error> downloadFirmware(const String& urlBase, const String& newVersion,
+                                               const FirmwareManifest& manifest) {
+	auto startTime = millis();
+
+	const esp_partition_t* partition = esp_ota_get_next_update_partition(NULL);
+	if (!partition || partition->size < manifest.size) {
+		return utils::make_unique<utils::Error>("Firmware doesn't fit the OTA partition.");
+	}
+
+	PartitionTarget target(partition);
+	auto err = downloadFirmwareChunks(urlBase + "/firmware.bin", newVersion, manifest, target);
+	if (!err)
+		log_i("Firmware download finished in %u ms", millis() - startTime);
+	return err;
+}
+
+/**
+ * Download, decompress and unpack the filesystem archive into the staging directory in one pass.
+ * Nothing is written to the live filesystem, and the staging is removed if the digest of the
+ * archive doesn't match.
+ *
+ * The staged tree sits next to the live one until commit, so the partition must hold both. The
+ * live files keep the device usable if the download fails, so they aren't removed first.
+ */
+std::unique_ptr<utils::Error> stageFileSystem(const String& url, const String& expectedDigest) {
+	auto startTime = millis();
+
+	removeTree(FS_STAGING_DIR);
+
+	// The new tree is about the size of the live one, fail before downloading if it can't fit
+	const size_t freeBytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+	if (freeBytes < LittleFS.usedBytes()) {
+		log_e("Only %u bytes free for a filesystem of %u bytes", freeBytes, LittleFS.usedBytes());
+		return utils::make_unique<utils::Error>("Not enough space to stage the filesystem.");
+	}
+
+	HTTPClient http;
+	http.setReuse(false);
 
-	log_i("Downloading and updating firmware...");
-	HttpsOTA.onHttpEvent(HttpEvent);
-	HttpsOTA.begin(firmwareUpdateUrl.c_str(), UPDATE_SERVER_CERT);
+	beginUpdateRequest(http, url);
 
-	while (true) {
-		auto status = HttpsOTA.status();
-		if (status == HTTPS_OTA_SUCCESS) {
-			log_i("Firmware updated successfully.");
+	const int httpCode = http.GET();
+	energyLedger.countTlsHandshake();
+
+	if (httpCode != 200) {
+		log_e("http returned code %d", httpCode);
+		http.end();
+		return utils::make_unique<utils::Error>("Firmware updater HTTP returned "
+		                                        + String(httpCode));
+	}
+
+	const int size = http.getSize();
+	if (size <= 0) {
+		http.end();
+		return utils::make_unique<utils::Error>("Firmware updater got no filesystem size.");
+	}
+	Sha256Stream stream(http.getStreamPtr());
+
+	std::unique_ptr<TarGzUnpacker> TARGZUnpacker = makeTarGzUnpacker();
+	bool unpacked = TARGZUnpacker->tarGzStreamExpander(&stream, tarGzFS, FS_STAGING_DIR, size);
+	if (!unpacked) {
+		log_e("tarGzStreamExpander failed with return code #%d", TARGZUnpacker->tarGzGetError());
+	}
+	TARGZUnpacker.reset();
+
+	// The expander stops at the end of the tar, the digest also covers what follows it
+	char rest[512];
+	auto lastData = millis();
+	while (unpacked && stream.bytesRead() < (size_t)size
+	       && millis() - lastData < FILE_SYSTEM_TIMEOUT_MS) {
+		if (!http.connected() && stream.available() == 0)
 			break;
-		} else if (status == HTTPS_OTA_FAIL) {
-			log_e("Firmware update failed.");
-			return utils::make_unique<utils::Error>("Firmware updater failed.");
+		if (stream.readBytes(rest, std::min(sizeof(rest), size - stream.bytesRead())) > 0)
+			lastData = millis();
+	}
+	http.end();
+
+	const bool complete = stream.bytesRead() == (size_t)size;
+	const String digest = stream.hexDigest();
+	if (!unpacked || !complete || digest != expectedDigest) {
+		if (unpacked && !complete)
+			log_e("Filesystem truncated: %u of %d bytes", stream.bytesRead(), size);
+		else if (unpacked)
+			log_e("Filesystem digest mismatch: %s != %s", digest.c_str(), expectedDigest.c_str());
+		removeTree(FS_STAGING_DIR);
+		return utils::make_unique<utils::Error>("Firmware updater filesystem download failed.");
+	}
+
+	log_i("Filesystem staged from %u bytes in %u ms", stream.bytesRead(), millis() - startTime);
+
+	return nullptr;
+}
+
+void recoverFileSystemUpdate() {
+	CommitMarker marker;
+	if (!readCommitMarker(marker)) {
+		if (LittleFS.exists(FS_STAGING_DIR)) {
+			log_i("Removing an uncommitted filesystem update...");
+			removeTree(FS_STAGING_DIR);
 		}
-		delay(100);
+		return;
 	}
 
-	log_i("Updating filesystem...");
+	if (marker.partition == esp_ota_get_running_partition()->label) {
+		log_i("Finishing an interrupted filesystem update...");
+		applyStagedFileSystem(marker);
+		return;
+	}
 
+	// Power was lost after the commit but before the boot partition was switched, roll forward
+	const esp_partition_t* partition = esp_partition_find_first(
+	    ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, marker.partition.c_str());
+	if (marker.phase == FS_PHASE_COMMITTED && partition) {
+		marker.phase = FS_PHASE_SWITCHED;
+		if (writeCommitMarker(marker) && esp_ota_set_boot_partition(partition) == ESP_OK) {
+			log_i("Restarting to the committed firmware...");
+			utils::forceRestart();
+		}
+	}
+
+	// Also reached when the new firmware was booted once and the old one runs again
+	log_e("Committed firmware can't be booted, discarding the filesystem update.");
+	LittleFS.remove(FS_COMMIT_MARKER);
+	removeTree(FS_STAGING_DIR);
+}
+
+std::unique_ptr<utils::Error> updateFirmware(const String& newVersion, const String& channel,
+                                             const std::function<void()> onBeforeFormat) {
+	auto count = sleepManager.scopedTaskCount();
+
+	// Intermediate files of older firmware versions
+	removeTree("/tmp");
+
+	const String urlBase = getUrlBase(channel) + "/v" + newVersion;
+
+	// The animation reads flash while we write it
 	onBeforeFormat();
 
-	// Move old assets to tmp.
-	// This is needed because assets are fingerprinted, so they are not overwritten when expanding
-	// filesystem and would take a lot of space after multiple updates.
-	auto assets = utils::listFiles("/webroot/assets");
-	for (const auto& file : assets) {
-		LittleFS.rename("/webroot/assets/" + file, "/tmp/webroot/assets/" + file);
+	// Firmware goes first, as it is large and resumable. Both ways must produce the image of
+	// the manifest.
+	auto manifestRes = fetchManifest(urlBase + "/firmware.manifest.json");
+	if (manifestRes.isErr())
+		return utils::make_unique<utils::Error>(*manifestRes.err());
+	const FirmwareManifest& manifest = *manifestRes.ok();
+
+	log_i("Downloading firmware delta...");
+	auto err = downloadFirmwareDelta(urlBase, manifest);
+	if (err) {
+		log_i("%s. Downloading the full firmware...", err->message.c_str());
+		err = downloadFirmware(urlBase, newVersion, manifest);
+		if (err)
+			return err;
 	}
 
-	std::unique_ptr<TarGzUnpacker> TARGZUnpacker = makeTarGzUnpacker();
+	const String fileSystemUrl = urlBase + "/file-system.tar.gz";
+	auto digestRes = fetchExpectedDigest(fileSystemUrl + ".sha256");
+	if (digestRes.isErr())
+		return utils::make_unique<utils::Error>(*digestRes.err());
 
-	// Expand new file system
-	if (!TARGZUnpacker->tarGzExpander(tarGzFS, "/tmp/file-system.tar.gz", tarGzFS, "/", nullptr)) {
-		log_e("tarGzExpander+intermediate file failed with return code #%d\n",
-		      TARGZUnpacker->tarGzGetError());
-		log_e("Filesystem update failed. Reverting firmware...");
-		// Revert update
-		const esp_partition_t* running_part = esp_ota_get_running_partition();
-		esp_ota_set_boot_partition(running_part);
-		TARGZUnpacker.reset();
-
-		// Revert asset move
-		for (const auto& file : assets) {
-			LittleFS.rename("/tmp/webroot/assets/" + file, "/webroot/assets/" + file);
-		}
+	log_i("Downloading new filesystem...");
+	err = stageFileSystem(fileSystemUrl, *digestRes.ok());
+	if (err)
+		return err;
 
+	// Point of no return: from here the new firmware is booted and the staged filesystem is
+	// applied, also after a power loss. The marker goes first, so that the new firmware never
+	// boots without its filesystem.
+	const esp_partition_t* partition = esp_ota_get_next_update_partition(NULL);
+	const CommitMarker marker{.phase = FS_PHASE_COMMITTED, .partition = partition->label};
+	if (!writeCommitMarker(marker)) {
+		log_e("Couldn't write commit marker.");
+		LittleFS.remove(FS_COMMIT_MARKER);
+		removeTree(FS_STAGING_DIR);
 		return utils::make_unique<utils::Error>("Firmware updater failed.");
 	}
-	TARGZUnpacker.reset();
 
-	log_i("Firmware and filesystem update success. Restarting...");
+	// Validates the image before activating it
+	if (esp_ota_set_boot_partition(partition) != ESP_OK) {
+		log_e("Firmware image invalid.");
+		LittleFS.remove(FS_COMMIT_MARKER);
+		removeTree(FS_STAGING_DIR);
+		preferences.putUInt(UPDATE_PROGRESS_CHUNK_KEY, 0);
+		return utils::make_unique<utils::Error>("Firmware updater failed.");
+	}
+	log_i("Firmware updated successfully.");
+	preferences.remove(UPDATE_PROGRESS_VERSION_KEY);
+	preferences.remove(UPDATE_PROGRESS_CHUNK_KEY);
+
+	log_i("Updating filesystem...");
+	if (applyStagedFileSystem(marker))
+		log_i("Firmware and filesystem update success. Restarting...");
+	else
+		log_e("Filesystem update incomplete, it is finished on boot. Restarting...");
 
 	utils::forceRestart();
 
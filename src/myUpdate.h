@@ -9,7 +9,15 @@
 
 const char* const CURR_BOOT_SUCCESS_KEY = "curr-b-ok";
 const char* const LAST_BOOT_SUCCESS_KEY = "last-b-ok";
+// Install the latest version on the next boot
 const char* const MANUAL_UPDATE_KEY = "up-force";
+// Firmware download progress, see downloadFirmwareChunks
+const char* const UPDATE_PROGRESS_VERSION_KEY = "up-ver";
+const char* const UPDATE_PROGRESS_CHUNK_KEY = "up-chunk";
+// Cached result of the latest version check
+const char* const LATEST_VERSION_KEY = "ver-latest";
+const char* const LATEST_VERSION_CHANNEL_KEY = "ver-chan";
+const char* const LATEST_VERSION_CHECKED_KEY = "ver-time";
 
 /**
  * Restarts the device, uses a workaround to force restart even when the device plugged in.
@@ -22,8 +30,36 @@ void restart();
  */
 utils::Result<String> getLatestFirmwareVersion(const String& channel);
 
+/**
+ * Latest firmware version from the last check or the NVS cache.
+ * Safe to call from any task.
+ */
+utils::Result<String> getLatestVersion();
+
+/**
+ * Load the cached latest version of the channel without network access.
+ * Returns the unix time of the cached check, 0 if there is none.
+ */
+time_t loadCachedLatestVersion(const String& channel);
+
+/**
+ * Fetch the latest version from the internet and cache it in NVS.
+ * Blocks on the network, run it in the background.
+ */
+utils::Result<String> checkLatestVersion(const String& channel);
+
+/**
+ * Finish or discard a filesystem update that was interrupted by a reset. Restarts into the new
+ * firmware if the update was committed but the boot partition wasn't switched yet.
+ * Call at boot after mounting LittleFS, before reading any files.
+ */
+void recoverFileSystemUpdate();
+
 /**
  * Fetches new firmware and filesystem from the internet based on newVersion.
+ * The filesystem archive is unpacked while downloading into a staging directory
+ * and verified against its published SHA-256, live files are replaced only after
+ * the firmware has been written.
  * onBeforeFilesystemWrite() callback is called before the filesystem is overwritten.
  * Use it to stop all reading and writing operations to avoid race conditions.
  */
@@ -0,0 +1,132 @@
+#include "resumeState.h"
+
+#include <esp_attr.h>
+#include <esp_system.h>
+
+namespace resume {
+
+namespace {
+const uint32_t STATE_MAGIC = 0x52534D31;  // "RSM1"
+
+struct RTCEvent {
+	bool valid;
+	// Microsoft event ids are around 150 characters, a status with longer fields isn't saved
+	char id[192];
+	char creator[96];
+	char summary[128];
+	time_t unixStartTime;
+	time_t unixEndTime;
+};
+
+struct State {
+	uint32_t magic;
+	bool statusValid;
+	char roomName[96];
+	RTCEvent currentEvent;
+	RTCEvent nextEvent;
+	Deadlines deadlines;
+	bool wifiValid;
+	uint8_t bssid[6];
+	int32_t channel;
+	bool rateLimitValid;
+	cal::RateLimiter::State rateLimit;
+};
+
+RTC_DATA_ATTR State state;
+
+/**
+ * Returns false if src doesn't fit, a truncated event id would target the wrong event.
+ */
+bool copyString(char* dest, size_t size, const String& src) {
+	if (src.length() >= size)
+		return false;
+	memcpy(dest, src.c_str(), src.length() + 1);
+	return true;
+}
+
+bool saveEvent(RTCEvent& dest, const std::shared_ptr<cal::Event>& event) {
+	dest.valid = !!event;
+	if (!event)
+		return true;
+	dest.unixStartTime = event->unixStartTime;
+	dest.unixEndTime = event->unixEndTime;
+	return copyString(dest.id, sizeof(dest.id), event->id)
+	       && copyString(dest.creator, sizeof(dest.creator), event->creator)
+	       && copyString(dest.summary, sizeof(dest.summary), event->summary);
+}
+
+std::shared_ptr<cal::Event> restoreEvent(const RTCEvent& src) {
+	if (!src.valid)
+		return nullptr;
+	return std::make_shared<cal::Event>(cal::Event{
+	    .id = src.id,
+	    .creator = src.creator,
+	    .summary = src.summary,
+	    .unixStartTime = src.unixStartTime,
+	    .unixEndTime = src.unixEndTime,
+	});
+}
+}  // namespace
+
+bool isResuming() {
+	return state.magic == STATE_MAGIC && esp_reset_reason() == ESP_RST_DEEPSLEEP;
+}
+
+void markValid() { state.magic = STATE_MAGIC; }
+
+void invalidate() { state.magic = 0; }
+
+void saveStatus(const cal::CalendarStatus& status) {
+	state.statusValid = copyString(state.roomName, sizeof(state.roomName), status.name)
+	                    && saveEvent(state.currentEvent, status.currentEvent)
+	                    && saveEvent(state.nextEvent, status.nextEvent);
+	if (!state.statusValid)
+		log_w("Calendar status doesn't fit in RTC memory, the next boot won't resume");
+}
+
+std::shared_ptr<cal::CalendarStatus> restoreStatus() {
+	if (!state.statusValid)
+		return nullptr;
+	// Status is restored once, it must be saved again before the next deep sleep
+	state.statusValid = false;
+	return std::make_shared<cal::CalendarStatus>(cal::CalendarStatus{
+	    .name = state.roomName,
+	    .currentEvent = restoreEvent(state.currentEvent),
+	    .nextEvent = restoreEvent(state.nextEvent),
+	});
+}
+
+void saveSchedule(const Deadlines& deadlines) { state.deadlines = deadlines; }
+
+Deadlines restoreSchedule() { return state.deadlines; }
+
+void saveWiFi(const uint8_t* bssid, int32_t channel) {
+	memcpy(state.bssid, bssid, sizeof(state.bssid));
+	state.channel = channel;
+	state.wifiValid = true;
+}
+
+bool restoreWiFi(uint8_t* bssid, int32_t& channel) {
+	if (!state.wifiValid)
+		return false;
+	memcpy(bssid, state.bssid, sizeof(state.bssid));
+	channel = state.channel;
+	return true;
+}
+
+void clearWiFi() { state.wifiValid = false; }
+
+void saveRateLimit(const cal::RateLimiter::State& rateLimit) {
+	state.rateLimit = rateLimit;
+	state.rateLimitValid = true;
+}
+
+bool restoreRateLimit(cal::RateLimiter::State& rateLimit) {
+	if (!state.rateLimitValid)
+		return false;
+	state.rateLimitValid = false;
+	rateLimit = state.rateLimit;
+	return true;
+}
+
+}  // namespace resume
@@ -0,0 +1,65 @@
+#ifndef RESUME_STATE_H
+#define RESUME_STATE_H
+
+#include <Arduino.h>
+
+#include <memory>
+
+#include "calendar/api.h"
+#include "calendar/rateLimiter.h"
+#include "scheduler.h"
+
+/**
+ * Minimal state kept in RTC slow memory over deep sleep.
+ * Everything else is lost in deep sleep, so a resumed boot rebuilds the model from this
+ * instead of fetching it again and redrawing the whole screen.
+ * Access tokens are persisted in NVS, see cal::saveAccessToken.
+ */
+namespace resume {
+
+/**
+ * True if we woke up from deep sleep with a valid saved state.
+ * Only meaningful before invalidate() is called.
+ */
+bool isResuming();
+
+/**
+ * Mark the saved state valid, call right before entering deep sleep.
+ */
+void markValid();
+
+/**
+ * Discard the saved state, so that a crash during resume causes a normal boot.
+ */
+void invalidate();
+
+/**
+ * The status isn't saved if any of its strings doesn't fit, the next boot is then a normal one.
+ */
+void saveStatus(const cal::CalendarStatus& status);
+/**
+ * Returns nullptr if no status was saved before the last deep sleep.
+ */
+std::shared_ptr<cal::CalendarStatus> restoreStatus();
+
+using Deadlines = std::array<time_t, (size_t)Scheduler::Job::SIZE>;
+void saveSchedule(const Deadlines& deadlines);
+Deadlines restoreSchedule();
+
+/**
+ * Access point of the last connection, used to skip scanning when reconnecting.
+ */
+void saveWiFi(const uint8_t* bssid, int32_t channel);
+bool restoreWiFi(uint8_t* bssid, int32_t& channel);
+void clearWiFi();
+
+/**
+ * Backoff and open circuit of the provider, so sleeping doesn't cut them short.
+ * Returns false if no state was saved before the last deep sleep.
+ */
+void saveRateLimit(const cal::RateLimiter::State& rateLimit);
+bool restoreRateLimit(cal::RateLimiter::State& rateLimit);
+
+}  // namespace resume
+
+#endif
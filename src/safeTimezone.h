@@ -5,6 +5,8 @@
 
 #include <mutex>
 
+#include "timezones.h"
+
 /**
  * A thread safe version of ezTime Timezone class.
  * Only implements functions that are used by us.
@@ -37,7 +39,9 @@ class SafeTimezone {
 		return tz_.dateTime(t, local_or_utc, format);
 	}
 
-	time_t tzTime(time_t t /* = TIME_NOW */) { return tz_.tzTime(t); }
+	time_t tzTime(time_t t /* = TIME_NOW */, ezLocalOrUTC_t local_or_utc = LOCAL_TIME) {
+		return tz_.tzTime(t, local_or_utc);
+	}
 
 	String getOlson() { return tz_.getOlson(); }
 
@@ -48,9 +52,14 @@ class SafeTimezone {
 		return res;
 	}
 
+	/**
+	 * Resolves the location from the bundled timezone table,
+	 * only unknown locations are looked up from the timezone server.
+	 */
 	bool setLocation(const String location /* = "GeoIP" */) {
 		xSemaphoreTake(handle_, portMAX_DELAY);
-		bool res = tz_.setLocation(location);
+		const char* posix = tzdb::lookupPosix(location.c_str());
+		bool res = posix ? tz_.setPosix(posix, location) : tz_.setLocation(location);
 		xSemaphoreGive(handle_);
 		return res;
 	}
@@ -0,0 +1,142 @@
+#include "scheduler.h"
+
+#include "globals.h"
+
+const std::array<const char*, (size_t)Scheduler::Job::SIZE> Scheduler::jobNames{
+    "STATUS_POLL", "TOKEN_REFRESH", "BATTERY_SAMPLE", "FIRMWARE_CHECK", "RTC_SYNC",
+};
+
+Scheduler::Scheduler() {
+	// Wake was timed for the earliest deadline, run everything that fits in the same wake
+	sleepManager.registerCallback(SleepManager::Callback::AFTER_WAKE_TIMER, [this]() {
+		runDue(safeUTC.now() + SCHEDULER_EARLY_WAKE_TOLERANCE_S);
+	});
+
+	// Touches may keep us awake past a deadline, don't sleep before catching up
+	sleepManager.registerCallback(SleepManager::Callback::BEFORE_SLEEP, [this]() {
+		time_t now = safeUTC.now();
+		if (anyOverdue(now)) {
+			runDue(now);  // Jobs enqueue tasks, which cancel sleep
+		}
+		logTable();
+	});
+}
+
+void Scheduler::addJob(Job job, uint32_t periodS, uint32_t slackS,
+                       const std::function<void()>& run) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Entry& entry = _entries[(size_t)job];
+		entry.registered = true;
+		entry.periodS = periodS;
+		entry.slackS = slackS;
+		entry.deadline = periodS ? safeUTC.now() + periodS : 0;
+		entry.run = run;
+	}
+	_updateWakeTime();
+}
+
+void Scheduler::reschedule(Job job) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Entry& entry = _entries[(size_t)job];
+		time_t now = safeUTC.now();
+		entry.lastRun = now;
+		entry.deadline = entry.periodS ? now + entry.periodS : 0;
+	}
+	_updateWakeTime();
+}
+
+void Scheduler::setDeadline(Job job, time_t deadline) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_entries[(size_t)job].deadline = deadline;
+	}
+	_updateWakeTime();
+}
+
+time_t Scheduler::getDeadline(Job job) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries[(size_t)job].deadline;
+}
+
+void Scheduler::runDue(time_t at) {
+	std::array<std::function<void()>, (size_t)Job::SIZE> due{};
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		time_t now = safeUTC.now();
+		for (size_t i = 0; i < _entries.size(); ++i) {
+			Entry& entry = _entries[i];
+			if (!entry.registered || entry.deadline == 0
+			    || entry.deadline - (time_t)entry.slackS > at)
+				continue;
+			log_i("Running job %s, %ld s before deadline", jobNames[i], entry.deadline - now);
+			entry.lastRun = now;
+			entry.runCount++;
+			entry.deadline = entry.periodS ? now + entry.periodS : 0;
+			due[i] = entry.run;
+		}
+	}
+	_updateWakeTime();
+
+	// Run outside the lock, jobs may reschedule themselves
+	for (auto& run : due) {
+		if (run)
+			run();
+	}
+}
+
+bool Scheduler::anyOverdue(time_t now) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const Entry& entry : _entries) {
+		if (entry.registered && entry.deadline != 0 && entry.deadline <= now)
+			return true;
+	}
+	return false;
+}
+
+time_t Scheduler::nextWake() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	time_t earliest = 0;
+	for (const Entry& entry : _entries) {
+		if (!entry.registered || entry.deadline == 0)
+			continue;
+		if (earliest == 0 || entry.deadline < earliest)
+			earliest = entry.deadline;
+	}
+	return earliest;
+}
+
+std::array<time_t, (size_t)Scheduler::Job::SIZE> Scheduler::getDeadlines() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::array<time_t, (size_t)Job::SIZE> deadlines{};
+	for (size_t i = 0; i < _entries.size(); ++i) deadlines[i] = _entries[i].deadline;
+	return deadlines;
+}
+
+void Scheduler::setDeadlines(const std::array<time_t, (size_t)Job::SIZE>& deadlines) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (size_t i = 0; i < _entries.size(); ++i) {
+			// Keep the fresh deadline of jobs that weren't scheduled before
+			if (_entries[i].registered && deadlines[i] != 0)
+				_entries[i].deadline = deadlines[i];
+		}
+	}
+	_updateWakeTime();
+}
+
+void Scheduler::logTable() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	time_t now = safeUTC.now();
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		const Entry& entry = _entries[i];
+		if (!entry.registered)
+			continue;
+		log_d("%-14s deadline %+6ld s, slack %5u s, period %6u s, last run %+6ld s, runs %u",
+		      jobNames[i], entry.deadline ? entry.deadline - now : 0, entry.slackS, entry.periodS,
+		      entry.lastRun ? entry.lastRun - now : 0, entry.runCount);
+	}
+}
+
+void Scheduler::_updateWakeTime() { sleepManager.nextWakeTime = nextWake(); }
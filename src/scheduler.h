@@ -0,0 +1,104 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+#include <array>
+#include <functional>
+#include <mutex>
+
+// Timer wakes may happen a bit early because of the inaccurate sleep timer
+#define SCHEDULER_EARLY_WAKE_TOLERANCE_S 2
+
+/**
+ * Runs periodic device jobs with as few wakes as possible.
+ *
+ * Every job has a deadline and a slack: it may run anywhere in the window
+ * [deadline - slack, deadline]. The device wakes at the earliest deadline and every job whose
+ * window is open at that point runs in the same wake, so jobs with generous slack ride along
+ * with the more frequent ones.
+ *
+ * There are only a handful of jobs, so the wheel is a fixed table indexed by Job
+ * and the earliest deadline is found with a linear scan.
+ *
+ * Jobs run on the SleepManager task, so they should only enqueue work to other tasks.
+ * Jobs that run on their own (e.g. a status update requested by the user)
+ * call reschedule() to move their deadline forward.
+ */
+class Scheduler {
+  public:
+	// Jobs run in this order when their windows are open at the same time
+	enum class Job : size_t {
+		STATUS_POLL,     // Fetch calendar status, also redraws the clock
+		TOKEN_REFRESH,   // Refresh the access token before it expires
+		BATTERY_SAMPLE,  // Add a sample to the smoothed battery voltage
+		FIRMWARE_CHECK,  // Check the latest firmware version
+		RTC_SYNC,        // Correct the RTC drift from NTP
+		SIZE
+	};
+
+	static const std::array<const char*, (size_t)Job::SIZE> jobNames;
+
+	Scheduler();
+
+	/**
+	 * Register a job. First deadline is one period from now.
+	 * A zero period means the job is rescheduled only with setDeadline.
+	 */
+	void addJob(Job job, uint32_t periodS, uint32_t slackS, const std::function<void()>& run);
+
+	/**
+	 * Mark the job done now, next deadline is one period from now.
+	 */
+	void reschedule(Job job);
+
+	/**
+	 * Set the next deadline explicitly, e.g. when it depends on a token expiry.
+	 */
+	void setDeadline(Job job, time_t deadline);
+	time_t getDeadline(Job job);
+
+	/**
+	 * Run every job whose window is open at time `at` (unix utc seconds).
+	 */
+	void runDue(time_t at);
+
+	/**
+	 * True if some job has passed its deadline, i.e. we didn't sleep until it.
+	 */
+	bool anyOverdue(time_t now);
+
+	/**
+	 * Earliest deadline of all jobs, 0 if there are none.
+	 */
+	time_t nextWake();
+
+	/**
+	 * Deadlines indexed by Job, used to keep the schedule over deep sleep.
+	 */
+	std::array<time_t, (size_t)Job::SIZE> getDeadlines();
+	void setDeadlines(const std::array<time_t, (size_t)Job::SIZE>& deadlines);
+
+	/**
+	 * Log the job table for debugging, one line per job.
+	 */
+	void logTable();
+
+  private:
+	struct Entry {
+		bool registered = false;
+		uint32_t periodS = 0;
+		uint32_t slackS = 0;
+		time_t deadline = 0;
+		time_t lastRun = 0;
+		uint32_t runCount = 0;
+		std::function<void()> run;
+	};
+
+	void _updateWakeTime();
+
+	std::mutex _mutex;  // Protects _entries
+	std::array<Entry, (size_t)Job::SIZE> _entries{};
+};
+
+#endif
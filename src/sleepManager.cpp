@@ -2,18 +2,22 @@
 
 #include "esp_wifi.h"
 #include "globals.h"
+#include "resumeState.h"
 #include "timeUtils.h"
+#include "trace.h"
 #include "utils.h"
 
-ScopedTaskCounter::ScopedTaskCounter(SleepManager* manager) : _manager{manager} {
-	_manager->incrementTaskCounter();
+ScopedTaskCounter::ScopedTaskCounter(SleepManager* manager, bool increment) : _manager{manager} {
+	if (increment)
+		_manager->incrementTaskCounter();
 }
 ScopedTaskCounter::~ScopedTaskCounter() { _manager->decrementTaskCounter(); }
 
 typedef SleepManager SM;
 
 const std::array<const char*, (size_t)SM::Callback::SIZE> SM::callbackNames{
-    "AFTER_WAKE", "AFTER_WAKE_TOUCH", "AFTER_WAKE_TIMER", "BEFORE_SLEEP", "BEFORE_SHUTDOWN",
+    "AFTER_WAKE",      "AFTER_WAKE_TOUCH",  "AFTER_WAKE_TIMER",
+    "BEFORE_SLEEP",    "BEFORE_SHUTDOWN",   "BEFORE_DEEP_SLEEP",
 };
 
 void handleBeforeAction(SM* manager, SM::Action action) {
@@ -64,14 +68,14 @@ void task(void* arg) {
 
 		handleBeforeAction(manager, action);
 
-		// BEFORE_* callbacks may spin up tasks that keep us awake.
-		// Wait until they are done.
+		// BEFORE_* callbacks may queue tasks that keep us awake.
+		// Queued requests are counted at enqueue, so the idle bits are already cleared here.
 		log_i("Waiting for BEFORE_* tasks to complete");
-		delay(50);
-		while (manager->_anyActivity()) {
-			delay(10);
-		}
+		TRACE_SLEEP_TIMER(waitStart, millis());
+		xEventGroupWaitBits(manager->_idleEvents, SM::ALL_IDLE_BITS, pdFALSE, pdTRUE,
+		                    portMAX_DELAY);
 		log_i("Waiting done!");
+		TRACE_SLEEP("Waited %lu ms for BEFORE_* tasks", millis() - waitStart);
 
 		// Remove all new queue actions added by callback tasks
 		xQueueReset(manager->_queueHandle);
@@ -83,25 +87,35 @@ void task(void* arg) {
 }
 
 // Timer callbacks can't block in any way
-void timerCallback(TimerHandle_t handle) {
-	SleepManager* manager = static_cast<SleepManager*>(pvTimerGetTimerID(handle));
+void touchTimerCallback(TimerHandle_t handle) {
+	static_cast<SM*>(pvTimerGetTimerID(handle))->_setIdle(SM::TOUCH_IDLE_BIT);
+}
+
+void taskTimerCallback(TimerHandle_t handle) {
+	SM* manager = static_cast<SM*>(pvTimerGetTimerID(handle));
+	// A task may have started after the timer expired. If it did, decrementTaskCounter clears
+	// the settled bit again before restarting the timer.
+	if (xEventGroupGetBits(manager->_idleEvents) & SM::TASKS_IDLE_BIT)
+		manager->_setIdle(SM::TASKS_SETTLED_BIT);
+}
 
-	if (manager->_anyActivity())
+void SleepManager::_setIdle(EventBits_t bits) {
+	// Returns the bits at the time of setting, they may have been cleared already
+	EventBits_t newBits = xEventGroupSetBits(_idleEvents, bits) | bits;
+	if ((newBits & ALL_IDLE_BITS) != ALL_IDLE_BITS)
 		return;
 
 	log_i("All timers and tasks expired");
 
-	if (manager->_shouldShutdown()) {
-		manager->_enqueue(SleepManager::Action::SHUTDOWN);
+	if (_shouldShutdown()) {
+		_enqueue(SleepManager::Action::SHUTDOWN);
 	} else {
-		manager->_enqueue(SleepManager::Action::SLEEP);
+		_enqueue(SleepManager::Action::SLEEP);
 	}
 }
 
 bool SleepManager::_anyActivity() {
-	return xTimerIsTimerActive(_taskActivityTimer) == pdTRUE
-	       || xTimerIsTimerActive(_touchActivityTimer) == pdTRUE
-	       || uxSemaphoreGetCount(_activeTaskCounter) > 0;
+	return (xEventGroupGetBits(_idleEvents) & ALL_IDLE_BITS) != ALL_IDLE_BITS;
 }
 
 void SleepManager::_enqueue(Action action) { xQueueSend(_queueHandle, (void*)&action, 0); }
@@ -112,40 +126,47 @@ SleepManager::SleepManager() {
 
 	_queueHandle = xQueueCreate(SLEEP_MANAGER_TASK_QUEUE_SIZE, sizeof(Action));
 	assert(_queueHandle != NULL);
+	metrics.registerTask("sleep", _taskHandle, _queueHandle);
 
-	_activeTaskCounter = xSemaphoreCreateCounting(SLEEP_MANAGER_MAX_TASK_COUNT, 0);
-	assert(_activeTaskCounter != NULL);
+	// Nothing is active at start, the first task completion or touch starts the timers
+	_idleEvents = xEventGroupCreate();
+	assert(_idleEvents != NULL);
+	xEventGroupSetBits(_idleEvents, ALL_IDLE_BITS);
 
 	_touchActivityTimer = xTimerCreate("TOUCH_ACTIVITY", pdMS_TO_TICKS(TOUCH_WAKE_TIMEOUT_MS),
-	                                   pdFALSE, (void*)this, timerCallback);
+	                                   pdFALSE, (void*)this, touchTimerCallback);
 	assert(_touchActivityTimer != NULL);
 
 	_taskActivityTimer = xTimerCreate("TASK_ACTIVITY", pdMS_TO_TICKS(TASK_WAKE_TIMEOUT_MS), pdFALSE,
-	                                  (void*)this, timerCallback);
+	                                  (void*)this, taskTimerCallback);
 	assert(_taskActivityTimer != NULL);
 }
 
 ScopedTaskCounter SleepManager::scopedTaskCount() { return ScopedTaskCounter{this}; }
 
+ScopedTaskCounter SleepManager::adoptTaskCount() { return ScopedTaskCounter{this, false}; }
+
 void SleepManager::incrementTaskCounter() {
-	if (xSemaphoreGive(_activeTaskCounter) != pdTRUE) {
-		log_e("Task counter increment failed");
-		return;
-	}
+	std::lock_guard<std::mutex> lock(_taskCountMutex);
+	if (_taskCount++ == 0)
+		xEventGroupClearBits(_idleEvents, TASKS_IDLE_BIT | TASKS_SETTLED_BIT);
 
-	// log_i("Task counter incremented: count %d", uxSemaphoreGetCount(_activeTaskCounter));
+	// log_i("Task counter incremented: count %d", _taskCount);
 }
 
 void SleepManager::decrementTaskCounter() {
-	if (xSemaphoreTake(_activeTaskCounter, 10) != pdTRUE) {
+	std::lock_guard<std::mutex> lock(_taskCountMutex);
+	if (_taskCount == 0) {
 		log_e("Task counter decrement failed");
 		return;
 	}
 
-	BaseType_t count = uxSemaphoreGetCount(_activeTaskCounter);
-	// log_i("Task counter decremented: count %d", count);
+	// log_i("Task counter decremented: count %d", _taskCount - 1);
 
-	if (count == 0) {
+	if (--_taskCount == 0) {
+		// Settled bit is set by the timer once no new tasks have started for TASK_WAKE_TIMEOUT_MS
+		xEventGroupClearBits(_idleEvents, TASKS_SETTLED_BIT);
+		xEventGroupSetBits(_idleEvents, TASKS_IDLE_BIT);
 		if (xTimerReset(_taskActivityTimer, 10) != pdPASS) {
 			log_e("Activity activity timer reset failed");
 		}
@@ -153,6 +174,8 @@ void SleepManager::decrementTaskCounter() {
 }
 
 void SleepManager::refreshTouchWake() {
+	_lastTouchMs = millis();
+	xEventGroupClearBits(_idleEvents, TOUCH_IDLE_BIT);
 	if (xTimerReset(_touchActivityTimer, 10) != pdPASS) {
 		log_e("Touch activity timer reset failed");
 	}
@@ -168,7 +191,9 @@ void SleepManager::registerCallback(Callback type, const std::function<void()>&
 void SleepManager::_dispatchCallbacks(Callback type) {
 	log_i("Dispatching callback %s.", SM::callbackNames[(size_t)type]);
 	std::lock_guard<std::mutex> lock(_callbacksMutex);
+	TRACE_SLEEP_TIMER(startTime, micros());
 	for (const auto& cb : _callbacks[(size_t)type]) cb();
+	TRACE_SLEEP("%s callbacks took %lu us", SM::callbackNames[(size_t)type], micros() - startTime);
 }
 
 SleepManager::WakeReason SleepManager::_sleep() {
@@ -176,6 +201,9 @@ SleepManager::WakeReason SleepManager::_sleep() {
 
 	uint64_t sleepTime = max(nextWakeTime - safeUTC.now(), (long)MIN_TIMED_SLEEP_S);
 
+	if (_shouldDeepSleep(sleepTime))
+		_deepSleep(sleepTime);
+
 	log_i("Sleeping for %llu s or until touch.", sleepTime);
 
 	Serial.flush();
@@ -187,7 +215,11 @@ SleepManager::WakeReason SleepManager::_sleep() {
 	// Light sleep and wait for timer or touch interrupt
 	esp_sleep_enable_ext0_wakeup(GPIO_NUM_36, LOW);  // TOUCH_INT
 	esp_sleep_enable_timer_wakeup(sleepTime * 1000 * 1000);
+	energyLedger.beginSleep();
+	TRACE_SLEEP_TIMER(sleepStart, millis());
 	esp_light_sleep_start();
+	TRACE_SLEEP("Woke up after %lu ms of light sleep", millis() - sleepStart);
+	energyLedger.endSleep();
 
 	wifiManager.wakeWiFi();
 
@@ -203,6 +235,30 @@ SleepManager::WakeReason SleepManager::_sleep() {
 	return WakeReason::UNKNOWN;
 }
 
+bool SleepManager::_shouldDeepSleep(uint64_t sleepTime) {
+	return _deepSleepEnabled && !_wifiKeepConnected && sleepTime >= DEEP_SLEEP_MIN_S
+	       && millis() - _lastTouchMs >= DEEP_SLEEP_IDLE_MS;
+}
+
+void SleepManager::_deepSleep(uint64_t sleepTime) {
+	log_i("Deep sleeping for %llu s or until touch.", sleepTime);
+
+	_dispatchCallbacks(Callback::BEFORE_DEEP_SLEEP);
+	energyLedger.beginDeepSleep();
+	resume::markValid();
+
+	Serial.flush();
+	wifiManager.sleepWiFi();
+
+	// Keep main power on, otherwise M5Paper turns off when on battery
+	gpio_hold_en((gpio_num_t)M5EPD_MAIN_PWR_PIN);
+	gpio_deep_sleep_hold_en();
+
+	esp_sleep_enable_ext0_wakeup(GPIO_NUM_36, LOW);  // TOUCH_INT
+	esp_sleep_enable_timer_wakeup(sleepTime * 1000 * 1000);
+	esp_deep_sleep_start();
+}
+
 void SleepManager::requestErrorReboot() { _enqueue(Action::ERROR_REBOOT); }
 
 void SleepManager::setOnTimes(JsonObjectConst config) {
@@ -236,6 +292,13 @@ void SleepManager::setOnTimes(JsonObjectConst config) {
 	      _onMinutes[1]);
 }
 
+void SleepManager::setDeepSleep(bool enabled, bool idle) {
+	_deepSleepEnabled = enabled;
+	// Unsigned overflow is fine, only the difference to millis() matters
+	_lastTouchMs = idle ? millis() - DEEP_SLEEP_IDLE_MS : millis();
+	log_i("Deep sleep enabled: %d", enabled);
+}
+
 void SleepManager::setWiFiKeepConnected(bool value) { 
 	_wifiKeepConnected = value;
 	log_i("WiFi keep connected: %d", value);
@@ -279,11 +342,11 @@ void SleepManager::_shutdown(time_t wakeAfter) {
 		turnOnTimeUTC = safeUTC.now() + wakeAfter;
 	}
 
-	const String logShut = "[" + safeMyTZ.dateTime(RFC3339) + "] Shut down";
 	const String logWake = "Try wake at " + safeMyTZ.dateTime(turnOnTimeUTC, UTC_TIME, RFC3339);
-	log_i("%s, %s", logShut.c_str(), logWake.c_str());
-	// utils::addBootLogEntry(logWake);
-	// utils::addBootLogEntry(logShut);
+	log_i("Shut down, %s", logWake.c_str());
+	eventLog.append(EventLog::Type::SHUTDOWN, logWake);
+
+	energyLedger.persist();
 
 	Serial.flush();
 
@@ -3,13 +3,12 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <ezTime.h>
+#include <freertos/event_groups.h>
 
 #include <atomic>
 #include <mutex>
 #include <vector>
 
-#define SLEEP_MANAGER_MAX_TASK_COUNT 20
-
 #define SLEEP_MANAGER_TASK_STACK_SIZE (1024 * 3)
 #define SLEEP_MANAGER_TASK_PRIORITY 10
 #define SLEEP_MANAGER_TASK_QUEUE_SIZE 5
@@ -26,16 +25,27 @@
 #define MIN_TIMED_SLEEP_S 3
 
 #define STATUS_UPDATE_INTERVAL_S (2 * SECS_PER_MIN)
+// How much earlier a status update may run to share a wake with other jobs
+#define STATUS_UPDATE_SLACK_S 20
 
 #define WAKEUP_SAFETY_BUFFER_S 10
 
 #define ERROR_REBOOT_DELAY_S (20 * SECS_PER_MIN)
 
+// Deep sleep is used instead of light sleep after this long without touch input, if enabled
+#define DEEP_SLEEP_IDLE_MS (5 * 60 * 1000)
+
+// Shorter sleeps than this are not worth the boot time of a deep sleep wake
+#define DEEP_SLEEP_MIN_S 60
+
 class SleepManager;
 
 class ScopedTaskCounter {
   public:
-	ScopedTaskCounter(SleepManager* manager);
+	/**
+	 * Set increment to false to take ownership of a count that was already incremented.
+	 */
+	ScopedTaskCounter(SleepManager* manager, bool increment = true);
 	~ScopedTaskCounter();
 
   private:
@@ -45,7 +55,9 @@ class ScopedTaskCounter {
 /**
  * Handles going to sleep and waking up from touch or a reccurring timer.
  * Makes the device sleep when there are no active tasks and there hasn't been a touch input in some
- * time. Members starting with underlines indicate pseudo private members, don't use them. (FreeRTOS
+ * time. Idle state is kept in an event group, which is updated on task count transitions and
+ * timer expiries, so nothing polls for activity.
+ * Members starting with underlines indicate pseudo private members, don't use them. (FreeRTOS
  * task API needs them public to work)
  */
 class SleepManager {
@@ -66,6 +78,12 @@ class SleepManager {
 	 */
 	[[nodiscard]] ScopedTaskCounter scopedTaskCount();
 
+	/**
+	 * RAII decrement for a count that was incremented earlier, e.g. when a request was queued.
+	 * Counting queued requests prevents sleeping between enqueue and the worker picking it up.
+	 */
+	[[nodiscard]] ScopedTaskCounter adoptTaskCount();
+
 	/**
 	 * You should probably be using scopedTaskCount insted of these.
 	 */
@@ -93,13 +111,18 @@ class SleepManager {
 		AFTER_WAKE_TIMER,
 		BEFORE_SLEEP,
 		BEFORE_SHUTDOWN,
+		/*
+		 * Is called after BEFORE_SLEEP and after tasks have completed, when entering deep sleep.
+		 * Callbacks should save their state with resume::save* synchronously.
+		 */
+		BEFORE_DEEP_SLEEP,
 		SIZE
 	};
 
 	static const std::array<const char*, (size_t)Callback::SIZE> callbackNames;
 
 	// Set this to control length of time to sleep, if it's less than current time, sleep will be
-	// default length. Uses unix utc seconds.
+	// default length. Uses unix utc seconds. Set by the Scheduler.
 	std::atomic<time_t> nextWakeTime{0};
 
 	void registerCallback(Callback type, const std::function<void()>& cb);
@@ -116,6 +139,16 @@ class SleepManager {
 	void setWiFiKeepConnected(bool value);
 	bool _wifiKeepConnected;
 
+	/**
+	 * Allow deep sleep after DEEP_SLEEP_IDLE_MS without touch input.
+	 * Set idle when resuming from a timer wake, the device was already idle before sleeping.
+	 */
+	void setDeepSleep(bool enabled, bool idle = false);
+	bool _deepSleepEnabled = false;
+	std::atomic<uint32_t> _lastTouchMs{0};
+	bool _shouldDeepSleep(uint64_t sleepTime);
+	[[noreturn]] void _deepSleep(uint64_t sleepTime);
+
 	time_t calculateTurnOnTimeUTC(time_t localNow);
 	bool _shouldShutdown();
 
@@ -132,8 +165,20 @@ class SleepManager {
 	void _enqueue(Action action);
 
 	bool _anyActivity();
+	/**
+	 * Set idle bits and enqueue sleep or shutdown if everything is idle.
+	 */
+	void _setIdle(EventBits_t bits);
+
+	// Event group bits, activity has stopped when all of them are set
+	static const EventBits_t TASKS_IDLE_BIT = 1 << 0;     // Task count is zero
+	static const EventBits_t TASKS_SETTLED_BIT = 1 << 1;  // No tasks for TASK_WAKE_TIMEOUT_MS
+	static const EventBits_t TOUCH_IDLE_BIT = 1 << 2;     // No touch for TOUCH_WAKE_TIMEOUT_MS
+	static const EventBits_t ALL_IDLE_BITS = TASKS_IDLE_BIT | TASKS_SETTLED_BIT | TOUCH_IDLE_BIT;
+	EventGroupHandle_t _idleEvents;
 
-	SemaphoreHandle_t _activeTaskCounter;
+	std::mutex _taskCountMutex;  // Keeps _taskCount and the task bits in sync
+	int _taskCount = 0;
 
 	TimerHandle_t _touchActivityTimer;
 	TimerHandle_t _taskActivityTimer;
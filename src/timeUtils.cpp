@@ -59,41 +59,142 @@ time_t getNextMidnight(time_t now) {
 	return ezt::makeTime(tm);
 }
 
-time_t parseRfcTimestamp(const String& input) {
-	tmElements_t tmElements{};
-	tmElements.Year = input.substring(0, 4).toInt() - 1970;
-	tmElements.Month = input.substring(5, 7).toInt();
-	tmElements.Day = input.substring(8, 10).toInt();
-	tmElements.Hour = input.substring(11, 13).toInt();
-	tmElements.Minute = input.substring(14, 16).toInt();
-	tmElements.Second = input.substring(17, 19).toInt();
-
-	time_t t = ezt::makeTime(tmElements);
-
-	// Find position of timezone, because we need to ignore fractions of seconds
-	unsigned int timeZonePos = 19;
-	if (input.charAt(19) == '.') {
-		timeZonePos = input.indexOf("Z", 19);
-		if (timeZonePos == -1)
-			timeZonePos = input.indexOf("+", 19);
-		if (timeZonePos == -1)
-			timeZonePos = input.indexOf("-", 19);
-	}
+namespace {
+const size_t DATE_TIME_LENGTH = 19;  // 2022-12-30T23:59:59
 
-	// Timezone handling
-	if (input.charAt(timeZonePos) != 'Z') {
-		int sign = 1;
-		if (input.charAt(timeZonePos) == '-') {
-			sign = -1;
-		}
+// Value of the two digits at input, without checking that they are digits
+inline int twoDigits(const char* input) { return (input[0] - '0') * 10 + (input[1] - '0'); }
 
-		int offsetHours = input.substring(timeZonePos + 1, timeZonePos + 3).toInt();
-		int offsetMinutes = input.substring(timeZonePos + 4, timeZonePos + 6).toInt();
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
 
-		t -= sign * offsetHours * SECS_PER_HOUR;
-		t -= sign * offsetMinutes * SECS_PER_MIN;
+bool isLeapYear(int year) { return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0; }
+
+int daysInMonth(int year, int month) {
+	static const uint8_t DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	return month == 2 && isLeapYear(year) ? 29 : DAYS[month - 1];
+}
+
+/**
+ * Days from 1970-01-01 to a date of the proleptic Gregorian calendar, without the loops of
+ * ezt::makeTime. See http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+ */
+int64_t daysFromCivil(int year, int month, int day) {
+	year -= month <= 2;
+	const int era = (year >= 0 ? year : year - 399) / 400;
+	const int yearOfEra = year - era * 400;
+	const int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return (int64_t)era * 146097 + dayOfEra - 719468;
+}
+
+int64_t toSeconds(const char* input) {
+	const int year = twoDigits(input) * 100 + twoDigits(input + 2);
+	const int64_t days = daysFromCivil(year, twoDigits(input + 5), twoDigits(input + 8));
+	return days * SECS_PER_DAY + twoDigits(input + 11) * SECS_PER_HOUR
+	       + twoDigits(input + 14) * SECS_PER_MIN + twoDigits(input + 17);
+}
+
+// Seconds east of UTC of an offset like +03:00 at input
+int offsetSeconds(const char* input) {
+	const int seconds = twoDigits(input + 1) * SECS_PER_HOUR + twoDigits(input + 4) * SECS_PER_MIN;
+	return input[0] == '-' ? -seconds : seconds;
+}
+
+// Skips the fraction of seconds, returns the position of the offset
+size_t skipFraction(const char* input, size_t length, size_t pos) {
+	if (pos < length && input[pos] == '.') {
+		pos++;
+		while (pos < length && isDigit(input[pos])) pos++;
 	}
+	return pos;
+}
+}  // namespace
+
+time_t parseRfcTimestamp(const char* input, size_t length) {
+	if (length < DATE_TIME_LENGTH)
+		return 0;
+	int64_t t = toSeconds(input);
 
+	const size_t pos = skipFraction(input, length, DATE_TIME_LENGTH);
+	if (pos + 6 <= length && (input[pos] == '+' || input[pos] == '-'))
+		t -= offsetSeconds(input + pos);
 	return t;
 }
+
+time_t parseRfcTimestamp(const String& input) {
+	return parseRfcTimestamp(input.c_str(), input.length());
+}
+
+bool parseRfcTimestampStrict(const char* input, size_t length, time_t& result) {
+	// Digits and separators of 2022-12-30T23:59:59, 'd' for a digit
+	static const char* const PATTERN = "dddd-dd-ddTdd:dd:dd";
+	if (length < DATE_TIME_LENGTH)
+		return false;
+	for (size_t i = 0; i < DATE_TIME_LENGTH; i++) {
+		const char c = input[i];
+		if (PATTERN[i] == 'd') {
+			if (!isDigit(c))
+				return false;
+		} else if (PATTERN[i] == 'T') {
+			if (c != 'T' && c != 't' && c != ' ')
+				return false;
+		} else if (c != PATTERN[i]) {
+			return false;
+		}
+	}
+	const int year = twoDigits(input) * 100 + twoDigits(input + 2);
+	const int month = twoDigits(input + 5);
+	if (month < 1 || month > 12 || twoDigits(input + 8) < 1
+	    || twoDigits(input + 8) > daysInMonth(year, month) || twoDigits(input + 11) > 23
+	    || twoDigits(input + 14) > 59 || twoDigits(input + 17) > 60)  // 60 is a leap second
+		return false;
+	int64_t t = toSeconds(input);
+
+	size_t pos = DATE_TIME_LENGTH;
+	if (pos < length && input[pos] == '.') {
+		const size_t fraction = skipFraction(input, length, pos);
+		if (fraction == pos + 1)
+			return false;
+		pos = fraction;
+	}
+
+	if (pos + 1 == length && (input[pos] == 'Z' || input[pos] == 'z')) {
+		// UTC
+	} else if (pos + 6 == length && (input[pos] == '+' || input[pos] == '-')) {
+		const char* offset = input + pos + 1;
+		if (!isDigit(offset[0]) || !isDigit(offset[1]) || offset[2] != ':' || !isDigit(offset[3])
+		    || !isDigit(offset[4]) || twoDigits(offset) > 23 || twoDigits(offset + 3) > 59)
+			return false;
+		t -= offsetSeconds(input + pos);
+	} else {
+		return false;
+	}
+
+	if (t != (int64_t)(time_t)t)
+		return false;
+	result = t;
+	return true;
+}
+
+time_t parseHttpDate(const String& input) {
+	static const char* const MONTHS = "JanFebMarAprMayJunJulAugSepOctNovDec";
+	int day, year, hour, minute, second;
+	char month[4];
+	if (sscanf(input.c_str(), "%*3s, %2d %3s %4d %2d:%2d:%2d GMT", &day, month, &year, &hour,
+	           &minute, &second)
+	    != 6)
+		return 0;
+	const char* found = strstr(MONTHS, month);
+	if (!found || strlen(month) != 3 || (found - MONTHS) % 3 != 0 || year < 1970)
+		return 0;
+
+	tmElements_t tmElements{};
+	tmElements.Year = year - 1970;
+	tmElements.Month = (found - MONTHS) / 3 + 1;
+	tmElements.Day = day;
+	tmElements.Hour = hour;
+	tmElements.Minute = minute;
+	tmElements.Second = second;
+	return ezt::makeTime(tmElements);
+}
 }  // namespace timeutils
\ No newline at end of file
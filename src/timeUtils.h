@@ -27,10 +27,28 @@ time_t getNextMidnight(time_t now);
  * - 2022-12-30T23:59:59.000+03:00
  * - 2022-12-30T23:59:59.123-03:00
  * Seconds may contain any number of digits after the decimal point, but they are all ignored.
- * `T` may be replaced with any single character.
+ * `T` may be replaced with any single character. A missing offset is read as UTC, like the
+ * times of Microsoft Graph with the UTC time zone preference.
+ *
+ * Reads input in place, e.g. straight from an ArduinoJson document, without allocating.
+ * input doesn't need to be zero terminated. Returns 0 if it is shorter than a date and time.
  */
+time_t parseRfcTimestamp(const char* input, size_t length);
 time_t parseRfcTimestamp(const String& input);
 
+/**
+ * Validating variant of parseRfcTimestamp for untrusted input, e.g. from the network.
+ * Accepts the same forms, but `T` must be `T`, `t` or a space and the offset is required.
+ * Returns false if input is not exactly one valid timestamp that fits time_t.
+ */
+bool parseRfcTimestampStrict(const char* input, size_t length, time_t& result);
+
+/**
+ * Parses an HTTP date (RFC 9110 IMF-fixdate) into a UTC time_t, 0 if it is not one.
+ * Example: Sun, 06 Nov 1994 08:49:37 GMT
+ */
+time_t parseHttpDate(const String& input);
+
 }  // namespace timeutils
 
 #endif
\ No newline at end of file
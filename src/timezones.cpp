@@ -0,0 +1,616 @@
+// This file is generated by scripts/generate_timezones.py, do not edit.
+// Source: /usr/share/zoneinfo (tzdata 2025b)
+
+#include "timezones.h"
+
+namespace tzdb {
+
+const uint16_t ZONE_COUNT = 554;
+
+const char ZONE_DATA[] =
+    "Africa/Abidjan\0" "GMT0\0"
+    "Africa/Accra\0" "GMT0\0"
+    "Africa/Addis_Ababa\0" "EAT-3\0"
+    "Africa/Algiers\0" "CET-1\0"
+    "Africa/Asmara\0" "EAT-3\0"
+    "Africa/Asmera\0" "EAT-3\0"
+    "Africa/Bamako\0" "GMT0\0"
+    "Africa/Bangui\0" "WAT-1\0"
+    "Africa/Banjul\0" "GMT0\0"
+    "Africa/Bissau\0" "GMT0\0"
+    "Africa/Blantyre\0" "CAT-2\0"
+    "Africa/Brazzaville\0" "WAT-1\0"
+    "Africa/Bujumbura\0" "CAT-2\0"
+    "Africa/Cairo\0" "EET-2EEST,M4.5.5/0,M10.5.4/24\0"
+    "Africa/Casablanca\0" "<+01>-1\0"
+    "Africa/Ceuta\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Africa/Conakry\0" "GMT0\0"
+    "Africa/Dakar\0" "GMT0\0"
+    "Africa/Dar_es_Salaam\0" "EAT-3\0"
+    "Africa/Djibouti\0" "EAT-3\0"
+    "Africa/Douala\0" "WAT-1\0"
+    "Africa/El_Aaiun\0" "<+01>-1\0"
+    "Africa/Freetown\0" "GMT0\0"
+    "Africa/Gaborone\0" "CAT-2\0"
+    "Africa/Harare\0" "CAT-2\0"
+    "Africa/Johannesburg\0" "SAST-2\0"
+    "Africa/Juba\0" "CAT-2\0"
+    "Africa/Kampala\0" "EAT-3\0"
+    "Africa/Khartoum\0" "CAT-2\0"
+    "Africa/Kigali\0" "CAT-2\0"
+    "Africa/Kinshasa\0" "WAT-1\0"
+    "Africa/Lagos\0" "WAT-1\0"
+    "Africa/Libreville\0" "WAT-1\0"
+    "Africa/Lome\0" "GMT0\0"
+    "Africa/Luanda\0" "WAT-1\0"
+    "Africa/Lubumbashi\0" "CAT-2\0"
+    "Africa/Lusaka\0" "CAT-2\0"
+    "Africa/Malabo\0" "WAT-1\0"
+    "Africa/Maputo\0" "CAT-2\0"
+    "Africa/Maseru\0" "SAST-2\0"
+    "Africa/Mbabane\0" "SAST-2\0"
+    "Africa/Mogadishu\0" "EAT-3\0"
+    "Africa/Monrovia\0" "GMT0\0"
+    "Africa/Nairobi\0" "EAT-3\0"
+    "Africa/Ndjamena\0" "WAT-1\0"
+    "Africa/Niamey\0" "WAT-1\0"
+    "Africa/Nouakchott\0" "GMT0\0"
+    "Africa/Ouagadougou\0" "GMT0\0"
+    "Africa/Porto-Novo\0" "WAT-1\0"
+    "Africa/Sao_Tome\0" "GMT0\0"
+    "Africa/Timbuktu\0" "GMT0\0"
+    "Africa/Tripoli\0" "EET-2\0"
+    "Africa/Tunis\0" "CET-1\0"
+    "Africa/Windhoek\0" "CAT-2\0"
+    "America/Adak\0" "HST10HDT,M3.2.0,M11.1.0\0"
+    "America/Anchorage\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "America/Anguilla\0" "AST4\0"
+    "America/Antigua\0" "AST4\0"
+    "America/Araguaina\0" "<-03>3\0"
+    "America/Argentina/Buenos_Aires\0" "<-03>3\0"
+    "America/Argentina/Catamarca\0" "<-03>3\0"
+    "America/Argentina/ComodRivadavia\0" "<-03>3\0"
+    "America/Argentina/Cordoba\0" "<-03>3\0"
+    "America/Argentina/Jujuy\0" "<-03>3\0"
+    "America/Argentina/La_Rioja\0" "<-03>3\0"
+    "America/Argentina/Mendoza\0" "<-03>3\0"
+    "America/Argentina/Rio_Gallegos\0" "<-03>3\0"
+    "America/Argentina/Salta\0" "<-03>3\0"
+    "America/Argentina/San_Juan\0" "<-03>3\0"
+    "America/Argentina/San_Luis\0" "<-03>3\0"
+    "America/Argentina/Tucuman\0" "<-03>3\0"
+    "America/Argentina/Ushuaia\0" "<-03>3\0"
+    "America/Aruba\0" "AST4\0"
+    "America/Asuncion\0" "<-03>3\0"
+    "America/Atikokan\0" "EST5\0"
+    "America/Atka\0" "HST10HDT,M3.2.0,M11.1.0\0"
+    "America/Bahia\0" "<-03>3\0"
+    "America/Bahia_Banderas\0" "CST6\0"
+    "America/Barbados\0" "AST4\0"
+    "America/Belem\0" "<-03>3\0"
+    "America/Belize\0" "CST6\0"
+    "America/Blanc-Sablon\0" "AST4\0"
+    "America/Boa_Vista\0" "<-04>4\0"
+    "America/Bogota\0" "<-05>5\0"
+    "America/Boise\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Buenos_Aires\0" "<-03>3\0"
+    "America/Cambridge_Bay\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Campo_Grande\0" "<-04>4\0"
+    "America/Cancun\0" "EST5\0"
+    "America/Caracas\0" "<-04>4\0"
+    "America/Catamarca\0" "<-03>3\0"
+    "America/Cayenne\0" "<-03>3\0"
+    "America/Cayman\0" "EST5\0"
+    "America/Chicago\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Chihuahua\0" "CST6\0"
+    "America/Ciudad_Juarez\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Coral_Harbour\0" "EST5\0"
+    "America/Cordoba\0" "<-03>3\0"
+    "America/Costa_Rica\0" "CST6\0"
+    "America/Coyhaique\0" "<-03>3\0"
+    "America/Creston\0" "MST7\0"
+    "America/Cuiaba\0" "<-04>4\0"
+    "America/Curacao\0" "AST4\0"
+    "America/Danmarkshavn\0" "GMT0\0"
+    "America/Dawson\0" "MST7\0"
+    "America/Dawson_Creek\0" "MST7\0"
+    "America/Denver\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Detroit\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Dominica\0" "AST4\0"
+    "America/Edmonton\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Eirunepe\0" "<-05>5\0"
+    "America/El_Salvador\0" "CST6\0"
+    "America/Ensenada\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "America/Fort_Nelson\0" "MST7\0"
+    "America/Fort_Wayne\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Fortaleza\0" "<-03>3\0"
+    "America/Glace_Bay\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "America/Godthab\0" "<-02>2<-01>,M3.5.0/-1,M10.5.0/0\0"
+    "America/Goose_Bay\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "America/Grand_Turk\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Grenada\0" "AST4\0"
+    "America/Guadeloupe\0" "AST4\0"
+    "America/Guatemala\0" "CST6\0"
+    "America/Guayaquil\0" "<-05>5\0"
+    "America/Guyana\0" "<-04>4\0"
+    "America/Halifax\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "America/Havana\0" "CST5CDT,M3.2.0/0,M11.1.0/1\0"
+    "America/Hermosillo\0" "MST7\0"
+    "America/Indiana/Indianapolis\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Knox\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Marengo\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Petersburg\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Tell_City\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Vevay\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Vincennes\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Indiana/Winamac\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Indianapolis\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Inuvik\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Iqaluit\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Jamaica\0" "EST5\0"
+    "America/Jujuy\0" "<-03>3\0"
+    "America/Juneau\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "America/Kentucky/Louisville\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Kentucky/Monticello\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Knox_IN\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Kralendijk\0" "AST4\0"
+    "America/La_Paz\0" "<-04>4\0"
+    "America/Lima\0" "<-05>5\0"
+    "America/Los_Angeles\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "America/Louisville\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Lower_Princes\0" "AST4\0"
+    "America/Maceio\0" "<-03>3\0"
+    "America/Managua\0" "CST6\0"
+    "America/Manaus\0" "<-04>4\0"
+    "America/Marigot\0" "AST4\0"
+    "America/Martinique\0" "AST4\0"
+    "America/Matamoros\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Mazatlan\0" "MST7\0"
+    "America/Mendoza\0" "<-03>3\0"
+    "America/Menominee\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Merida\0" "CST6\0"
+    "America/Metlakatla\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "America/Mexico_City\0" "CST6\0"
+    "America/Miquelon\0" "<-03>3<-02>,M3.2.0,M11.1.0\0"
+    "America/Moncton\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "America/Monterrey\0" "CST6\0"
+    "America/Montevideo\0" "<-03>3\0"
+    "America/Montreal\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Montserrat\0" "AST4\0"
+    "America/Nassau\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/New_York\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Nipigon\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Nome\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "America/Noronha\0" "<-02>2\0"
+    "America/North_Dakota/Beulah\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/North_Dakota/Center\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/North_Dakota/New_Salem\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Nuuk\0" "<-02>2<-01>,M3.5.0/-1,M10.5.0/0\0"
+    "America/Ojinaga\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Panama\0" "EST5\0"
+    "America/Pangnirtung\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Paramaribo\0" "<-03>3\0"
+    "America/Phoenix\0" "MST7\0"
+    "America/Port-au-Prince\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Port_of_Spain\0" "AST4\0"
+    "America/Porto_Acre\0" "<-05>5\0"
+    "America/Porto_Velho\0" "<-04>4\0"
+    "America/Puerto_Rico\0" "AST4\0"
+    "America/Punta_Arenas\0" "<-03>3\0"
+    "America/Rainy_River\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Rankin_Inlet\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Recife\0" "<-03>3\0"
+    "America/Regina\0" "CST6\0"
+    "America/Resolute\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Rio_Branco\0" "<-05>5\0"
+    "America/Rosario\0" "<-03>3\0"
+    "America/Santa_Isabel\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "America/Santarem\0" "<-03>3\0"
+    "America/Santiago\0" "<-04>4<-03>,M9.1.6/24,M4.1.6/24\0"
+    "America/Santo_Domingo\0" "AST4\0"
+    "America/Sao_Paulo\0" "<-03>3\0"
+    "America/Scoresbysund\0" "<-02>2<-01>,M3.5.0/-1,M10.5.0/0\0"
+    "America/Shiprock\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "America/Sitka\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "America/St_Barthelemy\0" "AST4\0"
+    "America/St_Johns\0" "NST3:30NDT,M3.2.0,M11.1.0\0"
+    "America/St_Kitts\0" "AST4\0"
+    "America/St_Lucia\0" "AST4\0"
+    "America/St_Thomas\0" "AST4\0"
+    "America/St_Vincent\0" "AST4\0"
+    "America/Swift_Current\0" "CST6\0"
+    "America/Tegucigalpa\0" "CST6\0"
+    "America/Thule\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "America/Thunder_Bay\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Tijuana\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "America/Toronto\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "America/Tortola\0" "AST4\0"
+    "America/Vancouver\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "America/Virgin\0" "AST4\0"
+    "America/Whitehorse\0" "MST7\0"
+    "America/Winnipeg\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "America/Yakutat\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "America/Yellowknife\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "Antarctica/Casey\0" "<+08>-8\0"
+    "Antarctica/Davis\0" "<+07>-7\0"
+    "Antarctica/DumontDUrville\0" "<+10>-10\0"
+    "Antarctica/Macquarie\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Antarctica/Mawson\0" "<+05>-5\0"
+    "Antarctica/McMurdo\0" "NZST-12NZDT,M9.5.0,M4.1.0/3\0"
+    "Antarctica/Palmer\0" "<-03>3\0"
+    "Antarctica/Rothera\0" "<-03>3\0"
+    "Antarctica/South_Pole\0" "NZST-12NZDT,M9.5.0,M4.1.0/3\0"
+    "Antarctica/Syowa\0" "<+03>-3\0"
+    "Antarctica/Troll\0" "<+00>0<+02>-2,M3.5.0/1,M10.5.0/3\0"
+    "Antarctica/Vostok\0" "<+05>-5\0"
+    "Arctic/Longyearbyen\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Asia/Aden\0" "<+03>-3\0"
+    "Asia/Almaty\0" "<+05>-5\0"
+    "Asia/Amman\0" "<+03>-3\0"
+    "Asia/Anadyr\0" "<+12>-12\0"
+    "Asia/Aqtau\0" "<+05>-5\0"
+    "Asia/Aqtobe\0" "<+05>-5\0"
+    "Asia/Ashgabat\0" "<+05>-5\0"
+    "Asia/Ashkhabad\0" "<+05>-5\0"
+    "Asia/Atyrau\0" "<+05>-5\0"
+    "Asia/Baghdad\0" "<+03>-3\0"
+    "Asia/Bahrain\0" "<+03>-3\0"
+    "Asia/Baku\0" "<+04>-4\0"
+    "Asia/Bangkok\0" "<+07>-7\0"
+    "Asia/Barnaul\0" "<+07>-7\0"
+    "Asia/Beirut\0" "EET-2EEST,M3.5.0/0,M10.5.0/0\0"
+    "Asia/Bishkek\0" "<+06>-6\0"
+    "Asia/Brunei\0" "<+08>-8\0"
+    "Asia/Calcutta\0" "IST-5:30\0"
+    "Asia/Chita\0" "<+09>-9\0"
+    "Asia/Choibalsan\0" "<+08>-8\0"
+    "Asia/Chongqing\0" "CST-8\0"
+    "Asia/Chungking\0" "CST-8\0"
+    "Asia/Colombo\0" "<+0530>-5:30\0"
+    "Asia/Dacca\0" "<+06>-6\0"
+    "Asia/Damascus\0" "<+03>-3\0"
+    "Asia/Dhaka\0" "<+06>-6\0"
+    "Asia/Dili\0" "<+09>-9\0"
+    "Asia/Dubai\0" "<+04>-4\0"
+    "Asia/Dushanbe\0" "<+05>-5\0"
+    "Asia/Famagusta\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Asia/Gaza\0" "EET-2EEST,M3.4.4/50,M10.4.4/50\0"
+    "Asia/Harbin\0" "CST-8\0"
+    "Asia/Hebron\0" "EET-2EEST,M3.4.4/50,M10.4.4/50\0"
+    "Asia/Ho_Chi_Minh\0" "<+07>-7\0"
+    "Asia/Hong_Kong\0" "HKT-8\0"
+    "Asia/Hovd\0" "<+07>-7\0"
+    "Asia/Irkutsk\0" "<+08>-8\0"
+    "Asia/Istanbul\0" "<+03>-3\0"
+    "Asia/Jakarta\0" "WIB-7\0"
+    "Asia/Jayapura\0" "WIT-9\0"
+    "Asia/Jerusalem\0" "IST-2IDT,M3.4.4/26,M10.5.0\0"
+    "Asia/Kabul\0" "<+0430>-4:30\0"
+    "Asia/Kamchatka\0" "<+12>-12\0"
+    "Asia/Karachi\0" "PKT-5\0"
+    "Asia/Kashgar\0" "<+06>-6\0"
+    "Asia/Kathmandu\0" "<+0545>-5:45\0"
+    "Asia/Katmandu\0" "<+0545>-5:45\0"
+    "Asia/Khandyga\0" "<+09>-9\0"
+    "Asia/Kolkata\0" "IST-5:30\0"
+    "Asia/Krasnoyarsk\0" "<+07>-7\0"
+    "Asia/Kuala_Lumpur\0" "<+08>-8\0"
+    "Asia/Kuching\0" "<+08>-8\0"
+    "Asia/Kuwait\0" "<+03>-3\0"
+    "Asia/Macao\0" "CST-8\0"
+    "Asia/Macau\0" "CST-8\0"
+    "Asia/Magadan\0" "<+11>-11\0"
+    "Asia/Makassar\0" "WITA-8\0"
+    "Asia/Manila\0" "PST-8\0"
+    "Asia/Muscat\0" "<+04>-4\0"
+    "Asia/Nicosia\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Asia/Novokuznetsk\0" "<+07>-7\0"
+    "Asia/Novosibirsk\0" "<+07>-7\0"
+    "Asia/Omsk\0" "<+06>-6\0"
+    "Asia/Oral\0" "<+05>-5\0"
+    "Asia/Phnom_Penh\0" "<+07>-7\0"
+    "Asia/Pontianak\0" "WIB-7\0"
+    "Asia/Pyongyang\0" "KST-9\0"
+    "Asia/Qatar\0" "<+03>-3\0"
+    "Asia/Qostanay\0" "<+05>-5\0"
+    "Asia/Qyzylorda\0" "<+05>-5\0"
+    "Asia/Rangoon\0" "<+0630>-6:30\0"
+    "Asia/Riyadh\0" "<+03>-3\0"
+    "Asia/Saigon\0" "<+07>-7\0"
+    "Asia/Sakhalin\0" "<+11>-11\0"
+    "Asia/Samarkand\0" "<+05>-5\0"
+    "Asia/Seoul\0" "KST-9\0"
+    "Asia/Shanghai\0" "CST-8\0"
+    "Asia/Singapore\0" "<+08>-8\0"
+    "Asia/Srednekolymsk\0" "<+11>-11\0"
+    "Asia/Taipei\0" "CST-8\0"
+    "Asia/Tashkent\0" "<+05>-5\0"
+    "Asia/Tbilisi\0" "<+04>-4\0"
+    "Asia/Tehran\0" "<+0330>-3:30\0"
+    "Asia/Tel_Aviv\0" "IST-2IDT,M3.4.4/26,M10.5.0\0"
+    "Asia/Thimbu\0" "<+06>-6\0"
+    "Asia/Thimphu\0" "<+06>-6\0"
+    "Asia/Tokyo\0" "JST-9\0"
+    "Asia/Tomsk\0" "<+07>-7\0"
+    "Asia/Ujung_Pandang\0" "WITA-8\0"
+    "Asia/Ulaanbaatar\0" "<+08>-8\0"
+    "Asia/Ulan_Bator\0" "<+08>-8\0"
+    "Asia/Urumqi\0" "<+06>-6\0"
+    "Asia/Ust-Nera\0" "<+10>-10\0"
+    "Asia/Vientiane\0" "<+07>-7\0"
+    "Asia/Vladivostok\0" "<+10>-10\0"
+    "Asia/Yakutsk\0" "<+09>-9\0"
+    "Asia/Yangon\0" "<+0630>-6:30\0"
+    "Asia/Yekaterinburg\0" "<+05>-5\0"
+    "Asia/Yerevan\0" "<+04>-4\0"
+    "Atlantic/Azores\0" "<-01>1<+00>,M3.5.0/0,M10.5.0/1\0"
+    "Atlantic/Bermuda\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "Atlantic/Canary\0" "WET0WEST,M3.5.0/1,M10.5.0\0"
+    "Atlantic/Cape_Verde\0" "<-01>1\0"
+    "Atlantic/Faeroe\0" "WET0WEST,M3.5.0/1,M10.5.0\0"
+    "Atlantic/Faroe\0" "WET0WEST,M3.5.0/1,M10.5.0\0"
+    "Atlantic/Jan_Mayen\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Atlantic/Madeira\0" "WET0WEST,M3.5.0/1,M10.5.0\0"
+    "Atlantic/Reykjavik\0" "GMT0\0"
+    "Atlantic/South_Georgia\0" "<-02>2\0"
+    "Atlantic/St_Helena\0" "GMT0\0"
+    "Atlantic/Stanley\0" "<-03>3\0"
+    "Australia/ACT\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Adelaide\0" "ACST-9:30ACDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Brisbane\0" "AEST-10\0"
+    "Australia/Broken_Hill\0" "ACST-9:30ACDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Canberra\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Currie\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Darwin\0" "ACST-9:30\0"
+    "Australia/Eucla\0" "<+0845>-8:45\0"
+    "Australia/Hobart\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/LHI\0" "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0\0"
+    "Australia/Lindeman\0" "AEST-10\0"
+    "Australia/Lord_Howe\0" "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0\0"
+    "Australia/Melbourne\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/NSW\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/North\0" "ACST-9:30\0"
+    "Australia/Perth\0" "AWST-8\0"
+    "Australia/Queensland\0" "AEST-10\0"
+    "Australia/South\0" "ACST-9:30ACDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Sydney\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Tasmania\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/Victoria\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+    "Australia/West\0" "AWST-8\0"
+    "Australia/Yancowinna\0" "ACST-9:30ACDT,M10.1.0,M4.1.0/3\0"
+    "Brazil/Acre\0" "<-05>5\0"
+    "Brazil/DeNoronha\0" "<-02>2\0"
+    "Brazil/East\0" "<-03>3\0"
+    "Brazil/West\0" "<-04>4\0"
+    "Canada/Atlantic\0" "AST4ADT,M3.2.0,M11.1.0\0"
+    "Canada/Central\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "Canada/Eastern\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "Canada/Mountain\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "Canada/Newfoundland\0" "NST3:30NDT,M3.2.0,M11.1.0\0"
+    "Canada/Pacific\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "Canada/Saskatchewan\0" "CST6\0"
+    "Canada/Yukon\0" "MST7\0"
+    "Chile/Continental\0" "<-04>4<-03>,M9.1.6/24,M4.1.6/24\0"
+    "Chile/EasterIsland\0" "<-06>6<-05>,M9.1.6/22,M4.1.6/22\0"
+    "Etc/GMT\0" "GMT0\0"
+    "Etc/GMT+0\0" "GMT0\0"
+    "Etc/GMT+1\0" "<-01>1\0"
+    "Etc/GMT+10\0" "<-10>10\0"
+    "Etc/GMT+11\0" "<-11>11\0"
+    "Etc/GMT+12\0" "<-12>12\0"
+    "Etc/GMT+2\0" "<-02>2\0"
+    "Etc/GMT+3\0" "<-03>3\0"
+    "Etc/GMT+4\0" "<-04>4\0"
+    "Etc/GMT+5\0" "<-05>5\0"
+    "Etc/GMT+6\0" "<-06>6\0"
+    "Etc/GMT+7\0" "<-07>7\0"
+    "Etc/GMT+8\0" "<-08>8\0"
+    "Etc/GMT+9\0" "<-09>9\0"
+    "Etc/GMT-0\0" "GMT0\0"
+    "Etc/GMT-1\0" "<+01>-1\0"
+    "Etc/GMT-10\0" "<+10>-10\0"
+    "Etc/GMT-11\0" "<+11>-11\0"
+    "Etc/GMT-12\0" "<+12>-12\0"
+    "Etc/GMT-13\0" "<+13>-13\0"
+    "Etc/GMT-14\0" "<+14>-14\0"
+    "Etc/GMT-2\0" "<+02>-2\0"
+    "Etc/GMT-3\0" "<+03>-3\0"
+    "Etc/GMT-4\0" "<+04>-4\0"
+    "Etc/GMT-5\0" "<+05>-5\0"
+    "Etc/GMT-6\0" "<+06>-6\0"
+    "Etc/GMT-7\0" "<+07>-7\0"
+    "Etc/GMT-8\0" "<+08>-8\0"
+    "Etc/GMT-9\0" "<+09>-9\0"
+    "Etc/GMT0\0" "GMT0\0"
+    "Etc/Greenwich\0" "GMT0\0"
+    "Etc/UCT\0" "UTC0\0"
+    "Etc/UTC\0" "UTC0\0"
+    "Etc/Universal\0" "UTC0\0"
+    "Etc/Zulu\0" "UTC0\0"
+    "Europe/Amsterdam\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Andorra\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Astrakhan\0" "<+04>-4\0"
+    "Europe/Athens\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Belfast\0" "GMT0BST,M3.5.0/1,M10.5.0\0"
+    "Europe/Belgrade\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Berlin\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Bratislava\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Brussels\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Bucharest\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Budapest\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Busingen\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Chisinau\0" "EET-2EEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Copenhagen\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Dublin\0" "IST-1GMT0,M10.5.0,M3.5.0/1\0"
+    "Europe/Gibraltar\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Guernsey\0" "GMT0BST,M3.5.0/1,M10.5.0\0"
+    "Europe/Helsinki\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Isle_of_Man\0" "GMT0BST,M3.5.0/1,M10.5.0\0"
+    "Europe/Istanbul\0" "<+03>-3\0"
+    "Europe/Jersey\0" "GMT0BST,M3.5.0/1,M10.5.0\0"
+    "Europe/Kaliningrad\0" "EET-2\0"
+    "Europe/Kiev\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Kirov\0" "MSK-3\0"
+    "Europe/Kyiv\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Lisbon\0" "WET0WEST,M3.5.0/1,M10.5.0\0"
+    "Europe/Ljubljana\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/London\0" "GMT0BST,M3.5.0/1,M10.5.0\0"
+    "Europe/Luxembourg\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Madrid\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Malta\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Mariehamn\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Minsk\0" "<+03>-3\0"
+    "Europe/Monaco\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Moscow\0" "MSK-3\0"
+    "Europe/Nicosia\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Oslo\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Paris\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Podgorica\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Prague\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Riga\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Rome\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Samara\0" "<+04>-4\0"
+    "Europe/San_Marino\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Sarajevo\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Saratov\0" "<+04>-4\0"
+    "Europe/Simferopol\0" "MSK-3\0"
+    "Europe/Skopje\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Sofia\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Stockholm\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Tallinn\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Tirane\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Tiraspol\0" "EET-2EEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Ulyanovsk\0" "<+04>-4\0"
+    "Europe/Uzhgorod\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Vaduz\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Vatican\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Vienna\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Vilnius\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Volgograd\0" "MSK-3\0"
+    "Europe/Warsaw\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Zagreb\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Europe/Zaporozhye\0" "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+    "Europe/Zurich\0" "CET-1CEST,M3.5.0,M10.5.0/3\0"
+    "Indian/Antananarivo\0" "EAT-3\0"
+    "Indian/Chagos\0" "<+06>-6\0"
+    "Indian/Christmas\0" "<+07>-7\0"
+    "Indian/Cocos\0" "<+0630>-6:30\0"
+    "Indian/Comoro\0" "EAT-3\0"
+    "Indian/Kerguelen\0" "<+05>-5\0"
+    "Indian/Mahe\0" "<+04>-4\0"
+    "Indian/Maldives\0" "<+05>-5\0"
+    "Indian/Mauritius\0" "<+04>-4\0"
+    "Indian/Mayotte\0" "EAT-3\0"
+    "Indian/Reunion\0" "<+04>-4\0"
+    "Mexico/BajaNorte\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "Mexico/BajaSur\0" "MST7\0"
+    "Mexico/General\0" "CST6\0"
+    "Pacific/Apia\0" "<+13>-13\0"
+    "Pacific/Auckland\0" "NZST-12NZDT,M9.5.0,M4.1.0/3\0"
+    "Pacific/Bougainville\0" "<+11>-11\0"
+    "Pacific/Chatham\0" "<+1245>-12:45<+1345>,M9.5.0/2:45,M4.1.0/3:45\0"
+    "Pacific/Chuuk\0" "<+10>-10\0"
+    "Pacific/Easter\0" "<-06>6<-05>,M9.1.6/22,M4.1.6/22\0"
+    "Pacific/Efate\0" "<+11>-11\0"
+    "Pacific/Enderbury\0" "<+13>-13\0"
+    "Pacific/Fakaofo\0" "<+13>-13\0"
+    "Pacific/Fiji\0" "<+12>-12\0"
+    "Pacific/Funafuti\0" "<+12>-12\0"
+    "Pacific/Galapagos\0" "<-06>6\0"
+    "Pacific/Gambier\0" "<-09>9\0"
+    "Pacific/Guadalcanal\0" "<+11>-11\0"
+    "Pacific/Guam\0" "ChST-10\0"
+    "Pacific/Honolulu\0" "HST10\0"
+    "Pacific/Johnston\0" "HST10\0"
+    "Pacific/Kanton\0" "<+13>-13\0"
+    "Pacific/Kiritimati\0" "<+14>-14\0"
+    "Pacific/Kosrae\0" "<+11>-11\0"
+    "Pacific/Kwajalein\0" "<+12>-12\0"
+    "Pacific/Majuro\0" "<+12>-12\0"
+    "Pacific/Marquesas\0" "<-0930>9:30\0"
+    "Pacific/Midway\0" "SST11\0"
+    "Pacific/Nauru\0" "<+12>-12\0"
+    "Pacific/Niue\0" "<-11>11\0"
+    "Pacific/Norfolk\0" "<+11>-11<+12>,M10.1.0,M4.1.0/3\0"
+    "Pacific/Noumea\0" "<+11>-11\0"
+    "Pacific/Pago_Pago\0" "SST11\0"
+    "Pacific/Palau\0" "<+09>-9\0"
+    "Pacific/Pitcairn\0" "<-08>8\0"
+    "Pacific/Pohnpei\0" "<+11>-11\0"
+    "Pacific/Ponape\0" "<+11>-11\0"
+    "Pacific/Port_Moresby\0" "<+10>-10\0"
+    "Pacific/Rarotonga\0" "<-10>10\0"
+    "Pacific/Saipan\0" "ChST-10\0"
+    "Pacific/Samoa\0" "SST11\0"
+    "Pacific/Tahiti\0" "<-10>10\0"
+    "Pacific/Tarawa\0" "<+12>-12\0"
+    "Pacific/Tongatapu\0" "<+13>-13\0"
+    "Pacific/Truk\0" "<+10>-10\0"
+    "Pacific/Wake\0" "<+12>-12\0"
+    "Pacific/Wallis\0" "<+12>-12\0"
+    "Pacific/Yap\0" "<+10>-10\0"
+    "US/Alaska\0" "AKST9AKDT,M3.2.0,M11.1.0\0"
+    "US/Aleutian\0" "HST10HDT,M3.2.0,M11.1.0\0"
+    "US/Arizona\0" "MST7\0"
+    "US/Central\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "US/East-Indiana\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "US/Eastern\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "US/Hawaii\0" "HST10\0"
+    "US/Indiana-Starke\0" "CST6CDT,M3.2.0,M11.1.0\0"
+    "US/Michigan\0" "EST5EDT,M3.2.0,M11.1.0\0"
+    "US/Mountain\0" "MST7MDT,M3.2.0,M11.1.0\0"
+    "US/Pacific\0" "PST8PDT,M3.2.0,M11.1.0\0"
+    "US/Samoa\0" "SST11\0"
+    "UTC\0" "UTC0\0";
+
+const uint16_t ZONE_INDEX[] = {
+    0, 20, 38, 63, 84, 104, 124, 143, 163, 182, 201, 223,
+    248, 271, 314, 340, 380, 400, 418, 445, 467, 487, 511, 532,
+    554, 574, 601, 619, 640, 662, 682, 704, 723, 747, 764, 784,
+    808, 828, 848, 868, 889, 911, 934, 955, 976, 998, 1018, 1041,
+    1065, 1089, 1110, 1131, 1152, 1171, 1193, 1230, 1273, 1295, 1316, 1341,
+    1379, 1414, 1454, 1487, 1518, 1552, 1585, 1623, 1654, 1688, 1722, 1755,
+    1788, 1807, 1831, 1853, 1890, 1911, 1939, 1961, 1982, 2002, 2028, 2053,
+    2075, 2112, 2140, 2185, 2213, 2233, 2256, 2281, 2304, 2324, 2363, 2386,
+    2431, 2458, 2481, 2505, 2530, 2551, 2573, 2594, 2620, 2640, 2666, 2704,
+    2743, 2765, 2805, 2829, 2854, 2894, 2919, 2961, 2986, 3027, 3075, 3116,
+    3158, 3179, 3203, 3226, 3251, 3273, 3312, 3354, 3378, 3430, 3474, 3521,
+    3571, 3620, 3665, 3714, 3761, 3805, 3843, 3882, 3903, 3924, 3964, 4015,
+    4066, 4105, 4129, 4151, 4171, 4214, 4256, 4283, 4305, 4326, 4348, 4369,
+    4393, 4434, 4456, 4479, 4520, 4540, 4584, 4609, 4653, 4692, 4715, 4741,
+    4781, 4805, 4843, 4883, 4922, 4960, 4983, 5034, 5085, 5139, 5184, 5223,
+    5243, 5286, 5312, 5333, 5379, 5406, 5432, 5459, 5484, 5512, 5555, 5599,
+    5621, 5641, 5681, 5707, 5730, 5774, 5798, 5847, 5874, 5899, 5952, 5992,
+    6031, 6058, 6101, 6123, 6145, 6168, 6192, 6219, 6244, 6281, 6324, 6363,
+    6402, 6423, 6464, 6484, 6508, 6548, 6589, 6632, 6657, 6682, 6717, 6767,
+    6793, 6840, 6865, 6891, 6941, 6966, 7016, 7042, 7089, 7107, 7127, 7146,
+    7167, 7186, 7206, 7228, 7251, 7271, 7292, 7313, 7331, 7352, 7373, 7414,
+    7435, 7455, 7478, 7497, 7521, 7542, 7563, 7589, 7608, 7630, 7649, 7667,
+    7686, 7708, 7752, 7793, 7811, 7854, 7879, 7900, 7918, 7939, 7961, 7980,
+    8000, 8042, 8066, 8090, 8109, 8130, 8158, 8185, 8207, 8229, 8254, 8280,
+    8301, 8321, 8338, 8355, 8377, 8398, 8416, 8436, 8478, 8504, 8529, 8547,
+    8565, 8589, 8610, 8631, 8650, 8672, 8695, 8721, 8741, 8761, 8784, 8807,
+    8824, 8844, 8867, 8895, 8913, 8935, 8956, 8981, 9022, 9042, 9063, 9080,
+    9099, 9125, 9150, 9174, 9194, 9217, 9240, 9266, 9287, 9312, 9339, 9360,
+    9407, 9447, 9489, 9516, 9558, 9599, 9645, 9688, 9712, 9742, 9766, 9790,
+    9833, 9883, 9910, 9963, 10011, 10057, 10084, 10113, 10159, 10210, 10237, 10294,
+    10343, 10386, 10412, 10435, 10464, 10511, 10557, 10605, 10653, 10675, 10727, 10746,
+    10770, 10789, 10808, 10847, 10885, 10923, 10962, 11008, 11046, 11071, 11089, 11139,
+    11190, 11203, 11218, 11235, 11254, 11273, 11292, 11309, 11326, 11343, 11360, 11377,
+    11394, 11411, 11428, 11443, 11461, 11481, 11501, 11521, 11541, 11561, 11579, 11597,
+    11615, 11633, 11651, 11669, 11687, 11705, 11719, 11738, 11751, 11764, 11783, 11797,
+    11841, 11883, 11908, 11951, 11991, 12034, 12075, 12120, 12163, 12209, 12252, 12295,
+    12338, 12383, 12424, 12468, 12509, 12554, 12598, 12622, 12661, 12686, 12727, 12746,
+    12787, 12827, 12871, 12910, 12955, 12996, 13036, 13082, 13103, 13144, 13164, 13208,
+    13247, 13287, 13331, 13372, 13413, 13452, 13474, 13519, 13562, 13585, 13609, 13650,
+    13692, 13736, 13780, 13821, 13864, 13889, 13934, 13974, 14016, 14057, 14101, 14124,
+    14165, 14206, 14253, 14294, 14320, 14342, 14367, 14393, 14413, 14438, 14458, 14482,
+    14507, 14528, 14551, 14591, 14611, 14631, 14653, 14698, 14728, 14789, 14812, 14859,
+    14882, 14909, 14934, 14956, 14982, 15007, 15030, 15059, 15080, 15103, 15126, 15150,
+    15178, 15202, 15229, 15253, 15283, 15304, 15327, 15348, 15395, 15419, 15443, 15465,
+    15489, 15514, 15538, 15568, 15594, 15617, 15637, 15660, 15684, 15711, 15733, 15755,
+    15779, 15800, 15835, 15871, 15887, 15921, 15960, 15994, 16010, 16051, 16086, 16121,
+    16155, 16170,
+};
+
+}  // namespace tzdb
@@ -0,0 +1,40 @@
+#ifndef TIMEZONES_H
+#define TIMEZONES_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Olson (IANA) timezone names mapped to POSIX TZ rules.
+// timezones.cpp is generated by scripts/generate_timezones.py from the tz database.
+namespace tzdb {
+
+extern const uint16_t ZONE_COUNT;
+// "name\0rule\0" pairs sorted by name
+extern const char ZONE_DATA[];
+// Offset of each pair in ZONE_DATA
+extern const uint16_t ZONE_INDEX[];
+
+/**
+ * Find the POSIX TZ rule of an Olson timezone name, e.g. "Europe/Helsinki".
+ * Returns a pointer into flash or nullptr if the timezone is not in the table.
+ */
+inline const char* lookupPosix(const char* olson) {
+	int low = 0;
+	int high = ZONE_COUNT - 1;
+	while (low <= high) {
+		int mid = (low + high) / 2;
+		const char* name = ZONE_DATA + ZONE_INDEX[mid];
+		int cmp = strcmp(name, olson);
+		if (cmp == 0)
+			return name + strlen(name) + 1;
+		if (cmp < 0)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+	return nullptr;
+}
+
+}  // namespace tzdb
+
+#endif
@@ -0,0 +1,98 @@
+#include "trace.h"
+
+#if TRACE_CATEGORIES
+
+#include <esp_heap_caps.h>
+#include <freertos/ringbuf.h>
+
+#include <atomic>
+
+#define TRACE_TASK_PRIORITY 1
+#define TRACE_TASK_STACK_SIZE 2048
+
+namespace trace {
+
+namespace {
+RingbufHandle_t ringbuf = nullptr;
+std::atomic<uint32_t> droppedCount{0};
+
+void task(void* arg) {
+	for (;;) {
+		size_t size;
+		char* line = static_cast<char*>(xRingbufferReceive(ringbuf, &size, portMAX_DELAY));
+		if (!line)
+			continue;
+		// Items include the zero terminator
+		Serial.write(line, size - 1);
+		Serial.write('\n');
+		vRingbufferReturnItem(ringbuf, line);
+	}
+
+	vTaskDelete(NULL);
+}
+}  // namespace
+
+void begin() {
+	if (ringbuf)
+		return;
+
+	auto storage
+	    = static_cast<uint8_t*>(heap_caps_malloc(TRACE_BUFFER_SIZE, MALLOC_CAP_SPIRAM));
+	auto ringbufStruct = static_cast<StaticRingbuffer_t*>(
+	    heap_caps_malloc(sizeof(StaticRingbuffer_t), MALLOC_CAP_INTERNAL));
+	if (!storage || !ringbufStruct) {
+		log_e("Trace buffer allocation failed");
+		free(storage);
+		free(ringbufStruct);
+		return;
+	}
+
+	ringbuf = xRingbufferCreateStatic(TRACE_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT, storage,
+	                                  ringbufStruct);
+	xTaskCreate(task, "Trace", TRACE_TASK_STACK_SIZE, nullptr, TRACE_TASK_PRIORITY, nullptr);
+	log_i("Tracing enabled, categories: 0x%x", TRACE_CATEGORIES);
+}
+
+void write(const char* category, const char* format, ...) {
+	if (!ringbuf) {
+		droppedCount++;
+		return;
+	}
+
+	char prefix[48];
+	int prefixLength;
+	uint32_t dropped = droppedCount.exchange(0);
+	if (dropped > 0)
+		prefixLength = snprintf(prefix, sizeof(prefix), "[%6lu][T:%s][%u dropped] ", millis(),
+		                        category, (unsigned)dropped);
+	else
+		prefixLength = snprintf(prefix, sizeof(prefix), "[%6lu][T:%s] ", millis(), category);
+
+	va_list args;
+	va_start(args, format);
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int messageLength = vsnprintf(nullptr, 0, format, argsCopy);
+	va_end(argsCopy);
+
+	// Truncate lines that could never fit into the buffer
+	size_t size = min(prefixLength + messageLength + 1, (int)xRingbufferGetMaxItemSize(ringbuf));
+
+	char* item = nullptr;
+	if (xRingbufferSendAcquire(ringbuf, (void**)&item, size, 0) != pdTRUE) {
+		droppedCount += dropped + 1;
+		va_end(args);
+		return;
+	}
+	memcpy(item, prefix, min(prefixLength, (int)size - 1));
+	item[size - 1] = '\0';
+	if ((int)size - 1 > prefixLength)
+		vsnprintf(item + prefixLength, size - prefixLength, format, args);
+	va_end(args);
+
+	xRingbufferSendComplete(ringbuf, item);
+}
+
+}  // namespace trace
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+/**
+ * Compile-time trace categories for verbose debug output.
+ * Enable with a build flag, e.g. -DTRACE_CATEGORIES="(TRACE_HTTP_BIT|TRACE_SLEEP_BIT)".
+ *
+ * Disabled categories compile to nothing, their arguments are not even evaluated.
+ * TRACE_<CATEGORY>_TIMER(name, now) declares a start time for the lines of that category,
+ * and is likewise dropped with its category.
+ * Enabled categories are formatted into a RAM ring buffer, which a low priority task drains
+ * to the serial port, so tracing doesn't block the awake window on the UART.
+ */
+#define TRACE_HTTP_BIT (1 << 0)   // Request and response bodies
+#define TRACE_GUI_BIT (1 << 1)    // Drawing and GUI task timing
+#define TRACE_SLEEP_BIT (1 << 2)  // Sleep transitions and callbacks
+
+#ifndef TRACE_CATEGORIES
+#define TRACE_CATEGORIES 0
+#endif
+
+// Size of the trace ring buffer, allocated from PSRAM
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE (32 * 1024)
+#endif
+
+#define TRACE_NOOP(...) \
+	do {                \
+	} while (0)
+
+#if TRACE_CATEGORIES & TRACE_HTTP_BIT
+#define TRACE_HTTP(format, ...) trace::write("HTTP", format, ##__VA_ARGS__)
+#define TRACE_HTTP_TIMER(name, now) const auto name = now
+#else
+#define TRACE_HTTP(...) TRACE_NOOP()
+#define TRACE_HTTP_TIMER(name, now)
+#endif
+
+#if TRACE_CATEGORIES & TRACE_GUI_BIT
+#define TRACE_GUI(format, ...) trace::write("GUI", format, ##__VA_ARGS__)
+#define TRACE_GUI_TIMER(name, now) const auto name = now
+#else
+#define TRACE_GUI(...) TRACE_NOOP()
+#define TRACE_GUI_TIMER(name, now)
+#endif
+
+#if TRACE_CATEGORIES & TRACE_SLEEP_BIT
+#define TRACE_SLEEP(format, ...) trace::write("SLEEP", format, ##__VA_ARGS__)
+#define TRACE_SLEEP_TIMER(name, now) const auto name = now
+#else
+#define TRACE_SLEEP(...) TRACE_NOOP()
+#define TRACE_SLEEP_TIMER(name, now)
+#endif
+
+namespace trace {
+
+#if TRACE_CATEGORIES
+/**
+ * Create the ring buffer and the drain task. Traces written before this are dropped.
+ */
+void begin();
+
+/**
+ * Format a trace line into the ring buffer. Never blocks, lines that don't fit are dropped
+ * and the drop count is reported with the next line that fits. Use the TRACE_* macros instead.
+ */
+void write(const char* category, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+#else
+inline void begin() {}
+#endif
+
+}  // namespace trace
+
+#endif
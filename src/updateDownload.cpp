@@ -0,0 +1,148 @@
+#include "updateDownload.h"
+
+#include <cert.h>
+#include <mbedtls/sha256.h>
+
+#include <algorithm>
+
+#include "allocators.h"
+#include "globals.h"
+#include "myUpdate.h"
+
+#define UPDATE_SERVER_CERT GOOGLE_API_FULL_CHAIN_CERT
+
+#define FIRMWARE_CHUNK_TIMEOUT_MS 10000
+#define FIRMWARE_CHUNK_MAX_RETRIES 5
+// Can be overridden with a build flag, the host tests don't wait between retries
+#ifndef FIRMWARE_CHUNK_RETRY_DELAY_MS
+#define FIRMWARE_CHUNK_RETRY_DELAY_MS 2000
+#endif
+
+bool beginUpdateRequest(HTTPClient& http, const String& url) {
+	if (url.startsWith("http://"))
+		return http.begin(url);
+	return http.begin(url, UPDATE_SERVER_CERT);
+}
+
+String hexDigest(const uint8_t* digest) {
+	char hex[65];
+	for (size_t i = 0; i < 32; i++) sprintf(hex + i * 2, "%02x", digest[i]);
+	return String(hex);
+}
+
+String sha256Hex(const uint8_t* data, size_t size) {
+	uint8_t digest[32];
+	mbedtls_sha256_ret(data, size, digest, 0);
+	return hexDigest(digest);
+}
+
+namespace {
+
+/**
+ * One Range request for the chunk. Returns false if the connection dropped
+ * or the chunk doesn't match its hash.
+ */
+bool downloadChunkOnce(const String& url, size_t offset, size_t size,
+                       const String& expectedDigest, uint8_t* buffer) {
+	wifiManager.waitWiFi();
+
+	HTTPClient http;
+	http.setReuse(false);
+	http.setTimeout(FIRMWARE_CHUNK_TIMEOUT_MS);
+
+	beginUpdateRequest(http, url);
+	http.addHeader("Range", "bytes=" + String(offset) + "-" + String(offset + size - 1));
+
+	const int httpCode = http.GET();
+	energyLedger.countTlsHandshake();
+
+	if (httpCode != 206) {
+		log_e("http returned code %d for range at %u", httpCode, offset);
+		http.end();
+		return false;
+	}
+
+	Stream* stream = http.getStreamPtr();
+	size_t received = 0;
+	auto lastData = millis();
+	while (received < size && millis() - lastData < FIRMWARE_CHUNK_TIMEOUT_MS) {
+		if (!http.connected() && stream->available() == 0)
+			break;
+		size_t n = stream->readBytes(buffer + received, size - received);
+		if (n > 0)
+			lastData = millis();
+		received += n;
+	}
+	http.end();
+
+	if (received != size) {
+		log_e("Chunk at %u truncated: %u of %u bytes", offset, received, size);
+		return false;
+	}
+
+	const String digest = sha256Hex(buffer, size);
+	if (digest != expectedDigest) {
+		log_e("Chunk at %u digest mismatch", offset);
+		return false;
+	}
+	return true;
+}
+
+}  // namespace
+
+bool downloadChunk(const String& url, size_t offset, size_t size, const String& expectedDigest,
+                   uint8_t* buffer) {
+	for (int retry = 0; retry < FIRMWARE_CHUNK_MAX_RETRIES; retry++) {
+		if (retry > 0)
+			delay(FIRMWARE_CHUNK_RETRY_DELAY_MS);
+		if (downloadChunkOnce(url, offset, size, expectedDigest, buffer))
+			return true;
+	}
+	return false;
+}
+
+std::unique_ptr<utils::Error> downloadFirmwareChunks(const String& url, const String& version,
+                                                     const FirmwareManifest& manifest,
+                                                     ChunkTarget& target) {
+	// Progress of another version is useless, its chunks are still found by their hashes
+	size_t firstChunk = 0;
+	if (preferences.getString(UPDATE_PROGRESS_VERSION_KEY) == version) {
+		size_t persisted = preferences.getUInt(UPDATE_PROGRESS_CHUNK_KEY);
+		firstChunk = std::min(persisted, manifest.chunks.size());
+	} else {
+		preferences.putString(UPDATE_PROGRESS_VERSION_KEY, version);
+		preferences.putUInt(UPDATE_PROGRESS_CHUNK_KEY, 0);
+	}
+
+	alloc::Buffer buffer = alloc::makeBuffer(alloc::Pool::BUFFER, manifest.chunkSize);
+	if (!buffer)
+		return utils::make_unique<utils::Error>("Out of memory for the firmware download.");
+	size_t downloaded = 0;
+
+	for (size_t i = firstChunk; i < manifest.chunks.size(); i++) {
+		const size_t offset = i * manifest.chunkSize;
+		const size_t size = std::min(manifest.chunkSize, manifest.size - offset);
+
+		if (target.digest(offset, size) != manifest.chunks[i]) {
+			if (!downloadChunk(url, offset, size, manifest.chunks[i], buffer.get())) {
+				return utils::make_unique<utils::Error>("Firmware download interrupted at chunk "
+				                                        + String(i) + ".");
+			}
+			if (!target.write(offset, buffer.get(), size))
+				return utils::make_unique<utils::Error>("Firmware write failed.");
+			downloaded += size;
+		}
+
+		preferences.putUInt(UPDATE_PROGRESS_CHUNK_KEY, i + 1);
+	}
+
+	// Also catches chunks trusted from persisted progress that changed afterwards
+	if (target.digest(0, manifest.size) != manifest.sha256) {
+		preferences.putUInt(UPDATE_PROGRESS_CHUNK_KEY, 0);
+		return utils::make_unique<utils::Error>("Firmware image digest mismatch.");
+	}
+
+	log_i("Firmware downloaded %u of %u bytes", downloaded, manifest.size);
+
+	return nullptr;
+}
@@ -0,0 +1,70 @@
+#ifndef UPDATE_DOWNLOAD_H
+#define UPDATE_DOWNLOAD_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+#include <memory>
+#include <vector>
+
+#include "utils.h"
+
+/**
+ * Begin a request to the update server, pinned to its certificate.
+ * A plain http:// UPDATE_STORAGE_URL of a local test server is opened without one.
+ */
+bool beginUpdateRequest(HTTPClient& http, const String& url);
+
+/**
+ * Lowercase hex of a SHA-256 digest.
+ */
+String hexDigest(const uint8_t* digest);
+
+String sha256Hex(const uint8_t* data, size_t size);
+
+/**
+ * Download size bytes at offset of url into buffer with a Range request, and check them against
+ * expectedDigest. A dropped connection, a truncated chunk or a digest mismatch is retried up to
+ * FIRMWARE_CHUNK_MAX_RETRIES times. Returns false if no attempt got the chunk.
+ */
+bool downloadChunk(const String& url, size_t offset, size_t size, const String& expectedDigest,
+                   uint8_t* buffer);
+
+/**
+ * Firmware manifest, generated by scripts/make_manifest.py:
+ * {"size": 1234567, "sha256": "...", "chunk_size": 65536, "chunks": ["...", ...]}
+ */
+struct FirmwareManifest {
+	size_t size;
+	String sha256;
+	size_t chunkSize;
+	std::vector<String> chunks;
+};
+
+/**
+ * Storage the firmware image is downloaded into, the inactive OTA partition on the device.
+ */
+class ChunkTarget {
+  public:
+	virtual ~ChunkTarget() {}
+	/**
+	 * Lowercase hex SHA-256 of the stored bytes, empty if they can't be read.
+	 */
+	virtual String digest(size_t offset, size_t size) = 0;
+	virtual bool write(size_t offset, const uint8_t* data, size_t size) = 0;
+};
+
+/**
+ * Download the image of the manifest from url into target, without activating it.
+ *
+ * The image is fetched in chunks listed in the manifest. Chunks that already match their hash in
+ * the target are skipped, so an interrupted download resumes where it stopped, and chunks that
+ * didn't change since the firmware previously stored in the target aren't downloaded at all.
+ * The index of the next chunk of version is persisted, so a resume doesn't rehash finished
+ * chunks.
+ */
+std::unique_ptr<utils::Error> downloadFirmwareChunks(const String& url, const String& version,
+                                                     const FirmwareManifest& manifest,
+                                                     ChunkTarget& target);
+
+#endif
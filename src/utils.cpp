@@ -4,6 +4,7 @@
 #include <LittleFS.h>
 
 #include <deque>
+#include <mutex>
 
 namespace utils {
 const uint32_t BAT_LOW = 3300;
@@ -11,82 +12,56 @@ const uint32_t BAT_HIGH = 4200;
 
 const size_t MAX_BATTERY_HISTORY = 5;
 
+std::mutex batteryMutex;  // Protects batteryVoltageHistory
 std::deque<uint32_t> batteryVoltageHistory;
-time_t lastBatteryVoltageUpdate = 0;
-uint32_t getSmoothBatteryVoltage() {
+
+void _sampleBatteryVoltage() {
 	if (batteryVoltageHistory.size() >= MAX_BATTERY_HISTORY) {
 		batteryVoltageHistory.pop_front();
 	}
 	uint32_t voltage = M5.getBatteryVoltage();
-	batteryVoltageHistory.push_back(M5.getBatteryVoltage());
 
-	uint32_t sum = 0;
+	uint32_t sum = voltage;
 	for (uint32_t v : batteryVoltageHistory) {
 		sum += v;
 	}
-
-	uint32_t avg = sum / batteryVoltageHistory.size();
+	uint32_t avg = sum / (batteryVoltageHistory.size() + 1);
 
 	// Clear history if voltage is too far off from average (e.g. started or stopped charging)
 	if (abs((int32_t)voltage - (int32_t)avg) > 100) {
 		batteryVoltageHistory.clear();
-		return voltage;
+	}
+	batteryVoltageHistory.push_back(voltage);
+}
+
+void sampleBatteryVoltage() {
+	std::lock_guard<std::mutex> lock(batteryMutex);
+	_sampleBatteryVoltage();
+}
+
+uint32_t getSmoothBatteryVoltage() {
+	std::lock_guard<std::mutex> lock(batteryMutex);
+	if (batteryVoltageHistory.empty()) {
+		_sampleBatteryVoltage();
 	}
 
-	return avg;
+	uint32_t sum = 0;
+	for (uint32_t v : batteryVoltageHistory) {
+		sum += v;
+	}
+	return sum / batteryVoltageHistory.size();
 }
 
 /**
  * Returns battery level in 0.0-1.0 range.
  */
 float getBatteryLevel() {
-	auto voltage = getSmoothBatteryVoltage();
 	auto clamped = std::min(std::max(getSmoothBatteryVoltage(), BAT_LOW), BAT_HIGH);
 	return (float)(clamped - BAT_LOW) / (float)(BAT_HIGH - BAT_LOW);
 }
 
 bool isCharging() { return M5.getBatteryVoltage() > 4275; }
 
-std::vector<String> getBootLog() {
-	fs::File readHandle = LittleFS.open("/boot.log", FILE_READ);
-	if (!readHandle) {
-		return std::vector<String>();
-	}
-
-	std::vector<String> entries{};
-	String line;
-	while (true) {
-		line = readHandle.readStringUntil('\n');
-		if (line.isEmpty())
-			break;
-		entries.push_back(std::move(line));
-	}
-	readHandle.close();
-
-	return entries;
-}
-
-bool addBootLogEntry(const String& entry) {
-	auto entries = getBootLog();
-
-	if (entries.size() > 11) {
-		entries.erase(entries.begin());
-	}
-
-	entries.push_back(entry);
-
-	fs::File writeHandle = LittleFS.open("/boot.log", FILE_WRITE, true);
-	if (!writeHandle) {
-		return false;
-	}
-
-	for (const String& entry : entries) {
-		writeHandle.println(entry);
-	}
-	writeHandle.close();
-	return true;
-}
-
 void forceRestart() {
 	Serial.flush();
 
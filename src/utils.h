@@ -63,14 +63,15 @@ class Result {
 	}
 };
 
+/**
+ * Add a sample to the smoothed battery voltage, run periodically by the Scheduler.
+ */
+void sampleBatteryVoltage();
+
 float getBatteryLevel();
 
 bool isCharging();
 
-std::vector<String> getBootLog();
-
-bool addBootLogEntry(const String& entry);
-
 template <typename T, typename... Args>
 std::unique_ptr<T> make_unique(Args&&... args) {
 	return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
@@ -3,6 +3,7 @@
 #include <esp_wifi.h>
 
 #include "globals.h"
+#include "resumeState.h"
 
 const char* AP_SSID = "BOOKING-SETUP-";
 const char* AP_PASS = "Monad-";
@@ -30,18 +31,25 @@ void onAPEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
  */
 void onSTAEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
 	switch (event) {
+		case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+			energyLedger.setWiFiAssociated(true);
+			break;
 		case ARDUINO_EVENT_WIFI_STA_GOT_IP: {
 			if (uxSemaphoreGetCount(wifiManager._connectSemaphore) == 0) {
 				log_i("WiFi connected in %d ms", millis() - wifiManager._connectTimer);
+				resume::saveWiFi(WiFi.BSSID(), WiFi.channel());
 				xSemaphoreGive(wifiManager._connectSemaphore);
 			}
 			break;
 		}
 		case ARDUINO_EVENT_WIFI_STA_DISCONNECTED: {
+			energyLedger.setWiFiAssociated(false);
 			if (uxSemaphoreGetCount(wifiManager._connectSemaphore) == 0) {
 				wifiManager._disconnectReason
 				    = (wifi_err_reason_t)info.wifi_sta_disconnected.reason;
 				wifiManager._disconnectReasonStr = wifiErrorToString(wifiManager._disconnectReason);
+				// The access point may have changed, scan on the next try
+				resume::clearWiFi();
 
 				// ASSOC_LEAVE seems to be one of the only non-error disconnect reasons.
 				// All other reasons should be passed into error callbacks.
@@ -83,23 +91,35 @@ WiFiManager::WiFiManager() {
 
 	WiFi.onEvent(onAPEvent, ARDUINO_EVENT_WIFI_AP_START);
 	WiFi.onEvent(onAPEvent, ARDUINO_EVENT_WIFI_AP_STOP);
+	WiFi.onEvent(onSTAEvent, ARDUINO_EVENT_WIFI_STA_CONNECTED);
 	WiFi.onEvent(onSTAEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
 	WiFi.onEvent(onSTAEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
 }
 
 bool WiFiManager::openStation(const String& ssid, const String& password, int maxRetries) {
 	log_i("Opening WiFi station...");
+	setStation(ssid, password);
+	return waitWiFi(maxRetries);
+}
+
+void WiFiManager::setStation(const String& ssid, const String& password) {
 	_ssid = ssid;
 	_password = password;
 
 	WiFi.setAutoReconnect(false);
-	return waitWiFi(maxRetries);
 }
 
 void WiFiManager::_connect() {
 	xSemaphoreTake(_connectSemaphore, portMAX_DELAY);
-	log_i("Connecting WiFi...");
-	WiFi.begin(_ssid.c_str(), _password.c_str());
+	uint8_t bssid[6];
+	int32_t channel;
+	if (resume::restoreWiFi(bssid, channel)) {
+		log_i("Connecting WiFi to known access point on channel %d...", channel);
+		WiFi.begin(_ssid.c_str(), _password.c_str(), channel, bssid);
+	} else {
+		log_i("Connecting WiFi...");
+		WiFi.begin(_ssid.c_str(), _password.c_str());
+	}
 	_connectTimer = millis();
 }
 
@@ -143,6 +163,7 @@ void WiFiManager::wakeWiFi() {
 void WiFiManager::sleepWiFi() {
 	esp_wifi_deauth_sta(0);
 	esp_wifi_stop();
+	energyLedger.setWiFiAssociated(false);
 }
 
 void WiFiManager::openAccessPoint() {
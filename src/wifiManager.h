@@ -29,6 +29,12 @@ class WiFiManager {
 	 */
 	bool openStation(const String& ssid, const String& password, int maxRetries = 0);
 
+	/**
+	 * Set station credentials without connecting.
+	 * The connection is created by the first 'waitWiFi()' call.
+	 */
+	void setStation(const String& ssid, const String& password);
+
 	/**
 	 * Opposite of 'openStation()'.
 	 * Starts wifi in AP mode.
@@ -0,0 +1,152 @@
+#include <unity.h>
+
+#include <vector>
+
+#include "calendar/ics.h"
+
+/**
+ * Expansion of recurring events by the streaming iCalendar parser: COUNT, UNTIL, nth weekdays,
+ * overridden and cancelled instances and EXDATE. Times are in UTC, so the results don't depend
+ * on the timezone of the device.
+ */
+namespace {
+
+const time_t HOUR_S = 60 * 60;
+const time_t DAY_S = 24 * HOUR_S;
+// Monday 2024-03-04 00:00 UTC
+const time_t MARCH_4 = 1709510400;
+const time_t WEEK_START = MARCH_4;
+const time_t WEEK_END = MARCH_4 + 7 * DAY_S;
+
+struct Instance {
+	String uid;
+	time_t start;
+	time_t end;
+	time_t recurrenceId;
+};
+
+/**
+ * Parses the events of text, a calendar object of VEVENTs without the VCALENDAR lines.
+ */
+std::vector<Instance> parse(const char* text, time_t windowStart = WEEK_START,
+                            time_t windowEnd = WEEK_END) {
+	cal::ics::TimeResolver resolver;
+	cal::ics::Parser parser(resolver);
+	std::vector<Instance> instances;
+	parser.begin(windowStart, windowEnd, [&](const cal::ics::Occurrence& occurrence) {
+		instances.push_back(
+		    Instance{occurrence.uid, occurrence.start, occurrence.end, occurrence.recurrenceId});
+	});
+	const String object = String("BEGIN:VCALENDAR\r\n") + text + "END:VCALENDAR\r\n";
+	parser.feed(object.c_str(), object.length());
+	parser.endObject();
+	return instances;
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_count_limits_instances() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:count\r\nDTSTART:20240301T090000Z\r\nDTEND:20240301T100000Z\r\n"
+	    "RRULE:FREQ=DAILY;COUNT=5\r\nEND:VEVENT\r\n");
+	// March 1st to 5th, two of them in the week
+	TEST_ASSERT_EQUAL(2, instances.size());
+	TEST_ASSERT_EQUAL(MARCH_4 + 9 * HOUR_S, instances[0].start);
+	TEST_ASSERT_EQUAL(MARCH_4 + 10 * HOUR_S, instances[0].end);
+	TEST_ASSERT_EQUAL(MARCH_4 + DAY_S + 9 * HOUR_S, instances[1].start);
+	TEST_ASSERT_EQUAL(instances[1].start, instances[1].recurrenceId);
+}
+
+void test_until_is_inclusive() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:until\r\nDTSTART:20240301T090000Z\r\nDURATION:PT30M\r\n"
+	    "RRULE:FREQ=DAILY;UNTIL=20240306T090000Z\r\nEND:VEVENT\r\n");
+	TEST_ASSERT_EQUAL(3, instances.size());
+	TEST_ASSERT_EQUAL(MARCH_4 + 2 * DAY_S + 9 * HOUR_S, instances[2].start);
+	TEST_ASSERT_EQUAL(instances[2].start + 30 * 60, instances[2].end);
+}
+
+void test_nth_weekday_of_month() {
+	// Second Tuesday, March 12th
+	auto second = parse(
+	    "BEGIN:VEVENT\r\nUID:second\r\nDTSTART:20240109T100000Z\r\nDTEND:20240109T110000Z\r\n"
+	    "RRULE:FREQ=MONTHLY;BYDAY=2TU\r\nEND:VEVENT\r\n",
+	    MARCH_4 + 6 * DAY_S, MARCH_4 + 13 * DAY_S);
+	TEST_ASSERT_EQUAL(1, second.size());
+	TEST_ASSERT_EQUAL(MARCH_4 + 8 * DAY_S + 10 * HOUR_S, second[0].start);
+
+	// Last Friday, March 29th
+	auto last = parse(
+	    "BEGIN:VEVENT\r\nUID:last\r\nDTSTART:20240126T100000Z\r\nDTEND:20240126T110000Z\r\n"
+	    "RRULE:FREQ=MONTHLY;BYDAY=-1FR\r\nEND:VEVENT\r\n",
+	    MARCH_4 + 21 * DAY_S, MARCH_4 + 28 * DAY_S);
+	TEST_ASSERT_EQUAL(1, last.size());
+	TEST_ASSERT_EQUAL(MARCH_4 + 25 * DAY_S + 10 * HOUR_S, last[0].start);
+}
+
+void test_override_replaces_instance() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:weekly\r\nDTSTART:20240205T120000Z\r\nDTEND:20240205T130000Z\r\n"
+	    "RRULE:FREQ=WEEKLY\r\nEND:VEVENT\r\n"
+	    "BEGIN:VEVENT\r\nUID:weekly\r\nRECURRENCE-ID:20240304T120000Z\r\n"
+	    "DTSTART:20240304T150000Z\r\nDTEND:20240304T160000Z\r\nEND:VEVENT\r\n");
+	TEST_ASSERT_EQUAL(1, instances.size());
+	TEST_ASSERT_EQUAL_STRING("weekly", instances[0].uid.c_str());
+	TEST_ASSERT_EQUAL(MARCH_4 + 15 * HOUR_S, instances[0].start);
+	TEST_ASSERT_EQUAL(MARCH_4 + 12 * HOUR_S, instances[0].recurrenceId);
+}
+
+void test_override_before_recurring_event() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:weekly\r\nRECURRENCE-ID:20240304T120000Z\r\n"
+	    "DTSTART:20240304T150000Z\r\nDTEND:20240304T160000Z\r\nEND:VEVENT\r\n"
+	    "BEGIN:VEVENT\r\nUID:weekly\r\nDTSTART:20240205T120000Z\r\nDTEND:20240205T130000Z\r\n"
+	    "RRULE:FREQ=WEEKLY\r\nEND:VEVENT\r\n");
+	TEST_ASSERT_EQUAL(1, instances.size());
+	TEST_ASSERT_EQUAL(MARCH_4 + 15 * HOUR_S, instances[0].start);
+}
+
+void test_cancelled_override_removes_instance() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:weekly\r\nDTSTART:20240205T120000Z\r\nDTEND:20240205T130000Z\r\n"
+	    "RRULE:FREQ=WEEKLY\r\nEND:VEVENT\r\n"
+	    "BEGIN:VEVENT\r\nUID:weekly\r\nRECURRENCE-ID:20240304T120000Z\r\nSTATUS:CANCELLED\r\n"
+	    "DTSTART:20240304T120000Z\r\nDTEND:20240304T130000Z\r\nEND:VEVENT\r\n");
+	TEST_ASSERT_EQUAL(0, instances.size());
+}
+
+void test_exdate_removes_instances() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:daily\r\nDTSTART:20240301T100000Z\r\nDTEND:20240301T110000Z\r\n"
+	    "RRULE:FREQ=DAILY\r\nEXDATE:20240305T100000Z,20240307T100000Z\r\nEND:VEVENT\r\n");
+	TEST_ASSERT_EQUAL(5, instances.size());
+	for (const Instance& instance : instances) {
+		TEST_ASSERT_NOT_EQUAL(MARCH_4 + DAY_S + 10 * HOUR_S, instance.start);
+		TEST_ASSERT_NOT_EQUAL(MARCH_4 + 3 * DAY_S + 10 * HOUR_S, instance.start);
+	}
+}
+
+void test_unsupported_rule_shows_first_instance() {
+	auto instances = parse(
+	    "BEGIN:VEVENT\r\nUID:setpos\r\nDTSTART:20240305T100000Z\r\nDTEND:20240305T110000Z\r\n"
+	    "RRULE:FREQ=MONTHLY;BYDAY=MO,TU;BYSETPOS=1\r\nEND:VEVENT\r\n");
+	TEST_ASSERT_EQUAL(1, instances.size());
+	TEST_ASSERT_EQUAL(MARCH_4 + DAY_S + 10 * HOUR_S, instances[0].start);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_count_limits_instances);
+	RUN_TEST(test_until_is_inclusive);
+	RUN_TEST(test_nth_weekday_of_month);
+	RUN_TEST(test_override_replaces_instance);
+	RUN_TEST(test_override_before_recurring_event);
+	RUN_TEST(test_cancelled_override_removes_instance);
+	RUN_TEST(test_exdate_removes_instances);
+	RUN_TEST(test_unsupported_rule_shows_first_instance);
+	return UNITY_END();
+}
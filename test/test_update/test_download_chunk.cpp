@@ -0,0 +1,241 @@
+#include <HTTPClient.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "globals.h"
+#include "myUpdate.h"
+#include "updateDownload.h"
+
+/**
+ * downloadChunk and downloadFirmwareChunks against the host HTTPClient, with canned responses
+ * and with a transport that cuts responses off like scripts/update_server.py.
+ */
+namespace {
+
+const char* const URL = "https://storage.googleapis.com/no-booking-binaries/v2.4.0/firmware.bin";
+const size_t IMAGE_SIZE = 10000;
+const size_t CHUNK_SIZE = 4096;
+
+String image;
+uint8_t buffer[CHUNK_SIZE];
+
+String chunkDigest(size_t offset, size_t size) {
+	return sha256Hex((const uint8_t*)image.c_str() + offset, size);
+}
+
+String header(const HTTPRequest& request, const char* name) {
+	for (const auto& h : request.headers) {
+		if (h.first.equalsIgnoreCase(name))
+			return h.second;
+	}
+	return "";
+}
+
+/**
+ * Serves Range requests of the image. The first `truncated` responses, and all responses after
+ * the first `dropAfter`, are cut off after half of the range. Requests are recorded.
+ */
+struct RangeServer {
+	int truncated = 0;
+	int dropAfter = -1;
+	bool ignoreRange = false;
+	std::vector<String> ranges;
+	std::vector<const char*> certs;
+
+	int operator()(const HTTPRequest& request, HTTPResponse& response) {
+		ranges.push_back(header(request, "Range"));
+		certs.push_back(request.caCert);
+		if (ignoreRange) {
+			response.body = image;
+			return 200;
+		}
+
+		size_t first = 0, last = 0;
+		sscanf(header(request, "Range").c_str(), "bytes=%zu-%zu", &first, &last);
+		size_t size = std::min(last + 1, (size_t)image.length()) - first;
+		if ((int)ranges.size() <= truncated || (dropAfter >= 0 && (int)ranges.size() > dropAfter))
+			size /= 2;
+		response.body = image.substring(first, first + size);
+		return 206;
+	}
+};
+
+void serve(RangeServer& server) {
+	HTTPClient::setTransport(
+	    [&server](const HTTPRequest& request, HTTPResponse& response) {
+		    return server(request, response);
+	    });
+}
+
+/**
+ * Firmware image storage in memory, starts out erased.
+ */
+struct MemoryTarget : ChunkTarget {
+	std::vector<uint8_t> data = std::vector<uint8_t>(IMAGE_SIZE, 0xff);
+
+	String digest(size_t offset, size_t size) override {
+		return sha256Hex(data.data() + offset, size);
+	}
+
+	bool write(size_t offset, const uint8_t* chunk, size_t size) override {
+		std::copy(chunk, chunk + size, data.begin() + offset);
+		return true;
+	}
+};
+
+FirmwareManifest manifest() {
+	FirmwareManifest m{
+	    .size = IMAGE_SIZE,
+	    .sha256 = chunkDigest(0, IMAGE_SIZE),
+	    .chunkSize = CHUNK_SIZE,
+	    .chunks = {},
+	};
+	for (size_t offset = 0; offset < IMAGE_SIZE; offset += CHUNK_SIZE)
+		m.chunks.push_back(chunkDigest(offset, std::min(CHUNK_SIZE, IMAGE_SIZE - offset)));
+	return m;
+}
+
+}  // namespace
+
+void setUp() {
+	if (image.isEmpty()) {
+		for (size_t i = 0; i < IMAGE_SIZE; i++) image += (char)('a' + i * 7 % 26);
+	}
+	memset(buffer, 0, sizeof(buffer));
+	preferences.clear();
+}
+
+void tearDown() {
+	HTTPClient::setTransport(nullptr);
+	HTTPClient::clearResponses();
+}
+
+void test_canned_chunk() {
+	HTTPClient::setResponse(URL, 206, image.substring(CHUNK_SIZE, 2 * CHUNK_SIZE));
+	TEST_ASSERT_TRUE(
+	    downloadChunk(URL, CHUNK_SIZE, CHUNK_SIZE, chunkDigest(CHUNK_SIZE, CHUNK_SIZE), buffer));
+	TEST_ASSERT_EQUAL_MEMORY(image.c_str() + CHUNK_SIZE, buffer, CHUNK_SIZE);
+}
+
+void test_canned_truncated_chunk_fails() {
+	HTTPClient::setResponse(URL, 206, image.substring(CHUNK_SIZE, CHUNK_SIZE + 1000));
+	TEST_ASSERT_FALSE(
+	    downloadChunk(URL, CHUNK_SIZE, CHUNK_SIZE, chunkDigest(CHUNK_SIZE, CHUNK_SIZE), buffer));
+}
+
+void test_canned_corrupt_chunk_fails() {
+	String corrupt = image.substring(0, CHUNK_SIZE);
+	corrupt[100] = '!';
+	HTTPClient::setResponse(URL, 206, corrupt);
+	TEST_ASSERT_FALSE(downloadChunk(URL, 0, CHUNK_SIZE, chunkDigest(0, CHUNK_SIZE), buffer));
+}
+
+void test_retries_truncated_chunk() {
+	RangeServer server;
+	server.truncated = 2;
+	serve(server);
+
+	TEST_ASSERT_TRUE(
+	    downloadChunk(URL, CHUNK_SIZE, CHUNK_SIZE, chunkDigest(CHUNK_SIZE, CHUNK_SIZE), buffer));
+	TEST_ASSERT_EQUAL_MEMORY(image.c_str() + CHUNK_SIZE, buffer, CHUNK_SIZE);
+	// Every retry asks for the same chunk again
+	TEST_ASSERT_EQUAL(3, server.ranges.size());
+	for (const String& range : server.ranges)
+		TEST_ASSERT_EQUAL_STRING("bytes=4096-8191", range.c_str());
+}
+
+void test_resumes_at_last_chunk() {
+	RangeServer server;
+	serve(server);
+
+	const size_t offset = 2 * CHUNK_SIZE;
+	const size_t size = IMAGE_SIZE - offset;
+	TEST_ASSERT_TRUE(downloadChunk(URL, offset, size, chunkDigest(offset, size), buffer));
+	TEST_ASSERT_EQUAL_MEMORY(image.c_str() + offset, buffer, size);
+	TEST_ASSERT_EQUAL(1, server.ranges.size());
+	TEST_ASSERT_EQUAL_STRING("bytes=8192-9999", server.ranges[0].c_str());
+}
+
+void test_gives_up_after_retries() {
+	RangeServer server;
+	server.truncated = 100;
+	serve(server);
+
+	TEST_ASSERT_FALSE(downloadChunk(URL, 0, CHUNK_SIZE, chunkDigest(0, CHUNK_SIZE), buffer));
+	TEST_ASSERT_EQUAL(5, server.ranges.size());
+}
+
+void test_full_response_is_rejected() {
+	RangeServer server;
+	server.ignoreRange = true;
+	serve(server);
+
+	TEST_ASSERT_FALSE(downloadChunk(URL, 0, CHUNK_SIZE, chunkDigest(0, CHUNK_SIZE), buffer));
+}
+
+void test_pins_certificate() {
+	RangeServer server;
+	serve(server);
+
+	TEST_ASSERT_TRUE(downloadChunk(URL, 0, CHUNK_SIZE, chunkDigest(0, CHUNK_SIZE), buffer));
+	TEST_ASSERT_NOT_NULL(server.certs[0]);
+
+	// A local update server from UPDATE_STORAGE_URL is plain HTTP
+	TEST_ASSERT_TRUE(downloadChunk("http://192.168.1.2:8000/v2.4.0/firmware.bin", 0, CHUNK_SIZE,
+	                               chunkDigest(0, CHUNK_SIZE), buffer));
+	TEST_ASSERT_NULL(server.certs[1]);
+}
+
+void test_resumes_interrupted_download() {
+	MemoryTarget target;
+	RangeServer server;
+	// The connection is lost for good after the first chunk
+	server.dropAfter = 1;
+	serve(server);
+
+	TEST_ASSERT_NOT_NULL(downloadFirmwareChunks(URL, "2.4.0", manifest(), target).get());
+	TEST_ASSERT_EQUAL(1, preferences.getUInt(UPDATE_PROGRESS_CHUNK_KEY));
+
+	// After a restart only the chunks that weren't finished are requested
+	RangeServer restarted;
+	serve(restarted);
+	TEST_ASSERT_NULL(downloadFirmwareChunks(URL, "2.4.0", manifest(), target).get());
+	TEST_ASSERT_EQUAL(2, restarted.ranges.size());
+	TEST_ASSERT_EQUAL_STRING("bytes=4096-8191", restarted.ranges[0].c_str());
+	TEST_ASSERT_EQUAL_STRING("bytes=8192-9999", restarted.ranges[1].c_str());
+	TEST_ASSERT_EQUAL_MEMORY(image.c_str(), target.data.data(), IMAGE_SIZE);
+}
+
+void test_skips_chunks_already_in_target() {
+	MemoryTarget target;
+	// Left from an earlier version without progress, only the middle chunk differs
+	std::copy(image.c_str(), image.c_str() + IMAGE_SIZE, target.data.begin());
+	target.data[CHUNK_SIZE + 10] = '!';
+	preferences.putString(UPDATE_PROGRESS_VERSION_KEY, "2.3.9");
+	preferences.putUInt(UPDATE_PROGRESS_CHUNK_KEY, 3);
+	RangeServer server;
+	serve(server);
+
+	TEST_ASSERT_NULL(downloadFirmwareChunks(URL, "2.4.0", manifest(), target).get());
+	TEST_ASSERT_EQUAL(1, server.ranges.size());
+	TEST_ASSERT_EQUAL_STRING("bytes=4096-8191", server.ranges[0].c_str());
+	TEST_ASSERT_EQUAL_MEMORY(image.c_str(), target.data.data(), IMAGE_SIZE);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_canned_chunk);
+	RUN_TEST(test_canned_truncated_chunk_fails);
+	RUN_TEST(test_canned_corrupt_chunk_fails);
+	RUN_TEST(test_retries_truncated_chunk);
+	RUN_TEST(test_resumes_at_last_chunk);
+	RUN_TEST(test_gives_up_after_retries);
+	RUN_TEST(test_full_response_is_rejected);
+	RUN_TEST(test_pins_certificate);
+	RUN_TEST(test_resumes_interrupted_download);
+	RUN_TEST(test_skips_chunks_already_in_target);
+	return UNITY_END();
+}